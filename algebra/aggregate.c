@@ -0,0 +1,819 @@
+/************************INCLUDES*******************************/
+
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/helpers.h"
+#include "../include/openrel.h"
+#include "../include/findrel.h"
+#include "../include/insertrec.h"
+#include "../include/createfromattrlist.h"
+#include "../include/unpinrel.h"
+#include "../include/destroy.h"
+#include "../include/bloom.h"
+#include "../include/iterator.h"
+#include "../include/view.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#define AGG_COUNT   0
+#define AGG_SUM     1
+#define AGG_AVG     2
+#define AGG_MIN     3
+#define AGG_MAX     4
+
+static const char *aggFuncNames[] = {"count", "sum", "avg", "min", "max"};
+
+/*
+ * Hash aggregation.
+ *
+ * Every group is a result record under construction: the group attributes, then one column per aggregate
+ * holding its running value (sums and averages as a total, min and max as the value itself), and a row count
+ * kept beside it.  The records sit in an open-addressing table keyed on the fingerprint of the group attributes
+ * (BloomHashAttrs(), which leaves floats out so that tolerance-equal floats hash alike), with isSameTupleAttrs()
+ * deciding equality.  Once the table holds AGG_MEM_BYTES, the rows of groups it has not seen yet are spilled
+ * to AGG_SPILL_PARTS files "<dst>.ap<n>" on other hash bits, and every file is aggregated the same way after
+ * the groups in memory have been written out, up to AGG_MAX_DEPTH passes deep.
+ */
+
+/* One aggregate of the compute list */
+typedef struct aggspec
+{
+    int func;                   // AGG_COUNT .. AGG_MAX
+    AttrDesc *in;               // input attribute, in the layout of the input rows; NULL for count(*)
+    int offset;                 // its column in the result record
+    int length;
+} AggSpec;
+
+typedef struct agg
+{
+    AttrDesc *keyAttrs;         // group attributes, at the front of the result record
+    int *keySrc;                // offset of every group attribute in an input row
+    int numKeys;
+    AggSpec *specs;
+    int numSpecs;
+    int recSize;                // result record
+    int inSize;                 // input row
+    int dstRel;
+    const char *prefix;         // prefix of spill files
+    int nextFile;               // spill files created so far
+    long numGroups;             // result records inserted
+} Agg;
+
+/* Input of a pass: the rows of the source, or of a spill file */
+typedef struct agginput
+{
+    Iter *it;
+    FILE *fp;                   // spill file, when it is NULL
+} AggInput;
+
+/* In-memory groups, kept in arrival order */
+typedef struct aggtable
+{
+    char *recs;                 // numEnts result records
+    unsigned long long *hashes; // fingerprint of every group
+    long long *counts;          // rows of every group
+    long numEnts, capEnts;
+    long *slots;                // open addressing, entry index or -1
+    long numSlots;              // power of two
+} AggTable;
+
+
+static void build_apart_filename(Agg *ag, int n, char *fname, size_t buflen)
+{
+    snprintf(fname, buflen, "%s.ap%d", ag->prefix, n);
+}
+
+
+/* Reads the next row of a pass; 1 with *row set, 0 at the end, NOTOK on error */
+static int nextRow(Agg *ag, AggInput *in, char *buf, char **row)
+{
+    if(in->it)
+        return IterNext(in->it, row);
+
+    if(fread(buf, ag->inSize, 1, in->fp) == 1)
+    {
+        *row = buf;
+        return 1;
+    }
+    if(ferror(in->fp))
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+    return 0;
+}
+
+
+/* Three-way comparison of two values of an input attribute, as for sort */
+static int valueCmp(const char *a, const char *b, AttrDesc *attr)
+{
+    if(attr->attr.type[0] == 's')
+    {
+        int c = strncmp(a, b, attr->attr.length);
+        return (c > 0) - (c < 0);
+    }
+    return compareNumeric(a, b, attr->attr.type[0], attr->attr.length);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION accumulate (ag, rec, row)
+
+FUNCTION DESCRIPTION:
+    Folds one input row into the aggregate columns of its group's result record.
+    Integer sums are kept in 8 bytes and wrap on overflow; float sums and averages are kept as doubles.
+
+------------------------------------------------------------*/
+
+static void accumulate(Agg *ag, char *rec, const char *row)
+{
+    for(int k = 0; k < ag->numSpecs; k++)
+    {
+        AggSpec *s = &ag->specs[k];
+        char *acc = rec + s->offset;
+
+        if(s->func == AGG_COUNT)
+            continue;
+
+        const char *v = row + s->in->attr.offset;
+        char type = s->in->attr.type[0];
+        int len = s->in->attr.length;
+
+        if(s->func == AGG_SUM && type == 'i')
+        {
+            unsigned long long x = (unsigned long long)getIntValue(acc, 8) + (unsigned long long)getIntValue(v, len);
+            putIntValue(acc, 8, (long long)x);
+        }
+        else if(s->func == AGG_SUM || s->func == AGG_AVG)
+        {
+            double x = getFloatValue(acc, 8) + (type == 'f' ? getFloatValue(v, len) : (double)getIntValue(v, len));
+            memcpy(acc, &x, sizeof(double));
+        }
+        else
+        {
+            int c = valueCmp(v, acc, s->in);
+
+            if(s->func == AGG_MIN ? c < 0 : c > 0)
+                memcpy(acc, v, len);
+        }
+    }
+}
+
+
+/* Turns the running values of a group into its result: counts, and totals divided into averages */
+static void finish(Agg *ag, char *rec, long long count)
+{
+    for(int k = 0; k < ag->numSpecs; k++)
+    {
+        AggSpec *s = &ag->specs[k];
+
+        if(s->func == AGG_COUNT)
+        {
+            putIntValue(rec + s->offset, s->length, count);
+        }
+        else if(s->func == AGG_AVG && count > 0)
+        {
+            double x = getFloatValue(rec + s->offset, 8) / count;
+            memcpy(rec + s->offset, &x, sizeof(double));
+        }
+    }
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION table helpers (tableFind, tableAdd, tableBytes, tableFree)
+
+FUNCTION DESCRIPTION:
+    tableFind() returns the group whose key equals the group attributes of key, or -1.
+    tableAdd() appends the group of key, its aggregate columns started from row, doubling the slot array
+    when it is half full, and returns its entry or NOTOK.
+    tableBytes() is the memory the table holds.
+
+------------------------------------------------------------*/
+
+static long tableFind(Agg *ag, AggTable *t, unsigned long long h, char *key)
+{
+    if(t->numSlots == 0)
+        return -1;
+
+    for(long s = h & (t->numSlots - 1);; s = (s + 1) & (t->numSlots - 1))
+    {
+        long e = t->slots[s];
+
+        if(e < 0)
+            return -1;
+        if(t->hashes[e] == h && isSameTupleAttrs(ag->keyAttrs, t->recs + e * ag->recSize, key))
+            return e;
+    }
+}
+
+static long tableAdd(Agg *ag, AggTable *t, unsigned long long h, char *key, const char *row)
+{
+    if(t->numEnts == t->capEnts)
+    {
+        long cap = t->capEnts ? 2 * t->capEnts : 256;
+        char *recs = realloc(t->recs, cap * ag->recSize);
+        if(recs)
+            t->recs = recs;
+        unsigned long long *hashes = realloc(t->hashes, cap * sizeof(unsigned long long));
+        if(hashes)
+            t->hashes = hashes;
+        long long *counts = realloc(t->counts, cap * sizeof(long long));
+        if(counts)
+            t->counts = counts;
+
+        if(!recs || !hashes || !counts)
+        {
+            db_err_code = MEM_ALLOC_ERROR;
+            return NOTOK;
+        }
+        t->capEnts = cap;
+    }
+
+    if(2 * (t->numEnts + 1) > t->numSlots)
+    {
+        long n = t->numSlots ? 2 * t->numSlots : 512;
+        long *slots = malloc(n * sizeof(long));
+
+        if(!slots)
+        {
+            db_err_code = MEM_ALLOC_ERROR;
+            return NOTOK;
+        }
+
+        for(long s = 0; s < n; s++)
+            slots[s] = -1;
+        for(long e = 0; e < t->numEnts; e++)
+        {
+            long s = t->hashes[e] & (n - 1);
+            while(slots[s] >= 0)
+                s = (s + 1) & (n - 1);
+            slots[s] = e;
+        }
+
+        free(t->slots);
+        t->slots = slots;
+        t->numSlots = n;
+    }
+
+    long e = t->numEnts++;
+    char *rec = t->recs + e * ag->recSize;
+
+    memcpy(rec, key, ag->recSize);
+    for(int k = 0; k < ag->numSpecs; k++)
+    {
+        AggSpec *s = &ag->specs[k];
+
+        if(s->func == AGG_MIN || s->func == AGG_MAX)
+            memcpy(rec + s->offset, row + s->in->attr.offset, s->length);
+        else
+            memset(rec + s->offset, 0, s->length);
+    }
+    t->hashes[e] = h;
+    t->counts[e] = 0;
+
+    long s = h & (t->numSlots - 1);
+    while(t->slots[s] >= 0)
+        s = (s + 1) & (t->numSlots - 1);
+    t->slots[s] = e;
+    return e;
+}
+
+static long tableBytes(Agg *ag, AggTable *t)
+{
+    return t->capEnts * (ag->recSize + sizeof(unsigned long long) + sizeof(long long)) + t->numSlots * sizeof(long);
+}
+
+static void tableFree(AggTable *t)
+{
+    free(t->recs);
+    free(t->hashes);
+    free(t->counts);
+    free(t->slots);
+    memset(t, 0, sizeof(AggTable));
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION aggPass (ag, in, depth)
+
+PARAMETER DESCRIPTION:
+    ag    → aggregation being evaluated.
+    in    → rows of this pass.
+    depth → spilling passes already made.
+
+FUNCTION DESCRIPTION:
+    Aggregates the rows of in into ag->dstRel.
+
+ALGORITHM:
+    1) For every row, build its group key in a result record and look it up; a new group is added
+       while the table holds less than AGG_MEM_BYTES (or depth reached AGG_MAX_DEPTH), otherwise the
+       row goes to the spill file chosen by 8 hash bits that no earlier pass used.
+    2) Fold the row into its group with accumulate().
+    3) Finish and insert every group in memory, then free the table.
+    4) Run aggPass() on every spill file, one level deeper.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+ERRORS REPORTED:
+    FILESYSTEM_ERROR
+    MEM_ALLOC_ERROR
+
+IMPLEMENTATION NOTES:
+    • A group found in the table never spills, and the table stops growing once it is full, so
+      every group is finished in exactly one place and the results of the passes are disjoint.
+    • The spill files use hash bits above the ones the next pass indexes its table with.
+
+------------------------------------------------------------*/
+
+static int aggPass(Agg *ag, AggInput *in, int depth)
+{
+    AggTable t;
+    AggInput parts[AGG_SPILL_PARTS];
+    int first = -1, r, rc = OK;
+    char fname[RELNAME + 16];
+    char *key = calloc(1, ag->recSize);
+    char *buf = malloc(ag->inSize);
+    char *row;
+
+    memset(&t, 0, sizeof(AggTable));
+    memset(parts, 0, sizeof(parts));
+    if(!key || !buf)
+    {
+        free(key);
+        free(buf);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    while(rc == OK && (r = nextRow(ag, in, buf, &row)) != 0)
+    {
+        if(r == NOTOK)
+        {
+            rc = NOTOK;
+            break;
+        }
+
+        int k = 0;
+        for(AttrDesc *a = ag->keyAttrs; a; a = a->next, k++)
+            memcpy(key + a->attr.offset, row + ag->keySrc[k], a->attr.length);
+
+        unsigned long long h = BloomHashAttrs(ag->keyAttrs, key);
+        long e = tableFind(ag, &t, h, key);
+
+        if(e < 0 && depth < AGG_MAX_DEPTH && tableBytes(ag, &t) >= AGG_MEM_BYTES)
+        {
+            if(first < 0)
+            {
+                first = ag->nextFile;
+                for(int p = 0; p < AGG_SPILL_PARTS && rc == OK; p++)
+                {
+                    build_apart_filename(ag, ag->nextFile++, fname, sizeof(fname));
+                    if(!(parts[p].fp = fopen(fname, "w+b")))
+                    {
+                        db_err_code = FILESYSTEM_ERROR;
+                        rc = NOTOK;
+                    }
+                }
+            }
+
+            AggInput *out = &parts[(h >> (32 + 8 * depth)) % AGG_SPILL_PARTS];
+
+            if(rc == OK && fwrite(row, ag->inSize, 1, out->fp) != 1)
+            {
+                db_err_code = FILESYSTEM_ERROR;
+                rc = NOTOK;
+            }
+            continue;
+        }
+
+        if(e < 0 && (e = tableAdd(ag, &t, h, key, row)) == NOTOK)
+        {
+            rc = NOTOK;
+            break;
+        }
+
+        t.counts[e]++;
+        accumulate(ag, t.recs + e * ag->recSize, row);
+    }
+
+    for(long e = 0; rc == OK && e < t.numEnts; e++)
+    {
+        char *rec = t.recs + e * ag->recSize;
+
+        finish(ag, rec, t.counts[e]);
+        rc = InsertRec(ag->dstRel, rec);
+        ag->numGroups++;
+    }
+
+    tableFree(&t);
+
+    for(int p = 0; first >= 0 && p < AGG_SPILL_PARTS && rc == OK; p++)
+    {
+        if(fflush(parts[p].fp) != 0 || fseek(parts[p].fp, 0, SEEK_SET) != 0)
+        {
+            db_err_code = FILESYSTEM_ERROR;
+            rc = NOTOK;
+            break;
+        }
+        rc = aggPass(ag, &parts[p], depth + 1);
+    }
+
+    for(int p = 0; first >= 0 && p < AGG_SPILL_PARTS; p++)
+    {
+        if(parts[p].fp)
+            fclose(parts[p].fp);
+        build_apart_filename(ag, first + p, fname, sizeof(fname));
+        remove(fname);
+    }
+
+    free(key);
+    free(buf);
+    return rc;
+}
+
+
+/* Attribute of the rows of it named attrName, or NULL with a message */
+static AttrDesc *inputAttr(Iter *it, const char *attrName)
+{
+    for(AttrDesc *a = it->attrList; a; a = a->next)
+    {
+        if(strncmp(a->attr.attrName, attrName, ATTRNAME) == OK)
+            return a;
+    }
+
+    printf("Attribute '%s' NOT present in relation '%s' of the DB.\n", attrName, it->name);
+    if(!ViewFind(it->name))
+        printCloseStrings(ATTRCAT_CACHE, offsetof(AttrCatRec, attrName), (char *)attrName, it->name);
+    db_err_code = ATTRNOEXIST;
+    return NULL;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION Aggregate (argc, argv)
+
+PARAMETER DESCRIPTION:
+    argc → number of command arguments.
+    argv → argument vector.
+
+SPECIFICATIONS:
+    argv[0]          = "aggregate"
+    argv[1]          = destination relation name
+    argv[2]          = source relation or view name
+    argv[3 .. g+2]   = group attributes (none without "group by")
+    argv[g+3]        = ""
+    argv[g+4 ..]     = pairs of aggregate function and attribute name, or "*" for count(*)
+    argv[argc]       = NIL
+
+    aggregate D from R group by A, B compute count(*), sum(C), avg(C), min(C), max(C);
+    aggregate D from R compute count(*);
+
+FUNCTION DESCRIPTION:
+    Creates relation D with one tuple per distinct combination of the group attributes of the source, holding
+    those attributes and then one attribute per aggregate, in the order given:
+        count(*), count(a) → "count", "count-a"     INTEGER, rows of the group
+        sum(a)             → "sum-a"                8-byte INTEGER for an INTEGER a, 8-byte FLOAT for a FLOAT a
+        avg(a)             → "avg-a"                8-byte FLOAT
+        min(a), max(a)     → "min-a", "max-a"       the type of a; strings order as strncmp()
+    Without "group by" the result is a single tuple.  Group attributes compare like compareRecs(): floats
+    within FLOAT_REL_EPS are one group.
+
+ALGORITHM:
+    1) Ensure that a database is open and that the destination does not exist.
+    2) Without group attributes and with only counts over a heap relation, answer from relcat's numRecs
+       without reading the relation.
+    3) Otherwise open the source, decoding only the attributes used when it is a heap relation, and
+       resolve the group attributes and aggregates against its rows.
+    4) Lay out the result attributes, create the destination with CreateFromAttrList() and open it.
+    5) aggPass() over the rows of the source; an ungrouped aggregate of no rows inserts one tuple
+       with every count and sum 0, and fails with AGG_NO_ROWS if it asks for a min, max or avg.
+       On any failure the destination is destroyed again.
+    6) Print a success message.
+
+ERRORS REPORTED:
+    DBNOTOPEN
+    RELEXIST
+    RELNOEXIST
+    ATTRNOEXIST
+    ATTR_NAME_EXCEEDED
+    AGG_INVALID
+    AGG_NO_ROWS
+    MEM_ALLOC_ERROR
+    FILESYSTEM_ERROR
+    Errors of Create() (e.g. DUP_ATTR for an aggregate given twice) and of InsertRec()
+
+GLOBAL VARIABLES MODIFIED:
+    db_err_code
+    Catalog entries and heap pages of the destination relation
+
+IMPLEMENTATION NOTES:
+    • MINIREL has no NULLs, so count(a) is count(*), and a min, max or avg of no rows, which would be NULL,
+      is an error rather than a value that was never seen.
+    • A source relation is read once (plus one write and read of the rows of spilled groups per pass).
+
+------------------------------------------------------------*/
+
+int Aggregate(int argc, char **argv)
+{
+    if(!db_open)
+    {
+        db_err_code = DBNOTOPEN;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    char *dstRelName = argv[1];
+    char *srcName = argv[2];
+    int sep = 3;
+
+    while(sep < argc && argv[sep][0])
+        sep++;
+
+    int numKeys = sep - 3;
+    int numSpecs = (argc - sep - 1) / 2;
+    char **keyNames = argv + 3;
+    char **specArgs = argv + sep + 1;
+    bool countsOnly = numKeys == 0;
+
+    if(FindRel(dstRelName) || ViewFind(dstRelName))
+    {
+        printf("Relation '%s' already exists in the DB.\n", dstRelName);
+        db_err_code = RELEXIST;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    Agg ag;
+    AttrDesc *keys = calloc(numKeys + 1, sizeof(AttrDesc));      // group attributes alone, for hashing and equality
+    AttrDesc *out = calloc(numKeys + numSpecs, sizeof(AttrDesc));   // every result attribute
+    char **names = malloc(argc * sizeof(char *));
+    Iter *it = NULL;
+    int srcRel = NOTOK, offset = 0, rc = OK;
+    bool created = false;
+
+    memset(&ag, 0, sizeof(Agg));
+    ag.keySrc = malloc((numKeys + 1) * sizeof(int));
+    ag.specs = malloc((numSpecs + 1) * sizeof(AggSpec));
+    ag.numKeys = numKeys;
+    ag.numSpecs = numSpecs;
+    ag.prefix = dstRelName;
+
+    if(!keys || !out || !names || !ag.keySrc || !ag.specs)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        rc = NOTOK;
+    }
+
+    for(int k = 0; rc == OK && k < numSpecs; k++)
+    {
+        AggSpec *s = &ag.specs[k];
+        char *func = specArgs[2 * k], *arg = specArgs[2 * k + 1];
+
+        s->func = -1;
+        s->in = NULL;
+        for(int f = AGG_COUNT; f <= AGG_MAX; f++)
+        {
+            if(strcmp(func, aggFuncNames[f]) == OK)
+                s->func = f;
+        }
+
+        if(s->func < 0 || (s->func != AGG_COUNT && strcmp(arg, "*") == OK))
+        {
+            printf("'%s(%s)' is NOT a valid aggregate.\n", func, arg);
+            db_err_code = AGG_INVALID;
+            rc = NOTOK;
+        }
+        countsOnly = countsOnly && s->func == AGG_COUNT;
+    }
+
+    if(rc == OK && countsOnly && !ViewFind(srcName))
+    {
+        /* count(*) of a whole heap relation is kept in relcat */
+        if((srcRel = OpenRel(srcName)) == NOTOK)
+        {
+            if(db_err_code == RELNOEXIST)
+            {
+                printf("Relation '%s' does NOT exist in the DB.\n", srcName);
+                printCloseStrings(RELCAT_CACHE, offsetof(RelCatRec, relName), srcName, NULL);
+            }
+            rc = NOTOK;
+        }
+
+        for(int k = 0; rc == OK && k < numSpecs; k++)
+        {
+            char *arg = specArgs[2 * k + 1];
+
+            if(strcmp(arg, "*") != OK && !getAttrDesc(srcRel, arg))
+            {
+                printf("Attribute '%s' NOT present in relation '%s' of the DB.\n", arg, srcName);
+                printCloseStrings(ATTRCAT_CACHE, offsetof(AttrCatRec, attrName), arg, srcName);
+                db_err_code = ATTRNOEXIST;
+                rc = NOTOK;
+            }
+        }
+    }
+    else if(rc == OK)
+    {
+        /* A heap relation only needs to decode the attributes used */
+        int numNames = 0;
+
+        for(int k = 0; k < numKeys; k++)
+            names[numNames++] = keyNames[k];
+        for(int k = 0; k < numSpecs; k++)
+        {
+            if(strcmp(specArgs[2 * k + 1], "*") != OK)
+                names[numNames++] = specArgs[2 * k + 1];
+        }
+
+        it = numNames && !ViewFind(srcName) ? ScanIterOpenCols(srcName, numNames, names) : IterOpen(srcName);
+        if(!it)
+            rc = NOTOK;
+        else
+            ag.inSize = it->recSize;
+    }
+
+    /* Group attributes keep their type and length */
+    for(int k = 0; rc == OK && k < numKeys; k++)
+    {
+        AttrDesc *in = inputAttr(it, keyNames[k]);
+
+        if(!in)
+        {
+            rc = NOTOK;
+            break;
+        }
+
+        keys[k].attr = in->attr;
+        keys[k].attr.offset = offset;
+        keys[k].attr.encoding = ENC_NONE;
+        keys[k].next = k + 1 < numKeys ? &keys[k + 1] : NULL;
+        out[k].attr = keys[k].attr;
+        out[k].next = &out[k + 1];
+        ag.keySrc[k] = in->attr.offset;
+        offset += in->attr.length;
+    }
+    ag.keyAttrs = numKeys ? keys : NULL;
+
+    for(int k = 0; rc == OK && k < numSpecs; k++)
+    {
+        AggSpec *s = &ag.specs[k];
+        AttrDesc *o = &out[numKeys + k];
+        char *arg = specArgs[2 * k + 1];
+        char name[2 * ATTRNAME];
+
+        if(strcmp(arg, "*") == OK)
+            snprintf(name, sizeof(name), "%s", aggFuncNames[s->func]);
+        else
+            snprintf(name, sizeof(name), "%s-%s", aggFuncNames[s->func], arg);
+
+        if(strlen(name) >= ATTRNAME)
+        {
+            printf("Result attribute name '%s' is too long: attribute names are limited to %d characters.\n", name, ATTRNAME - 1);
+            db_err_code = ATTR_NAME_EXCEEDED;
+            rc = NOTOK;
+            break;
+        }
+
+        if(it && strcmp(arg, "*") != OK && !(s->in = inputAttr(it, arg)))
+        {
+            rc = NOTOK;
+            break;
+        }
+
+        char type = s->in ? s->in->attr.type[0] : 'i';
+
+        if((s->func == AGG_SUM || s->func == AGG_AVG) && type != 'i' && type != 'f')
+        {
+            printf("%s() needs an INTEGER or FLOAT attribute; '%s' is a %s.\n", aggFuncNames[s->func], arg, typeName(type));
+            db_err_code = AGG_INVALID;
+            rc = NOTOK;
+            break;
+        }
+
+        memset(&o->attr, 0, sizeof(AttrCatRec));
+        strncpy(o->attr.attrName, name, ATTRNAME - 1);
+
+        switch(s->func)
+        {
+            case AGG_COUNT:
+                o->attr.type[0] = 'i';
+                o->attr.length = sizeof(int);
+                break;
+            case AGG_SUM:
+                o->attr.type[0] = type;
+                o->attr.length = 8;
+                break;
+            case AGG_AVG:
+                o->attr.type[0] = 'f';
+                o->attr.length = sizeof(double);
+                break;
+            default:
+                o->attr.type[0] = type;
+                o->attr.length = s->in->attr.length;
+        }
+
+        o->attr.offset = offset;
+        o->next = k + 1 < numSpecs ? o + 1 : NULL;
+        s->offset = offset;
+        s->length = o->attr.length;
+        offset += o->attr.length;
+    }
+
+    if(rc == OK)
+    {
+        ag.recSize = offset;
+
+        created = CreateFromAttrList(dstRelName, out) == OK;
+
+        if(!created || (ag.dstRel = OpenRel(dstRelName)) == NOTOK)
+            rc = NOTOK;
+    }
+
+    if(rc == OK && !it)
+    {
+        /* Only counts, no groups: a single tuple from relcat */
+        char *rec = calloc(1, ag.recSize);
+
+        if(!rec)
+        {
+            db_err_code = MEM_ALLOC_ERROR;
+            rc = NOTOK;
+        }
+        else
+        {
+            finish(&ag, rec, catcache[srcRel].relcat_rec.numRecs);
+            rc = InsertRec(ag.dstRel, rec);
+            ag.numGroups = 1;
+            free(rec);
+        }
+    }
+    else if(rc == OK)
+    {
+        AggInput in = {it, NULL};
+
+        rc = aggPass(&ag, &in, 0);
+
+        /* count and sum of no rows are 0, but min, max and avg have no value to report */
+        bool valueless = false;
+
+        for(int k = 0; rc == OK && k < numSpecs; k++)
+            valueless |= ag.specs[k].func == AGG_MIN || ag.specs[k].func == AGG_MAX || ag.specs[k].func == AGG_AVG;
+
+        if(rc == OK && numKeys == 0 && ag.numGroups == 0 && valueless)
+        {
+            printf("%s has no rows, so min, max and avg have no value.\n", srcName);
+            db_err_code = AGG_NO_ROWS;
+            rc = NOTOK;
+        }
+        else if(rc == OK && numKeys == 0 && ag.numGroups == 0)
+        {
+            char *rec = calloc(1, ag.recSize);
+
+            if(!rec)
+            {
+                db_err_code = MEM_ALLOC_ERROR;
+                rc = NOTOK;
+            }
+            else
+            {
+                rc = InsertRec(ag.dstRel, rec);
+                ag.numGroups = 1;
+                free(rec);
+            }
+        }
+    }
+
+    if(it)
+        IterClose(it);
+    if(srcRel != NOTOK)
+        UnPinRel(srcRel);
+    free(keys);
+    free(out);
+    free(names);
+    free(ag.keySrc);
+    free(ag.specs);
+
+    if(rc != OK)
+    {
+        /* Do not leave a partly written result behind */
+        int err = db_err_code;
+        char *destroyArgv[] = {"_destroy", dstRelName, NULL};
+
+        if(created)
+            Destroy(2, destroyArgv);
+        db_err_code = err;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    UnPinRel(ag.dstRel);
+    printf("Created relation %s with the %ld groups of %s\n", dstRelName, ag.numGroups, srcName);
+    return OK;
+}
@@ -6,14 +6,107 @@
 #include "../include/helpers.h"
 #include "../include/openrel.h"
 #include "../include/findrec.h"
+#include "../include/getrec.h"
+#include "../include/idxmaint.h"
+#include "../include/planner.h"
+#include "../include/delete.h"
 #include "../include/deleterec.h"
 #include "../include/unpinrel.h"
+#include "../include/view.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
 
 
+/*------------------------------------------------------------
+
+FUNCTION DeleteConj (r, conj, numConj)
+
+PARAMETER DESCRIPTION:
+    r       → open relation.
+    conj    → conjunction bound to its literals (ConjBind()), in rank order; left to the caller.
+    numConj → number of conjuncts.
+
+FUNCTION DESCRIPTION:
+    Body of Delete() once its predicate is built, shared with prepared statements (Execute()):
+    chooses the access path (PlanAccess()) and deletes every record satisfying the conjunction.
+
+RETURNS:
+    Number of records deleted, or NOTOK with db_err_code set.
+
+------------------------------------------------------------*/
+
+int DeleteConj(int r, Conjunct *conj, int numConj)
+{
+    AccessPlan plan;
+    int recsAffected = 0;
+
+    PlanAccess(r, conj, numConj, &plan);
+
+    int d = plan.driver[plan.method];
+    AttrCatRec *attr = conj[d].attr;
+    void *recPtr = malloc(catcache[r].relcat_rec.recLength);
+    Rid *rids = NULL;
+    int numRids = 0;
+    int useIdx = 0;
+
+    if(!recPtr)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    /* An index scan only visits the matching records */
+    useIdx = PlanFindRids(r, conj, numConj, &plan, &rids, &numRids);
+
+    int rc = useIdx == NOTOK ? NOTOK : OK;
+
+    for(int i = 0; rc == OK && useIdx && i < numRids; i++)
+    {
+        int got = GetRec(r, rids[i], recPtr);
+
+        if(got == NOTOK)
+        {
+            rc = NOTOK;
+        }
+        else if(got && ConjMatch(recPtr, conj, numConj, -1))
+        {
+            rc = DeleteRec(r, rids[i]);
+            recsAffected += rc == OK;
+        }
+    }
+
+    free(rids);
+
+    Rid recRid = INVALID_RID;
+
+    while(rc == OK && !useIdx)
+    {
+        if(FindRec(r, recRid, &recRid, recPtr, attr->type[0], attr->length, attr->offset,
+                   conj[d].valuePtr, conj[d].compOp) == NOTOK)
+        {
+            rc = NOTOK;
+            break;
+        }
+
+        if(!isValidRid(recRid))
+        {
+            break;
+        }
+
+        if(ConjMatch(recPtr, conj, numConj, d))
+        {
+            rc = DeleteRec(r, recRid);
+            recsAffected += rc == OK;
+        }
+    }
+
+    free(recPtr);
+    return rc == NOTOK ? NOTOK : recsAffected;
+}
+
+
 /*------------------------------------------------------------
 
 FUNCTION Delete (argc, argv)
@@ -24,15 +117,15 @@ PARAMETER DESCRIPTION:
     Specifications:
         argv[0] = "delete"
         argv[1] = relation name
-        argv[2] = attribute name on which condition applies
-        argv[3] = comparison operator (encoded integer)
-        argv[4] = literal value to compare
+        argv[2 + 3k] = attribute name of the k-th conjunct
+        argv[3 + 3k] = comparison operator of the k-th conjunct (encoded integer)
+        argv[4 + 3k] = literal value of the k-th conjunct
         argv[argc] = NIL
 
 FUNCTION DESCRIPTION:
     Implements delete operation. 
-    All tuples in the given relation that satisfy the comparison criterion: 
-        attribute <op> literal
+    All tuples in the given relation that satisfy the conjunction of comparisons: 
+        attribute1 <op1> literal1 AND attribute2 <op2> literal2 AND ...
     are removed from the file.  
     The operator is one of (=, !=, <, <=, >, >=), encoded as CMP_* constants.
     Incoming values are validated and converted according to the attribute catalog description.  
@@ -43,12 +136,11 @@ ALGORITHM:
     1) Verify that the database is open.
     2) Reject attempts to delete from system catalogs.
     3) Check that the named relation exists; open it.
-    4) Search for the attribute in the relation's attribute list.
-        If not found, report an error.
-    5) Validate the literal value for the attribute type. Construct a binary valuePtr for comparison.
-    6) Initialize recRid = INVALID_RID.
-    7) Repeatedly call FindRec():
-        a) Find next tuple satisfying attribute <op> literal.
+    4) Build the conjuncts with ConjBuild(): every attribute must exist (ATTRNOEXIST) and every literal be valid for its type (INVALID_VALUE).
+    5) Choose the access path with PlanAccess() (DeleteConj() does 5-7).
+    6) If it is an index scan, delete the records whose Rids PlanFindRids() returns from one index, or from the AND of several bitmap indexes (after re-checking them with the predicate kernel from PredInit()), and skip the scan.
+    7) Otherwise initialize recRid = INVALID_RID and repeatedly call FindRec():
+        a) Find next tuple satisfying the driving conjunct, and check it against the others (ConjMatch()).
         b) If no valid RID returned, stop.
         c) Call DeleteRec() on the found tuple.
         d) Increment deletion counter.
@@ -62,6 +154,7 @@ ERRORS REPORTED:
     DBNOTOPEN         – no database open
     METADATA_SECURITY – attempt to delete from relcat/attrcat
     RELNOEXIST        – relation does not exist
+    VIEW_READONLY     – the relation is a view
     ATTRNOEXIST       – attribute not found in relation schema
     INVALID_VALUE     – literal not valid for attribute type
     MEM_ALLOC_ERROR   – memory allocation failure
@@ -74,7 +167,9 @@ GLOBAL VARIABLES MODIFIED:
     Buffer pages containing affected tuples
 
 IMPLEMENTATION NOTES:
-    • delete uses FindRec() to implement conditional filtering; the entire relation is scanned in RID order.
+    • Without an index, delete uses FindRec() to implement conditional filtering; the relation is scanned in RID order,
+      skipping the pages its zone map rules out.
+    • "explain delete ..." prints the plan without deleting anything (Explain()).
     • DeleteRec() manages slotmap updates, dirty flags, and page/freemap maintenance.
     • Comparison operators are integer codes mapped to CMP_*.
     • Caller is responsible for supplying valid operator codes.
@@ -90,11 +185,6 @@ int Delete(int argc, char **argv)
     }
 
     char *relName = argv[1];
-    char *attrName = argv[2];
-    int operator = *(int *)argv[3];
-    char *value = argv[4];
-
-    int recsAffected = 0;
 
     if(strncmp(relName, RELCAT, RELNAME) == OK)
     {
@@ -110,6 +200,11 @@ int Delete(int argc, char **argv)
         return ErrorMsgs(db_err_code, print_flag);
     }
 
+    if(ViewIsReadOnly(relName))
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
     int r = OpenRel(relName);
 
     if(r == NOTOK)
@@ -122,67 +217,20 @@ int Delete(int argc, char **argv)
         return ErrorMsgs(db_err_code, print_flag);
     }
 
-    bool found = false;
-    AttrDesc *ptr = catcache[r].attrList;
-    int recSize = catcache[r].relcat_rec.recLength;
-    
-    for(;ptr;ptr=ptr->next)
+    int numConj = (argc - 2) / 3;
+    Conjunct *conj;
+
+    if(ConjBuild(r, relName, numConj, argv + 2, &conj) == NOTOK)
     {
-        if(strncmp((ptr->attr).attrName, attrName, ATTRNAME) == OK)
-        {
-            found = true;
-            Rid recRid = INVALID_RID;
-            char type = (ptr->attr).type[0];
-            int offset = (ptr->attr).offset;
-            int size = (ptr->attr).length;
-            void *recPtr = malloc(recSize);
-            void *valuePtr = malloc(size);
-
-            if(!recPtr || !valuePtr)
-            {
-                db_err_code = MEM_ALLOC_ERROR;
-                return ErrorMsgs(db_err_code, print_flag);
-            }
-
-            if(!isValidForType(type, size, value, valuePtr))
-            {
-                printf("'%s' is an INVALID literal for TYPE %s.\n", 
-                value, type == 'i' ? "INTEGER" : "FLOAT");
-                db_err_code = INVALID_VALUE;
-                return ErrorMsgs(db_err_code, print_flag);
-            }
-
-            do
-            {
-                if(FindRec(r, recRid, &recRid, recPtr, type, size, offset, valuePtr, operator) == NOTOK)
-                {
-                    return ErrorMsgs(db_err_code, print_flag);
-                }
-
-                if(!isValidRid(recRid))
-                {
-                    break;
-                }
-
-                if(DeleteRec(r, recRid) == NOTOK)
-                {
-                    return ErrorMsgs(db_err_code, print_flag);
-                }
-                recsAffected++;
-            } 
-            while(true);
-
-            free(recPtr);
-            free(valuePtr);
-            break;
-        }
+        return ErrorMsgs(db_err_code, print_flag);
     }
 
-    if(!found)
+    int recsAffected = DeleteConj(r, conj, numConj);
+
+    ConjFree(conj, numConj);
+
+    if(recsAffected == NOTOK)
     {
-        printf("Attribute '%s' NOT present in relation '%s' of the DB.\n", attrName, relName);
-        printCloseStrings(ATTRCAT_CACHE, offsetof(AttrCatRec, attrName), attrName, relName);
-        db_err_code = ATTRNOEXIST;
         return ErrorMsgs(db_err_code, print_flag);
     }
 
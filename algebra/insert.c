@@ -6,8 +6,13 @@
 #include "../include/openrel.h"
 #include "../include/helpers.h"
 #include "../include/insertrec.h"
-#include "../include/getnextrec.h"
+#include "../include/getnextpagerecs.h"
+#include "../include/getrec.h"
+#include "../include/idxmaint.h"
+#include "../include/bloom.h"
 #include "../include/unpinrel.h"
+#include "../include/insert.h"
+#include "../include/view.h"
 #include <stdio.h>
 #include <stdbool.h>
 #include <stddef.h>
@@ -40,11 +45,13 @@ FUNCTION DESCRIPTION:
         • Ensuring the target relation exists
         • Ensuring ALL attributes of the relation are supplied
         • Validating literals:
-            - integer → must pass isValidInteger(), stored via memcpy
-            - float   → must pass isValidFloat(), stored via memcpy
+            - integer → must pass isValidInteger() and fit the attribute's width
+            - float   → must pass isValidFloat(); stored as a float or, for "f8", a double
+            - date    → must be "YYYY-MM-DD"; stored as its day number
             - string  → copied up to attribute length, NULL-terminated
         • Checking for repeated attribute names
-        • Checking for duplicate tuples via full sequential scan
+        • Checking for duplicate tuples: skipped when the record fingerprint filter ("<rel>.rbloom") has never seen the tuple,
+          otherwise via a hash index probe when one exists, otherwise a full sequential scan
         • Invoking InsertRec() to place the tuple into the file.
     The relation catalog (catcache[r].attrList) supplies offsets, lengths, and type information for each attribute.
 
@@ -60,10 +67,12 @@ ALGORITHM:
     6) Check that no attribute name appears twice.
     7) Check attribute completeness:
         (#supplied attributes) == (#schema attributes)
-    8) Duplicate detection:
-        a) Scan relation using GetNextRec().
-        b) Compare ALL attributes (compareVals or direct checks).
-        c) If exact match found → reject with DUP_ROWS.
+    8) Duplicate detection (InsertTuple() does 8-10):
+        a) Refresh the relation's Bloom filters (BloomRefresh()); if the record fingerprint is definitely absent, skip b)-d).
+        b) If some attribute has a hash index, fetch only the records sharing its value (FindRidsByIndex() + GetRec());
+           otherwise scan relation a page at a time using GetNextPageRecs(), comparing records in the page buffer.
+        c) Compare ALL attributes (isSameTuple()).
+        d) If exact match found → reject with DUP_ROWS.
     9) If unique, call InsertRec() to insert the tuple.
     10) Print success if called interactively (“insert” vs “_insert”).
 
@@ -74,6 +83,7 @@ ERRORS REPORTED:
     DBNOTOPEN         – no database currently open
     METADATA_SECURITY – attempted modification of catalog tables
     RELNOEXIST        – relation does not exist
+    VIEW_READONLY     – the relation is a view
     ATTRNOEXIST       – attribute not found in schema
     INVALID_VALUE     – literal invalid for declared type
     DUP_ATTR_INSERT   – same attribute repeated in command
@@ -88,7 +98,7 @@ GLOBAL VARIABLES MODIFIED:
     catcache[]        – via InsertRec (numRecs metadata)
 
 IMPLEMENTATION NOTES:
-    - Uses isValidInteger(), isValidFloat(), isValidForType(), compareVals(), GetNextRec(), and InsertRec().
+    - Uses isValidInteger(), isValidFloat(), isValidForType(), compareVals(), GetNextPageRecs(), and InsertRec().
     - InsertRec() performs slot allocation, page writes, freemap updates, and relcat metadata increments.
     - "_insert" form suppresses user-facing print messages.
 
@@ -122,8 +132,12 @@ int Insert(int argc, char **argv)
         return ErrorMsgs(db_err_code, print_flag && flag);
     }
 
+    if(ViewIsReadOnly(relName))
+    {
+        return ErrorMsgs(db_err_code, print_flag && flag);
+    }
+
     int r = OpenRel(relName);
-    int numAttrs = catcache[r].relcat_rec.numAttrs;
 
     if(r == NOTOK)
     {
@@ -135,6 +149,7 @@ int Insert(int argc, char **argv)
         return ErrorMsgs(db_err_code, print_flag && flag);
     }
 
+    int numAttrs = catcache[r].relcat_rec.numAttrs;
     int recLength = catcache[r].relcat_rec.recLength;
     void *newRecord = calloc(recLength, 1);
 
@@ -159,41 +174,18 @@ int Insert(int argc, char **argv)
                 int offset = (ptr->attr).offset;
                 int size = (ptr->attr).length;
 
-                if(type == 'i')
-                {
-                    /* Check if the value string is a valid integer literal 
-                    (may have negatives)*/
-                    /* If so, then set *(int *)(newRecordPtr + offset) = atoi(value) */
-                    /* Else set the db_err_code global variable to INVALID_VALUE
-                    and return ErrorMsgs(db_err_code, INVALID_VALUE) */
-                    if(!isValidInteger(value))
-                    {
-                        db_err_code = INVALID_VALUE;
-                        free(newRecord);
-                        printf("'%s' is NOT a valid INTEGER literal.\n", value);
-                        return ErrorMsgs(INVALID_VALUE, print_flag && flag);
-                    }
-
-                    int intval = atoi(value);
-                    memcpy((char *)newRecord + offset, &intval, sizeof(int));
-                }
-                else if(type == 'f')
+                if(type == 'i' || type == 'f' || type == 'd')
                 {
-                    /* Check if the value string is a valid floating point literal 
-                    (may have negatives)*/
-                    /* If so, then set *(float *)(newRecordPtr + offset) = atof(value) (or parse it as float of 4 bytes) */
+                    /* Convert the literal to the attribute's type and width (isValidForType()) */
                     /* Else set the db_err_code global variable to INVALID_VALUE
                     and return ErrorMsgs(db_err_code, INVALID_VALUE) */
-                    if(!isValidFloat(value))
+                    if(!isValidForType(type, size, value, (char *)newRecord + offset))
                     {
                         db_err_code = INVALID_VALUE;
                         free(newRecord);
-                        printf("'%s' is NOT a valid FLOAT literal.\n", value);
+                        printf("'%s' is NOT a valid %s literal.\n", value, typeName(type));
                         return ErrorMsgs(INVALID_VALUE, print_flag && flag);
                     }
-
-                    float fval = atof(value);
-                    memcpy((char *)newRecord + offset, &fval, sizeof(float));
                 }
                 else if(type == 's')
                 {
@@ -239,78 +231,127 @@ int Insert(int argc, char **argv)
         return ErrorMsgs(ATTR_SET_INVALID, print_flag);
     }
 
+    int rc = InsertTuple(r, newRecord, flag);
+
+    free(newRecord);
+    return rc;
+}
+
+/*------------------------------------------------------------
+
+FUNCTION InsertTuple (r, newRecord, flag)
+
+PARAMETER DESCRIPTION:
+    r         → open relation, pinned by the caller; unpinned once the record is inserted.
+    newRecord → complete record to insert; left to the caller.
+    flag      → true for "insert", false for "_insert", which prints nothing.
+
+FUNCTION DESCRIPTION:
+    Steps 8-10 of Insert(), shared with prepared statements (Execute()): rejects a duplicate of a record
+    already in r, then inserts newRecord.
+
+RETURNS:
+    OK, or the result of ErrorMsgs().
+
+------------------------------------------------------------*/
+
+int InsertTuple(int r, void *newRecord, bool flag)
+{
+    char *relName = catcache[r].relcat_rec.relName;
+    int recLength = catcache[r].relcat_rec.recLength;
+
     /*We need to check for duplicate tuples also*/
-    Rid recId = INVALID_RID;
     void *recPtr = malloc(recLength);
-    do
+
+    if(!recPtr)
     {
-        if(GetNextRec(r, recId, &recId, recPtr) == NOTOK)
-        {
-            return ErrorMsgs(db_err_code, print_flag);
-        }
+        db_err_code = MEM_ALLOC_ERROR;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    /* A record whose fingerprint the relation's Bloom filter has never seen cannot be a duplicate */
+    char rbloomName[RELNAME + 8];
+    build_rbloom_filename(relName, rbloomName, sizeof(rbloomName));
+
+    int mayExist = BloomRefresh(r) == NOTOK ? NOTOK : BloomMayContain(rbloomName, BloomHashRecord(r, newRecord));
+
+    if(mayExist == NOTOK)
+    {
+        free(recPtr);
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    /* A duplicate must agree on every attribute, so an equality probe on any
+       hash-indexed attribute yields every possible duplicate */
+    Rid *rids = NULL;
+    int numRids = 0;
+    int useIdx = 0;
 
-        if(!isValidRid(recId))
+    for(AttrDesc *ptr = catcache[r].attrList; mayExist && ptr; ptr = ptr->next)
+    {
+        if((ptr->attr).hasIndex & IDX_HASH)
         {
+            useIdx = FindRidsByIndex(r, &(ptr->attr), (char *)newRecord + (ptr->attr).offset, CMP_EQ, &rids, &numRids);
             break;
         }
+    }
 
-        AttrDesc *ptr = catcache[r].attrList;
-        bool matchingTupleFound = true;
+    if(useIdx == NOTOK)
+    {
+        free(recPtr);
+        return ErrorMsgs(db_err_code, print_flag);
+    }
 
-        for(;ptr;ptr=ptr->next)
+    if(useIdx)
+    {
+        for(int i = 0; i < numRids; i++)
         {
-            char type = (ptr->attr).type[0];
-            int offset = (ptr->attr).offset;
-            int size = (ptr->attr).length;
+            int rc = GetRec(r, rids[i], recPtr);
 
-            if(type == 'i')
+            if(rc == NOTOK)
             {
-                /* Compare *(int *)((char *)recPtr + offset) and 
-                *(int *)((char *)recPtr + offset) 
-                as integers */
-                /*If they are NOT equal, then set matchingTupleFound as false*/
-                if(*(int *)((char *)recPtr + offset) != *(int *)((char *)newRecord + offset))
-                {
-                    matchingTupleFound = false;
-                    break;
-                }   
+                free(rids);
+                free(recPtr);
+                return ErrorMsgs(db_err_code, print_flag);
             }
-            else if(type == 'f')
+
+            if(rc && isSameTuple(r, recPtr, newRecord))
             {
-                /* Compare *(float *)((char *)recPtr + offset) and 
-                *(float *)((char *)recPtr + offset) 
-                as integers */
-                /*If they are NOT equal, then set matchingTupleFound as false*/
-                float f1 = *(float *)((char *)recPtr + offset);
-                float f2 = *(float *)((char *)newRecord + offset);
-                float diff = f1 - f2;
-                if(!compareVals(&f1, &f2, 'f', sizeof(float), CMP_EQ))
-                {
-                    matchingTupleFound = false;
-                }
+                free(rids);
+                db_err_code = DUP_ROWS;
+                free(recPtr);
+                return ErrorMsgs(db_err_code, print_flag && flag);
+            }
+        }
+
+        free(rids);
+    }
+    else if(mayExist)
+    {
+        short pid = 0;
+        char *recs[MAX_RECS_PER_PG];
+        int numRecs;
+
+        do
+        {
+            if(GetNextPageRecs(r, &pid, NULL, recs, &numRecs) == NOTOK)
+            {
+                free(recPtr);
+                return ErrorMsgs(db_err_code, print_flag);
             }
-            else if(type == 's')
+
+            for(int i = 0; i < numRecs; i++)
             {
-                /* Compare ((char *)recPtr + offset) and ((char *)recPtr + offset) 
-                as size length strings*/
-                /* If NOT equal, then set matchingTupleFound = false */
-                char *s1 = (char *)recPtr + offset;
-                char *s2 = (char *)newRecord + offset;
-                if(!compareVals(s1, s2, 's', size, CMP_EQ))
+                if(isSameTuple(r, recs[i], newRecord))
                 {
-                    matchingTupleFound = false;
-                    break;
+                    db_err_code = DUP_ROWS;
+                    free(recPtr);
+                    return ErrorMsgs(db_err_code, print_flag && flag);
                 }
             }
-        }
-
-        if(matchingTupleFound)
-        {
-            db_err_code = DUP_ROWS;
-            return ErrorMsgs(db_err_code, print_flag && flag);
-        }
-    } 
-    while(1);
+        } 
+        while(numRecs > 0);
+    }
     
     /* Free the sequential search record pointer */
     free(recPtr);
@@ -320,13 +361,11 @@ int Insert(int argc, char **argv)
     {
         if(flag)
         printf("Inserted record successfully into %s\n", relName);
-        free(newRecord);
         UnPinRel(r);
         return OK;
     }
     else
     {
-        free(newRecord);
         db_err_code = REC_INS_ERR;
         UnPinRel(r);
         return ErrorMsgs(db_err_code, print_flag && flag);
@@ -0,0 +1,1371 @@
+/************************INCLUDES*******************************/
+
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/helpers.h"
+#include "../include/openrel.h"
+#include "../include/getnextpagerecs.h"
+#include "../include/insertrec.h"
+#include "../include/createfromattrlist.h"
+#include "../include/unpinrel.h"
+#include "../include/predicate.h"
+#include "../include/bloom.h"
+#include "../include/join.h"
+#include "../include/iterator.h"
+#include "../include/view.h"
+#include "../include/pagelayout.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * Pipelined operators.
+ *
+ * Every operator is an Iter passing column batches of up to BATCH_SIZE rows (include/iterator.h),
+ * so a query over views (algebra/view.c) reads its base relations once and writes nothing until
+ * IterMaterialize() inserts the final records, or Print() formats them as they arrive.
+ *
+ * A scan decodes heap pages into columns once per batch; filters then refine the selection vector
+ * with the column kernels of PredEvalSel(), projections pick columns without copying them, and the
+ * join hashes a batch of probe keys at a time.  IterNext() turns batches back into records.
+ */
+
+/* Sequential scan of a heap relation */
+typedef struct scanstate
+{
+    short pid;                  // next page to read
+    int recsPerPg;              // most records a page may hold
+    int pax;                    // the relation has PAX pages
+    int *srcOffsets;            // offset in the relation's records of every attribute read
+    int done;                   // the relation is exhausted
+    Batch batch;                // columns decoded from the pages read last
+} ScanState;
+
+/* Conjunction of "attr op literal" over the child's rows */
+typedef struct filterstate
+{
+    Iter *child;
+    int numConj;
+    Pred *preds;                // compiled for a column (attribute offset 0)
+    int *cols;                  // column tested by every conjunct
+    char **values;              // literals converted to the attribute type; preds point into them
+    Batch batch;                // the child's columns, with the rows that pass
+} FilterState;
+
+/* Projection with duplicate elimination */
+typedef struct projectstate
+{
+    Iter *child;
+    int *srcCols;               // column of the child of every projected attribute
+    unsigned long long hashes[BATCH_SIZE]; // of the selected rows of the batch being projected
+    char *recs;                 // distinct records returned so far, in order
+    unsigned long long *entHashes; // hash of every distinct record
+    long numEnts, capEnts;
+    long *slots;                // open addressing, entry index or -1
+    long numSlots;              // power of two
+    Batch batch;                // the projected columns of the child, with the new rows
+} ProjectState;
+
+/* Hash equi-join: the right input is loaded into a hash table, then probed with the left batches in order */
+typedef struct joinstate
+{
+    Iter *left, *right;
+    char type;                  // type of the join attributes
+    int col1;                   // left join column
+    int len1;                   // and its length
+    int o2, cmpSize;            // right join attribute offset, compared length
+    int numRight;               // attributes of the right record copied to the result
+    int *rightOffsets;          // their offsets in the right record
+    int *rightLens;             // and lengths
+    int built;                  // the right input is in the table
+    char *rows;                 // right records, in order
+    long numRows, capRows;
+    unsigned long long *rowHashes;
+    long *heads;                // first record of every bucket, or -1
+    long *chain;                // next record of the same bucket, in order, or -1
+    long numBuckets;            // power of two; 0 when the right input is empty
+    Batch *probe;               // left batch being probed, or NULL
+    int probePos;               // entry of probe->sel being probed
+    long cand;                  // next right record to compare with it, or -1 for the next entry
+    int drained;                // the pairs gathered use the last rows of probe
+    int done;                   // the left input is exhausted
+    unsigned long long hashes[BATCH_SIZE]; // of the join keys of probe's selected rows
+    long leftRows[BATCH_SIZE], rightRows[BATCH_SIZE]; // matches gathered into batch
+    Batch batch;                // the joined rows
+} JoinState;
+
+
+/*------------------------------------------------------------
+
+FUNCTION iterAlloc (name, stateSize)
+
+FUNCTION DESCRIPTION:
+    Allocates a zeroed Iter with a zeroed state of stateSize bytes.
+
+RETURNS:
+    The iterator, or NULL (db_err_code = MEM_ALLOC_ERROR).
+
+------------------------------------------------------------*/
+
+static Iter *iterAlloc(const char *name, size_t stateSize)
+{
+    Iter *it = calloc(1, sizeof(Iter));
+    void *state = calloc(1, stateSize);
+
+    if(!it || !state)
+    {
+        free(it);
+        free(state);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NULL;
+    }
+
+    strncpy(it->name, name, RELNAME - 1);
+    it->state = state;
+    return it;
+}
+
+static void iterFree(Iter *it)
+{
+    free(it->rec);
+    free(it->state);
+    free(it);
+}
+
+
+/* Attribute attrName of an iterator's schema, or NULL; *col receives its column */
+static AttrDesc *iterAttr(Iter *it, const char *attrName, int *col)
+{
+    int k = 0;
+
+    for(AttrDesc *p = it->attrList; p; p = p->next, k++)
+    {
+        if(strncmp(p->attr.attrName, attrName, ATTRNAME) == OK)
+        {
+            if(col)
+                *col = k;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+static void attrNotFound(Iter *it, const char *attrName)
+{
+    printf("Attribute '%s' NOT present in relation '%s' of the DB.\n", attrName, it->name);
+    if(!ViewFind(it->name))
+        printCloseStrings(ATTRCAT_CACHE, offsetof(AttrCatRec, attrName), (char *)attrName, it->name);
+    db_err_code = ATTRNOEXIST;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION column helpers (batchAllocCols, batchFreeCols, decodeColumn, gatherColumn, hashColumn)
+
+FUNCTION DESCRIPTION:
+    batchAllocCols() gives a batch a vector of BATCH_SIZE values for every attribute of attrList;
+    batchFreeCols() releases them.
+    decodeColumn() copies one attribute of numRecs records into a column; gatherColumn() copies
+    the values idx[0 .. n-1] of src, stride bytes apart, into a column.  Both have a plain int
+    loop for 4-byte values.
+    hashColumn() mixes the first len bytes of the values, stride bytes apart, of one column for the rows of sel
+    into h (one entry per row of sel); floats are left out because they compare with a tolerance, and strings stop at their NUL as
+    in compareVals().
+
+------------------------------------------------------------*/
+
+static int batchAllocCols(Batch *b, AttrDesc *attrList, int numAttrs)
+{
+    int k = 0;
+
+    if(!(b->cols = calloc(numAttrs, sizeof(char *))))
+        return NOTOK;
+
+    for(AttrDesc *p = attrList; p; p = p->next, k++)
+    {
+        if(!(b->cols[k] = malloc((size_t)BATCH_SIZE * p->attr.length)))
+            return NOTOK;
+    }
+    return OK;
+}
+
+static void batchFreeCols(Batch *b, int numAttrs)
+{
+    for(int k = 0; b->cols && k < numAttrs; k++)
+        free(b->cols[k]);
+    free(b->cols);
+    b->cols = NULL;
+}
+
+static void decodeColumn(char *dst, int len, char **recs, int numRecs, int offset)
+{
+    if(len == sizeof(int))
+    {
+        int *d = (int *)dst;
+
+        for(int i = 0; i < numRecs; i++)
+            memcpy(&d[i], recs[i] + offset, sizeof(int));
+        return;
+    }
+
+    for(int i = 0; i < numRecs; i++)
+        memcpy(dst + i * len, recs[i] + offset, len);
+}
+
+static void gatherColumn(char *dst, int len, const char *src, long stride, const long *idx, int n)
+{
+    if(len == sizeof(int))
+    {
+        int *d = (int *)dst;
+
+        for(int i = 0; i < n; i++)
+            memcpy(&d[i], src + idx[i] * stride, sizeof(int));
+        return;
+    }
+
+    for(int i = 0; i < n; i++)
+        memcpy(dst + i * len, src + idx[i] * stride, len);
+}
+
+static void hashColumn(unsigned long long *h, char type, int len, int stride, const char *col, const short *sel, int numSel)
+{
+    if(type == 'f')
+        return;
+
+    for(int k = 0; k < numSel; k++)
+        h[k] = h[k] * 0x100000001b3ULL ^ BloomHashValue(type, len, col + sel[k] * stride);
+}
+
+/* Copies row of b into the record rec laid out by it->attrList */
+static void batchGather(Iter *it, Batch *b, int row, char *rec)
+{
+    int k = 0;
+
+    for(AttrDesc *p = it->attrList; p; p = p->next, k++)
+        memcpy(rec + p->attr.offset, b->cols[k] + row * p->attr.length, p->attr.length);
+}
+
+/* Selects rows 0 .. numRows-1 */
+static void batchSelectAll(Batch *b)
+{
+    for(int i = 0; i < b->numRows; i++)
+        b->sel[i] = i;
+    b->numSel = b->numRows;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ScanIterOpen (relName) / ScanIterOpenCols (relName, numAttrs, attrNames)
+
+PARAMETER DESCRIPTION:
+    relName   → heap relation to read.
+    numAttrs  → number of names in attrNames.
+    attrNames → attributes to read, or NULL for all; names the relation does not have are ignored.
+
+FUNCTION DESCRIPTION:
+    Iterator over the records of a heap relation in page and slot order, the order of GetNextRec().
+    ScanIterOpen() reads every attribute; ScanIterOpenCols() only the named ones, in relation order with
+    packed offsets, so that a consumer of a few columns decodes only those.
+
+ALGORITHM:
+    While a whole page still fits in the batch, read the next non-empty page with GetNextPageRecs()
+    and append the values of each attribute read to its column:
+        • row pages: from every record returned;
+        • PAX pages: from the attribute's minipage, with one copy when every slot of the page is occupied.
+
+IMPLEMENTATION NOTES:
+    • The relation is looked up with OpenRel() for every page, so it may leave the cache between pages.
+    • Pages are decoded once; a self-join reads both of its inputs through the one buffer of the relation.
+
+ERRORS REPORTED:
+    RELNOEXIST (with the usual message), MEM_ALLOC_ERROR, errors of OpenRel()
+
+------------------------------------------------------------*/
+
+/* Appends the attributes read of the page just returned by GetNextPageRecs() to the batch */
+static void scanDecodePage(Iter *it, int r, char **recs, Rid *rids, int numRecs)
+{
+    ScanState *st = it->state;
+    Batch *b = &st->batch;
+    const CacheEntry *entry = &catcache[r];
+    int k = 0;
+
+    for(AttrDesc *p = it->attrList; p; p = p->next, k++)
+    {
+        int len = p->attr.length;
+        char *dst = b->cols[k] + b->numRows * len;
+
+        if(!st->pax)
+        {
+            decodeColumn(dst, len, recs, numRecs, st->srcOffsets[k]);
+            continue;
+        }
+
+        const AttrDesc *src = PageAttrAt(entry, st->srcOffsets[k]);
+        const char *minipage = buffer[r].page + PageAttrPos(entry, 0, src);
+
+        if(src->dict)
+        {
+            for(int i = 0; i < numRecs; i++)
+                PageGetValue(src, minipage + rids[i].slotnum * src->pageLength, dst + i * len);
+            continue;
+        }
+
+        if(numRecs == entry->relcat_rec.recsPerPg)
+        {
+            memcpy(dst, minipage, numRecs * len);
+            continue;
+        }
+
+        for(int i = 0; i < numRecs; i++)
+            memcpy(dst + i * len, minipage + rids[i].slotnum * len, len);
+    }
+}
+
+static int scanNextBatch(Iter *it, Batch **batch)
+{
+    ScanState *st = it->state;
+    Batch *b = &st->batch;
+
+    b->numRows = 0;
+
+    while(!st->done && BATCH_SIZE - b->numRows >= st->recsPerPg)
+    {
+        char *recs[MAX_RECS_PER_PG];
+        Rid rids[MAX_RECS_PER_PG];
+        int numRecs;
+        int r = OpenRel(it->name);
+
+        if(r == NOTOK || GetNextPageRecs(r, &st->pid, st->pax ? rids : NULL, st->pax ? NULL : recs, &numRecs) == NOTOK)
+            return NOTOK;
+
+        if(numRecs == 0)
+        {
+            st->done = 1;
+            break;
+        }
+
+        scanDecodePage(it, r, recs, rids, numRecs);
+        b->numRows += numRecs;
+    }
+
+    if(b->numRows == 0)
+        return 0;
+
+    batchSelectAll(b);
+    *batch = b;
+    return 1;
+}
+
+static int scanRewind(Iter *it)
+{
+    ScanState *st = it->state;
+
+    st->pid = 0;
+    st->done = 0;
+    return OK;
+}
+
+static void scanClose(Iter *it)
+{
+    ScanState *st = it->state;
+    int r = FindRelNum(it->name);
+
+    if(r != NOTOK)
+        UnPinRel(r);
+
+    batchFreeCols(&st->batch, it->numAttrs);
+    if(it->attrList)
+        FreeLinkedList((void **)&it->attrList, offsetof(AttrDesc, next));
+    free(st->srcOffsets);
+    iterFree(it);
+}
+
+Iter *ScanIterOpenCols(const char *relName, int numAttrs, char **attrNames)
+{
+    int r = OpenRel((char *)relName);
+
+    if(r == NOTOK)
+    {
+        if(db_err_code == RELNOEXIST)
+        {
+            printf("Relation '%s' does NOT exist in the DB.\n", relName);
+            printCloseStrings(RELCAT_CACHE, offsetof(RelCatRec, relName), (char *)relName, NULL);
+        }
+        return NULL;
+    }
+
+    Iter *it = iterAlloc(relName, sizeof(ScanState));
+
+    if(!it)
+        return NULL;
+
+    ScanState *st = it->state;
+    AttrDesc *tail = NULL;
+    int ok = 1;
+
+    it->nextBatch = scanNextBatch;
+    it->rewind = scanRewind;
+    it->close = scanClose;
+    st->recsPerPg = MIN(catcache[r].relcat_rec.recsPerPg, MAX_RECS_PER_PG);
+    st->pax = catcache[r].relcat_rec.layout == LAYOUT_PAX;
+    st->srcOffsets = malloc(catcache[r].relcat_rec.numAttrs * sizeof(int));
+
+    for(AttrDesc *p = catcache[r].attrList; st->srcOffsets && p; p = p->next)
+    {
+        int wanted = !attrNames;
+
+        for(int k = 0; !wanted && k < numAttrs; k++)
+            wanted = strncmp(p->attr.attrName, attrNames[k], ATTRNAME) == OK;
+
+        if(!wanted)
+            continue;
+
+        AttrDesc *node = malloc(sizeof(AttrDesc));
+
+        if(!node)
+        {
+            ok = 0;
+            break;
+        }
+
+        node->attr = p->attr;
+        node->attr.offset = it->recSize;
+        node->next = NULL;
+        if(tail)
+            tail->next = node;
+        else
+            it->attrList = node;
+        tail = node;
+
+        st->srcOffsets[it->numAttrs++] = p->attr.offset;
+        it->recSize += p->attr.length;
+    }
+
+    if(!ok || !st->srcOffsets || batchAllocCols(&st->batch, it->attrList, it->numAttrs) == NOTOK)
+    {
+        scanClose(it);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NULL;
+    }
+
+    return it;
+}
+
+Iter *ScanIterOpen(const char *relName)
+{
+    return ScanIterOpenCols(relName, 0, NULL);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION FilterIterOpen (child, numConj, conj)
+
+PARAMETER DESCRIPTION:
+    child   → input; owned by the filter from here on, and closed if the filter cannot be opened.
+    numConj → number of conjuncts.
+    conj    → numConj triples (attribute name, int-encoded CMP_* code, literal), laid out as in Select()'s argv.
+
+FUNCTION DESCRIPTION:
+    Returns the rows of child satisfying every conjunct, each compiled once into a Pred over its column.
+    The schema is the child's.
+
+ALGORITHM:
+    For every batch of the child, narrow its selection vector with PredEvalSel(), one conjunct at a time,
+    and skip the batch if no row is left.
+
+ERRORS REPORTED:
+    ATTRNOEXIST, INVALID_VALUE (with Select()'s messages), MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+static int filterNextBatch(Iter *it, Batch **batch)
+{
+    FilterState *st = it->state;
+    Batch *in, *out = &st->batch;
+    int rc;
+
+    while((rc = IterNextBatch(st->child, &in)) == 1)
+    {
+        const short *sel = in->sel;
+
+        out->numRows = in->numRows;
+        out->numSel = in->numSel;
+        out->cols = in->cols;
+
+        for(int k = 0; k < st->numConj && out->numSel > 0; k++)
+        {
+            out->numSel = PredEvalSel(&st->preds[k], in->cols[st->cols[k]], in->numRows, sel, out->numSel, out->sel);
+            sel = out->sel;
+        }
+
+        if(st->numConj == 0)
+            memcpy(out->sel, in->sel, in->numSel * sizeof(short));
+
+        if(out->numSel > 0)
+        {
+            *batch = out;
+            return 1;
+        }
+    }
+    return rc;
+}
+
+static int filterRewind(Iter *it)
+{
+    return IterRewind(((FilterState *)it->state)->child);
+}
+
+static void filterClose(Iter *it)
+{
+    FilterState *st = it->state;
+
+    IterClose(st->child);
+    for(int k = 0; st->values && k < st->numConj; k++)
+        free(st->values[k]);
+    free(st->values);
+    free(st->preds);
+    free(st->cols);
+    iterFree(it);
+}
+
+Iter *FilterIterOpen(Iter *child, int numConj, char **conj)
+{
+    Iter *it = iterAlloc(child->name, sizeof(FilterState));
+
+    if(!it)
+    {
+        IterClose(child);
+        return NULL;
+    }
+
+    FilterState *st = it->state;
+
+    it->nextBatch = filterNextBatch;
+    it->rewind = filterRewind;
+    it->close = filterClose;
+    it->attrList = child->attrList;
+    it->numAttrs = child->numAttrs;
+    it->recSize = child->recSize;
+    st->child = child;
+    st->numConj = numConj;
+    st->preds = calloc(numConj, sizeof(Pred));
+    st->cols = calloc(numConj, sizeof(int));
+    st->values = calloc(numConj, sizeof(char *));
+
+    if(!st->preds || !st->cols || !st->values)
+    {
+        filterClose(it);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NULL;
+    }
+
+    for(int k = 0; k < numConj; k++)
+    {
+        char *attrName = conj[3 * k];
+        char *value = conj[3 * k + 2];
+        AttrDesc *a = iterAttr(child, attrName, &st->cols[k]);
+
+        if(!a)
+        {
+            attrNotFound(child, attrName);
+            filterClose(it);
+            return NULL;
+        }
+
+        char type = a->attr.type[0];
+        st->values[k] = malloc(a->attr.length);
+
+        if(!st->values[k])
+        {
+            filterClose(it);
+            db_err_code = MEM_ALLOC_ERROR;
+            return NULL;
+        }
+
+        if(!isValidForType(type, a->attr.length, value, st->values[k]))
+        {
+            printf("'%s' is an INVALID literal for TYPE %s.\n", value, typeName(type));
+            filterClose(it);
+            db_err_code = INVALID_VALUE;
+            return NULL;
+        }
+
+        PredInit(&st->preds[k], type, a->attr.length, 0, st->values[k], *(int *)conj[3 * k + 1]);
+    }
+
+    return it;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION projection table helpers (projFind, projAdd)
+
+FUNCTION DESCRIPTION:
+    Distinct projected records, kept in arrival order in an open-addressing table keyed on the hashColumn()
+    mix of their attributes (which leaves floats out), with isSameTupleAttrs() deciding equality: the duplicates Project() drops
+    through Insert() are dropped here as well.
+    projFind() tells whether rec was already returned; projAdd() appends it, doubling the slots when half full.
+
+------------------------------------------------------------*/
+
+static bool projFind(Iter *it, unsigned long long h, char *rec)
+{
+    ProjectState *st = it->state;
+
+    if(st->numSlots == 0)
+        return false;
+
+    for(long s = h & (st->numSlots - 1);; s = (s + 1) & (st->numSlots - 1))
+    {
+        long e = st->slots[s];
+
+        if(e < 0)
+            return false;
+        if(st->entHashes[e] == h && isSameTupleAttrs(it->attrList, st->recs + e * it->recSize, rec))
+            return true;
+    }
+}
+
+static int projAdd(Iter *it, unsigned long long h, char *rec)
+{
+    ProjectState *st = it->state;
+
+    if(st->numEnts == st->capEnts)
+    {
+        long cap = st->capEnts ? 2 * st->capEnts : 256;
+        char *recs = realloc(st->recs, cap * it->recSize);
+        if(recs)
+            st->recs = recs;
+        unsigned long long *hashes = realloc(st->entHashes, cap * sizeof(unsigned long long));
+        if(hashes)
+            st->entHashes = hashes;
+
+        if(!recs || !hashes)
+        {
+            db_err_code = MEM_ALLOC_ERROR;
+            return NOTOK;
+        }
+        st->capEnts = cap;
+    }
+
+    if(2 * (st->numEnts + 1) > st->numSlots)
+    {
+        long n = st->numSlots ? 2 * st->numSlots : 512;
+        long *slots = malloc(n * sizeof(long));
+
+        if(!slots)
+        {
+            db_err_code = MEM_ALLOC_ERROR;
+            return NOTOK;
+        }
+
+        for(long s = 0; s < n; s++)
+            slots[s] = -1;
+        for(long e = 0; e < st->numEnts; e++)
+        {
+            long s = st->entHashes[e] & (n - 1);
+            while(slots[s] >= 0)
+                s = (s + 1) & (n - 1);
+            slots[s] = e;
+        }
+
+        free(st->slots);
+        st->slots = slots;
+        st->numSlots = n;
+    }
+
+    long e = st->numEnts++;
+    memcpy(st->recs + e * it->recSize, rec, it->recSize);
+    st->entHashes[e] = h;
+
+    long s = h & (st->numSlots - 1);
+    while(st->slots[s] >= 0)
+        s = (s + 1) & (st->numSlots - 1);
+    st->slots[s] = e;
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ProjectIterOpen (child, numAttrs, attrNames)
+
+PARAMETER DESCRIPTION:
+    child     → input; owned by the projection from here on, and closed if the projection cannot be opened.
+    numAttrs  → number of attributes kept.
+    attrNames → their names, in result order.
+
+FUNCTION DESCRIPTION:
+    Returns the distinct projections of the child's rows, in the order they first occur.
+    The schema holds the listed attributes with packed offsets, as CreateFromAttrList() lays them out.
+
+ALGORITHM:
+    For every batch of the child:
+    1) Point the output columns at the child's columns of the kept attributes.
+    2) Hash the selected rows a column at a time.
+    3) Keep in the selection vector the rows whose projection is not in the table yet, adding them.
+
+IMPLEMENTATION NOTES:
+    • Values are copied bit for bit; Project() into a relation goes through Insert(), which keeps two decimals of a float.
+
+ERRORS REPORTED:
+    ATTRNOEXIST, DUP_ATTR, MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+static int projectNextBatch(Iter *it, Batch **batch)
+{
+    ProjectState *st = it->state;
+    Batch *in, *out = &st->batch;
+    int rc;
+
+    while((rc = IterNextBatch(st->child, &in)) == 1)
+    {
+        int k = 0;
+
+        out->numRows = in->numRows;
+        memset(st->hashes, 0, in->numSel * sizeof(unsigned long long));
+
+        for(AttrDesc *p = it->attrList; p; p = p->next, k++)
+        {
+            out->cols[k] = in->cols[st->srcCols[k]];
+            hashColumn(st->hashes, p->attr.type[0], p->attr.length, p->attr.length, out->cols[k], in->sel, in->numSel);
+        }
+
+        out->numSel = 0;
+
+        for(int j = 0; j < in->numSel; j++)
+        {
+            batchGather(it, out, in->sel[j], it->rec);
+
+            if(projFind(it, st->hashes[j], it->rec))
+                continue;
+
+            if(projAdd(it, st->hashes[j], it->rec) == NOTOK)
+                return NOTOK;
+
+            out->sel[out->numSel++] = in->sel[j];
+        }
+
+        if(out->numSel > 0)
+        {
+            *batch = out;
+            return 1;
+        }
+    }
+    return rc;
+}
+
+static int projectRewind(Iter *it)
+{
+    ProjectState *st = it->state;
+
+    st->numEnts = 0;
+    for(long s = 0; s < st->numSlots; s++)
+        st->slots[s] = -1;
+    return IterRewind(st->child);
+}
+
+static void projectClose(Iter *it)
+{
+    ProjectState *st = it->state;
+
+    IterClose(st->child);
+    if(it->attrList)
+        FreeLinkedList((void **)&it->attrList, offsetof(AttrDesc, next));
+    free(st->batch.cols);
+    free(st->srcCols);
+    free(st->recs);
+    free(st->entHashes);
+    free(st->slots);
+    iterFree(it);
+}
+
+Iter *ProjectIterOpen(Iter *child, int numAttrs, char **attrNames)
+{
+    Iter *it = iterAlloc(child->name, sizeof(ProjectState));
+
+    if(!it)
+    {
+        IterClose(child);
+        return NULL;
+    }
+
+    ProjectState *st = it->state;
+    AttrDesc *tail = NULL;
+
+    it->nextBatch = projectNextBatch;
+    it->rewind = projectRewind;
+    it->close = projectClose;
+    st->child = child;
+    st->srcCols = malloc(numAttrs * sizeof(int));
+    st->batch.cols = calloc(numAttrs, sizeof(char *));
+
+    if(!st->srcCols || !st->batch.cols)
+    {
+        projectClose(it);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NULL;
+    }
+
+    for(int k = 0; k < numAttrs; k++)
+    {
+        AttrDesc *a = iterAttr(child, attrNames[k], &st->srcCols[k]);
+
+        if(!a)
+        {
+            attrNotFound(child, attrNames[k]);
+            projectClose(it);
+            return NULL;
+        }
+
+        if(iterAttr(it, attrNames[k], NULL))
+        {
+            printf("Attribute name '%s' has been duplicated.\n", attrNames[k]);
+            projectClose(it);
+            db_err_code = DUP_ATTR;
+            return NULL;
+        }
+
+        AttrDesc *node = malloc(sizeof(AttrDesc));
+
+        if(!node)
+        {
+            projectClose(it);
+            db_err_code = MEM_ALLOC_ERROR;
+            return NULL;
+        }
+
+        node->attr = a->attr;
+        node->attr.offset = it->recSize;
+        node->next = NULL;
+        if(tail)
+            tail->next = node;
+        else
+            it->attrList = node;
+        tail = node;
+
+        it->numAttrs++;
+        it->recSize += a->attr.length;
+    }
+
+    it->rec = calloc(1, it->recSize);
+
+    if(!it->rec)
+    {
+        projectClose(it);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NULL;
+    }
+
+    return it;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION joinBuild (it)
+
+FUNCTION DESCRIPTION:
+    Reads the whole right input of a join into a chained hash table on its join attribute.
+    Chains list the records in input order, so probing returns matches in the order of the nested loop.
+
+RETURNS:
+    OK, or NOTOK (db_err_code set).
+
+------------------------------------------------------------*/
+
+static int joinBuild(Iter *it)
+{
+    JoinState *st = it->state;
+    Iter *right = st->right;
+    Batch *b;
+    int rc;
+
+    while((rc = IterNextBatch(right, &b)) == 1)
+    {
+        if(st->numRows + b->numSel > st->capRows)
+        {
+            long cap = st->capRows ? 2 * st->capRows : 4 * BATCH_SIZE;
+            while(cap < st->numRows + b->numSel)
+                cap *= 2;
+
+            char *rows = realloc(st->rows, cap * right->recSize);
+            if(rows)
+                st->rows = rows;
+            unsigned long long *hashes = realloc(st->rowHashes, cap * sizeof(unsigned long long));
+            if(hashes)
+                st->rowHashes = hashes;
+
+            if(!rows || !hashes)
+            {
+                db_err_code = MEM_ALLOC_ERROR;
+                return NOTOK;
+            }
+            st->capRows = cap;
+        }
+
+        for(int j = 0; j < b->numSel; j++)
+        {
+            char *row = st->rows + (st->numRows + j) * right->recSize;
+
+            batchGather(right, b, b->sel[j], row);
+            st->rowHashes[st->numRows + j] = st->type == 'f' ? 0 : BloomHashValue(st->type, st->cmpSize, row + st->o2);
+        }
+        st->numRows += b->numSel;
+    }
+
+    if(rc == NOTOK)
+        return NOTOK;
+
+    st->built = 1;
+
+    if(st->numRows == 0)
+        return OK;
+
+    st->numBuckets = 1;
+    while(st->numBuckets < st->numRows)
+        st->numBuckets *= 2;
+
+    st->heads = malloc(st->numBuckets * sizeof(long));
+    st->chain = malloc(st->numRows * sizeof(long));
+
+    if(!st->heads || !st->chain)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    for(long h = 0; h < st->numBuckets; h++)
+        st->heads[h] = -1;
+
+    for(long e = st->numRows - 1; e >= 0; e--)
+    {
+        long h = st->rowHashes[e] & (st->numBuckets - 1);
+
+        st->chain[e] = st->heads[h];
+        st->heads[h] = e;
+    }
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION JoinIterOpen (left, attrName1, right, attrName2)
+
+PARAMETER DESCRIPTION:
+    left, right → inputs; owned by the join from here on, and closed if the join cannot be opened.
+    attrName1   → join attribute of left.
+    attrName2   → join attribute of right.
+
+FUNCTION DESCRIPTION:
+    Equi-join of left and right, in the order of Join(): for every left row, the matching right rows in their order.
+    The schema is JoinAttrList()'s: the left attributes, then the right ones but the join attribute, renamed on collision.
+
+ALGORITHM:
+    1) On the first call, load the right input into the hash table (joinBuild()).
+    2) For every left batch, hash the join keys of all its selected rows.
+    3) Walk the bucket of each row in turn, comparing keys with compareVals(), and record the
+       (left row, right record) pairs until the output batch is full or the left batch is done.
+    4) Build the output columns from the pairs, one column at a time.
+
+IMPLEMENTATION NOTES:
+    • Float keys compare with a tolerance and cannot be hashed: they all go to one bucket, which makes the
+      probe a nested loop over the right records.
+    • The right input is held in memory.
+
+ERRORS REPORTED:
+    ATTRNOEXIST, INCOMPATIBLE_TYPES (with Join()'s messages), MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+static int joinNextBatch(Iter *it, Batch **batch)
+{
+    JoinState *st = it->state;
+    Batch *out = &st->batch;
+    int n = 0;
+
+    if(!st->built && joinBuild(it) == NOTOK)
+        return NOTOK;
+
+    if(st->numRows == 0)
+        return 0;
+
+    while(n < BATCH_SIZE && !st->done)
+    {
+        if(!st->probe)
+        {
+            int rc = IterNextBatch(st->left, &st->probe);
+
+            if(rc == NOTOK)
+                return NOTOK;
+
+            if(rc == 0)
+            {
+                st->probe = NULL;
+                st->done = 1;
+                break;
+            }
+
+            memset(st->hashes, 0, st->probe->numSel * sizeof(unsigned long long));
+            hashColumn(st->hashes, st->type, st->cmpSize, st->len1, st->probe->cols[st->col1], st->probe->sel, st->probe->numSel);
+            st->probePos = 0;
+            st->cand = st->heads[st->hashes[0] & (st->numBuckets - 1)];
+        }
+
+        Batch *in = st->probe;
+        int row = in->sel[st->probePos];
+        char *key = in->cols[st->col1] + row * st->len1;
+
+        while(st->cand >= 0 && n < BATCH_SIZE)
+        {
+            long e = st->cand;
+
+            st->cand = st->chain[e];
+            if(compareVals(key, st->rows + e * st->right->recSize + st->o2, st->type, st->cmpSize, CMP_EQ))
+            {
+                st->leftRows[n] = row;
+                st->rightRows[n++] = e;
+            }
+        }
+
+        if(st->cand >= 0)
+            break;
+
+        if(++st->probePos < in->numSel)
+        {
+            st->cand = st->heads[st->hashes[st->probePos] & (st->numBuckets - 1)];
+            continue;
+        }
+
+        /* The pairs refer to this batch: emit them before the left input moves on */
+        if(n > 0)
+        {
+            st->drained = 1;
+            break;
+        }
+        st->probe = NULL;
+    }
+
+    if(n == 0)
+        return 0;
+
+    int k = 0;
+
+    for(AttrDesc *p = st->left->attrList; p; p = p->next, k++)
+        gatherColumn(out->cols[k], p->attr.length, st->probe->cols[k], p->attr.length, st->leftRows, n);
+
+    for(int j = 0; j < st->numRight; j++, k++)
+        gatherColumn(out->cols[k], st->rightLens[j], st->rows + st->rightOffsets[j], st->right->recSize, st->rightRows, n);
+
+    if(st->drained)
+    {
+        st->probe = NULL;
+        st->drained = 0;
+    }
+
+    out->numRows = n;
+    batchSelectAll(out);
+    *batch = out;
+    return 1;
+}
+
+static int joinRewind(Iter *it)
+{
+    JoinState *st = it->state;
+
+    st->probe = NULL;
+    st->done = 0;
+    return IterRewind(st->left);
+}
+
+static void joinClose(Iter *it)
+{
+    JoinState *st = it->state;
+
+    if(st->left)
+        IterClose(st->left);
+    if(st->right)
+        IterClose(st->right);
+    batchFreeCols(&st->batch, it->numAttrs);
+    if(it->attrList)
+        FreeLinkedList((void **)&it->attrList, offsetof(AttrDesc, next));
+    free(st->rightOffsets);
+    free(st->rightLens);
+    free(st->rows);
+    free(st->rowHashes);
+    free(st->heads);
+    free(st->chain);
+    iterFree(it);
+}
+
+Iter *JoinIterOpen(Iter *left, const char *attrName1, Iter *right, const char *attrName2)
+{
+    Iter *it = iterAlloc(left->name, sizeof(JoinState));
+
+    if(!it)
+    {
+        IterClose(left);
+        IterClose(right);
+        return NULL;
+    }
+
+    JoinState *st = it->state;
+
+    it->nextBatch = joinNextBatch;
+    it->rewind = joinRewind;
+    it->close = joinClose;
+    st->left = left;
+    st->right = right;
+
+    AttrDesc *ad1 = iterAttr(left, attrName1, &st->col1);
+    AttrDesc *ad2 = iterAttr(right, attrName2, NULL);
+
+    if(!ad1 || !ad2)
+    {
+        attrNotFound(ad1 ? right : left, ad1 ? attrName2 : attrName1);
+        joinClose(it);
+        return NULL;
+    }
+
+    st->type = ad1->attr.type[0];
+
+    if(st->type != ad2->attr.type[0])
+    {
+        printf("Type '%c' of '%s.%s' incompatible with '%c' of '%s.%s'.\n",
+               st->type, left->name, attrName1, ad2->attr.type[0], right->name, attrName2);
+        joinClose(it);
+        db_err_code = INCOMPATIBLE_TYPES;
+        return NULL;
+    }
+
+    /* Numbers compare at their own width: "i2" and "i4" values are not laid out alike */
+    if(st->type != 's' && ad1->attr.length != ad2->attr.length)
+    {
+        printf("Width %d of '%s.%s' incompatible with width %d of '%s.%s'.\n",
+               ad1->attr.length, left->name, attrName1, ad2->attr.length, right->name, attrName2);
+        joinClose(it);
+        db_err_code = INCOMPATIBLE_TYPES;
+        return NULL;
+    }
+
+    st->len1 = ad1->attr.length;
+    st->o2 = ad2->attr.offset;
+    st->cmpSize = MIN(ad1->attr.length, ad2->attr.length);
+
+    if(JoinAttrList(left->attrList, right->attrList, ad2, attrName2, &it->attrList) == NOTOK)
+    {
+        joinClose(it);
+        return NULL;
+    }
+
+    /* The right attributes JoinAttrList() kept follow the left ones, in right order */
+    st->rightOffsets = malloc(right->numAttrs * sizeof(int));
+    st->rightLens = malloc(right->numAttrs * sizeof(int));
+
+    for(AttrDesc *p = right->attrList; st->rightOffsets && st->rightLens && p; p = p->next)
+    {
+        char name[ATTRNAME];
+
+        strncpy(name, p->attr.attrName, ATTRNAME - 1);
+        name[ATTRNAME - 1] = '\0';
+        if(strcmp(name, attrName2) == OK)
+            continue;
+
+        st->rightOffsets[st->numRight] = p->attr.offset;
+        st->rightLens[st->numRight++] = p->attr.length;
+    }
+
+    for(AttrDesc *p = it->attrList; p; p = p->next)
+    {
+        it->numAttrs++;
+        it->recSize += p->attr.length;
+    }
+
+    if(!st->rightOffsets || !st->rightLens || batchAllocCols(&st->batch, it->attrList, it->numAttrs) == NOTOK)
+    {
+        joinClose(it);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NULL;
+    }
+
+    return it;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION IterOpen (name)
+
+FUNCTION DESCRIPTION:
+    Iterator over a view (its plan, opened afresh) or else over the heap relation of that name.
+
+RETURNS:
+    The iterator, or NULL (db_err_code set, message printed).
+
+------------------------------------------------------------*/
+
+Iter *IterOpen(const char *name)
+{
+    ViewDef *v = ViewFind(name);
+
+    if(!v)
+        return ScanIterOpen(name);
+
+    Iter *it = v->plan(v->argc, v->argv);
+
+    if(it)
+        strncpy(it->name, v->name, RELNAME - 1);
+    return it;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PlanSelect / PlanProject / PlanJoin (argc, argv)
+
+FUNCTION DESCRIPTION:
+    Iterator computing the select, project or join command whose arguments are argv, laid out as for
+    Select(), Project() and Join(); argv[1], the result name, is not used.
+
+RETURNS:
+    The iterator, or NULL (db_err_code set, message printed).
+
+------------------------------------------------------------*/
+
+Iter *PlanSelect(int argc, char **argv)
+{
+    Iter *child = IterOpen(argv[2]);
+
+    return child ? FilterIterOpen(child, (argc - 3) / 3, argv + 3) : NULL;
+}
+
+Iter *PlanProject(int argc, char **argv)
+{
+    /* A heap relation only needs to decode the projected columns */
+    Iter *child = ViewFind(argv[2]) ? IterOpen(argv[2]) : ScanIterOpenCols(argv[2], argc - 3, argv + 3);
+
+    return child ? ProjectIterOpen(child, argc - 3, argv + 3) : NULL;
+}
+
+Iter *PlanJoin(int argc, char **argv)
+{
+    Iter *left = IterOpen(argv[2]);
+
+    if(!left)
+        return NULL;
+
+    Iter *right = IterOpen(argv[4]);
+
+    if(!right)
+    {
+        IterClose(left);
+        return NULL;
+    }
+
+    return JoinIterOpen(left, argv[3], right, argv[5]);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION IterNext (it, rec) / IterRewind (it)
+
+FUNCTION DESCRIPTION:
+    Row-at-a-time access to an iterator: IterNext() copies the next selected row of the current batch
+    into a record laid out by it->attrList, fetching a batch when the current one is used up.
+    IterRewind() restarts the iterator from its first row.
+
+RETURNS:
+    IterNext(): 1 with *rec set (valid until the next call), 0 at the end, NOTOK on error.
+    IterRewind(): OK or NOTOK.
+
+------------------------------------------------------------*/
+
+int IterNext(Iter *it, char **rec)
+{
+    while(!it->cur || it->curPos == it->cur->numSel)
+    {
+        int rc = IterNextBatch(it, &it->cur);
+
+        if(rc != 1)
+        {
+            it->cur = NULL;
+            return rc;
+        }
+        it->curPos = 0;
+    }
+
+    if(!it->rec && !(it->rec = malloc(it->recSize)))
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    batchGather(it, it->cur, it->cur->sel[it->curPos++], it->rec);
+    *rec = it->rec;
+    return 1;
+}
+
+int IterRewind(Iter *it)
+{
+    it->cur = NULL;
+    return it->rewind(it);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION IterMaterialize (it, dstRelName)
+
+PARAMETER DESCRIPTION:
+    it         → iterator to drain, closed before returning; NULL when opening it failed.
+    dstRelName → relation to create.
+
+FUNCTION DESCRIPTION:
+    Creates dstRelName with the iterator's schema and inserts every record the iterator returns.
+    This is the only write of a query over views.
+
+RETURNS:
+    OK, or NOTOK (db_err_code set).
+
+ERRORS REPORTED:
+    RELEXIST (via Create()), REC_INS_ERR (via InsertRec()), errors of the iterator
+
+------------------------------------------------------------*/
+
+int IterMaterialize(Iter *it, const char *dstRelName)
+{
+    if(!it)
+        return NOTOK;
+
+    int rc = CreateFromAttrList(dstRelName, it->attrList);
+    int d = rc == OK ? OpenRel((char *)dstRelName) : NOTOK;
+    char *rec;
+
+    while(d != NOTOK && (rc = IterNext(it, &rec)) == 1)
+    {
+        if(InsertRec(d, rec) == NOTOK)
+        {
+            rc = NOTOK;
+            break;
+        }
+    }
+
+    IterClose(it);
+
+    if(d == NOTOK || rc == NOTOK)
+        return NOTOK;
+
+    UnPinRel(d);
+    return OK;
+}
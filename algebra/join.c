@@ -6,86 +6,24 @@
 #include "../include/findrel.h"
 #include "../include/openrel.h"
 #include "../include/findrelattr.h"
-#include "../include/getnextrec.h"
+#include "../include/unpinrel.h"
+#include "../include/join.h"
+#include "../include/iterator.h"
+#include "../include/view.h"
+#include "../include/getnextpagerecs.h"
+#include "../include/getrec.h"
 #include "../include/insertrec.h"
+#include "../include/idxmaint.h"
+#include "../include/extsort.h"
+#include "../include/bloom.h"
 #include "../include/createfromattrlist.h"
-#include "../include/unpinrel.h"
+#include "../include/planner.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <stddef.h>
 #include <string.h>
 
 
-/*------------------------------------------------------------
-
-FUNCTION copy_attribute (srcRec, dstRec, srcAttrDesc, dstAttrDesc)
-
-PARAMETER DESCRIPTION:
-    srcRec         → Pointer to source record buffer (raw tuple bytes)
-    dstRec         → Pointer to destination record buffer (raw tuple bytes)
-    srcAttrDesc    → Pointer to pointer to current attribute descriptor in the source relation’s attribute linked list (AttrDesc **)
-    dstAttrDesc    → Pointer to pointer to current attribute descriptor in the destination relation’s attribute list (AttrDesc **)
-
-FUNCTION DESCRIPTION:
-    This routine is used internally by JOIN to copy one attribute at a time from a tuple of the source relation into the correct location inside a tuple of the destination (joined) relation.
-    The routine:
-       • Reads the source attribute metadata (offset, type, length).
-       • Computes source field location: srcRec+offset.
-       • Computes destination attribute offset.
-       • Invokes writeAttrToRec() to correctly copy the value.
-       • Advances both pointer-to-AttrDesc parameters to their respective next attributes, enabling simple loop-based copying.
-    Supported attribute types:
-       • INTEGER ('i')
-       • FLOAT   ('f')
-       • STRING  ('s')
-    Attribute sizes and layouts must be respected as stored in the attribute catalog of each relation.
-
-ALGORITHM:
-    1) Extract from *srcAttrDesc:
-        - source offset
-        - source type
-        - source attribute length
-    2) Extract from *dstAttrDesc the destination offset.
-    3) Compute source attribute address:
-        srcPtr = (char *)srcRec + source_offset
-    4) Call writeAttrToRec() with: (dstRec, srcPtr, type, length, destination_offset) so that correct formatting, truncation, padding, and casting is performed as needed.
-    5) Advance both attribute descriptor pointers:
-           *srcAttrDesc = (*srcAttrDesc)->next
-           *dstAttrDesc = (*dstAttrDesc)->next
-
-BUGS:
-    None found.
-
-ERRORS REPORTED:
-    • No direct errors generated.
-
-GLOBAL VARIABLES MODIFIED:
-    None.
-
-IMPLEMENTATION NOTES :
-    • Created to simplify JOIN construction; avoids repetitive offset computation code in the Join loop.
-    • Works one attribute at a time; JOIN repeatedly invokes it to build a full destination tuple.
-    • Maintains alignment and padding rules consistent with MINIREL’s physical record layout.
-
-------------------------------------------------------------*/
-
-void copy_attribute(void *srcRec, void *dstRec, AttrDesc **srcAttrDesc, AttrDesc **dstAttrDesc) 
-{
-    int dOffset = (*dstAttrDesc)->attr.offset;
-    int sOffset = (*srcAttrDesc)->attr.offset;
-    int sType = (*srcAttrDesc)->attr.type[0];
-    int sSize = (*srcAttrDesc)->attr.length;
-    
-    writeAttrToRec((char *)dstRec, 
-                   (char *)srcRec + sOffset, 
-                   sType, 
-                   sSize, 
-                   dOffset);
-    
-    *dstAttrDesc = (*dstAttrDesc)->next;
-    *srcAttrDesc = (*srcAttrDesc)->next;
-}
-
-
 /* Helper: normalize into buffer and print hex bytes for debugging */
 static void normalize_str(const char *src, char *dst /* size ATTRNAME */)
 {
@@ -109,8 +47,8 @@ static void hex_dump(const char *label, const char *s)
 
 /* nameCollidesDetailedWithMatch:
    - resHead: attributes already in result
-   - s1: relation number for src1 (or -1 to skip)
-   - s2: relation number for src2 (or -1 to skip)
+   - list1: attribute list of src1 (or NULL to skip)
+   - list2: attribute list of src2 (or NULL to skip)
    - ad2: AttrDesc* to exclude from s2 checks (the join attribute)
    - exclude_s2: AttrDesc* to exclude from s2 checks (the current attribute node p)
    - outMatch: optional buffer to receive the matching existing name (size ATTRNAME)
@@ -120,7 +58,7 @@ static void hex_dump(const char *label, const char *s)
      2 => collides with s1
      3 => collides with s2 (non-ad2, non-exclude_s2)
 */
-static int nameCollidesDetailedWithMatch(const char *name, AttrDesc *resHead, int s1, int s2, AttrDesc *ad2, AttrDesc *exclude_s2, char *outMatch /* size ATTRNAME */)
+static int nameCollidesDetailedWithMatch(const char *name, AttrDesc *resHead, AttrDesc *list1, AttrDesc *list2, AttrDesc *ad2, AttrDesc *exclude_s2, char *outMatch /* size ATTRNAME */)
 {
     char norm_name[ATTRNAME];
     normalize_str(name, norm_name);
@@ -138,9 +76,9 @@ static int nameCollidesDetailedWithMatch(const char *name, AttrDesc *resHead, in
     }
 
     /* 2) check s1 */
-    if (s1 >= 0)
+    if (list1)
     {
-        for (AttrDesc *p = catcache[s1].attrList; p; p = p->next)
+        for (AttrDesc *p = list1; p; p = p->next)
         {
             char pname[ATTRNAME];
             normalize_str(p->attr.attrName, pname);
@@ -153,9 +91,9 @@ static int nameCollidesDetailedWithMatch(const char *name, AttrDesc *resHead, in
     }
 
     /* 3) check s2 BUT explicitly ignore ad2 and exclude_s2 */
-    if (s2 >= 0)
+    if (list2)
     {
-        for (AttrDesc *p = catcache[s2].attrList; p; p = p->next)
+        for (AttrDesc *p = list2; p; p = p->next)
         {
             if (p == ad2) continue;
             if (p == exclude_s2) continue; /* do not consider the same node as a collision */
@@ -173,169 +111,40 @@ static int nameCollidesDetailedWithMatch(const char *name, AttrDesc *resHead, in
 }
 
 /* small wrapper boolean version */
-static bool nameCollidesExcludingSelf(const char *name, AttrDesc *resHead, int s1, int s2, AttrDesc *ad2, AttrDesc *exclude_s2)
+static bool nameCollidesExcludingSelf(const char *name, AttrDesc *resHead, AttrDesc *list1, AttrDesc *list2, AttrDesc *ad2, AttrDesc *exclude_s2)
 {
-    return (nameCollidesDetailedWithMatch(name, resHead, s1, s2, ad2, exclude_s2, NULL) != 0);
+    return (nameCollidesDetailedWithMatch(name, resHead, list1, list2, ad2, exclude_s2, NULL) != 0);
 }
 
 
 /*------------------------------------------------------------
 
-FUNCTION Join (argc, argv)
+FUNCTION JoinAttrList (head1, head2, ad2, attrName2, resHeadOut)
 
 PARAMETER DESCRIPTION:
-    argc → number of command-line arguments.
-    argv → pointer to array of argument strings.
-    Specifications:
-        argv[0] = "join"
-        argv[1] = name of destination relation to be created
-        argv[2] = name of first source relation (R1)
-        argv[3] = join attribute of R1
-        argv[4] = name of second source relation (R2)
-        argv[5] = join attribute of R2
-        argv[argc] = NIL
+    head1      → attribute list of R1.
+    head2      → attribute list of R2.
+    ad2        → join attribute of R2 (a node of head2).
+    attrName2  → name of the join attribute of R2.
+    resHeadOut → receives the newly allocated attribute list of the result.
 
 FUNCTION DESCRIPTION:
-    The routine performs an equi-join of two relations R1 and R2 on the specified attributes, producing a new relation with schema:
-        (all attributes of R1)  ⨝  (all attributes of R2 except the join attribute)
-    Rules and requirements:
-        • Both relations must exist.
-        • Join attributes must exist in their respective relations.
-        • Join attributes must have the same type.
-        • Destination relation must NOT already exist.
-        • Result relation schema is built by combining schemas of R1 and R2.
-        • Attribute name conflicts (excluding the join attribute) from R2 are resolved by renaming to attr_R2.
-        • All matching tuple pairs (t1, t2) with t1.attrName1 == t2.attrName2 are inserted into the new relation.
-
-ALGORITHM:
-    1) Validate database state (DB must be open).
-    2) Parse argument strings:
-        dstRelName, src1RelName, attrName1, src2RelName, attrName2.
-    3) Open both source relations R1 and R2.
-        If either fails, report RELNOEXIST.
-    4) Confirm that destination relation does NOT already exist.
-    5) Look up attribute descriptors:
-        attrName1 in R1,
-        attrName2 in R2.
-        If either does NOT exist, report ATTRNOEXIST.
-    6) Verify that join attributes have identical types.
-        If not, report INCOMPATIBLE_TYPES.
-    7) Build the result schema:
-        a) Copy attribute descriptors of R1 entirely.
-        b) Copy attributes of R2 except join attribute.
-        c) If an attribute name from R2 duplicates one in R1, rename as "<attr>_<src2RelName>".
-    8) Using the combined attribute list, call CreateFromAttrList() to create the destination relation.
-    9) Re-open the created destination relation.
-    10) For each record r1 in R1:
-            For each record r2 in R2:
-                Compare join fields:
-                    if equal → create joined tuple and insert into destination relation.
-    11) Perform attribute-wise copying using copy_attribute() to ensure correct offsets, types, and physical layout.
-    12) Print success message.
+    Builds the schema of R1 ⨝ R2: every attribute of R1, then every attribute of R2 except the join attribute.
+    An attribute of R2 whose name collides with one already in the result, or with another attribute of R1 or R2,
+    is renamed by appending the smallest numeric suffix that makes it unique.
+    Offsets are those of the packed result record.
+    Used by Join() and by the join iterator (algebra/iterator.c).
 
-BUGS:
-    None found.
+RETURNS:
+    OK, or NOTOK (db_err_code set) with nothing allocated.
 
 ERRORS REPORTED:
-    DBNOTOPEN           → database is closed
-    RELNOEXIST          → either source relation does not exist
-    RELEXIST            → destination relation already exists
-    ATTRNOEXIST         → join attribute not found
-    INCOMPATIBLE_TYPES  → join attributes' types differ
-    MEM_ALLOC_ERROR     → memory allocation failure
-    OTHER errors raised by: OpenRel(), FindRec(), InsertRec(), CreateFromAttrList(), compareVals(), etc.
-
-GLOBAL VARIABLES MODIFIED:
-      db_err_code
-      catcache[] entries (via schema creation and relation opening)
-
-IMPLEMENTATION NOTES:
-    • Uses nested loop join.
-    • Performs safe attribute renaming for R2 to avoid collisions.
-    • copy_attribute() abstracts offset calculations during record assembly.
-    • Destination schema creation must precede record insertion.
-    • The join inserts records in physical order encountered.
+    MEM_ALLOC_ERROR
 
 ------------------------------------------------------------*/
 
-int Join(int argc, char **argv)
+int JoinAttrList(AttrDesc *head1, AttrDesc *head2, AttrDesc *ad2, const char *attrName2, AttrDesc **resHeadOut)
 {
-    if (!db_open)
-    {
-        db_err_code = DBNOTOPEN;
-        return ErrorMsgs(db_err_code, print_flag);
-    }
-
-    char *dstRelName = argv[1];
-    char *src1RelName = argv[2];
-    char *attrName1   = argv[3];
-    char *src2RelName = argv[4];
-    char *attrName2   = argv[5];
-
-    int s1 = OpenRel(src1RelName);
-    int s2 = OpenRel(src2RelName);
-
-    if (s1 == NOTOK)
-    {
-        if(db_err_code == RELNOEXIST)
-        {
-            printf("Relation '%s' does NOT exist in the DB.\n", src1RelName);
-            printCloseStrings(RELCAT_CACHE, offsetof(RelCatRec, relName), src1RelName, NULL);
-        }
-        return ErrorMsgs(db_err_code, print_flag);
-    }
-
-    if (s2 == NOTOK)
-    {
-        if(db_err_code == RELNOEXIST)
-        {
-            printf("Relation '%s' does NOT exist in the DB.\n", src2RelName);
-            printCloseStrings(RELCAT_CACHE, offsetof(RelCatRec, relName), src2RelName, NULL);
-        }
-        return ErrorMsgs(db_err_code, print_flag);
-    }
-
-    int d = FindRel(dstRelName);
-    if (d)
-    {
-        printf("Relation '%s' already exists in the DB.\n", dstRelName);
-        db_err_code = RELEXIST;
-        return ErrorMsgs(db_err_code, print_flag);
-    }
-
-    AttrDesc *ad1 = FindRelAttr(s1, attrName1);
-    AttrDesc *ad2 = FindRelAttr(s2, attrName2);
-
-    if (!ad1)
-    {
-        printf("Attribute '%s' NOT present in relation '%s' of the DB.\n", src1RelName, attrName1);
-        printCloseStrings(ATTRCAT_CACHE, offsetof(AttrCatRec, attrName), attrName1, src1RelName);
-        db_err_code = ATTRNOEXIST;
-        return ErrorMsgs(db_err_code, print_flag);
-    }
-
-    if (!ad2)
-    {
-        printf("Attribute '%s' NOT present in relation '%s' of the DB.\n", src2RelName, attrName2);
-        printCloseStrings(ATTRCAT_CACHE, offsetof(AttrCatRec, attrName), attrName2, src2RelName);
-        db_err_code = ATTRNOEXIST;
-        return ErrorMsgs(db_err_code, print_flag);
-    }
-
-    char t1 = (ad1->attr).type[0];
-    char t2 = (ad2->attr).type[0];
-
-    if (t1 != t2)
-    {
-        printf("Type '%c' of '%s.%s' incompatible with '%c' of '%s.%s'.\n",
-               t1, src1RelName, attrName1, t2, src2RelName, attrName2);
-        db_err_code = INCOMPATIBLE_TYPES;
-        return ErrorMsgs(db_err_code, print_flag);
-    }
-
-    AttrDesc *head1 = catcache[s1].attrList;
-    AttrDesc *head2 = catcache[s2].attrList;
-
     AttrDesc *resHead = NULL, *resTail = NULL;
 
     /* Step 1: copy attrs from relation1 */
@@ -347,7 +156,7 @@ int Join(int argc, char **argv)
             db_err_code = MEM_ALLOC_ERROR;
             AttrDesc *tmp;
             while (resHead) { tmp = resHead; resHead = resHead->next; free(tmp); }
-            return ErrorMsgs(db_err_code, print_flag);
+            return NOTOK;
         }
         newNode->attr = p->attr;
         newNode->attr.attrName[ATTRNAME - 1] = '\0';
@@ -379,7 +188,7 @@ int Join(int argc, char **argv)
             db_err_code = MEM_ALLOC_ERROR;
             AttrDesc *tmp;
             while (resHead) { tmp = resHead; resHead = resHead->next; free(tmp); }
-            return ErrorMsgs(db_err_code, print_flag);
+            return NOTOK;
         }
 
         newNode->attr = p->attr;
@@ -388,7 +197,7 @@ int Join(int argc, char **argv)
 
         /* Use normalized collision check but exclude the current node p from s2 checks */
         char matching_name[ATTRNAME];
-        int collSrc = nameCollidesDetailedWithMatch(p->attr.attrName, resHead, s1, s2, ad2, p, matching_name);
+        int collSrc = nameCollidesDetailedWithMatch(p->attr.attrName, resHead, head1, head2, ad2, p, matching_name);
         bool collision = (collSrc != 0);
 
         if (collSrc == 0)
@@ -427,7 +236,7 @@ int Join(int argc, char **argv)
                 candidate[ATTRNAME - 1] = '\0';
 
                 char match2[ATTRNAME];
-                int coll2 = nameCollidesDetailedWithMatch(candidate, resHead, s1, s2, ad2, p, match2);
+                int coll2 = nameCollidesDetailedWithMatch(candidate, resHead, head1, head2, ad2, p, match2);
                 if (coll2 == 0)
                 {
                     strncpy(newNode->attr.attrName, candidate, ATTRNAME - 1);
@@ -444,7 +253,7 @@ int Join(int argc, char **argv)
                 while (resHead) { tmp = resHead; resHead = resHead->next; free(tmp); }
                 free(newNode);
                 db_err_code = MEM_ALLOC_ERROR;
-                return ErrorMsgs(db_err_code, print_flag);
+                return NOTOK;
             }
         }
 
@@ -453,118 +262,783 @@ int Join(int argc, char **argv)
         else { resTail->next = newNode; resTail = newNode; }
     }
 
-    /* Step 3: create schema, cleanup */
-    int status = CreateFromAttrList(dstRelName, resHead);
-    if (status != OK)
+    /* Offsets of the packed result record, as Create() lays it out */
+    int offset = 0;
+    for (AttrDesc *p = resHead; p; p = p->next)
     {
-        AttrDesc *tmp;
-        while (resHead) { tmp = resHead; resHead = resHead->next; free(tmp); }
-        return ErrorMsgs(db_err_code, print_flag);
+        p->attr.offset = offset;
+        offset += p->attr.length;
     }
 
-    /* free resHead */
+    *resHeadOut = resHead;
+    return OK;
+}
+
+
+/* qsort() comparator ordering Rids by page then slot, so GetRec() reads each page once */
+static int ridCmp(const void *a, const void *b)
+{
+    const Rid *x = a, *y = b;
+
+    if(x->pid != y->pid)
+        return x->pid - y->pid;
+    return x->slotnum - y->slotnum;
+}
+
+
+/* State of a join evaluated by one of the executors below; side 0 is R1, side 1 is R2 */
+typedef struct joinrun
+{
+    int r[2];                   // open source relations
+    AttrDesc *ad[2];            // join attributes
+    int recLen[2];              // record lengths
+    int off[2];                 // join attribute offsets
+    char type;                  // join attribute type
+    int cmpSize;                // compared length
+    int d;                      // open destination relation
+    int numCols;                // attributes of the result
+    int *colSide;               // side each attribute of the result is copied from
+    int *colOff;                // and its offset there
+    int *colLen;                // and its length
+    char *out;                  // result record being assembled
+} JoinRun;
+
+/* Order of the join keys of a sort-merge: the offset of the key in the records sorted */
+typedef struct joinkey
+{
+    char type;
+    int size;
+    int off;
+} JoinKey;
+
+static int joinKeyCmp(const void *a, const void *b, void *ctx)
+{
+    const JoinKey *k = ctx;
+
+    if(k->type == 's')
+        return strncmp((const char *)a + k->off, (const char *)b + k->off, k->size);
+    return compareNumeric((const char *)a + k->off, (const char *)b + k->off, k->type, k->size);
+}
+
+/* Three-way order of the keys of a record of each side, as the sort-merge sorted them */
+static int joinOrder(const JoinRun *j, const char *rec1, const char *rec2)
+{
+    if(j->type == 's')
+        return strncmp(rec1 + j->off[0], rec2 + j->off[1], j->cmpSize);
+    return compareNumeric(rec1 + j->off[0], rec2 + j->off[1], j->type, j->cmpSize);
+}
+
+/* True when the keys of a record of each side join; floats compare with the tolerance of compareVals() */
+static bool joinMatch(const JoinRun *j, const char *rec1, const char *rec2)
+{
+    return compareVals((char *)rec1 + j->off[0], (char *)rec2 + j->off[1], j->type, j->cmpSize, CMP_EQ);
+}
+
+/* Assembles the result record of rec1 and rec2 and inserts it into the destination */
+static int joinEmit(JoinRun *j, const char *rec1, const char *rec2)
+{
+    int pos = 0;
+
+    for(int c = 0; c < j->numCols; c++)
     {
-        AttrDesc *tmp;
-        while (resHead) { tmp = resHead; resHead = resHead->next; free(tmp); }
+        memcpy(j->out + pos, (j->colSide[c] ? rec2 : rec1) + j->colOff[c], j->colLen[c]);
+        pos += j->colLen[c];
     }
+    return InsertRec(j->d, j->out);
+}
+
+/* joinEmit() with the records given as outer side o and the other side */
+static int joinEmitSides(JoinRun *j, int o, const char *outer, const char *inner)
+{
+    return o == 0 ? joinEmit(j, outer, inner) : joinEmit(j, inner, outer);
+}
 
-    /* Step 4: open dest and insert joined rows (same as before) */
-    d = OpenRel(dstRelName);
-    if (d == NOTOK) { return ErrorMsgs(db_err_code, print_flag); }
+/* Copies the next non-empty page of side s into page; *numRecs = 0 at the end of the relation */
+static int joinReadPage(JoinRun *j, int s, short *pid, char *page, int *numRecs)
+{
+    char *recs[MAX_RECS_PER_PG];
+
+    if(GetNextPageRecs(j->r[s], pid, NULL, recs, numRecs) == NOTOK)
+        return NOTOK;
+
+    for(int i = 0; i < *numRecs; i++)
+        memcpy(page + i * j->recLen[s], recs[i], j->recLen[s]);
+    return OK;
+}
+
+
+/* Scans the inner side 1 - o once, matching every record of each of its pages against the numBlock outer records of block */
+static int joinBlockScan(JoinRun *j, int o, const char *block, int numBlock)
+{
+    char *recs[MAX_RECS_PER_PG];
+    int numRecs = 1, rc = OK;
+    short pid = 0;
 
-    int dstRecSize = catcache[d].relcat_rec.recLength;
-    void *recPtr1 = malloc(catcache[s1].relcat_rec.recLength);
-    void *recPtr2 = malloc(catcache[s2].relcat_rec.recLength);
-    if (!recPtr1 || !recPtr2)
+    while(rc == OK && numRecs > 0)
     {
-        if (recPtr1) free(recPtr1);
-        if (recPtr2) free(recPtr2);
-        return ErrorMsgs(MEM_ALLOC_ERROR, print_flag);
+        rc = GetNextPageRecs(j->r[1 - o], &pid, NULL, recs, &numRecs);
+
+        for(int b = 0; rc == OK && b < numBlock; b++)
+        {
+            const char *outer = block + b * j->recLen[o];
+
+            for(int k = 0; rc == OK && k < numRecs; k++)
+            {
+                if(o == 0 ? joinMatch(j, outer, recs[k]) : joinMatch(j, recs[k], outer))
+                    rc = joinEmitSides(j, o, outer, recs[k]);
+            }
+        }
     }
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION joinBlockNL (j, o, blockRecs)
+
+FUNCTION DESCRIPTION:
+    Block nested loop join with side o outer: the inner side is scanned once per block of blockRecs outer records,
+    and every record of an inner page is matched against the block.  With blockRecs = 1 it is the nested loop join,
+    and its output is in outer order, then inner order.
+    Outer pages are copied before the inner side is read, as a self-join reads both sides through one buffer.
+
+------------------------------------------------------------*/
+
+static int joinBlockNL(JoinRun *j, int o, int blockRecs)
+{
+    char *page = malloc(MAX_RECS_PER_PG * j->recLen[o]);
+    char *block = malloc((long)blockRecs * j->recLen[o]);
+    int numBlock = 0, numRecs = 1;
+    short pid = 0;
 
-    Rid rid1 = INVALID_RID, rid2 = INVALID_RID;
-    char t = t1;
-    int o1 = ad1->attr.offset;
-    int o2 = ad2->attr.offset;
+    if(!page || !block)
+    {
+        free(page);
+        free(block);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
 
-    int cmpSize = MIN(ad1->attr.length, ad2->attr.length);
-    int dNumAttrs = catcache[d].relcat_rec.numAttrs;
-    int s1NumAttrs = catcache[s1].relcat_rec.numAttrs;
-    int s2NumAttrs = catcache[s2].relcat_rec.numAttrs;
+    int rc = OK;
 
-    rid1 = INVALID_RID;
-    while (1)
+    while(rc == OK && numRecs > 0)
     {
-        rid2 = INVALID_RID;
-        if (GetNextRec(s1, rid1, &rid1, recPtr1) == NOTOK)
+        rc = joinReadPage(j, o, &pid, page, &numRecs);
+
+        for(int k = 0; rc == OK && k < numRecs; k++)
         {
-            free(recPtr1); free(recPtr2);
-            return ErrorMsgs(db_err_code, print_flag);
+            memcpy(block + numBlock++ * j->recLen[o], page + k * j->recLen[o], j->recLen[o]);
+
+            if(numBlock == blockRecs)
+            {
+                rc = joinBlockScan(j, o, block, numBlock);
+                numBlock = 0;
+            }
         }
-        if (!isValidRid(rid1)) break;
+    }
+
+    if(rc == OK && numBlock > 0)
+        rc = joinBlockScan(j, o, block, numBlock);
+
+    free(page);
+    free(block);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION joinHash (j, o)
 
-        while (1)
+FUNCTION DESCRIPTION:
+    Hash join building a chained hash table on the records of side 1 - o, then probing it with every record of side o;
+    the output is in probe order, then build order.  Keys are hashed with BloomHashValue() and compared with
+    compareVals().  The planner only chooses it for keys that are not floats.
+
+------------------------------------------------------------*/
+
+static int joinHash(JoinRun *j, int o)
+{
+    int b = 1 - o;
+    long cap = MAX(catcache[j->r[b]].relcat_rec.numRecs, 1), n = 0;
+    char *rows = malloc(cap * j->recLen[b]);
+    char *page = malloc(MAX_RECS_PER_PG * j->recLen[b]);
+    int rc = rows && page ? OK : NOTOK;
+    int numRecs = 1;
+    short pid = 0;
+
+    if(rc == NOTOK)
+        db_err_code = MEM_ALLOC_ERROR;
+
+    while(rc == OK && numRecs > 0)
+    {
+        rc = joinReadPage(j, b, &pid, page, &numRecs);
+
+        if(rc == OK && n + numRecs > cap)
         {
-            if (GetNextRec(s2, rid2, &rid2, recPtr2) == NOTOK)
+            char *grown = realloc(rows, (n + numRecs) * 2 * j->recLen[b]);
+
+            if(!grown)
             {
-                free(recPtr1); free(recPtr2);
-                return ErrorMsgs(db_err_code, print_flag);
+                db_err_code = MEM_ALLOC_ERROR;
+                rc = NOTOK;
+                break;
             }
-            if (!isValidRid(rid2)) break;
+            rows = grown;
+            cap = (n + numRecs) * 2;
+        }
 
-            void *valPtr1 = (char *)recPtr1 + o1;
-            void *valPtr2 = (char *)recPtr2 + o2;
+        if(rc == OK)
+        {
+            memcpy(rows + n * j->recLen[b], page, (long)numRecs * j->recLen[b]);
+            n += numRecs;
+        }
+    }
 
-            if (compareVals(valPtr1, valPtr2, t, cmpSize, CMP_EQ))
-            {
-                void *dstRecPtr = malloc(dstRecSize);
-                if (!dstRecPtr)
-                {
-                    free(recPtr1); free(recPtr2);
-                    db_err_code = MEM_ALLOC_ERROR;
-                    return ErrorMsgs(db_err_code, print_flag);
-                }
+    long numBuckets = 1;
 
-                AttrDesc *dstAttrDescPtr = catcache[d].attrList;
-                AttrDesc *src1AttrDescPtr = catcache[s1].attrList;
-                AttrDesc *src2AttrDescPtr = catcache[s2].attrList;
+    while(numBuckets < n)
+        numBuckets <<= 1;
 
-                for (int ctr = 0; ctr < dNumAttrs; ctr++)
-                {
-                    if (!dstAttrDescPtr) break;
-                    if (ctr < s1NumAttrs)
-                    {
-                        copy_attribute(recPtr1, dstRecPtr, &src1AttrDescPtr, &dstAttrDescPtr);
-                    }
-                    else
-                    {
-                        if (src2AttrDescPtr == ad2)
-                        {
-                            src2AttrDescPtr = src2AttrDescPtr->next;
-                            ctr--;
-                            continue;
-                        }
-                        else
-                        {
-                            copy_attribute(recPtr2, dstRecPtr, &src2AttrDescPtr, &dstAttrDescPtr);
-                        }
-                    }
-                }
+    long *head = rc == OK ? malloc(numBuckets * sizeof(long)) : NULL;
+    long *next = rc == OK ? malloc(MAX(n, 1) * sizeof(long)) : NULL;
 
-                if (InsertRec(d, dstRecPtr) == NOTOK)
-                {
-                    free(dstRecPtr); free(recPtr1); free(recPtr2);
-                    return ErrorMsgs(db_err_code, print_flag);
-                }
-                free(dstRecPtr);
-            }
-        } /* inner */
-    } /* outer */
+    if(rc == OK && (!head || !next))
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        rc = NOTOK;
+    }
+
+    if(rc == OK)
+    {
+        for(long h = 0; h < numBuckets; h++)
+            head[h] = -1;
+
+        /* Inserted last to first, so that every chain lists its records in build order */
+        for(long e = n - 1; e >= 0; e--)
+        {
+            long h = BloomHashValue(j->type, j->cmpSize, rows + e * j->recLen[b] + j->off[b]) & (numBuckets - 1);
+
+            next[e] = head[h];
+            head[h] = e;
+        }
+    }
+
+    char *recs[MAX_RECS_PER_PG];
+
+    pid = 0;
+    numRecs = 1;
+
+    while(rc == OK && numRecs > 0)
+    {
+        rc = GetNextPageRecs(j->r[o], &pid, NULL, recs, &numRecs);
+
+        for(int k = 0; rc == OK && k < numRecs; k++)
+        {
+            long h = BloomHashValue(j->type, j->cmpSize, recs[k] + j->off[o]) & (numBuckets - 1);
+
+            for(long e = head[h]; rc == OK && e >= 0; e = next[e])
+            {
+                const char *built = rows + e * j->recLen[b];
+
+                if(o == 0 ? joinMatch(j, recs[k], built) : joinMatch(j, built, recs[k]))
+                    rc = joinEmitSides(j, o, recs[k], built);
+            }
+        }
+    }
+
+    free(rows);
+    free(page);
+    free(head);
+    free(next);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION joinIndexNL (j, o)
+
+FUNCTION DESCRIPTION:
+    Index nested loop join with side o outer: the key of every outer record is looked up in the index of the inner
+    join attribute (FindRidsByIndex(), equality), and the inner records it gives are fetched in Rid order with
+    GetRec() and re-checked with compareVals().  The output is in outer order, then inner Rid order.
+
+------------------------------------------------------------*/
+
+static int joinIndexNL(JoinRun *j, int o)
+{
+    int i = 1 - o;
+    AttrCatRec *attr = &j->ad[i]->attr;
+    char *page = malloc(MAX_RECS_PER_PG * j->recLen[o]);
+    char *inner = malloc(j->recLen[i]);
+    char *key = calloc(1, attr->length);
+    int rc = page && inner && key ? OK : NOTOK;
+    int numRecs = 1;
+    short pid = 0;
+
+    if(rc == NOTOK)
+        db_err_code = MEM_ALLOC_ERROR;
+
+    while(rc == OK && numRecs > 0)
+    {
+        rc = joinReadPage(j, o, &pid, page, &numRecs);
+
+        for(int k = 0; rc == OK && k < numRecs; k++)
+        {
+            const char *outer = page + k * j->recLen[o];
+            Rid *rids;
+            int numRids;
+
+            /* The key as the inner attribute holds it: a shorter string is padded with NULs */
+            memcpy(key, outer + j->off[o], j->cmpSize);
+
+            if(FindRidsByIndex(j->r[i], attr, key, CMP_EQ, &rids, &numRids) == NOTOK)
+            {
+                rc = NOTOK;
+                break;
+            }
+
+            if(numRids > 1)
+                qsort(rids, numRids, sizeof(Rid), ridCmp);
+
+            for(int m = 0; rc == OK && m < numRids; m++)
+            {
+                int got = GetRec(j->r[i], rids[m], inner);
+
+                if(got == NOTOK)
+                    rc = NOTOK;
+                else if(got && (o == 0 ? joinMatch(j, outer, inner) : joinMatch(j, inner, outer)))
+                    rc = joinEmitSides(j, o, outer, inner);
+            }
+
+            free(rids);
+        }
+    }
+
+    free(page);
+    free(inner);
+    free(key);
+    return rc;
+}
+
+
+/* Feeds every record of side s to the external sort */
+static int joinSortSide(JoinRun *j, int s, ExtSort *sort)
+{
+    char *recs[MAX_RECS_PER_PG];
+    int numRecs = 1;
+    short pid = 0;
+
+    while(numRecs > 0)
+    {
+        if(GetNextPageRecs(j->r[s], &pid, NULL, recs, &numRecs) == NOTOK)
+            return NOTOK;
+
+        for(int k = 0; k < numRecs; k++)
+        {
+            if(ExtSortAdd(sort, recs[k]) == NOTOK)
+                return NOTOK;
+        }
+    }
+    return ExtSortFinish(sort);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION joinSortMerge (j, dstRelName)
+
+FUNCTION DESCRIPTION:
+    Sort-merge join: both sides are sorted on their join attribute with the external sort (run files
+    "<dstRelName>.l.run<n>" and "<dstRelName>.r.run<n>"), then merged.  The R2 records whose keys may still join
+    the current R1 record are kept in a window, so duplicate keys on both sides, and floats equal within the
+    tolerance of compareVals(), give every pair.  The output is in key order.
+
+------------------------------------------------------------*/
+
+static int joinSortMerge(JoinRun *j, const char *dstRelName)
+{
+    JoinKey key[2] = {{j->type, j->cmpSize, j->off[0]}, {j->type, j->cmpSize, j->off[1]}};
+    ExtSort sort[2];
+    char prefix[RELNAME + ATTRNAME + 8];
+    int opened = 0, rc = OK;
+
+    for(int s = 0; rc == OK && s < 2; s++)
+    {
+        snprintf(prefix, sizeof(prefix), "%s.%c", dstRelName, s ? 'r' : 'l');
+        rc = ExtSortOpen(&sort[s], j->recLen[s], joinKeyCmp, &key[s], SORT_MEM_BYTES, prefix);
+        opened += rc == OK;
+        if(rc == OK)
+            rc = joinSortSide(j, s, &sort[s]);
+    }
+
+    long winCap = 64, winStart = 0, winEnd = 0;
+    char *win = malloc(winCap * j->recLen[1]);
+    char *left = malloc(j->recLen[0]);
+    char *right = malloc(j->recLen[1]);
+    int haveRight = 0, haveLeft = 0;
+
+    if(rc == OK && (!win || !left || !right))
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        rc = NOTOK;
+    }
+
+    if(rc == OK && (haveRight = ExtSortNext(&sort[1], right)) == NOTOK)
+        rc = NOTOK;
+
+    while(rc == OK && (haveLeft = ExtSortNext(&sort[0], left)) == 1)
+    {
+        /* R2 records below the key that do not join it cannot join the larger keys that follow */
+        while(winStart < winEnd && joinOrder(j, left, win + winStart * j->recLen[1]) > 0 &&
+              !joinMatch(j, left, win + winStart * j->recLen[1]))
+            winStart++;
+
+        if(winStart == winEnd)
+            winStart = winEnd = 0;
+
+        while(haveRight == 1 && (joinOrder(j, left, right) >= 0 || joinMatch(j, left, right)))
+        {
+            if(winEnd == winCap)
+            {
+                memmove(win, win + winStart * j->recLen[1], (winEnd - winStart) * j->recLen[1]);
+                winEnd -= winStart;
+                winStart = 0;
+            }
+
+            if(winEnd == winCap)
+            {
+                char *grown = realloc(win, winCap * 2 * j->recLen[1]);
+
+                if(!grown)
+                {
+                    db_err_code = MEM_ALLOC_ERROR;
+                    rc = NOTOK;
+                    break;
+                }
+                win = grown;
+                winCap *= 2;
+            }
+
+            memcpy(win + winEnd++ * j->recLen[1], right, j->recLen[1]);
+            haveRight = ExtSortNext(&sort[1], right);
+        }
+
+        if(haveRight == NOTOK)
+            rc = NOTOK;
+
+        for(long w = winStart; rc == OK && w < winEnd; w++)
+        {
+            if(joinMatch(j, left, win + w * j->recLen[1]))
+                rc = joinEmit(j, left, win + w * j->recLen[1]);
+        }
+    }
+
+    if(haveLeft == NOTOK)
+        rc = NOTOK;
+
+    for(int s = 0; s < opened; s++)
+        ExtSortClose(&sort[s]);
+    free(win);
+    free(left);
+    free(right);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION joinRun (s1, ad1, s2, ad2, dstRelName, plan)
+
+FUNCTION DESCRIPTION:
+    Creates the destination relation with the schema of JoinAttrList() and fills it with the executor of the
+    method the planner chose, other than the hash join building R2, which is the pipelined PlanJoin().
+
+RETURNS:
+    OK, or NOTOK with db_err_code set.
+
+------------------------------------------------------------*/
+
+static int joinRun(int s1, AttrDesc *ad1, int s2, AttrDesc *ad2, const char *dstRelName, const JoinPlan *plan)
+{
+    JoinRun j = {{s1, s2}, {ad1, ad2}, {catcache[s1].relcat_rec.recLength, catcache[s2].relcat_rec.recLength},
+                 {ad1->attr.offset, ad2->attr.offset}, ad1->attr.type[0], MIN(ad1->attr.length, ad2->attr.length)};
+    AttrDesc *resHead;
+
+    if(JoinAttrList(catcache[s1].attrList, catcache[s2].attrList, ad2, ad2->attr.attrName, &resHead) == NOTOK)
+        return NOTOK;
+
+    int rc = CreateFromAttrList(dstRelName, resHead);
+    int outLen = 0;
+
+    for(AttrDesc *p = resHead; p; p = p->next)
+    {
+        j.numCols++;
+        outLen += p->attr.length;
+    }
+    FreeLinkedList((void **)&resHead, offsetof(AttrDesc, next));
+
+    if(rc != OK)
+        return NOTOK;
+
+    j.d = OpenRel((char *)dstRelName);
+    j.colSide = malloc(j.numCols * sizeof(int));
+    j.colOff = malloc(j.numCols * sizeof(int));
+    j.colLen = malloc(j.numCols * sizeof(int));
+    j.out = malloc(MAX(outLen, 1));
+
+    if(j.d == NOTOK || !j.colSide || !j.colOff || !j.colLen || !j.out)
+    {
+        if(j.d != NOTOK)
+            db_err_code = MEM_ALLOC_ERROR;
+        rc = NOTOK;
+    }
+
+    /* The columns of the result, as JoinAttrList() lists them: all of R1, then R2 without its join attribute */
+    int c = 0;
+
+    for(int s = 0; rc == OK && s < 2; s++)
+    {
+        for(AttrDesc *p = catcache[j.r[s]].attrList; p; p = p->next)
+        {
+            if(s == 1 && p == ad2)
+                continue;
+            j.colSide[c] = s;
+            j.colOff[c] = p->attr.offset;
+            j.colLen[c++] = p->attr.length;
+        }
+    }
+
+    if(rc == OK)
+    {
+        switch(plan->method)
+        {
+            case JOIN_HASH:      rc = joinHash(&j, plan->swap);                                     break;
+            case JOIN_INL:       rc = joinIndexNL(&j, plan->swap);                                  break;
+            case JOIN_SORTMERGE: rc = joinSortMerge(&j, dstRelName);                                break;
+            case JOIN_BNL:       rc = joinBlockNL(&j, plan->swap, MAX(JOIN_MEM_BYTES / j.recLen[plan->swap], 1)); break;
+            default:             rc = joinBlockNL(&j, plan->swap, 1);
+        }
+    }
+
+    free(j.colSide);
+    free(j.colOff);
+    free(j.colLen);
+    free(j.out);
+
+    if(rc == NOTOK)
+        return NOTOK;
+
+    UnPinRel(j.d);
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION Join (argc, argv)
+
+PARAMETER DESCRIPTION:
+    argc → number of command-line arguments.
+    argv → pointer to array of argument strings.
+    Specifications:
+        argv[0] = "join"
+        argv[1] = name of destination relation to be created, or "as" followed by the name of a view to define
+        argv[2] = name of first source relation (R1)
+        argv[3] = join attribute of R1
+        argv[4] = name of second source relation (R2)
+        argv[5] = join attribute of R2
+        argv[argc] = NIL
+
+FUNCTION DESCRIPTION:
+    The routine performs an equi-join of two relations R1 and R2 on the specified attributes, producing a new relation with schema:
+        (all attributes of R1)  ⨝  (all attributes of R2 except the join attribute)
+    Rules and requirements:
+        • Both relations must exist.
+        • Join attributes must exist in their respective relations.
+        • Join attributes must have the same type.
+        • Destination relation must NOT already exist.
+        • Result relation schema is built by combining schemas of R1 and R2.
+        • Attribute name conflicts (excluding the join attribute) from R2 are resolved by renaming to attr_R2.
+        • All matching tuple pairs (t1, t2) with t1.attrName1 == t2.attrName2 are inserted into the new relation.
+
+ALGORITHM:
+    1) Validate database state (DB must be open).
+    2) Parse argument strings:
+        dstRelName, src1RelName, attrName1, src2RelName, attrName2.
+    3) Open both source relations R1 and R2.
+        If either fails, report RELNOEXIST.
+    4) Confirm that destination relation does NOT already exist.
+    5) Look up attribute descriptors:
+        attrName1 in R1,
+        attrName2 in R2.
+        If either does NOT exist, report ATTRNOEXIST.
+    6) Verify that join attributes have identical types, and for numbers and dates identical widths.
+        If not, report INCOMPATIBLE_TYPES.
+    7) Build the result schema:
+        a) Copy attribute descriptors of R1 entirely.
+        b) Copy attributes of R2 except join attribute.
+        c) If an attribute name from R2 duplicates one in R1, rename as "<attr>_<src2RelName>".
+    8) Choose the join method with PlanJoinMethod() and create the destination relation with the combined attribute list:
+        • hash join building R2: fill it with IterMaterialize() from the batched hash join of PlanJoin():
+            a) R2 is read into a hash table on attrName2, in its record order.
+            b) R1 is read a batch of pages at a time; the keys of a batch are hashed together and each
+               R1 record is matched against its bucket with compareVals().
+            c) Joined rows are assembled a column at a time and inserted in R1 order, then R2 order.
+        • any other plan: fill it with the executor of that method (joinRun()): hash join building R1, index
+          nested loop, sort-merge, block nested loop or nested loop join.
+    9) Print success message.
+
+BUGS:
+    None found.
+
+ERRORS REPORTED:
+    DBNOTOPEN           → database is closed
+    RELNOEXIST          → either source relation does not exist
+    RELEXIST            → destination relation already exists
+    ATTRNOEXIST         → join attribute not found
+    INCOMPATIBLE_TYPES  → join attributes' types (or numeric widths) differ
+    MEM_ALLOC_ERROR     → memory allocation failure
+    OTHER errors raised by: OpenRel(), FindRec(), InsertRec(), CreateFromAttrList(), compareVals(), etc.
+
+GLOBAL VARIABLES MODIFIED:
+      db_err_code
+      catcache[] entries (via schema creation and relation opening)
+
+IMPLEMENTATION NOTES:
+    • The planner takes the hash join building R2 on equal costs, the join of earlier versions: a hash join over column
+      batches (algebra/iterator.c) whose output order is that of the tuple-at-a-time nested loop.  The output order of
+      the other methods follows the method: probe side, outer side, or key order for sort-merge.
+    • Float join attributes compare with a tolerance, so the planner never hashes them nor looks them up in an index.
+    • "explain join ..." prints the estimates and the plan without evaluating the join (Explain()).
+    • Performs safe attribute renaming for R2 to avoid collisions.
+    • Destination schema creation must precede record insertion.
+    • The join inserts records in physical order encountered.
+    • "join as V ..." only records the view (ViewDefine()). If either source is a view, the join is evaluated by the
+      pipelined operators (PlanJoin(), same schema and order) and only the result is written, by IterMaterialize().
+
+------------------------------------------------------------*/
+
+int Join(int argc, char **argv)
+{
+    if (!db_open)
+    {
+        db_err_code = DBNOTOPEN;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if (strcmp(argv[1], "as") == OK)
+    {
+        return ViewDefine(PlanJoin, argc - 1, argv + 1);
+    }
+
+    char *dstRelName = argv[1];
+    char *src1RelName = argv[2];
+    char *attrName1   = argv[3];
+    char *src2RelName = argv[4];
+    char *attrName2   = argv[5];
+
+    if (ViewFind(src1RelName) || ViewFind(src2RelName))
+    {
+        if (IterMaterialize(PlanJoin(argc, argv), dstRelName) == NOTOK)
+        {
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+
+        printf("Join of relations %s and %s into %s successfully performed.\n",
+               src1RelName, src2RelName, dstRelName);
+        return OK;
+    }
+
+    int s1 = OpenRel(src1RelName);
+    int s2 = OpenRel(src2RelName);
+
+    if (s1 == NOTOK)
+    {
+        if(db_err_code == RELNOEXIST)
+        {
+            printf("Relation '%s' does NOT exist in the DB.\n", src1RelName);
+            printCloseStrings(RELCAT_CACHE, offsetof(RelCatRec, relName), src1RelName, NULL);
+        }
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if (s2 == NOTOK)
+    {
+        if(db_err_code == RELNOEXIST)
+        {
+            printf("Relation '%s' does NOT exist in the DB.\n", src2RelName);
+            printCloseStrings(RELCAT_CACHE, offsetof(RelCatRec, relName), src2RelName, NULL);
+        }
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    int d = FindRel(dstRelName) || ViewFind(dstRelName);
+    if (d)
+    {
+        printf("Relation '%s' already exists in the DB.\n", dstRelName);
+        db_err_code = RELEXIST;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    AttrDesc *ad1 = FindRelAttr(s1, attrName1);
+    AttrDesc *ad2 = FindRelAttr(s2, attrName2);
+
+    if (!ad1)
+    {
+        printf("Attribute '%s' NOT present in relation '%s' of the DB.\n", src1RelName, attrName1);
+        printCloseStrings(ATTRCAT_CACHE, offsetof(AttrCatRec, attrName), attrName1, src1RelName);
+        db_err_code = ATTRNOEXIST;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if (!ad2)
+    {
+        printf("Attribute '%s' NOT present in relation '%s' of the DB.\n", src2RelName, attrName2);
+        printCloseStrings(ATTRCAT_CACHE, offsetof(AttrCatRec, attrName), attrName2, src2RelName);
+        db_err_code = ATTRNOEXIST;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    char t1 = (ad1->attr).type[0];
+    char t2 = (ad2->attr).type[0];
+
+    if (t1 != t2)
+    {
+        printf("Type '%c' of '%s.%s' incompatible with '%c' of '%s.%s'.\n",
+               t1, src1RelName, attrName1, t2, src2RelName, attrName2);
+        db_err_code = INCOMPATIBLE_TYPES;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if (t1 != 's' && ad1->attr.length != ad2->attr.length)
+    {
+        printf("Width %d of '%s.%s' incompatible with width %d of '%s.%s'.\n",
+               ad1->attr.length, src1RelName, attrName1, ad2->attr.length, src2RelName, attrName2);
+        db_err_code = INCOMPATIBLE_TYPES;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    JoinPlan plan;
+
+    PlanJoinMethod(s1, ad1, s2, ad2, &plan);
+
+    if (plan.method == JOIN_HASH && !plan.swap)
+    {
+        if (IterMaterialize(PlanJoin(argc, argv), dstRelName) == NOTOK)
+        {
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+    }
+    else if (joinRun(s1, ad1, s2, ad2, dstRelName, &plan) == NOTOK)
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
 
-    free(recPtr1); free(recPtr2);
     UnPinRel(s1);
     UnPinRel(s2);
-    UnPinRel(d);
     printf("Join of relations %s and %s into %s successfully performed.\n",
            src1RelName, src2RelName, dstRelName);
     return OK;
@@ -0,0 +1,878 @@
+/************************INCLUDES*******************************/
+
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/helpers.h"
+#include "../include/openrel.h"
+#include "../include/findrelattr.h"
+#include "../include/unpinrel.h"
+#include "../include/idxmaint.h"
+#include "../include/bitmapidx.h"
+#include "../include/zonemap.h"
+#include "../include/stats.h"
+#include "../include/view.h"
+#include "../include/planner.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * Cost-based planning of select, delete and join.
+ *
+ * Costs are counted in page reads, plus PLAN_CPU_REC for every record handled and PLAN_CPU_CMP for
+ * every key comparison.  Selectivities and distinct counts come from the statistics of an analyzed
+ * relation (physical/stats.c), else from nKeys in attrcat, else from the System R defaults.
+ *
+ * A select or delete reads its relation by one of three access paths: every page, FindRec() skipping
+ * the pages that the zone map of one conjunct rules out (counted exactly from the zone map), or the
+ * Rids an index gives for one conjunct, or for the AND of the bitmaps of several.  A join is evaluated by the cheapest of hash, index nested loop,
+ * sort-merge, block nested loop and nested loop join, each with its cheaper assignment of the two sides.
+ */
+
+
+/* Default selectivities (System R) used while neither statistics nor an index describe an attribute */
+#define SEL_EQ_DEFAULT      0.1
+#define SEL_RANGE_DEFAULT   (1.0 / 3.0)
+
+static const char *accessNames[ACCESS_METHODS] = {"full scan", "zone-map scan", "index scan", "bitmap and scan"};
+static const char *joinNames[JOIN_METHODS] = {"hash", "index nested loop", "sort-merge", "block nested loop", "nested loop"};
+
+
+/*------------------------------------------------------------
+
+FUNCTION estimateConjunct (c)
+
+PARAMETER DESCRIPTION:
+    c → conjunct whose attrDesc, attr, compOp and valuePtr are set.
+
+FUNCTION DESCRIPTION:
+    Fills in c->sel and c->rank.
+    An analyzed relation has its selectivity read off the histogram of the attribute (StatsSelectivity()).
+    Otherwise equality selects one distinct value out of nKeys when the catalog knows it, SEL_EQ_DEFAULT otherwise;
+    '!=' is its complement and the range operators select SEL_RANGE_DEFAULT.
+    The cost of one evaluation grows with the width of the compared value (ints are cheapest, then floats
+    whose comparison honours a tolerance, then strings by length), and conjuncts are ranked by cost / (1 - sel),
+    so a cheap conjunct that rejects most records runs first.
+
+RETURNS:
+    None.
+
+------------------------------------------------------------*/
+
+static void estimateConjunct(Conjunct *c, int relNum)
+{
+    double eq = SEL_EQ_DEFAULT;
+
+    if(c->attr->nKeys > 0)
+    {
+        eq = 1.0 / c->attr->nKeys;
+    }
+
+    if(StatsSelectivity(relNum, c->attrDesc, c->valuePtr, c->compOp, &c->sel) == NOTOK)
+    {
+        switch(c->compOp)
+        {
+            case CMP_EQ: c->sel = eq;                   break;
+            case CMP_NE: c->sel = 1.0 - eq;             break;
+            default:     c->sel = SEL_RANGE_DEFAULT;
+        }
+    }
+
+    double cost;
+
+    switch(c->attr->type[0])
+    {
+        case 'i':
+        case 'd': cost = 1.0;                               break;
+        case 'f': cost = 2.0;                               break;
+        default:  cost = 1.0 + c->attr->length / 8.0;
+    }
+
+    c->rank = c->sel >= 1.0 ? cost * 1e9 : cost / (1.0 - c->sel);
+}
+
+
+/* qsort() comparator ordering conjuncts by rank */
+static int conjRankCmp(const void *a, const void *b)
+{
+    double x = ((const Conjunct *)a)->rank, y = ((const Conjunct *)b)->rank;
+    return (x > y) - (x < y);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ConjResolve (relNum, relName, numConj, args, conjOut)
+
+PARAMETER DESCRIPTION:
+    relNum  → open relation the predicate applies to.
+    relName → its name, for messages.
+    numConj → number of conjuncts.
+    args    → args[3k], args[3k + 1], args[3k + 2]: attribute name, CMP_* code and literal of the k-th conjunct.
+    conjOut → (OUT) malloc'd array of numConj conjuncts in the order of args; free with ConjFree().
+
+FUNCTION DESCRIPTION:
+    Resolves the attributes and operators of a conjunction and allocates the buffers of its literals, which
+    ConjBind() fills.  A prepared statement resolves once and binds at every execution.
+
+RETURNS:
+    OK, or NOTOK with db_err_code set and the message printed.
+
+ERRORS REPORTED:
+    ATTRNOEXIST
+    MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+int ConjResolve(int relNum, const char *relName, int numConj, char **args, Conjunct **conjOut)
+{
+    Conjunct *conj = calloc(numConj, sizeof(Conjunct));
+
+    if(!conj)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    for(int k = 0; k < numConj; k++)
+    {
+        char *attrName = args[3 * k];
+        AttrDesc *foundField = FindRelAttr(relNum, attrName);
+
+        if(!foundField)
+        {
+            printf("Attribute '%s' NOT present in relation '%s' of the DB.\n", attrName, relName);
+            printCloseStrings(ATTRCAT_CACHE, offsetof(AttrCatRec, attrName), attrName, (char *)relName);
+            ConjFree(conj, numConj);
+            db_err_code = ATTRNOEXIST;
+            return NOTOK;
+        }
+
+        conj[k].arg = k;
+        conj[k].attrDesc = foundField;
+        conj[k].attr = &(foundField->attr);
+        conj[k].compOp = *(int *)(args[3 * k + 1]);
+        conj[k].valuePtr = malloc(conj[k].attr->length);
+
+        if(!conj[k].valuePtr)
+        {
+            ConjFree(conj, numConj);
+            db_err_code = MEM_ALLOC_ERROR;
+            return NOTOK;
+        }
+    }
+
+    *conjOut = conj;
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ConjBind (relNum, conj, numConj, args)
+
+PARAMETER DESCRIPTION:
+    relNum  → relation the conjuncts were resolved on.
+    conj    → conjuncts of ConjResolve(), in any order.
+    numConj → number of conjuncts.
+    args    → arguments laid out as for ConjResolve(); the literal of conj[i] is args[3 * conj[i].arg + 2].
+
+FUNCTION DESCRIPTION:
+    Converts the literals to the attribute types, compiles every conjunct with PredInit(), estimates it
+    (estimateConjunct()) and sorts the conjuncts by increasing rank.
+
+RETURNS:
+    OK, or NOTOK with db_err_code set and the message printed.
+
+ERRORS REPORTED:
+    INVALID_VALUE
+
+------------------------------------------------------------*/
+
+int ConjBind(int relNum, Conjunct *conj, int numConj, char **args)
+{
+    for(int k = 0; k < numConj; k++)
+    {
+        char *value = args[3 * conj[k].arg + 2];
+        char type = conj[k].attr->type[0];
+
+        if(!isValidForType(type, conj[k].attr->length, value, conj[k].valuePtr))
+        {
+            printf("'%s' is an INVALID literal for TYPE %s.\n",
+            value, typeName(type));
+            db_err_code = INVALID_VALUE;
+            return NOTOK;
+        }
+
+        PredInit(&conj[k].pred, type, conj[k].attr->length, conj[k].attr->offset, conj[k].valuePtr, conj[k].compOp);
+        estimateConjunct(&conj[k], relNum);
+    }
+
+    qsort(conj, numConj, sizeof(Conjunct), conjRankCmp);
+    return OK;
+}
+
+
+/* ConjResolve() then ConjBind(): the conjunction of a select or delete, ready to evaluate */
+int ConjBuild(int relNum, const char *relName, int numConj, char **args, Conjunct **conjOut)
+{
+    if(ConjResolve(relNum, relName, numConj, args, conjOut) == NOTOK)
+        return NOTOK;
+
+    if(ConjBind(relNum, *conjOut, numConj, args) == NOTOK)
+    {
+        ConjFree(*conjOut, numConj);
+        return NOTOK;
+    }
+    return OK;
+}
+
+
+/* Frees the literal buffers of the conjuncts and the array itself */
+void ConjFree(Conjunct *conj, int numConj)
+{
+    for(int i = 0; i < numConj; i++)
+        free(conj[i].valuePtr);
+    free(conj);
+}
+
+
+/* True when recPtr satisfies every conjunct but conj[skip], in rank order; stops at the first one that fails */
+bool ConjMatch(const void *recPtr, Conjunct *conj, int numConj, int skip)
+{
+    for(int i = 0; i < numConj; i++)
+    {
+        if(i != skip && !PredEval(&conj[i].pred, recPtr))
+            return false;
+    }
+    return true;
+}
+
+
+/* x^n for n >= 0, by squaring: MINIREL is not linked with libm */
+static double powInt(double x, double n)
+{
+    double r = 1;
+
+    for(long long e = (long long)(n + 0.5); e > 0; e >>= 1, x *= x)
+    {
+        if(e & 1)
+            r *= x;
+    }
+    return r;
+}
+
+/* log2(x) for x >= 1, to a tenth */
+static double log2Approx(double x)
+{
+    double l = 0;
+
+    for(; x >= 2; x /= 2)
+        l++;
+    return l + (x - 1);
+}
+
+/* Pages holding k records chosen at random among pages (Cardenas' formula) */
+static double pagesTouched(double pages, double k)
+{
+    if(pages <= 1)
+        return MIN(pages, k);
+    return pages * (1 - powInt(1 - 1 / pages, k));
+}
+
+/* Page reads of one lookup of an index of the given kind selecting the fraction sel of the records */
+static double indexProbeCost(const AttrCatRec *attr, int kind, double sel)
+{
+    double pages = MAX(attr->nPages, 1);
+
+    if(kind == IDX_HASH)
+        return 2;
+    if(kind == IDX_BITMAP)
+        return pages;
+
+    /* B+-tree: the inner levels, then the leaves holding the matching keys */
+    double fanout = PAGESIZE / (double)(attr->length + sizeof(int));
+    double height = 1;
+
+    for(double span = fanout; span < pages; span *= fanout)
+        height++;
+    return height + sel * pages;
+}
+
+
+/* Whether the conjunct is answered by a bitmap index, and so can take part in a bitmap AND scan */
+static bool bitmapAnswers(const Conjunct *c)
+{
+    return (c->compOp == CMP_EQ || c->compOp == CMP_NE) && (c->attr->hasIndex & IDX_BITMAP);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PlanAccess (relNum, conj, numConj, plan)
+
+PARAMETER DESCRIPTION:
+    relNum  → open heap relation.
+    conj    → conjunction, in rank order (ConjBuild()).
+    numConj → number of conjuncts, at least 1.
+    plan    → (OUT) the access paths and the one chosen.
+
+FUNCTION DESCRIPTION:
+    Costs the three access paths of a conjunction and chooses the cheapest.
+        • Full scan: every page, and every record evaluated.  FindRec() is driven by the first ranked conjunct.
+        • Zone-map scan: FindRec() driven by the conjunct whose zone map leaves the fewest pages to read; the pages
+          are counted with ZoneMapCanSkip().  Only offered when it skips at least one page.
+        • Index scan: the conjunct an index answers (IndexAnswers()) with the cheapest lookup plus Rid fetches, the
+          pages fetched being estimated with Cardenas' formula from the records it selects.  An equality whose value
+          the Bloom filter of its attribute rules out (IndexRulesOut()) is an index scan of cost 1 that selects nothing.
+        • Bitmap AND scan: when two or more '=' or '!=' conjuncts have bitmap indexes, the AND of all their bitmaps,
+          costed as reading every bitmap file plus fetching the records the conjuncts select together.
+    Conjuncts are taken as independent, so the records selected are numRecs times the product of the selectivities.
+
+------------------------------------------------------------*/
+
+void PlanAccess(int relNum, Conjunct *conj, int numConj, AccessPlan *plan)
+{
+    const RelCatRec *rc = &catcache[relNum].relcat_rec;
+    double numRecs = rc->numRecs, numPgs = rc->numPgs;
+
+    plan->rows = numRecs;
+    for(int k = 0; k < numConj; k++)
+        plan->rows *= conj[k].sel;
+
+    for(int m = 0; m < ACCESS_METHODS; m++)
+    {
+        plan->driver[m] = -1;
+        plan->pages[m] = 0;
+        plan->cost[m] = PLAN_NO_COST;
+    }
+
+    plan->driver[ACCESS_SCAN] = 0;
+    plan->pages[ACCESS_SCAN] = numPgs;
+    plan->cost[ACCESS_SCAN] = numPgs + numRecs * PLAN_CPU_REC;
+
+    for(int k = 0; k < numConj; k++)
+    {
+        const AttrCatRec *attr = conj[k].attr;
+        double pages = 0;
+
+        for(int pid = 0; pid < rc->numPgs; pid++)
+        {
+            if(!ZoneMapCanSkip(relNum, pid, attr->type[0], attr->length, attr->offset, conj[k].valuePtr, conj[k].compOp))
+                pages++;
+        }
+
+        double cost = pages + (numPgs > 0 ? numRecs * pages / numPgs : 0) * PLAN_CPU_REC;
+
+        if(pages < numPgs && cost < plan->cost[ACCESS_ZONEMAP])
+        {
+            plan->driver[ACCESS_ZONEMAP] = k;
+            plan->pages[ACCESS_ZONEMAP] = pages;
+            plan->cost[ACCESS_ZONEMAP] = cost;
+        }
+
+        /* A value the Bloom filter rules out selects nothing, at the price of reading the filter */
+        if(IndexRulesOut(relNum, attr, conj[k].valuePtr, conj[k].compOp))
+        {
+            conj[k].sel = 0;
+            plan->rows = 0;
+            plan->driver[ACCESS_INDEX] = k;
+            plan->pages[ACCESS_INDEX] = 1;
+            plan->cost[ACCESS_INDEX] = 1;
+            break;
+        }
+
+        int kind = IndexAnswers(attr, conj[k].compOp);
+
+        if(!kind)
+            continue;
+
+        double matches = conj[k].sel * numRecs;
+        double fetched = pagesTouched(numPgs, matches);
+        double probe = indexProbeCost(attr, kind, conj[k].sel);
+
+        cost = probe + fetched + matches * (PLAN_CPU_REC + log2Approx(matches + 1) * PLAN_CPU_CMP);
+
+        if(cost < plan->cost[ACCESS_INDEX])
+        {
+            plan->driver[ACCESS_INDEX] = k;
+            plan->pages[ACCESS_INDEX] = probe + fetched;
+            plan->cost[ACCESS_INDEX] = cost;
+        }
+    }
+
+    /* Every bitmap is read once; the records fetched are those of all the conjuncts together */
+    double probe = 0, sel = 1;
+    int numBitmaps = 0;
+
+    for(int k = 0; k < numConj && plan->rows > 0; k++)
+    {
+        if(bitmapAnswers(&conj[k]))
+        {
+            if(numBitmaps++ == 0)
+                plan->driver[ACCESS_BITMAP] = k;
+            probe += indexProbeCost(conj[k].attr, IDX_BITMAP, conj[k].sel);
+            sel *= conj[k].sel;
+        }
+    }
+
+    if(numBitmaps > 1)
+    {
+        double matches = sel * numRecs;
+        double fetched = pagesTouched(numPgs, matches);
+
+        plan->pages[ACCESS_BITMAP] = probe + fetched;
+        plan->cost[ACCESS_BITMAP] = probe + fetched + matches * (PLAN_CPU_REC + log2Approx(matches + 1) * PLAN_CPU_CMP);
+    }
+    else
+    {
+        plan->driver[ACCESS_BITMAP] = -1;
+    }
+
+    plan->method = ACCESS_SCAN;
+    for(int m = ACCESS_SCAN + 1; m < ACCESS_METHODS; m++)
+    {
+        if(plan->cost[m] < plan->cost[plan->method])
+            plan->method = m;
+    }
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PlanFindRids (relNum, conj, numConj, plan, rids, numRids)
+
+PARAMETER DESCRIPTION:
+    relNum  → open heap relation.
+    conj    → conjunction the plan was made for, bound to its literals.
+    numConj → number of conjuncts.
+    plan    → access path chosen by PlanAccess().
+    rids    → (OUT) malloc'd array of candidate Rids; the caller frees it.
+    numRids → (OUT) number of candidate Rids.
+
+FUNCTION DESCRIPTION:
+    Gives the candidate records of an index access path.
+    An index scan asks FindRidsByIndex() for the driving conjunct.  A bitmap AND scan reads the bitmap of every '='
+    or '!=' conjunct with a bitmap index (FindBitmapByIndex()), ANDs them (WahAnd()) and turns the result into Rids
+    (WahToRids()), so only records satisfying all of those conjuncts are fetched.
+    The candidates must still be checked against the whole conjunction (ConjMatch()).
+
+RETURNS:
+    1     → rids/numRids hold the candidates.
+    0     → the plan is not an index path, or its index files are gone; the caller must scan.
+    NOTOK → an index could not be read (db_err_code set).
+
+------------------------------------------------------------*/
+
+int PlanFindRids(int relNum, Conjunct *conj, int numConj, const AccessPlan *plan, Rid **rids, int *numRids)
+{
+    *rids = NULL;
+    *numRids = 0;
+
+    if(plan->method == ACCESS_INDEX)
+    {
+        int d = plan->driver[ACCESS_INDEX];
+        return FindRidsByIndex(relNum, conj[d].attr, conj[d].valuePtr, conj[d].compOp, rids, numRids);
+    }
+
+    if(plan->method != ACCESS_BITMAP)
+        return 0;
+
+    WahBitmap acc, bm, out;
+    int recsPerPg = 0, have = 0, rc = OK;
+
+    WahInit(&acc);
+    for(int k = 0; rc == OK && k < numConj; k++)
+    {
+        int found = FindBitmapByIndex(relNum, conj[k].attr, conj[k].valuePtr, conj[k].compOp, &bm, &recsPerPg);
+
+        if(found == NOTOK)
+        {
+            rc = NOTOK;
+        }
+        else if(found && !have)
+        {
+            acc = bm;
+            have = 1;
+        }
+        else if(found)
+        {
+            rc = WahAnd(&acc, &bm, &out);
+            WahFree(&bm);
+            WahFree(&acc);
+            acc = out;
+        }
+    }
+
+    if(rc == OK && have)
+        rc = WahToRids(&acc, recsPerPg, rids, numRids);
+    WahFree(&acc);
+
+    return rc == NOTOK ? NOTOK : have;
+}
+
+
+/* Distinct values of a join attribute: analyzed, else nKeys, else every record taken as distinct */
+static double joinDistinct(int relNum, AttrDesc *ad)
+{
+    const AttrStats *s = StatsGet(relNum, ad);
+
+    if(s && s->numDistinct > 0)
+        return s->numDistinct;
+    if(ad->attr.nKeys > 0)
+        return ad->attr.nKeys;
+    return MAX(catcache[relNum].relcat_rec.numRecs, 1);
+}
+
+/* Reads, record copies and comparisons of sorting a relation on its join attribute with the external sort */
+static double sortCost(double pages, double recs)
+{
+    double io = pages * PAGESIZE > SORT_MEM_BYTES ? 2 * pages : 0;
+
+    return pages + io + recs * (2 * PLAN_CPU_REC + log2Approx(recs + 1) * PLAN_CPU_CMP);
+}
+
+/* Records the cost of a method for one assignment of the sides when it beats the other one */
+static void joinOffer(JoinPlan *plan, int method, int swap, double cost)
+{
+    if(cost < plan->cost[method])
+    {
+        plan->cost[method] = cost;
+        plan->costSwap[method] = swap;
+    }
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PlanJoinMethod (r1, ad1, r2, ad2, plan)
+
+PARAMETER DESCRIPTION:
+    r1, ad1 → left heap relation and its join attribute.
+    r2, ad2 → right heap relation and its join attribute.
+    plan    → (OUT) the cost of every method and the one chosen.
+
+FUNCTION DESCRIPTION:
+    Estimates the size of the equi-join as rows1 * rows2 / max(distinct1, distinct2) and costs every method with both
+    assignments of the sides, o being the outer (or probe) side and i the inner (or build) side:
+        • hash:               Pi + Po, records of i inserted at 2 * PLAN_CPU_REC, of o probed at PLAN_CPU_REC.  Only when
+                              the build side fits in JOIN_MEM_BYTES and the keys are not floats, which compare with a tolerance.
+        • index nested loop:  Po + Ro * (index lookup + pages fetched for Ri / distinct_i matches).  Only with an index of i
+                              answering equality (IndexAnswers()), and keys that are not floats.
+        • sort-merge:         the sort of both sides (in memory or one merge pass of the external sort), each record copied
+                              in and out of the sort, plus the merge.
+        • block nested loop:  Po + Pi per block of JOIN_MEM_BYTES of o, and Ro * Ri comparisons.
+        • nested loop:        Po + Ro * Pi, and Ro * Ri comparisons.
+    The cheapest plan is chosen; on equal costs the method listed first, and the right relation as the build or inner side,
+    as before the planner existed.
+
+------------------------------------------------------------*/
+
+void PlanJoinMethod(int r1, AttrDesc *ad1, int r2, AttrDesc *ad2, JoinPlan *plan)
+{
+    const RelCatRec *rc1 = &catcache[r1].relcat_rec, *rc2 = &catcache[r2].relcat_rec;
+    double rows[2], pages[2], distinct[2], recLen[2];
+    AttrDesc *ad[2] = {ad1, ad2};
+
+    rows[0] = plan->rows1 = rc1->numRecs;
+    rows[1] = plan->rows2 = rc2->numRecs;
+    pages[0] = plan->pages1 = rc1->numPgs;
+    pages[1] = plan->pages2 = rc2->numPgs;
+    distinct[0] = plan->distinct1 = joinDistinct(r1, ad1);
+    distinct[1] = plan->distinct2 = joinDistinct(r2, ad2);
+    recLen[0] = rc1->recLength;
+    recLen[1] = rc2->recLength;
+    plan->rows = rows[0] * rows[1] / MAX(MAX(distinct[0], distinct[1]), 1);
+
+    for(int m = 0; m < JOIN_METHODS; m++)
+    {
+        plan->cost[m] = PLAN_NO_COST;
+        plan->costSwap[m] = 0;
+    }
+
+    int isFloat = ad1->attr.type[0] == 'f';
+    double output = plan->rows * PLAN_CPU_REC;
+
+    /* swap 0: the left relation is outer or probe side (o = 0, i = 1); swap 1: the reverse */
+    for(int swap = 0; swap < 2; swap++)
+    {
+        int o = swap, i = 1 - swap;
+        double comparisons = rows[o] * rows[i] * PLAN_CPU_CMP;
+
+        if(!isFloat && rows[i] * recLen[i] <= JOIN_MEM_BYTES)
+        {
+            joinOffer(plan, JOIN_HASH, swap, pages[i] + pages[o] + rows[i] * 2 * PLAN_CPU_REC +
+                      rows[o] * PLAN_CPU_REC + plan->rows * PLAN_CPU_CMP + output);
+        }
+
+        int kind = isFloat ? 0 : IndexAnswers(&ad[i]->attr, CMP_EQ);
+
+        if(kind)
+        {
+            double matches = rows[i] / MAX(distinct[i], 1);
+            double lookup = indexProbeCost(&ad[i]->attr, kind, 1 / MAX(distinct[i], 1)) + pagesTouched(pages[i], matches);
+
+            joinOffer(plan, JOIN_INL, swap, pages[o] + rows[o] * (lookup + matches * PLAN_CPU_CMP + PLAN_CPU_REC) + output);
+        }
+
+        double blocks = rows[o] * recLen[o] / JOIN_MEM_BYTES;
+
+        joinOffer(plan, JOIN_BNL, swap, pages[o] + MAX(1, blocks + 0.999) * pages[i] + comparisons + output);
+        joinOffer(plan, JOIN_NL, swap, pages[o] + rows[o] * pages[i] + comparisons + output);
+    }
+
+    joinOffer(plan, JOIN_SORTMERGE, 0, sortCost(pages[0], rows[0]) + sortCost(pages[1], rows[1]) +
+              (rows[0] + rows[1] + plan->rows) * PLAN_CPU_CMP + output);
+
+    plan->method = JOIN_HASH;
+    for(int m = 1; m < JOIN_METHODS; m++)
+    {
+        if(plan->cost[m] < plan->cost[plan->method])
+            plan->method = m;
+    }
+    plan->swap = plan->costSwap[plan->method];
+    plan->total = plan->cost[plan->method];
+}
+
+
+/* Text of a CMP_* operator */
+static const char *compOpName(int compOp)
+{
+    switch(compOp)
+    {
+        case CMP_EQ:  return "=";
+        case CMP_NE:  return "!=";
+        case CMP_LT:  return "<";
+        case CMP_LTE: return "<=";
+        case CMP_GT:  return ">";
+        default:      return ">=";
+    }
+}
+
+/* Prints a cost, or "n/a" for a method that does not apply */
+static void printCost(const char *name, double cost)
+{
+    if(cost >= PLAN_NO_COST)
+        printf("  %-22s %12s\n", name, "n/a");
+    else
+        printf("  %-22s %12.2f\n", name, cost);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION explainAccess (verb, relName, numConj, args)
+
+FUNCTION DESCRIPTION:
+    Prints the conjuncts of a select or delete on relName with their selectivities, the cost of every access path
+    and the one PlanAccess() chooses.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+------------------------------------------------------------*/
+
+static int explainAccess(const char *verb, char *relName, int numConj, char **args)
+{
+    if(ViewFind(relName))
+    {
+        printf("%s on view %s: evaluated by the pipelined operators, without indexes.\n", verb, relName);
+        return OK;
+    }
+
+    int r = OpenRel(relName);
+
+    if(r == NOTOK)
+    {
+        if(db_err_code == RELNOEXIST)
+        {
+            printf("Relation '%s' does NOT exist in the DB.\n", relName);
+            printCloseStrings(RELCAT_CACHE, offsetof(RelCatRec, relName), relName, NULL);
+        }
+        return NOTOK;
+    }
+
+    Conjunct *conj;
+    AccessPlan plan;
+
+    if(ConjBuild(r, relName, numConj, args, &conj) == NOTOK)
+        return NOTOK;
+
+    PlanAccess(r, conj, numConj, &plan);
+
+    const RelCatRec *rc = &catcache[r].relcat_rec;
+
+    printf("%s on %s: %d records in %d pages%s\n", verb, relName, rc->numRecs, rc->numPgs,
+    catcache[r].stats ? "" : " (not analyzed)");
+
+    for(int k = 0; k < numConj; k++)
+    {
+        printf("  %s %s %s: selectivity %.4f\n", conj[k].attr->attrName, compOpName(conj[k].compOp),
+        args[3 * conj[k].arg + 2], conj[k].sel);
+    }
+
+    for(int m = 0; m < ACCESS_METHODS; m++)
+        printCost(accessNames[m], plan.cost[m]);
+
+    int d = plan.driver[plan.method];
+
+    printf("Plan: %s", accessNames[plan.method]);
+    if(plan.method == ACCESS_BITMAP)
+    {
+        for(int k = 0, n = 0; k < numConj; k++)
+        {
+            if(bitmapAnswers(&conj[k]))
+                printf("%s %s %s", n++ ? " and" : " on", conj[k].attr->attrName, compOpName(conj[k].compOp));
+        }
+    }
+    else if(plan.method != ACCESS_SCAN)
+        printf(" on %s %s", conj[d].attr->attrName, compOpName(conj[d].compOp));
+    printf(", about %.0f pages read, %.0f records selected\n", plan.pages[plan.method], plan.rows);
+
+    ConjFree(conj, numConj);
+    UnPinRel(r);
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION explainJoin (argv)
+
+FUNCTION DESCRIPTION:
+    Prints the estimates of a join of two heap relations, the cost of every method and the plan PlanJoinMethod()
+    chooses.  A join reading a view is evaluated by the pipelined hash join.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+------------------------------------------------------------*/
+
+static int explainJoin(char **argv)
+{
+    char *src1 = argv[2], *attrName1 = argv[3], *src2 = argv[4], *attrName2 = argv[5];
+
+    if(ViewFind(src1) || ViewFind(src2))
+    {
+        printf("Join of %s and %s reads a view: evaluated by the pipelined hash join, building %s.\n", src1, src2, src2);
+        return OK;
+    }
+
+    int r1 = OpenRel(src1);
+    int r2 = r1 == NOTOK ? NOTOK : OpenRel(src2);
+
+    if(r1 == NOTOK || r2 == NOTOK)
+    {
+        if(db_err_code == RELNOEXIST)
+            printf("Relation '%s' does NOT exist in the DB.\n", r1 == NOTOK ? src1 : src2);
+        return NOTOK;
+    }
+
+    AttrDesc *ad1 = FindRelAttr(r1, attrName1);
+    AttrDesc *ad2 = FindRelAttr(r2, attrName2);
+
+    if(!ad1 || !ad2)
+    {
+        printf("Attribute '%s' NOT present in relation '%s' of the DB.\n", ad1 ? attrName2 : attrName1, ad1 ? src2 : src1);
+        db_err_code = ATTRNOEXIST;
+        return NOTOK;
+    }
+
+    if(ad1->attr.type[0] != ad2->attr.type[0] || (ad1->attr.type[0] != 's' && ad1->attr.length != ad2->attr.length))
+    {
+        printf("Join attributes '%s.%s' and '%s.%s' are incompatible.\n", src1, attrName1, src2, attrName2);
+        db_err_code = INCOMPATIBLE_TYPES;
+        return NOTOK;
+    }
+
+    JoinPlan plan;
+    char *names[2] = {src1, src2};
+
+    PlanJoinMethod(r1, ad1, r2, ad2, &plan);
+
+    printf("Join of %s and %s on %s.%s = %s.%s\n", src1, src2, src1, attrName1, src2, attrName2);
+    printf("  %-20s %10.0f records, %8.0f pages, %10.0f distinct keys\n", src1, plan.rows1, plan.pages1, plan.distinct1);
+    printf("  %-20s %10.0f records, %8.0f pages, %10.0f distinct keys\n", src2, plan.rows2, plan.pages2, plan.distinct2);
+    printf("  estimated result     %10.0f records\n", plan.rows);
+
+    for(int m = 0; m < JOIN_METHODS; m++)
+    {
+        char name[64];
+        int s = plan.costSwap[m];
+
+        if(m == JOIN_SORTMERGE || plan.cost[m] >= PLAN_NO_COST)
+            snprintf(name, sizeof(name), "%s", joinNames[m]);
+        else if(m == JOIN_HASH)
+            snprintf(name, sizeof(name), "%s, build %s", joinNames[m], names[1 - s]);
+        else
+            snprintf(name, sizeof(name), "%s, outer %s", joinNames[m], names[s]);
+        printCost(name, plan.cost[m]);
+    }
+
+    printf("Plan: %s join", joinNames[plan.method]);
+    if(plan.method == JOIN_HASH)
+        printf(", building %s and probing with %s", names[1 - plan.swap], names[plan.swap]);
+    else if(plan.method == JOIN_INL)
+        printf(", %s outer, index of %s", names[plan.swap], names[1 - plan.swap]);
+    else if(plan.method != JOIN_SORTMERGE)
+        printf(", %s outer", names[plan.swap]);
+    printf(", cost %.2f\n", plan.total);
+
+    UnPinRel(r1);
+    UnPinRel(r2);
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION Explain (argc, argv)
+
+PARAMETER DESCRIPTION:
+    argc → number of command arguments
+    argv → arguments of the select, delete or join command explained, laid out as for Select(), Delete() and Join();
+           argv[0] is the command name.
+
+FUNCTION DESCRIPTION:
+    Shows how a select, delete or join would be evaluated, without evaluating it: the estimates of the planner,
+    the cost of every alternative and the plan chosen.  Nothing is created or changed, except that a relation
+    whose statistics have drifted is analyzed again.
+
+ERRORS REPORTED:
+    DBNOTOPEN
+    RELNOEXIST
+    ATTRNOEXIST
+    INVALID_VALUE
+    INCOMPATIBLE_TYPES
+    MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+int Explain(int argc, char **argv)
+{
+    if(!db_open)
+    {
+        db_err_code = DBNOTOPEN;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    int rc;
+
+    /* "select as V ..." and "join as V ..." carry one more argument, the view name */
+    if(strcmp(argv[1], "as") == OK)
+    {
+        argc--;
+        argv++;
+    }
+
+    if(strcmp(argv[0], "delete") == OK)
+        rc = explainAccess("Delete", argv[1], (argc - 2) / 3, argv + 2);
+    else if(strcmp(argv[0], "join") == OK)
+        rc = explainJoin(argv);
+    else
+        rc = explainAccess("Select", argv[2], (argc - 3) / 3, argv + 3);
+
+    return rc == OK ? OK : ErrorMsgs(db_err_code, print_flag);
+}
\ No newline at end of file
@@ -0,0 +1,566 @@
+/************************INCLUDES*******************************/
+
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/helpers.h"
+#include "../include/openrel.h"
+#include "../include/pinrel.h"
+#include "../include/unpinrel.h"
+#include "../include/findrel.h"
+#include "../include/findrelattr.h"
+#include "../include/view.h"
+#include "../include/planner.h"
+#include "../include/select.h"
+#include "../include/insert.h"
+#include "../include/delete.h"
+#include "../include/prepare.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+/*
+ * Prepared statements: "prepare Q as <select into | insert | delete>" keeps a command in which literals, and the
+ * result relation of a select, may be parameters '?'; "execute Q (v1, v2, ...)" runs it with those values.
+ * What does not depend on the values (the relation, its attributes and the checks of the schema, the constant
+ * literals of an insert) is worked out once and kept while the relation stays in its catalog cache slot
+ * (CacheEntry.openSeq).  An execution then only converts its values, compiles the predicates for them and plans
+ * the access path, as the best path depends on the literals.
+ */
+
+static Prepared *statements = NULL;
+
+
+static bool isCommand(const Prepared *p, const char *cmd)
+{
+    return strcmp(p->argv[0], cmd) == OK;
+}
+
+/* Relation the statement reads (select) or changes (insert, delete) */
+static const char *stmtRel(const Prepared *p)
+{
+    return isCommand(p, "select") ? p->argv[2] : p->argv[1];
+}
+
+/* Argument i of cmd may be a parameter: a literal, or the result relation of a select */
+static bool paramAllowed(const char *cmd, int i)
+{
+    if(strcmp(cmd, "select") == OK)
+        return i == 1 || (i >= 5 && (i - 5) % 3 == 0);
+    if(strcmp(cmd, "delete") == OK)
+        return i >= 4 && (i - 4) % 3 == 0;
+    return i >= 3 && (i - 3) % 2 == 0;
+}
+
+static bool isParamArg(const Prepared *p, int i)
+{
+    for(int j = 0; j < p->numParams; j++)
+    {
+        if(p->paramArg[j] == i)
+            return true;
+    }
+    return false;
+}
+
+/* Stores a literal at the attribute's offset the way Insert() does; false when it is not valid for the type */
+static bool storeValue(char *record, const AttrCatRec *attr, char *value)
+{
+    char type = attr->type[0];
+
+    if(type != 's')
+        return isValidForType(type, attr->length, value, record + attr->offset);
+
+    strncpy(record + attr->offset, value, attr->length);
+    if(strlen(value) >= attr->length)
+        record[attr->offset + attr->length - 1] = '\0';
+    return true;
+}
+
+/* Forgets the resolution of the statement */
+static void stmtRelease(Prepared *p)
+{
+    if(p->conj)
+        ConjFree(p->conj, p->numConj);
+    free(p->record);
+    free(p->attrs);
+    p->conj = NULL;
+    p->numConj = 0;
+    p->record = NULL;
+    p->attrs = NULL;
+    p->relNum = NOTOK;
+}
+
+static void stmtFree(Prepared *p)
+{
+    stmtRelease(p);
+    for(int i = 0; p->argv && i < p->argc; i++)
+        free(p->argv[i]);
+    free(p->argv);
+    free(p->paramArg);
+    free(p);
+}
+
+/* Attributes of the conjuncts of a select or delete */
+static bool resolveConj(Prepared *p, int r)
+{
+    bool select = isCommand(p, "select");
+    char **args = p->argv + (select ? 3 : 2);
+    int numConj = (p->argc - (select ? 3 : 2)) / 3;
+
+    for(int k = 0; k < numConj; k++)
+    {
+        if(!FindRelAttr(r, args[3 * k]))
+            return false;
+    }
+
+    if(ConjResolve(r, stmtRel(p), numConj, args, &p->conj) == NOTOK)
+        return false;
+
+    p->numConj = numConj;
+    return true;
+}
+
+/* Attribute of every pair of an insert, checked as Insert() does, and a record holding its constant literals */
+static bool resolveInsert(Prepared *p, int r)
+{
+    int numPairs = (p->argc - 2) / 2;
+
+    if(numPairs != catcache[r].relcat_rec.numAttrs)
+        return false;
+
+    p->attrs = calloc(numPairs, sizeof(AttrDesc *));
+    p->record = calloc(catcache[r].relcat_rec.recLength, 1);
+
+    if(!p->attrs || !p->record)
+        return false;
+
+    for(int k = 0; k < numPairs; k++)
+    {
+        int i = 2 + 2 * k;
+
+        if(!(p->attrs[k] = FindRelAttr(r, p->argv[i])))
+            return false;
+
+        for(int j = 0; j < k; j++)
+        {
+            if(p->attrs[j] == p->attrs[k])
+                return false;
+        }
+
+        if(!isParamArg(p, i + 1) && !storeValue(p->record, &p->attrs[k]->attr, p->argv[i + 1]))
+            return false;
+    }
+    return true;
+}
+
+/*
+ * True when the statement is resolved on the relation as it is now cached, resolving it again if the slot was
+ * reloaded (or the relation destroyed) since.  Prints nothing: false sends the execution through Select(),
+ * Insert() or Delete(), which report what is wrong.
+ */
+static bool stmtResolve(Prepared *p)
+{
+    if(p->relNum != NOTOK && (catcache[p->relNum].status & VALID_MASK) &&
+    catcache[p->relNum].openSeq == p->openSeq)
+    {
+        return true;
+    }
+
+    stmtRelease(p);
+
+    const char *relName = stmtRel(p);
+
+    if(ViewFind(relName) || strncmp(relName, RELCAT, RELNAME) == OK ||
+    strncmp(relName, ATTRCAT, RELNAME) == OK)
+    {
+        return false;
+    }
+
+    int r = OpenRel((char *)relName);
+
+    if(r == NOTOK)
+    {
+        return false;
+    }
+
+    bool ok = isCommand(p, "insert") ? resolveInsert(p, r) : resolveConj(p, r);
+
+    UnPinRel(r);
+
+    if(!ok)
+    {
+        stmtRelease(p);
+        return false;
+    }
+
+    p->relNum = r;
+    p->openSeq = catcache[r].openSeq;
+    return true;
+}
+
+static int executeSelect(Prepared *p, char **cmd)
+{
+    char *dstRelName = cmd[1];
+
+    if(FindRel(dstRelName) || ViewFind(dstRelName))
+    {
+        printf("Relation '%s' already exists in the DB.\n", dstRelName);
+        db_err_code = RELEXIST;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if(ConjBind(p->relNum, p->conj, p->numConj, cmd + 3) == NOTOK ||
+    SelectConj(p->relNum, dstRelName, p->conj, p->numConj) == NOTOK)
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    printf("Created relation %s successfully and placed filtered tuples of %s\n", dstRelName, cmd[2]);
+    return OK;
+}
+
+static int executeDelete(Prepared *p, char **cmd)
+{
+    int recsAffected = NOTOK;
+
+    if(ConjBind(p->relNum, p->conj, p->numConj, cmd + 2) == OK)
+    {
+        recsAffected = DeleteConj(p->relNum, p->conj, p->numConj);
+    }
+
+    if(recsAffected == NOTOK)
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    printf("%d records successfully deleted from relation %s\n", recsAffected, cmd[1]);
+    return OK;
+}
+
+static int executeInsert(Prepared *p, char **cmd)
+{
+    int recLength = catcache[p->relNum].relcat_rec.recLength;
+    char *newRecord = malloc(recLength);
+
+    if(!newRecord)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    memcpy(newRecord, p->record, recLength);
+
+    for(int j = 0; j < p->numParams; j++)
+    {
+        int i = p->paramArg[j];
+        AttrCatRec *attr = &p->attrs[(i - 3) / 2]->attr;
+
+        if(!storeValue(newRecord, attr, cmd[i]))
+        {
+            free(newRecord);
+            printf("'%s' is NOT a valid %s literal.\n", cmd[i], typeName(attr->type[0]));
+            db_err_code = INVALID_VALUE;
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+    }
+
+    int rc = InsertTuple(p->relNum, newRecord, true);
+
+    free(newRecord);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION Prepare (argc, argv, isParam)
+
+PARAMETER DESCRIPTION:
+    argc    → number of arguments.
+    argv    → argument vector.
+    isParam → isParam[i] is true when argv[i] is a parameter '?'.
+
+SPECIFICATIONS:
+    argv[0] = "prepare"
+    argv[1] = name of the statement
+    argv[2 ...] = arguments of the select, insert or delete, as Select(), Insert() and Delete() take them,
+                  with "?" for each parameter
+    argv[argc] = NIL
+
+FUNCTION DESCRIPTION:
+    Keeps a select into, insert or delete under a name for the rest of the session, to be run by Execute().
+    A parameter may stand for a literal, or for the result relation of a select.  A statement prepared again
+    under the same name replaces the old one.  Nothing is checked against the catalogs here: the first
+    execution resolves the statement and reports its errors.
+
+ALGORITHM:
+    1) Check that a database is open and that the name fits in RELNAME.
+    2) Reject "select as" (a view) and any parameter that stands for something else than a literal or the
+       result relation of a select (STMT_INVALID).
+    3) Copy the command and the positions of its parameters; drop a statement of the same name and append
+       the new one to the list.
+
+ERRORS REPORTED:
+    DBNOTOPEN
+    REL_LENGTH_EXCEEDED
+    STMT_INVALID
+    MEM_ALLOC_ERROR
+
+GLOBAL VARIABLES MODIFIED:
+    db_err_code
+
+IMPLEMENTATION NOTES:
+    • Operators are int codes in their argument, so arguments are copied for at least sizeof(int) bytes, as
+      ViewDefine() does.
+
+------------------------------------------------------------*/
+
+int Prepare(int argc, char **argv, const short *isParam)
+{
+    if(!db_open)
+    {
+        db_err_code = DBNOTOPEN;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    char *name = argv[1];
+    char **cmd = argv + 2;
+    int cmdArgc = argc - 2;
+    int numParams = 0;
+
+    if(strlen(name) >= RELNAME)
+    {
+        db_err_code = REL_LENGTH_EXCEEDED;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if(strcmp(cmd[0], "select") == OK && strcmp(cmd[1], "as") == OK)
+    {
+        printf("A view CANNOT be prepared; select into a relation instead.\n");
+        db_err_code = STMT_INVALID;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    for(int i = 1; i < cmdArgc; i++)
+    {
+        if(!isParam[i + 2])
+            continue;
+
+        if(!paramAllowed(cmd[0], i))
+        {
+            printf("Parameter '?' CANNOT stand for a relation or attribute name in %s.\n", cmd[0]);
+            db_err_code = STMT_INVALID;
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+        numParams++;
+    }
+
+    Prepared *p = calloc(1, sizeof(Prepared));
+
+    if(p)
+    {
+        p->relNum = NOTOK;
+        p->argv = calloc(cmdArgc, sizeof(char *));
+        p->paramArg = calloc(numParams + 1, sizeof(int));
+    }
+
+    for(int i = 0; p && p->argv && p->paramArg && i < cmdArgc; i++)
+    {
+        size_t len = strlen(cmd[i]) + 1;
+
+        if(len < sizeof(int))
+            len = sizeof(int);
+
+        if(!(p->argv[p->argc] = malloc(len)))
+            break;
+
+        memcpy(p->argv[p->argc++], cmd[i], len);
+
+        if(isParam[i + 2])
+            p->paramArg[p->numParams++] = i;
+    }
+
+    if(!p || p->argc < cmdArgc)
+    {
+        if(p)
+            stmtFree(p);
+        db_err_code = MEM_ALLOC_ERROR;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    strcpy(p->name, name);
+
+    Prepared **link = &statements;
+
+    while(*link && strcmp((*link)->name, name) != OK)
+        link = &(*link)->next;
+
+    if(*link)
+    {
+        Prepared *old = *link;
+        *link = old->next;
+        stmtFree(old);
+    }
+
+    while(*link)
+        link = &(*link)->next;
+    *link = p;
+
+    printf("Prepared statement %s: %s with %d parameter%s.\n", name, cmd[0], numParams, numParams == 1 ? "" : "s");
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION Execute (argc, argv)
+
+PARAMETER DESCRIPTION:
+    argc → number of arguments.
+    argv → argument vector.
+
+SPECIFICATIONS:
+    argv[0] = "execute"
+    argv[1] = name of a prepared statement
+    argv[2 ...] = value of each parameter, in order
+    argv[argc] = NIL
+
+FUNCTION DESCRIPTION:
+    Runs a statement of Prepare() with the values given for its parameters.  It does what Select(), Insert()
+    or Delete() would do with the values in place of the parameters, and prints the same messages, but the
+    relation, the attributes and the constant literals are looked up once per load of the relation into the
+    catalog cache rather than at every execution.
+
+ALGORITHM:
+    1) Check that a database is open, find the statement (STMT_NOEXIST) and check that there is one value per
+       parameter (STMT_ARGS).
+    2) Build the arguments of the command with the values in place of the parameters.
+    3) If the statement is resolved on the relation as it is cached, or resolves now (stmtResolve()):
+        select → check the result relation does not exist, bind the conjuncts (ConjBind()), run SelectConj();
+        delete → bind the conjuncts, run DeleteConj();
+        insert → copy the record of constant literals, store the values, run InsertTuple().
+    4) Otherwise run Select(), Insert() or Delete() on the arguments, which reports the error.
+
+ERRORS REPORTED:
+    DBNOTOPEN
+    STMT_NOEXIST
+    STMT_ARGS
+    MEM_ALLOC_ERROR
+    Errors of the statement (RELEXIST, RELNOEXIST, ATTRNOEXIST, INVALID_VALUE, DUP_ROWS ...)
+
+GLOBAL VARIABLES MODIFIED:
+    db_err_code
+    The relations the statement changes or creates
+
+------------------------------------------------------------*/
+
+int Execute(int argc, char **argv)
+{
+    if(!db_open)
+    {
+        db_err_code = DBNOTOPEN;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    Prepared *p = PrepareFind(argv[1]);
+
+    if(!p)
+    {
+        printf("No statement named '%s' has been prepared.\n", argv[1]);
+        db_err_code = STMT_NOEXIST;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if(argc - 2 != p->numParams)
+    {
+        printf("Statement %s has %d parameters; %d values were given.\n", p->name, p->numParams, argc - 2);
+        db_err_code = STMT_ARGS;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    char **cmd = malloc((p->argc + 1) * sizeof(char *));
+
+    if(!cmd)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    memcpy(cmd, p->argv, p->argc * sizeof(char *));
+    for(int j = 0; j < p->numParams; j++)
+        cmd[p->paramArg[j]] = argv[2 + j];
+    cmd[p->argc] = NULL;
+
+    int rc;
+
+    if(!stmtResolve(p))
+    {
+        if(isCommand(p, "select"))
+            rc = Select(p->argc, cmd);
+        else if(isCommand(p, "insert"))
+            rc = Insert(p->argc, cmd);
+        else
+            rc = Delete(p->argc, cmd);
+    }
+    else
+    {
+        /* What OpenRel() does for a relation already open */
+        PinRel(p->relNum);
+        catcache[p->relNum].timestamp = (uint32_t)time(NULL);
+
+        if(isCommand(p, "select"))
+            rc = executeSelect(p, cmd);
+        else if(isCommand(p, "insert"))
+            rc = executeInsert(p, cmd);
+        else
+            rc = executeDelete(p, cmd);
+
+        UnPinRel(p->relNum);
+    }
+
+    free(cmd);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PrepareFind (name)
+
+RETURNS:
+    The prepared statement called name, or NULL.
+
+------------------------------------------------------------*/
+
+Prepared *PrepareFind(const char *name)
+{
+    for(Prepared *p = statements; p; p = p->next)
+    {
+        if(strcmp(p->name, name) == OK)
+            return p;
+    }
+    return NULL;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PrepareDropAll ()
+
+FUNCTION DESCRIPTION:
+    Forgets every prepared statement; called when the database is closed.
+
+------------------------------------------------------------*/
+
+void PrepareDropAll(void)
+{
+    while(statements)
+    {
+        Prepared *p = statements;
+        statements = p->next;
+        stmtFree(p);
+    }
+}
\ No newline at end of file
@@ -6,9 +6,11 @@
 #include "../include/helpers.h"
 #include "../include/openrel.h"
 #include "../include/findrel.h"
-#include "../include/getnextrec.h"
+#include "../include/getnextpagerecs.h"
 #include "../include/createfromattrlist.h"
 #include "../include/unpinrel.h"
+#include "../include/iterator.h"
+#include "../include/view.h"
 #include <stdio.h>
 #include <stddef.h>
 #include <stdlib.h>
@@ -63,7 +65,7 @@ ALGORITHM:
 BUGS:
     • Memory is allocated for each attribute; failure during formatting attempts partial cleanup but relies on Insert() not holding references afterward.
     • Does not perform duplicate elimination — Insert() handles it.
-    • Assumes attribute types are strictly one of {'i','f','s'}.
+    • Assumes attribute types are strictly one of {'i','f','d','s'}.
 
 ERRORS REPORTED:
     MEM_ALLOC_ERROR (local check)
@@ -74,7 +76,7 @@ GLOBAL VARIABLES MODIFIED:
 
 IMPLEMENTATION NOTES:
     • This routine acts as a bridge between projection output and the existing Insert() command parser.
-    • recPtr is expected to point to a fully populated tuple from GetNextRec().
+    • recPtr is expected to point to a fully populated tuple, e.g. one returned by GetNextPageRecs().
     • Destination relation must already exist and be opened before this is called.
 
 ------------------------------------------------------------*/
@@ -113,10 +115,18 @@ int InsertProjectedRecFromLL(char *dstRelName, AttrDesc *head, void *recPtr)
 
         if (type == 'i')
         {
-            int val = *(int *)((char *)recPtr + offset);
+            long long val = getIntValue((char *)recPtr + offset, length);
             valStr = (char *)malloc(32);
             if (valStr)
-                sprintf(valStr, "%d", val);
+                sprintf(valStr, "%lld", val);
+        }
+        else if (type == 'f' && length == sizeof(double))
+        {
+            /* A double is written with all its digits, so that it reads back the same */
+            double val = getFloatValue((char *)recPtr + offset, length);
+            valStr = (char *)malloc(64);
+            if (valStr)
+                sprintf(valStr, "%.17g", val);
         }
         else if (type == 'f')
         {
@@ -125,6 +135,12 @@ int InsertProjectedRecFromLL(char *dstRelName, AttrDesc *head, void *recPtr)
             if (valStr)
                 sprintf(valStr, "%.2f", val);
         }
+        else if (type == 'd')
+        {
+            valStr = (char *)malloc(16);
+            if (valStr)
+                formatDate((int)getIntValue((char *)recPtr + offset, length), valStr);
+        }
         else if (type == 's')
         {
             char *src = (char *)recPtr + offset;
@@ -174,7 +190,7 @@ PARAMETER DESCRIPTION:
     argv → argument vector
     Specification:
         argv[0] = "project"
-        argv[1] = destination relation name
+        argv[1] = destination relation name, or "as" followed by the name of a view to define
         argv[2] = source relation name
         argv[3] = first attribute to retain
         argv[4] = second attribute to retain
@@ -187,7 +203,7 @@ FUNCTION DESCRIPTION:
     The routine creates a new relation (dstRelName) whose schema consists ONLY of the attributes explicitly listed in the command. 
     The attribute descriptors of these fields are copied from the source relation’s attribute catalog into a temporary local linked list. 
     CreateFromAttrList() is then used to create a new relation with exactly these fields.
-    After the schema is created, every tuple in the source relation is scanned sequentially using GetNextRec(), and a projected tuple containing only the selected fields is constructed and inserted into the destination relation using InsertProjectedRecFromLL().
+    After the schema is created, every tuple in the source relation is scanned sequentially a page at a time using GetNextPageRecs(), and a projected tuple containing only the selected fields is constructed and inserted into the destination relation using InsertProjectedRecFromLL().
     Duplicate elimination is NOT performed by this routine. (If Insert() signals DUP_ROWS, it is ignored unless it indicates a different error.)
 
 ALGORITHM:
@@ -204,9 +220,9 @@ ALGORITHM:
     6) Call CreateFromAttrList(dstRelName, head) to construct the new relation schema.
     7) Open the new destination relation.
     8) Sequentially scan the source relation:
-        a) Call GetNextRec() repeatedly to read each tuple.
-        b) If rid invalid → end of scan.
-        c) Construct projected record and insert it into dstRelName using InsertProjectedRecFromLL().
+        a) Call GetNextPageRecs() repeatedly to get the tuples of each page.
+        b) If no tuples are returned → end of scan.
+        c) For each tuple, construct projected record and insert it into dstRelName using InsertProjectedRecFromLL().
             Ignore DUP_ROWS (optional duplicate avoidance).
             For any other error → report via ErrorMsgs().
     9) Print success message.
@@ -234,6 +250,8 @@ IMPLEMENTATION NOTES (IF ANY):
     • Projection preserves attribute order exactly as listed in the command, not necessarily in source schema order.
     • InsertProjectedRecFromLL() builds a synthetic argv[] to reuse Insert() rather than writing directly into pages.
     • The schema copy uses a deep copy of AttrCatRec but does not modify offsets; CreateFromAttrList recomputes offsets for the new relation.
+    • "project as V ..." only records the view (ViewDefine()). A view source is evaluated by the pipelined
+      operators (PlanProject(), which drops duplicates in memory) and only the result is written, by IterMaterialize().
 
 ------------------------------------------------------------*/
 
@@ -245,9 +263,25 @@ int Project(int argc, char **argv)
         return ErrorMsgs(db_err_code, print_flag);
     }
 
+    if(strcmp(argv[1], "as") == OK)
+    {
+        return ViewDefine(PlanProject, argc - 1, argv + 1);
+    }
+
     char *dstRelName = argv[1];
     char *srcRelName = argv[2];
 
+    if(ViewFind(srcRelName))
+    {
+        if(IterMaterialize(PlanProject(argc, argv), dstRelName) == NOTOK)
+        {
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+
+        printf("Projected relation %s into %s successfully.\n", srcRelName, dstRelName);
+        return OK;
+    }
+
     int r = OpenRel(srcRelName);
 
     if(r == NOTOK)
@@ -262,7 +296,6 @@ int Project(int argc, char **argv)
 
     AttrDesc *head = NULL;
     AttrDesc *tail = NULL;
-    int recLength = catcache[r].relcat_rec.recLength;
 
     for(int c = 3; c < argc; c++)
     {
@@ -309,7 +342,7 @@ int Project(int argc, char **argv)
         }
     }
 
-    int s = FindRel(dstRelName);
+    int s = FindRel(dstRelName) || ViewFind(dstRelName);
 
     if(s)
     {
@@ -325,27 +358,26 @@ int Project(int argc, char **argv)
         return ErrorMsgs(db_err_code, print_flag);
     }
 
-    Rid recRid = INVALID_RID;
-    void *recPtr = malloc(recLength);
+    short pid = 0;
+    char *recs[MAX_RECS_PER_PG];
+    int numRecs;
     do
     {
-        if(GetNextRec(r, recRid, &recRid, recPtr) == NOTOK)
+        if(GetNextPageRecs(r, &pid, NULL, recs, &numRecs) == NOTOK)
         {
             return ErrorMsgs(db_err_code, print_flag);
         }
 
-        if(!isValidRid(recRid))
-        {
-            break;
-        }
-
-        int sIns = InsertProjectedRecFromLL(dstRelName, head, recPtr);
-        if(sIns != OK && sIns != DUP_ROWS)
+        for(int i = 0; i < numRecs; i++)
         {
-            return ErrorMsgs(db_err_code, print_flag);
+            int sIns = InsertProjectedRecFromLL(dstRelName, head, recs[i]);
+            if(sIns != OK && sIns != DUP_ROWS)
+            {
+                return ErrorMsgs(db_err_code, print_flag);
+            }
         }
     }
-    while(true);
+    while(numRecs > 0);
 
     UnPinRel(r);
     printf("Projected relation %s into %s successfully.\n", srcRelName, dstRelName);
@@ -7,9 +7,17 @@
 #include "../include/openrel.h"
 #include "../include/findrel.h"
 #include "../include/findrec.h"
+#include "../include/findrelattr.h"
+#include "../include/getrec.h"
+#include "../include/idxmaint.h"
+#include "../include/predicate.h"
 #include "../include/insertrec.h"
 #include "../include/createrel.h"
 #include "../include/unpinrel.h"
+#include "../include/iterator.h"
+#include "../include/view.h"
+#include "../include/planner.h"
+#include "../include/select.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -17,6 +25,139 @@
 #include <string.h>
 
 
+/* qsort() comparator ordering Rids by page then slot, so GetRec() reads each page once */
+static int ridCmp(const void *a, const void *b)
+{
+    const Rid *x = a, *y = b;
+
+    if(x->pid != y->pid)
+        return x->pid - y->pid;
+    return x->slotnum - y->slotnum;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION SelectConj (r2, dstRelName, conj, numConj)
+
+PARAMETER DESCRIPTION:
+    r2         → open source relation.
+    dstRelName → relation to create; the caller has checked that it does not exist.
+    conj       → conjunction bound to its literals (ConjBind()), in rank order; left to the caller.
+    numConj    → number of conjuncts.
+
+FUNCTION DESCRIPTION:
+    Body of Select() once its conjunction is built, shared with prepared statements (Execute()):
+    chooses the access path (PlanAccess()), creates the destination with the schema of r2 and inserts every
+    record satisfying the conjunction.
+
+RETURNS:
+    OK, or NOTOK with db_err_code set.
+
+------------------------------------------------------------*/
+
+int SelectConj(int r2, const char *dstRelName, Conjunct *conj, int numConj)
+{
+    AccessPlan plan;
+
+    PlanAccess(r2, conj, numConj, &plan);
+
+    int recSize = catcache[r2].relcat_rec.recLength;
+
+    if(CreateRel((char *)dstRelName, r2) == NOTOK)
+    {
+        return NOTOK;
+    }
+    
+    /* Insert records into result relation that satisfy criteria */
+    int r1 = OpenRel((char *)dstRelName);
+
+    void *recPtr = malloc(recSize);
+
+    if(r1 == NOTOK || !recPtr)
+    {
+        free(recPtr);
+        if(r1 != NOTOK)
+            db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    /* The access path chosen by the planner decides which records are visited */
+    Rid *rids = NULL;
+    int numRids = 0;
+    int useIdx;
+    int d = plan.driver[plan.method];
+
+    useIdx = PlanFindRids(r2, conj, numConj, &plan, &rids, &numRids);
+
+    if(useIdx == NOTOK)
+    {
+        free(recPtr);
+        return NOTOK;
+    }
+
+    int rc = OK;
+
+    if(useIdx)
+    {
+        if(numRids > 1)
+            qsort(rids, numRids, sizeof(Rid), ridCmp);
+
+        for(int i = 0; rc == OK && i < numRids; i++)
+        {
+            int got = GetRec(r2, rids[i], recPtr);
+
+            if(got == NOTOK)
+            {
+                rc = NOTOK;
+            }
+            else if(got && ConjMatch(recPtr, conj, numConj, -1))
+            {
+                rc = InsertRec(r1, recPtr);
+            }
+        }
+
+        free(rids);
+    }
+    else
+    {
+        /* Go through each record of srcRelName and filter; FindRec() skips the pages the zone map of the driver rules out */
+        Rid recRid = INVALID_RID;
+        AttrCatRec *first = conj[d].attr;
+
+        while(rc == OK)
+        {
+            if(FindRec(r2, recRid, &recRid, recPtr, first->type[0], first->length, first->offset,
+                       conj[d].valuePtr, conj[d].compOp) == NOTOK)
+            {
+                rc = NOTOK;
+                break;
+            }
+
+            if(!isValidRid(recRid))
+            {
+                break;
+            }
+
+            if(ConjMatch(recPtr, conj, numConj, d))
+            {
+                rc = InsertRec(r1, recPtr);
+            }
+        }
+    }
+
+    free(recPtr);
+
+    if(rc == NOTOK)
+    {
+        return NOTOK;
+    }
+
+    UnPinRel(r1);
+    return OK;
+}
+
+
 /*------------------------------------------------------------
 
 FUNCTION Select (argc, argv)
@@ -26,45 +167,47 @@ PARAMETER DESCRIPTION:
     argv → argument vector
     Specifications:
         argv[0] = "select"
-        argv[1] = destination relation name (new relation)
+        argv[1] = destination relation name (new relation), or "as" followed by the name of a view to define
         argv[2] = source relation name
-        argv[3] = attribute name in source relation
-        argv[4] = comparison operator (integer-encoded)
-        argv[5] = literal value
+        argv[3 + 3k] = attribute name of the k-th conjunct
+        argv[4 + 3k] = comparison operator of the k-th conjunct (integer-encoded)
+        argv[5 + 3k] = literal value of the k-th conjunct
         argv[argc] = NIL
 
 FUNCTION DESCRIPTION:
-    Implements the relational selection operator σ.
-    This routine creates a new relation (dstRelName) having exactly the same schema as the source relation (srcRelName). 
-    It then scans every record of the source relation, evaluates the selection predicate:
-        srcRel[attrName] <op> literal
-    and inserts each matching tuple into the destination relation.
+    Implements the relational selection operator σ over a conjunction of comparisons.
+    This routine creates a new relation (dstRelName) having exactly the same schema as the source relation (srcRelName)
+    and inserts every tuple of the source relation satisfying
+        srcRel[attr1] <op1> literal1 AND srcRel[attr2] <op2> literal2 AND ...
     Attribute-type validation, literal conversion, and comparison are performed according to the attribute’s format stored in the catalog (integer, float, string).
+    Conjuncts are evaluated in increasing order of estimated cost / (1 - selectivity) (ConjBuild()), and evaluation
+    of a record stops at the first conjunct it fails.
+    The records visited are chosen by the cheapest access path (PlanAccess()): a full scan, a scan skipping the pages the
+    zone map of one conjunct rules out, the Rids an index gives for one conjunct (FindRidsByIndex()), or the Rids of
+    the AND of the bitmaps of every conjunct with a bitmap index (PlanFindRids()).
     The routine fails if:
         • source relation does not exist,
         • destination relation already exists,
-        • attribute does not exist,
-        • the literal is not valid for the attribute type.
+        • an attribute does not exist,
+        • a literal is not valid for its attribute type.
 
 ALGORITHM:
     1) Ensure that a database is open; otherwise signal error.
-    2) Extract arguments: dstRelName, srcRelName, attrName, operator code, literal value.
-    3) Check that destination relation does not already exist.
-    4) Open source relation via OpenRel():
+    2) Check that destination relation does not already exist.
+    3) Open source relation via OpenRel():
         if it does not exist → RELNOEXIST.
-    5) Search the source relation’s attribute list for attrName:
-        if not found → ATTRNOEXIST.
-    6) Determine the attribute's offset, length, and type.
-    7) Create a new relation (dstRelName) using CreateRel() with the same schema as the source relation.
-    8) Open the new destination relation using OpenRel().
-    9) Convert the literal value into typed form using isValidForType(); allocate storage for casted value.
-        if invalid → INVALID_VALUE.
-    10) Sequentially scan the source relation:
-        a) Call FindRec() to locate the next matching tuple.
+    4) Build the conjuncts with ConjBuild(): attributes (ATTRNOEXIST), literals (INVALID_VALUE), kernels, estimates and rank order.
+    5) Choose the access path with PlanAccess() (SelectConj() does 5-8).
+    6) Create the destination relation using CreateRel() with the same schema as the source relation, and OpenRel() it.
+    7) Index scan: PlanFindRids() gives the Rids of the driving conjunct, or of the ANDed bitmaps:
+        a) Sort the Rids by page and slot, fetch each record with GetRec().
+        b) Insert the record if it satisfies every conjunct (each evaluated by its kernel compiled with PredInit()).
+    8) Otherwise sequentially scan the source relation:
+        a) Call FindRec() with the driving conjunct to locate the next candidate (skipping pages by zone map).
         b) If foundRid is INVALID_RID → end of scan.
-        c) If a matching tuple is found, insert it into the destination relation using InsertRec().
-    11) Print success message.
-    12) Return OK.
+        c) Insert the candidate if it satisfies the other conjuncts.
+    9) Print success message.
+    10) Return OK.
 
 BUGS:
     • Does not prevent selection into the same relation name if both src and dst are identical (handled earlier by FindRel()).
@@ -86,9 +229,13 @@ GLOBAL VARIABLES MODIFIED:
     Physical heap pages for dstRelName (InsertRec)
 
 IMPLEMENTATION NOTES:
-    • The operator argument is expected to be an integer code corresponding to comparison constants (CMP_EQ, CMP_LT, etc.).
+    • The operator arguments are expected to be integer codes corresponding to comparison constants (CMP_EQ, CMP_LT, etc.).
     • Select creates a full relation copy structurally identical to the source relation; projection is a separate operator.
-    • Uses FindRec iteratively to locate each successive match, enabling efficient cursor-style traversal.
+    • Selectivities come from the statistics of an analyzed relation, else nKeys, else the System R defaults.
+    • "explain select ..." prints the plan without evaluating it (Explain()).
+    • All literals are validated before the destination is created, so a bad predicate leaves no empty relation behind.
+    • "select as V ..." only records the view (ViewDefine()). A view source is evaluated by the pipelined
+      operators (PlanSelect()) and only the result is written, by IterMaterialize(); indexes are not used then.
 
 ------------------------------------------------------------*/
 
@@ -100,15 +247,28 @@ int Select(int argc, char **argv)
         return ErrorMsgs(db_err_code, print_flag);
     }
 
+    if(strcmp(argv[1], "as") == OK)
+    {
+        return ViewDefine(PlanSelect, argc - 1, argv + 1);
+    }
+
     char *dstRelName = argv[1];
     char *srcRelName = argv[2];
-    char *attrName = argv[3];
-    int operator = *(int *)(argv[4]);
-    char *value = argv[5];
+    int numConj = (argc - 3) / 3;
 
-    bool attrFound = false;
+    if(ViewFind(srcRelName))
+    {
+        if(IterMaterialize(PlanSelect(argc, argv), dstRelName) == NOTOK)
+        {
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+
+        printf("Created relation %s successfully and placed filtered tuples of %s\n", 
+        dstRelName, srcRelName);
+        return OK;
+    }
 
-    int r1 = FindRel(dstRelName);
+    int r1 = FindRel(dstRelName) || ViewFind(dstRelName);
     int r2 = OpenRel(srcRelName);
 
     if(r1)
@@ -128,84 +288,22 @@ int Select(int argc, char **argv)
         return ErrorMsgs(db_err_code, print_flag);
     }
 
-    AttrDesc *ptr = catcache[r2].attrList;
-    AttrDesc *foundField = NULL;
-
-    for(;ptr;ptr=ptr->next)
-    {
-        if(strncmp((ptr->attr).attrName, attrName, ATTRNAME) == OK)
-        {
-            attrFound = true;
-            foundField = ptr;
-            break;
-        }
-    }
-
-    if(!attrFound)
-    {
-        printf("Attribute '%s' NOT present in relation '%s' of the DB.\n", attrName, srcRelName);
-        printCloseStrings(ATTRCAT_CACHE, offsetof(AttrCatRec, attrName), attrName, srcRelName);
-        db_err_code = ATTRNOEXIST;
-        return ErrorMsgs(db_err_code, print_flag);
-    }
-    
-    int recSize = catcache[r2].relcat_rec.recLength;
-
-    if(CreateRel(dstRelName, r2) == NOTOK)
-    {
-        return ErrorMsgs(db_err_code, print_flag);
-    }
-    
-    /* Insert records into result relation that satisfy criteria */
-    r1 = OpenRel(dstRelName);
+    Conjunct *conj;
 
-    if(r1 == NOTOK)
+    if(ConjBuild(r2, srcRelName, numConj, argv + 3, &conj) == NOTOK)
     {
         return ErrorMsgs(db_err_code, print_flag);
     }
 
-    Rid recRid = INVALID_RID;
-    int offset = (foundField->attr).offset;
-    int size = (foundField->attr).length;
-    char type = (foundField->attr).type[0];
-    void *valuePtr = malloc(size);
-    void *recPtr = malloc(recSize);
+    int rc = SelectConj(r2, dstRelName, conj, numConj);
 
-    if(!valuePtr || !recPtr)
-    {
-        db_err_code = MEM_ALLOC_ERROR;
-        return ErrorMsgs(MEM_ALLOC_ERROR, print_flag);
-    }
+    ConjFree(conj, numConj);
 
-    if(!isValidForType(type, size, value, valuePtr))
+    if(rc == NOTOK)
     {
-        printf("'%s' is an INVALID literal for TYPE %s.\n", 
-        value, type == 'i' ? "INTEGER" : "FLOAT");
-        db_err_code = INVALID_VALUE;
         return ErrorMsgs(db_err_code, print_flag);
     }
 
-    /* Go through each record of srcRelName and filter */
-    do
-    {
-        if(FindRec(r2, recRid, &recRid, recPtr, type, size, offset, valuePtr, operator) == NOTOK)
-        {
-            return ErrorMsgs(db_err_code, print_flag);
-        }
-
-        if(!isValidRid(recRid))
-        {
-            break;
-        }
-
-        if(InsertRec(r1, recPtr) == NOTOK)
-        {
-            return ErrorMsgs(db_err_code, print_flag);
-        }
-    } 
-    while(true);
-
-    UnPinRel(r1);
     UnPinRel(r2);
 
     printf("Created relation %s successfully and placed filtered tuples of %s\n", 
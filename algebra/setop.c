@@ -0,0 +1,610 @@
+/************************INCLUDES*******************************/
+
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/helpers.h"
+#include "../include/openrel.h"
+#include "../include/findrel.h"
+#include "../include/getnextrec.h"
+#include "../include/insertrec.h"
+#include "../include/createfromattrlist.h"
+#include "../include/unpinrel.h"
+#include "../include/bloom.h"
+#include "../include/view.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#define SETOP_UNION     0
+#define SETOP_INTERSECT 1
+#define SETOP_EXCEPT    2
+
+#define SETOP_TMP_NAME  "tmp_file"      /* result relation when no "into" is given; printed and destroyed */
+
+/*
+ * Hash-based set operators.
+ *
+ * The distinct tuples of the left input go into an in-memory hash table keyed on the record fingerprint
+ * (BloomHashRecord(), which leaves floats out so that tolerance-equal floats hash alike), with isSameTuple() deciding equality.
+ * The right input then probes it: union adds the tuples it has not seen, intersect and except mark the ones they find.
+ * If the inputs are larger than SETOP_MEM_BYTES, both are first partitioned on the fingerprint into files
+ * "<dst>.hp<n>", and every pair of partitions is processed the same way, repartitioning with other hash bits
+ * if needed (up to SETOP_MAX_DEPTH passes).
+ */
+
+/* One input of a pass: a heap relation or a partition file */
+typedef struct setinput
+{
+    int relNum;                 // relation read with GetNextRec(), or -1
+    Rid rid;
+    FILE *fp;                   // partition file, when relNum is -1
+    long numRecs;               // records in the input
+} SetInput;
+
+typedef struct setop
+{
+    int op;                     // SETOP_UNION, SETOP_INTERSECT or SETOP_EXCEPT
+    int schemaRel;              // relation whose attribute list describes every record
+    int dstRel;                 // result relation
+    int recSize;
+    const char *prefix;         // prefix of partition files
+    int nextFile;               // partition files created so far
+} SetOp;
+
+/* In-memory table of distinct tuples, kept in arrival order */
+typedef struct settable
+{
+    char *recs;                 // numEnts records
+    unsigned long long *hashes; // fingerprint of every record
+    char *marked;               // probe side found the record
+    long numEnts, capEnts;
+    long *slots;                // open addressing, entry index or -1
+    long numSlots;              // power of two
+} SetTable;
+
+
+static void build_hpart_filename(SetOp *so, int n, char *fname, size_t buflen)
+{
+    snprintf(fname, buflen, "%s.hp%d", so->prefix, n);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION nextInput (in, rec, recSize)
+
+FUNCTION DESCRIPTION:
+    Reads the next record of a relation or partition file.
+
+RETURNS:
+    1 with the record in rec, 0 at the end, NOTOK on error (db_err_code set).
+
+------------------------------------------------------------*/
+
+static int nextInput(SetInput *in, void *rec, int recSize)
+{
+    if(in->relNum >= 0)
+    {
+        if(GetNextRec(in->relNum, in->rid, &in->rid, rec) == NOTOK)
+            return NOTOK;
+        return isValidRid(in->rid) ? 1 : 0;
+    }
+
+    if(fread(rec, recSize, 1, in->fp) == 1)
+        return 1;
+    if(ferror(in->fp))
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+    return 0;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION table helpers (tableFind, tableAdd, tableFree)
+
+FUNCTION DESCRIPTION:
+    tableFind() returns the entry holding a tuple equal to rec, or -1.
+    tableAdd() appends rec as a new entry, doubling the slot array when it is half full.
+
+------------------------------------------------------------*/
+
+static long tableFind(SetOp *so, SetTable *t, unsigned long long h, void *rec)
+{
+    if(t->numSlots == 0)
+        return -1;
+
+    for(long s = h & (t->numSlots - 1);; s = (s + 1) & (t->numSlots - 1))
+    {
+        long e = t->slots[s];
+
+        if(e < 0)
+            return -1;
+        if(t->hashes[e] == h && isSameTuple(so->schemaRel, t->recs + e * so->recSize, rec))
+            return e;
+    }
+}
+
+static int tableAdd(SetOp *so, SetTable *t, unsigned long long h, void *rec)
+{
+    if(t->numEnts == t->capEnts)
+    {
+        long cap = t->capEnts ? 2 * t->capEnts : 1024;
+        char *recs = realloc(t->recs, cap * so->recSize);
+        if(recs)
+            t->recs = recs;
+        unsigned long long *hashes = realloc(t->hashes, cap * sizeof(unsigned long long));
+        if(hashes)
+            t->hashes = hashes;
+        char *marked = realloc(t->marked, cap);
+        if(marked)
+            t->marked = marked;
+
+        if(!recs || !hashes || !marked)
+        {
+            db_err_code = MEM_ALLOC_ERROR;
+            return NOTOK;
+        }
+        t->capEnts = cap;
+    }
+
+    if(2 * (t->numEnts + 1) > t->numSlots)
+    {
+        long n = t->numSlots ? 2 * t->numSlots : 2048;
+        long *slots = malloc(n * sizeof(long));
+
+        if(!slots)
+        {
+            db_err_code = MEM_ALLOC_ERROR;
+            return NOTOK;
+        }
+
+        for(long s = 0; s < n; s++)
+            slots[s] = -1;
+        for(long e = 0; e < t->numEnts; e++)
+        {
+            long s = t->hashes[e] & (n - 1);
+            while(slots[s] >= 0)
+                s = (s + 1) & (n - 1);
+            slots[s] = e;
+        }
+
+        free(t->slots);
+        t->slots = slots;
+        t->numSlots = n;
+    }
+
+    long e = t->numEnts++;
+    memcpy(t->recs + e * so->recSize, rec, so->recSize);
+    t->hashes[e] = h;
+    t->marked[e] = 0;
+
+    long s = h & (t->numSlots - 1);
+    while(t->slots[s] >= 0)
+        s = (s + 1) & (t->numSlots - 1);
+    t->slots[s] = e;
+    return OK;
+}
+
+static void tableFree(SetTable *t)
+{
+    free(t->recs);
+    free(t->hashes);
+    free(t->marked);
+    free(t->slots);
+    memset(t, 0, sizeof(SetTable));
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION memPass (so, left, right)
+
+PARAMETER DESCRIPTION:
+    so    → set operation being evaluated.
+    left  → left input (hashed).
+    right → right input (probes).
+
+FUNCTION DESCRIPTION:
+    Evaluates the operation on one pair of inputs in memory and inserts the result into so->dstRel.
+
+ALGORITHM:
+    1) Add every distinct tuple of left to the table.
+    2) For every tuple of right: union adds it if it is not there yet; intersect and except mark the matching entry.
+    3) Insert the entries in arrival order: all of them (union), the marked ones (intersect) or the unmarked ones (except).
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+------------------------------------------------------------*/
+
+static int memPass(SetOp *so, SetInput *left, SetInput *right)
+{
+    SetTable t;
+    char *rec = malloc(so->recSize);
+    int r, rc = OK;
+
+    memset(&t, 0, sizeof(SetTable));
+    if(!rec)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    while(rc == OK && (r = nextInput(left, rec, so->recSize)) != 0)
+    {
+        if(r == NOTOK)
+        {
+            rc = NOTOK;
+            break;
+        }
+
+        unsigned long long h = BloomHashRecord(so->schemaRel, rec);
+
+        if(tableFind(so, &t, h, rec) < 0)
+            rc = tableAdd(so, &t, h, rec);
+    }
+
+    while(rc == OK && (r = nextInput(right, rec, so->recSize)) != 0)
+    {
+        if(r == NOTOK)
+        {
+            rc = NOTOK;
+            break;
+        }
+
+        unsigned long long h = BloomHashRecord(so->schemaRel, rec);
+        long e = tableFind(so, &t, h, rec);
+
+        if(e >= 0)
+            t.marked[e] = 1;
+        else if(so->op == SETOP_UNION)
+            rc = tableAdd(so, &t, h, rec);
+    }
+
+    for(long e = 0; rc == OK && e < t.numEnts; e++)
+    {
+        bool keep = so->op == SETOP_UNION ||
+                    (so->op == SETOP_INTERSECT && t.marked[e]) ||
+                    (so->op == SETOP_EXCEPT && !t.marked[e]);
+
+        if(keep)
+            rc = InsertRec(so->dstRel, t.recs + e * so->recSize);
+    }
+
+    tableFree(&t);
+    free(rec);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION hashPass (so, left, right, depth)
+
+PARAMETER DESCRIPTION:
+    so    → set operation being evaluated.
+    left  → left input.
+    right → right input.
+    depth → partitioning passes already made.
+
+FUNCTION DESCRIPTION:
+    Evaluates the operation with memPass() if both inputs fit in SETOP_MEM_BYTES (or depth reached SETOP_MAX_DEPTH).
+    Otherwise partitions both inputs into matching files on 16 bits of the fingerprint that no earlier pass used,
+    and recurses on every pair; equal tuples always land in the same pair, so the results of the pairs are disjoint.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+ERRORS REPORTED:
+    FILESYSTEM_ERROR
+    MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+static int hashPass(SetOp *so, SetInput *left, SetInput *right, int depth)
+{
+    long perRec = so->recSize + sizeof(unsigned long long) + 1 + 2 * sizeof(long);
+    long bytes = (left->numRecs + right->numRecs) * perRec;
+
+    if(bytes <= SETOP_MEM_BYTES || depth == SETOP_MAX_DEPTH)
+        return memPass(so, left, right);
+
+    int numParts = (int)MIN(bytes / SETOP_MEM_BYTES + 1, 256);
+    int first = so->nextFile, rc = OK;
+    char fname[RELNAME + 16];
+    char *rec = malloc(so->recSize);
+    SetInput *parts = calloc(2 * numParts, sizeof(SetInput));
+
+    if(!rec || !parts)
+    {
+        free(rec);
+        free(parts);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    /* parts[p] holds the left side of partition p, parts[numParts + p] the right side */
+    for(int i = 0; i < 2 * numParts; i++)
+    {
+        build_hpart_filename(so, so->nextFile++, fname, sizeof(fname));
+        parts[i].relNum = -1;
+        parts[i].fp = fopen(fname, "w+b");
+
+        if(!parts[i].fp)
+        {
+            db_err_code = FILESYSTEM_ERROR;
+            rc = NOTOK;
+            break;
+        }
+    }
+
+    for(int side = 0; side < 2 && rc == OK; side++)
+    {
+        SetInput *in = side == 0 ? left : right;
+        int r;
+
+        while(rc == OK && (r = nextInput(in, rec, so->recSize)) != 0)
+        {
+            if(r == NOTOK)
+            {
+                rc = NOTOK;
+                break;
+            }
+
+            unsigned long long h = BloomHashRecord(so->schemaRel, rec);
+            SetInput *out = &parts[side * numParts + (int)((h >> (16 * depth)) % numParts)];
+
+            if(fwrite(rec, so->recSize, 1, out->fp) != 1)
+            {
+                db_err_code = FILESYSTEM_ERROR;
+                rc = NOTOK;
+            }
+            out->numRecs++;
+        }
+    }
+
+    for(int i = 0; i < 2 * numParts && rc == OK; i++)
+    {
+        if(fflush(parts[i].fp) != 0 || fseek(parts[i].fp, 0, SEEK_SET) != 0)
+        {
+            db_err_code = FILESYSTEM_ERROR;
+            rc = NOTOK;
+        }
+    }
+
+    for(int p = 0; p < numParts && rc == OK; p++)
+    {
+        rc = hashPass(so, &parts[p], &parts[numParts + p], depth + 1);
+    }
+
+    for(int i = 0; i < 2 * numParts; i++)
+    {
+        if(parts[i].fp)
+            fclose(parts[i].fp);
+        build_hpart_filename(so, first + i, fname, sizeof(fname));
+        remove(fname);
+    }
+
+    free(parts);
+    free(rec);
+    return rc;
+}
+
+
+/* Body of SetOperation() once both sources can be read by Rid: readNames are the source relations, or the
+   temporary relations view sources were materialized into; messages name the sources as given */
+static int setOpRels(char **argv, int op, char **readNames)
+{
+    char *dstRelName = argv[1][0] ? argv[1] : SETOP_TMP_NAME;
+    char *srcNames[2] = {argv[2], argv[3]};
+    int src[2];
+
+    if(FindRel(dstRelName) || ViewFind(dstRelName))
+    {
+        printf("Relation '%s' already exists in the DB.\n", dstRelName);
+        db_err_code = RELEXIST;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    for(int i = 0; i < 2; i++)
+    {
+        src[i] = OpenRel(readNames[i]);
+
+        if(src[i] == NOTOK)
+        {
+            if(db_err_code == RELNOEXIST)
+            {
+                printf("Relation '%s' does NOT exist in the DB.\n", srcNames[i]);
+                printCloseStrings(RELCAT_CACHE, offsetof(RelCatRec, relName), srcNames[i], NULL);
+            }
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+    }
+
+    AttrDesc *a = catcache[src[0]].attrList;
+    AttrDesc *b = catcache[src[1]].attrList;
+
+    for(; a && b; a = a->next, b = b->next)
+    {
+        if(a->attr.type[0] != b->attr.type[0] || a->attr.length != b->attr.length || a->attr.offset != b->attr.offset)
+            break;
+    }
+
+    if(a || b)
+    {
+        printf("Relations '%s' and '%s' are not union-compatible.\n", srcNames[0], srcNames[1]);
+        db_err_code = NOT_UNION_COMPATIBLE;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if(CreateFromAttrList(dstRelName, catcache[src[0]].attrList) == NOTOK)
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    SetOp so;
+    so.op = op;
+    so.schemaRel = src[0];
+    so.dstRel = OpenRel(dstRelName);
+    so.recSize = catcache[src[0]].relcat_rec.recLength;
+    so.prefix = dstRelName;
+    so.nextFile = 0;
+
+    if(so.dstRel == NOTOK)
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    SetInput in[2];
+    for(int i = 0; i < 2; i++)
+    {
+        in[i].relNum = src[i];
+        in[i].rid = INVALID_RID;
+        in[i].fp = NULL;
+        in[i].numRecs = catcache[src[i]].relcat_rec.numRecs;
+    }
+
+    if(hashPass(&so, &in[0], &in[1], 0) == NOTOK)
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    UnPinRel(so.dstRel);
+    UnPinRel(src[0]);
+    UnPinRel(src[1]);
+
+    if(!argv[1][0])
+    {
+        char *printArgv[] = {"print", dstRelName, NULL};
+        char *destroyArgv[] = {"destroy", dstRelName, NULL};
+
+        Print(2, printArgv);
+        return Destroy(2, destroyArgv);
+    }
+
+    printf("Created relation %s with the %d tuples of %s %s %s\n", dstRelName, catcache[so.dstRel].relcat_rec.numRecs,
+    srcNames[0], argv[0], srcNames[1]);
+
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION SetOperation (argc, argv, op)
+
+PARAMETER DESCRIPTION:
+    argc → number of command arguments.
+    argv → argument vector.
+    op   → SETOP_UNION, SETOP_INTERSECT or SETOP_EXCEPT.
+
+SPECIFICATIONS:
+    argv[0] = "union", "intersect" or "except"
+    argv[1] = destination relation name ("" when no "into" is given)
+    argv[2] = first source relation or view name
+    argv[3] = second source relation or view name
+    argv[argc] = NIL
+
+FUNCTION DESCRIPTION:
+    Computes the set union, intersection or difference (first minus second) of two union-compatible relations.
+    The result holds every qualifying tuple once, even if the inputs contain duplicates; it takes the attribute names of the first relation.
+    Without "into" the result is printed and dropped.
+
+ALGORITHM:
+    1) Ensure that a database is open and that the destination does not exist.
+    2) Write a view source to a temporary relation (ViewMaterialize()), destroyed at the end.
+       Open both source relations; they must have the same number of attributes with pairwise equal types and lengths.
+    3) Create the destination from the attribute list of the first relation with CreateFromAttrList() and open it.
+    4) hashPass() over both relations.
+    5) Print the result (no "into") or a success message.
+
+ERRORS REPORTED:
+    DBNOTOPEN
+    RELEXIST
+    RELNOEXIST
+    NOT_UNION_COMPATIBLE
+    MEM_ALLOC_ERROR
+    FILESYSTEM_ERROR
+    REC_INS_ERR (via InsertRec)
+
+GLOBAL VARIABLES MODIFIED:
+    db_err_code
+    Catalog entries and heap pages of the destination relation
+
+IMPLEMENTATION NOTES:
+    • Cost is one read of each input (plus one write and read per partitioning pass), instead of the per-tuple scan of the destination that Insert()'s duplicate check would do.
+
+------------------------------------------------------------*/
+
+static int SetOperation(int argc, char **argv, int op)
+{
+    if(!db_open)
+    {
+        db_err_code = DBNOTOPEN;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    char tmpNames[2][RELNAME];
+    char *readNames[2] = {argv[2], argv[3]};
+    int rc = OK;
+
+    for(int i = 0; rc == OK && i < 2; i++)
+    {
+        if(ViewFind(readNames[i]))
+        {
+            rc = ViewMaterialize(readNames[i], tmpNames[i]);
+            readNames[i] = rc == OK ? tmpNames[i] : argv[2 + i];
+        }
+    }
+
+    if(rc == OK)
+    {
+        rc = setOpRels(argv, op, readNames);
+    }
+    else
+    {
+        ErrorMsgs(db_err_code, print_flag);
+    }
+
+    for(int i = 0; i < 2; i++)
+    {
+        if(readNames[i] != argv[2 + i])
+            ViewUnmaterialize(readNames[i]);
+    }
+
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION Union / Intersect / Except (argc, argv)
+
+FUNCTION DESCRIPTION:
+    Entry points of "union", "intersect" and "except" (see SetOperation()):
+        union into D from (R S);
+        intersect into D from (R S);
+        except into D from (R S);       tuples of R that are not in S
+
+------------------------------------------------------------*/
+
+int Union(int argc, char **argv)
+{
+    return SetOperation(argc, argv, SETOP_UNION);
+}
+
+int Intersect(int argc, char **argv)
+{
+    return SetOperation(argc, argv, SETOP_INTERSECT);
+}
+
+int Except(int argc, char **argv)
+{
+    return SetOperation(argc, argv, SETOP_EXCEPT);
+}
\ No newline at end of file
@@ -0,0 +1,293 @@
+/************************INCLUDES*******************************/
+
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/findrel.h"
+#include "../include/iterator.h"
+#include "../include/destroy.h"
+#include "../include/view.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Views: "select as V from ...", "project as V from ..." and "join as V (...)" name a query instead of
+ * creating a relation. A view is kept for the session as its command arguments and is evaluated through
+ * the pipelined operators (algebra/iterator.c) each time it is read, so a chain of views writes nothing
+ * until its result is printed or materialized with an ordinary "into".  Commands that read whole relations
+ * by Rid (sort, union, intersect, except) read a view from a temporary relation (ViewMaterialize()), and the
+ * commands that change or index a relation refuse a view (ViewIsReadOnly()).
+ */
+
+static ViewDef *views = NULL;
+
+
+/* A view reads the relation or view name directly */
+static bool viewReads(ViewDef *v, const char *name)
+{
+    return strcmp(v->argv[2], name) == OK || (v->plan == PlanJoin && strcmp(v->argv[4], name) == OK);
+}
+
+static void viewFree(ViewDef *v)
+{
+    for(int i = 0; v->argv && i < v->argc; i++)
+        free(v->argv[i]);
+    free(v->argv);
+    free(v);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ViewDefine (plan, argc, argv)
+
+PARAMETER DESCRIPTION:
+    plan → PlanSelect(), PlanProject() or PlanJoin().
+    argc → number of arguments.
+    argv → arguments of the command as plan expects them, with argv[1] the name of the view.
+
+FUNCTION DESCRIPTION:
+    Records a view for the rest of the session, once its plan opens successfully.
+
+ALGORITHM:
+    1) Reject a name that is too long or already names a relation or a view.
+    2) Open and close the plan, which checks the sources, attributes, literals and types.
+    3) Copy the arguments and append the view to the list.
+
+ERRORS REPORTED:
+    REL_LENGTH_EXCEEDED
+    RELEXIST
+    MEM_ALLOC_ERROR
+    Errors of the plan (RELNOEXIST, ATTRNOEXIST, INVALID_VALUE, INCOMPATIBLE_TYPES ...)
+
+GLOBAL VARIABLES MODIFIED:
+    db_err_code
+
+IMPLEMENTATION NOTES:
+    • The comparison operators of a select are int codes in their argument, so arguments are copied
+      for at least sizeof(int) bytes whatever strlen() says.
+
+------------------------------------------------------------*/
+
+int ViewDefine(PlanFn plan, int argc, char **argv)
+{
+    char *name = argv[1];
+
+    if(strlen(name) >= RELNAME)
+    {
+        db_err_code = REL_LENGTH_EXCEEDED;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if(FindRel(name) || ViewFind(name))
+    {
+        printf("Relation '%s' already exists in the DB.\n", name);
+        db_err_code = RELEXIST;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    Iter *it = plan(argc, argv);
+
+    if(!it)
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    IterClose(it);
+
+    ViewDef *v = calloc(1, sizeof(ViewDef));
+
+    if(v)
+    {
+        v->argv = calloc(argc, sizeof(char *));
+    }
+
+    for(int i = 0; v && v->argv && i < argc; i++)
+    {
+        size_t len = strlen(argv[i]) + 1;
+
+        if(len < sizeof(int))
+            len = sizeof(int);
+
+        if(!(v->argv[v->argc] = malloc(len)))
+            break;
+
+        memcpy(v->argv[v->argc++], argv[i], len);
+    }
+
+    if(!v || v->argc < argc)
+    {
+        if(v)
+            viewFree(v);
+        db_err_code = MEM_ALLOC_ERROR;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    strcpy(v->name, name);
+    v->plan = plan;
+
+    ViewDef **tail = &views;
+    while(*tail)
+        tail = &(*tail)->next;
+    *tail = v;
+
+    printf("Created view %s over %s; it is evaluated each time it is read.\n", name, argv[2]);
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ViewFind (name)
+
+RETURNS:
+    The view called name, or NULL.
+
+------------------------------------------------------------*/
+
+ViewDef *ViewFind(const char *name)
+{
+    for(ViewDef *v = views; v; v = v->next)
+    {
+        if(strcmp(v->name, name) == OK)
+            return v;
+    }
+    return NULL;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ViewDrop (name)
+
+FUNCTION DESCRIPTION:
+    Drops a view, then every view reading it, so that a view never refers to a name defined after it
+    (and views cannot form a cycle).
+
+RETURNS:
+    OK, or NOTOK if there is no such view.
+
+------------------------------------------------------------*/
+
+int ViewDrop(const char *name)
+{
+    ViewDef **link = &views;
+
+    while(*link && strcmp((*link)->name, name) != OK)
+        link = &(*link)->next;
+
+    if(!*link)
+        return NOTOK;
+
+    ViewDef *v = *link;
+    *link = v->next;
+    printf("View %s dropped.\n", v->name);
+
+    for(ViewDef *d = views; d; )
+    {
+        if(viewReads(d, v->name))
+        {
+            ViewDrop(d->name);
+            d = views;      /* the list changed */
+        }
+        else
+        {
+            d = d->next;
+        }
+    }
+
+    viewFree(v);
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ViewDropAll ()
+
+FUNCTION DESCRIPTION:
+    Forgets every view; called when the database is closed.
+
+------------------------------------------------------------*/
+
+void ViewDropAll(void)
+{
+    while(views)
+    {
+        ViewDef *v = views;
+        views = v->next;
+        viewFree(v);
+    }
+}
+
+
+
+/*------------------------------------------------------------
+
+FUNCTION ViewIsReadOnly (name)
+
+FUNCTION DESCRIPTION:
+    Tells a command that changes or indexes a relation that name is a view, which it cannot do.
+    Prints why and sets VIEW_READONLY, so the caller only has to report the error.
+
+RETURNS:
+    true when name is a view.
+
+------------------------------------------------------------*/
+
+bool ViewIsReadOnly(const char *name)
+{
+    if(!ViewFind(name))
+        return false;
+
+    printf("'%s' is a view; views are read-only.\n", name);
+    db_err_code = VIEW_READONLY;
+    return true;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ViewMaterialize / ViewUnmaterialize (name, tmpName)
+
+PARAMETER DESCRIPTION:
+    name    → view to read.
+    tmpName → (OUT) name of the temporary relation holding its rows, at least RELNAME bytes.
+
+FUNCTION DESCRIPTION:
+    ViewMaterialize() writes the rows of a view to a new relation VIEW_TMP_PREFIX<n>, n being the first number
+    no relation uses, for the commands that read a source by Rid; a relation it could not fill is destroyed again.
+    ViewUnmaterialize() destroys it quietly.
+
+RETURNS:
+    OK, or NOTOK (db_err_code set).
+
+------------------------------------------------------------*/
+
+int ViewMaterialize(const char *name, char *tmpName)
+{
+    int n = 0;
+
+    do
+        snprintf(tmpName, RELNAME, "%s%d", VIEW_TMP_PREFIX, n++);
+    while(FindRel(tmpName));
+
+    if(IterMaterialize(IterOpen(name), tmpName) == OK)
+        return OK;
+
+    /* Do not leave a partly written relation behind */
+    int err = db_err_code;
+
+    if(FindRel(tmpName))
+        ViewUnmaterialize(tmpName);
+    db_err_code = err;
+    return NOTOK;
+}
+
+void ViewUnmaterialize(const char *tmpName)
+{
+    char *destroyArgv[] = {"_destroy", (char *)tmpName, NULL};
+
+    Destroy(2, destroyArgv);
+}
\ No newline at end of file
@@ -2,6 +2,12 @@
 #include <string.h>
 #include <stdio.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "fes.h"
 #include "../include/createdb.h"
 #include "../include/destroydb.h"
@@ -17,7 +23,7 @@ typedef struct
 	short find, tcode, action, next;
 } PARSER_TABLE;
 
-PARSER_TABLE table[21][20] = 
+PARSER_TABLE table[25][21] = 
 {
 	{{0, CREATEDB, EAT1, 0},
 	 {1, STR, EAT1, 0},
@@ -38,6 +44,9 @@ PARSER_TABLE table[21][20] =
 	 {1, STR, EAT1, 0},
 	 {1, COMMA, THROW, 3},
 	 {0, RPARAN, THROW, 0},
+	 {1, USING, THROW, 10},
+	 {0, SEMI, DONE, 0},
+	 {1, STR, EAT1, 0},
 	 {1, SEMI, DONE, 0}},
 	{{0, DESTROY, EAT1, 0},
 	 {1, STR, EAT1, 0},
@@ -48,6 +57,13 @@ PARSER_TABLE table[21][20] =
 	 {1, STR, EAT1, 0},
 	 {1, SEMI, DONE, 0}},
 	{{0, PRINT, EAT1, 0},
+	 {1, STR, EAT1, 0},
+	 {1, TO, THROW, 5},
+	 {0, FORMAT, INC, 8},
+	 {0, SEMI, DONE, 0},
+	 {1, QUOTEDSTR, EAT1, 0},
+	 {1, FORMAT, THROW, 8},
+	 {0, SEMI, DONE, 0},
 	 {1, STR, EAT1, 0},
 	 {1, SEMI, DONE, 0}},
 	{{0, SORT, EAT1, 0},
@@ -57,40 +73,49 @@ PARSER_TABLE table[21][20] =
 	 {1, STR, EAT1, 0},
 	 {1, ON, THROW, 0},
 	 {1, STR, EAT1, 0},
+	 {1, STR, EAT1, 10},
+	 {0, SIZE, INC, 12},
+	 {0, SEMI, DONE, 0},
+	 {1, SIZE, THROW, 12},
+	 {0, SEMI, DONE, 0},
+	 {1, NUMBER, EAT1, 0},
 	 {1, SEMI, DONE, 0}},
 	{{0, QUIT, EAT1, 0},
 	 {1, SEMI, DONE, 0}},
 	{{0, SELECT, EAT1, 0},
-	 {1, INTO, THROW, 0},
+	 {1, INTO, THROW, 3},
+	 {0, AS, EAT1, 0},
 	 {1, STR, EAT1, 0},
 	 {1, FROM, THROW, 0},
 	 {1, STR, EAT1, 0},
 	 {1, WHERE, THROW, 0},
 	 {1, LPARAN, THROW, 0},
 	 {1, STR, EAT1, 0},
-	 {1, EQOP, EAT3, 14},
-	 {0, GEOP, EAT3, 14},
-	 {0, GTOP, EAT3, 14},
-	 {0, LEOP, EAT3, 14},
-	 {0, NOTEQOP, EAT3, 14},
+	 {1, EQOP, EAT3, 15},
+	 {0, GEOP, EAT3, 15},
+	 {0, GTOP, EAT3, 15},
+	 {0, LEOP, EAT3, 15},
+	 {0, NOTEQOP, EAT3, 15},
 	 {0, LTOP, EAT3, 0},
-	 {1, NUMBER, EAT1, 16},
+	 {1, NUMBER, EAT1, 17},
 	 {0, QUOTEDSTR, EAT1, 0},
 	 {1, AND, THROW, 8},
 	 {0, RPARAN, THROW, 0},
 	 {1, SEMI, DONE, 0}},
 	{{0, PROJECT, EAT1, 0},
-	 {1, INTO, THROW, 0},
+	 {1, INTO, THROW, 3},
+	 {0, AS, EAT1, 0},
 	 {1, STR, EAT1, 0},
 	 {1, FROM, THROW, 0},
 	 {1, STR, EAT1, 0},
 	 {1, LPARAN, THROW, 0},
 	 {1, STR, EAT1, 0},
-	 {1, COMMA, THROW, 6},
+	 {1, COMMA, THROW, 7},
 	 {0, RPARAN, THROW, 0},
 	 {1, SEMI, DONE, 0}},
 	{{0, JOIN, EAT1, 0},
-	 {1, INTO, THROW, 0},
+	 {1, INTO, THROW, 3},
+	 {0, AS, EAT1, 0},
 	 {1, STR, EAT1, 0},
 	 {1, LPARAN, THROW, 0},
 	 {1, STR, EAT1, 0},
@@ -158,6 +183,13 @@ PARSER_TABLE table[21][20] =
 	 {1, STR, EAT1, 0},
 	 {1, ON, THROW, 0},
 	 {1, STR, EAT1, 0},
+	 {1, FILL, THROW, 8},
+	 {0, USING, INC, 11},
+	 {0, SEMI, DONE, 0},
+	 {1, NUMBER, EAT1, 0},
+	 {1, USING, THROW, 11},
+	 {0, SEMI, DONE, 0},
+	 {1, STR, EAT1, 0},
 	 {1, SEMI, DONE, 0}},
 	{{0, DROPINDEX, EAT1, 0},
 	 {1, FOR, THROW, 0},
@@ -166,10 +198,57 @@ PARSER_TABLE table[21][20] =
 	 {0, SEMI, DONE, 0},
 	 {1, STR, EAT1, 0},
 	 {1, SEMI, DONE, 0}},
+	{{0, EXCEPT, EAT1, 0},
+	 {1, INTO, THROW, 3},
+	 {0, FROM, INC, 5},
+	 {1, STR, EAT1, 0},
+	 {1, FROM, THROW, 0},
+	 {1, LPARAN, THROW, 0},
+	 {1, STR, EAT1, 0},
+	 {1, STR, EAT1, 0},
+	 {1, RPARAN, THROW, 0},
+	 {1, SEMI, DONE, 0}},
+	{{0, AGGREGATE, EAT1, 0},
+	 {1, STR, EAT1, 0},
+	 {1, FROM, THROW, 0},
+	 {1, STR, EAT1, 0},
+	 {1, GROUP, THROW, 6},
+	 {0, COMPUTE, INC, 10},
+	 {1, BY, THROW, 0},
+	 {1, STR, EAT1, 0},
+	 {1, COMMA, THROW, 7},
+	 {0, COMPUTE, INC, 0},
+	 {1, STR, EAT1, 0},
+	 {1, LPARAN, THROW, 0},
+	 {1, STR, EAT1, 14},
+	 {0, STAR, EAT1, 0},
+	 {1, RPARAN, THROW, 0},
+	 {1, COMMA, THROW, 10},
+	 {0, SEMI, DONE, 0}},
+	{{0, ANALYZE, EAT1, 0},
+	 {1, STR, EAT1, 0},
+	 {1, SEMI, DONE, 0}},
+	{{0, PREPARE, EAT1, 0},
+	 {1, STR, EAT1, 0},
+	 {1, AS, THROW, 0},
+	 {1, SELECT, THROW, 0},
+	 {0, INSERT, THROW, 0},
+	 {0, DELETE, THROW, 0}},
+	{{0, EXECUTE, EAT1, 0},
+	 {1, STR, EAT1, 0},
+	 {1, LPARAN, THROW, 4},
+	 {0, SEMI, DONE, 0},
+	 {1, NUMBER, EAT1, 7},
+	 {0, QUOTEDSTR, EAT1, 7},
+	 {0, STR, EAT1, 0},
+	 {1, COMMA, THROW, 4},
+	 {0, RPARAN, THROW, 0},
+	 {1, SEMI, DONE, 0}},
 };
 
 void parser ();
 int getinput (char[]);
+int runscript (char*);
 int processquery (char*, char**);
 int synerror (char*, char*, short, short, short);
 int findtoken (char*, char*, short*);
@@ -253,10 +332,189 @@ int getinput (char buff[])
 	}
 } /* getinput */
 
+/*	runscript
+
+	Runs the queries of a script file ("minirel -f script") without
+	prompting or echoing them.  The file is mapped into memory and each
+	query is handed to processquery() where it lies, instead of being
+	read a character at a time into a line buffer as getinput() does;
+	processquery() still copies its tokens into params, as it does for
+	typed queries.  Queries are split as getinput() splits
+	them: a query ends with a semicolon and the rest of its line is
+	discarded.  A line starting with "--" before a query is a comment.
+	Linefeeds and tabs inside a query are skipped by findtoken().
+
+	The output is fully buffered.  Once the script ends, or reaches a
+	quit, the number of queries and the time spent are printed for the
+	whole script and for each command.  The database is closed at the
+	end of a script without a quit.
+*/
+
+/* name of each command, from CREATEDB on */
+static char *cmdnames[] =
+{
+	"createdb", "destroydb", "opendb", "closedb", "create", "destroy",
+	"load", "print", "sort", "quit", "select", "project", "join",
+	"insert", "delete", "intersect", "union", "help", "buildindex",
+	"dropindex", "except", "aggregate", "analyze", "prepare", "execute"
+};
+
+#define NCMDSTAT	(EXECUTE - CREATEDB + 3)	/* commands, explain, errors */
+
+static char *scriptstart = NULL;	/* script being run, for the line of a syntax error */
+
+static double elapsed (struct timespec *from)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - from->tv_sec) + (now.tv_nsec - from->tv_nsec) / 1e9;
+}
+
+static void scriptstats (char *path, long *count, double *secs, struct timespec *start)
+{
+	long total = 0;
+	short i;
+
+	for (i=0; i<NCMDSTAT; i++)
+	{
+		total += count[i];
+	}
+
+	printf("\nScript %s: %ld queries in %.3f s\n", path, total, elapsed(start));
+	printf("%-12s %10s %12s %12s\n", "command", "queries", "total (s)", "mean (ms)");
+	for (i=0; i<NCMDSTAT; i++)
+	{
+		if (count[i] > 0)
+		{
+			printf("%-12s %10ld %12.3f %12.4f\n",
+				(i < NCMDSTAT - 2) ? cmdnames[i] : ((i == NCMDSTAT - 2) ? "explain" : "(error)"),
+				count[i], secs[i], secs[i] * 1000.0 / count[i]);
+		}
+	}
+	fflush(stdout);
+}
+
+int runscript (char *path)
+{
+	char params[MAXPARAS][PARALEN], *ptr[MAXPARAS], tokenbuff[PARALEN];
+	char *script, *p, *end, *semi, *eol;
+	long count[NCMDSTAT];
+	double secs[NCMDSTAT];
+	struct timespec start, qstart;
+	struct stat st;
+	short loop, len, kind;
+	int fd, tcode;
+
+	fd = open(path, O_RDONLY);
+	if ((fd < 0) || (fstat(fd, &st) < 0))
+	{
+		printf("Cannot read script %s.\n", path);
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		return (NOTOK);
+	}
+
+	script = NULL;
+	if (st.st_size > 0)
+	{
+		script = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (script == MAP_FAILED)
+		{
+			printf("Cannot map script %s.\n", path);
+			close(fd);
+			return (NOTOK);
+		}
+		madvise(script, st.st_size, MADV_SEQUENTIAL);
+	}
+	close(fd);
+
+	setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+	memset(count, 0, sizeof(count));
+	memset(secs, 0, sizeof(secs));
+	scriptstart = script;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	p = script;
+	end = script + st.st_size;
+	while (p < end)
+	{
+		/* skip blanks and comment lines up to the next query */
+		if ((*p == ' ') || (*p == '\t') || (*p == '\n') || (*p == '\r'))
+		{
+			p++;
+			continue;
+		}
+		if ((*p == '-') && (p + 1 < end) && (p[1] == '-'))
+		{
+			eol = memchr(p, '\n', end - p);
+			p = eol ? eol + 1 : end;
+			continue;
+		}
+
+		semi = memchr(p, ';', end - p);
+		if (!semi)
+		{
+			break;	/* text after the last query */
+		}
+
+		tcode = findtoken(p, tokenbuff, &len);
+		if ((tcode >= CREATEDB) && (tcode <= EXECUTE))
+		{
+			kind = tcode - CREATEDB;
+		}
+		else
+		{
+			kind = (tcode == EXPLAIN) ? NCMDSTAT - 2 : NCMDSTAT - 1;
+		}
+
+		if (tcode == QUIT)
+		{
+			scriptstats(path, count, secs, &start);
+		}
+
+		if (semi > p)
+		{
+			for (loop=0; loop<(MAXPARAS); loop++)
+			{
+				ptr[loop] = params[loop];
+			}
+			clock_gettime(CLOCK_MONOTONIC, &qstart);
+			processquery(p, ptr);
+			secs[kind] += elapsed(&qstart);
+			count[kind] += 1;
+		}
+
+		/* the rest of the line is discarded, as getinput() does */
+		eol = memchr(semi, '\n', end - semi);
+		p = eol ? eol + 1 : end;
+	}
+
+	scriptstats(path, count, secs, &start);
+	scriptstart = NULL;
+
+	if (db_open)
+	{
+		ptr[0] = "closedb";
+		ptr[1] = NULL;
+		CloseDB(1, ptr);
+	}
+
+	if (script)
+	{
+		munmap(script, st.st_size);
+	}
+	fflush(stdout);
+	return (OK);
+} /* runscript */
+
 int processquery (char *buff, char **ptr)
 {
 	char tokenbuff[PARALEN], *buffstart;
-	short loop, len, command, state, scount, pcount;
+	short loop, len, command, state, scount, pcount, explain, prepare;
+	short isParam[MAXPARAS];
 	int tcode;
 
 	buffstart = buff;
@@ -264,21 +522,71 @@ int processquery (char *buff, char **ptr)
 	for (loop=0; loop<(MAXPARAS); loop++)
 	{
 		ptr[loop][0] = '\0';
+		isParam[loop] = FALSE;
 	}
 	
 	tcode = findtoken(buff, tokenbuff, &len);
+
+	/* "explain" is followed by the select, delete or join it explains */
+	explain = (tcode == EXPLAIN);
+	if (explain)
+	{
+		buff += len;
+		tcode = findtoken(buff, tokenbuff, &len);
+		if ((tcode != SELECT) && (tcode != DELETE) && (tcode != JOIN))
+		{
+			synerror(buffstart, buff, 0, 0, NOCOMMAND);
+			return (CONTINUE);
+		}
+	}
+
+	/* "prepare <name> as" is followed by the select, insert or delete it prepares; its arguments follow the name */
+	prepare = (tcode == PREPARE);
+	if (prepare)
+	{
+		strcpy (ptr[0], tokenbuff);
+		state = 1;
+		buff += len;
+		tcode = findtoken(buff, tokenbuff, &len);
+		if (tcode == STR)
+		{
+			strcpy (ptr[1], tokenbuff);
+			state = 2;
+			buff += len;
+			tcode = findtoken(buff, tokenbuff, &len);
+			if (tcode == AS)
+			{
+				state = 5;
+				buff += len;
+				tcode = findtoken(buff, tokenbuff, &len);
+			}
+		}
+		if ((state != 5) || ((tcode != SELECT) && (tcode != INSERT) && (tcode != DELETE)))
+		{
+			synerror(buffstart, buff, PREPARE - CREATEDB, state, tcode);
+			return (CONTINUE);
+		}
+	}
 	
-	if ((tcode >= CREATEDB) && (tcode <= DROPINDEX))
+	if ((tcode >= CREATEDB) && (tcode <= EXECUTE))
 	{
 		command = tcode - CREATEDB;
 		state = 0;
-		pcount = 0;
+		pcount = prepare ? 2 : 0;
 		loop = 1;
 		do
 		{
 			if (table[command][state].find)
 			{
 				tcode = findtoken(buff, tokenbuff, &len);
+
+				/* in a prepared statement '?' may stand for a string, number or quoted string */
+				if (prepare && (tcode == PARAM) && ((table[command][state].tcode == STR) ||
+					(table[command][state].tcode == NUMBER) || (table[command][state].tcode == QUOTEDSTR)))
+				{
+					tcode = table[command][state].tcode;
+					isParam[pcount] = TRUE;
+				}
 			}
 			
 			if (tcode == table[command][state].tcode)
@@ -347,6 +655,18 @@ int processquery (char *buff, char **ptr)
 
 	ptr[pcount] = NULL;
 
+	if (explain)
+	{
+		Explain (pcount, ptr);
+		return (CONTINUE);
+	}
+
+	if (prepare)
+	{
+		Prepare (pcount, ptr, isParam);
+		return (CONTINUE);
+	}
+
 	switch (command + CREATEDB)
 	{
 		case CREATEDB:
@@ -382,11 +702,9 @@ int processquery (char *buff, char **ptr)
 		case QUIT:
 			Quit (pcount, ptr);
 			return (DONE);
-		/*  
 		case SORT :
 			Sort (pcount, ptr);
 			break;
-		*/
 		case SELECT:
 			Select (pcount, ptr);
 			break;
@@ -402,13 +720,25 @@ int processquery (char *buff, char **ptr)
 		case DELETE:
 			Delete (pcount, ptr);
 			break;
-		/*
 		case INTERSECT :
-			printf ("intersect not yet implemented\n");
+			Intersect (pcount, ptr);
 			break;
 		case UNIONOP :
-			printf ("union not yet implemented\n");
+			Union (pcount, ptr);
+			break;
+		case EXCEPT :
+			Except (pcount, ptr);
+			break;
+		case AGGREGATE :
+			Aggregate (pcount, ptr);
 			break;
+		case ANALYZE :
+			Analyze (pcount, ptr);
+			break;
+		case EXECUTE :
+			Execute (pcount, ptr);
+			break;
+		/*
 		case HELP :
 			printf ("help not yet implemented\n");
 			break;
@@ -422,19 +752,36 @@ int synerror (char *start, char *error_at, short command, short state, short tco
 {
 	short i, more;
 	ptrdiff_t len;
+	long line;
+	char *at;
 	len = error_at - start;
-	
-	for (i=0; i<len; i++)
+
+	if (scriptstart)
 	{
-		printf(" ");
+		/* the query was not echoed: give the line of the script */
+		for (line=1, at=scriptstart; at < error_at; at++)
+		{
+			if (*at == '\n')
+			{
+				line += 1;
+			}
+		}
+		printf("Line %ld: Syntax error: ", line);
 	}
-	
-	while (*error_at == ' ')
+	else
 	{
-		error_at++;
-		printf(" ");
+		for (i=0; i<len; i++)
+		{
+			printf(" ");
+		}
+
+		while (*error_at == ' ')
+		{
+			error_at++;
+			printf(" ");
+		}
+		printf("^\nSyntax error: ");
 	}
-	printf("^\nSyntax error: ");
 
 	switch (tcode)
 	{
@@ -542,6 +889,42 @@ int synerror (char *start, char *error_at, short command, short state, short tco
 			case FOR:
 				printf ("for");
 				break;
+			case FILL:
+				printf ("fill");
+				break;
+			case USING:
+				printf ("using");
+				break;
+			case AS:
+				printf ("as");
+				break;
+			case GROUP:
+				printf ("group");
+				break;
+			case BY:
+				printf ("by");
+				break;
+			case COMPUTE:
+				printf ("compute");
+				break;
+			case FORMAT:
+				printf ("format");
+				break;
+			case STAR:
+				printf ("'*'");
+				break;
+			case PARAM:
+				printf ("'?'");
+				break;
+			case SELECT:
+				printf ("select");
+				break;
+			case INSERT:
+				printf ("insert");
+				break;
+			case DELETE:
+				printf ("delete");
+				break;
 			default:
 				printf ("something else");
 		}
@@ -581,9 +964,9 @@ int findtoken (char *p, char *tokenp, short *len)
 	*len = 0;  /* initialize token length to zero  */
 	count = 0; /* initialize string length to zero */
 
-	while (*p == ' ')
+	while ((*p == ' ') || (*p == '\t') || (*p == '\n') || (*p == '\r'))
 	{ 
-		/* get rid of spaces */
+		/* get rid of spaces, and the linefeeds and tabs of a script */
 		p++;
 		*len += 1;
 	}
@@ -695,6 +1078,16 @@ int findtoken (char *p, char *tokenp, short *len)
 			*len += 1;
 			return (RSQR);
 
+		case '*':
+			strcpy(tokenp, "*");
+			*len += 1;
+			return (STAR);
+
+		case '?':	   /* parameter of a prepared statement */
+			strcpy(tokenp, "?");
+			*len += 1;
+			return (PARAM);
+
 		case '"':	   /* quoted string	*/
 			p++;	   /* store characters within */
 			*len += 1; /* quotes into token buffer */
@@ -772,6 +1165,8 @@ int findtoken (char *p, char *tokenp, short *len)
 			return (INTERSECT);
 		if (strcmp(btokenp, "union") == EQUAL)
 			return (UNIONOP);
+		if (strcmp(btokenp, "except") == EQUAL)
+			return (EXCEPT);
 		if (strcmp(btokenp, "on") == EQUAL)
 			return (ON);
 		if (strcmp(btokenp, "key") == EQUAL)
@@ -798,6 +1193,30 @@ int findtoken (char *p, char *tokenp, short *len)
 			return (DROPINDEX);
 		if (strcmp(btokenp, "for") == EQUAL)
 			return (FOR);
+		if (strcmp(btokenp, "fill") == EQUAL)
+			return (FILL);
+		if (strcmp(btokenp, "using") == EQUAL)
+			return (USING);
+		if (strcmp(btokenp, "as") == EQUAL)
+			return (AS);
+		if (strcmp(btokenp, "aggregate") == EQUAL)
+			return (AGGREGATE);
+		if (strcmp(btokenp, "analyze") == EQUAL)
+			return (ANALYZE);
+		if (strcmp(btokenp, "group") == EQUAL)
+			return (GROUP);
+		if (strcmp(btokenp, "by") == EQUAL)
+			return (BY);
+		if (strcmp(btokenp, "compute") == EQUAL)
+			return (COMPUTE);
+		if (strcmp(btokenp, "explain") == EQUAL)
+			return (EXPLAIN);
+		if (strcmp(btokenp, "format") == EQUAL)
+			return (FORMAT);
+		if (strcmp(btokenp, "prepare") == EQUAL)
+			return (PREPARE);
+		if (strcmp(btokenp, "execute") == EQUAL)
+			return (EXECUTE);
 		if (strcmp(btokenp, "") == EQUAL)
 			return (ILLEGAL);
 
@@ -60,6 +60,8 @@
 #define	DOT			115
 #define SEMI		116
 #define	STR			117
+#define STAR		118
+#define PARAM		119
 
 /* Note: Commands codes must be contiguous */
 
@@ -84,6 +86,11 @@
 #define HELP		218
 #define BUILDINDEX	219
 #define DROPINDEX	220
+#define EXCEPT		221
+#define AGGREGATE	222
+#define ANALYZE		223
+#define PREPARE		224
+#define EXECUTE		225
 
 /* other reserved words */
 #define ON		301		
@@ -96,6 +103,14 @@
 #define WHERE	308
 #define AND		309
 #define FOR		310
+#define FILL	311
+#define USING	312
+#define AS		313
+#define GROUP	314
+#define BY		315
+#define COMPUTE	316
+#define EXPLAIN	317
+#define FORMAT	318
 
 /* action codes */
 #define	ONE		1		
@@ -32,7 +32,7 @@ char DB_DIR[MAX_PATH_LENGTH];  /* database working directory */
 bool db_open = false;   /* database open */
 bool print_flag = true; /* flag to print error messages*/
 bool debug_flag = true; /* for debugging purposes */
-int db_err_code = OK; /* Global state for last error */
+_Thread_local int db_err_code = OK; /* Last error of the calling thread (parallel sort workers hand theirs back) */
 
 const int relcat_recLength = (int)sizeof(RelCatRec);
 const int attrcat_recLength = (int)sizeof(AttrCatRec);
@@ -43,49 +43,55 @@ const int relCat_numPgs = ((NUM_CATS + relcat_recsPerPg - 1) / relcat_recsPerPg)
 const int attrCat_numPgs = ((attrCat_numRecs + attrcat_recsPerPg - 1) / attrcat_recsPerPg);
 
 //relcat record for relcat
-RelCatRec Relcat_rc = {RELCAT, relcat_recLength, relcat_recsPerPg, RELCAT_NUMATTRS, NUM_CATS, relCat_numPgs};
+RelCatRec Relcat_rc = {RELCAT, relcat_recLength, relcat_recsPerPg, RELCAT_NUMATTRS, NUM_CATS, relCat_numPgs, LAYOUT_ROW};
 
 //relcat record for attrcat
-RelCatRec Relcat_ac = {ATTRCAT, attrcat_recLength, attrcat_recsPerPg, ATTRCAT_NUMATTRS, attrCat_numRecs, attrCat_numPgs};
+RelCatRec Relcat_ac = {ATTRCAT, attrcat_recLength, attrcat_recsPerPg, ATTRCAT_NUMATTRS, attrCat_numRecs, attrCat_numPgs, LAYOUT_ROW};
 
 //attrcat record for relName column of relcat
-AttrCatRec Attrcat_rrelName = {offsetof(RelCatRec, relName), RELNAME, "s", "relName", RELCAT, 0, 0, 0};
+AttrCatRec Attrcat_rrelName = {offsetof(RelCatRec, relName), RELNAME, "s", "relName", RELCAT, 0, 0, 0, ENC_NONE};
 
 //attrcat record for recLength column of relcat
-AttrCatRec Attrcat_recLength = {offsetof(RelCatRec, recLength), sizeof(int), "i", "recLength", RELCAT, 0, 0, 0};
+AttrCatRec Attrcat_recLength = {offsetof(RelCatRec, recLength), sizeof(int), "i", "recLength", RELCAT, 0, 0, 0, ENC_NONE};
 
 //attrcat record for recsPerPg column of relcat
-AttrCatRec Attrcat_recsPerPg = {offsetof(RelCatRec, recsPerPg), sizeof(int), "i", "recsPerPg", RELCAT, 0, 0, 0};
+AttrCatRec Attrcat_recsPerPg = {offsetof(RelCatRec, recsPerPg), sizeof(int), "i", "recsPerPg", RELCAT, 0, 0, 0, ENC_NONE};
 
 //attrcat record for numAttrs column of relcat
-AttrCatRec AttrCat_numAttrs = {offsetof(RelCatRec, numAttrs), sizeof(int), "i", "numAttrs", RELCAT, 0, 0, 0};
+AttrCatRec AttrCat_numAttrs = {offsetof(RelCatRec, numAttrs), sizeof(int), "i", "numAttrs", RELCAT, 0, 0, 0, ENC_NONE};
 
 //attrcat record for numRecs column of relcat
-AttrCatRec AttrCat_numRecs = {offsetof(RelCatRec, numRecs), sizeof(int), "i", "numRecs", RELCAT, 0, 0, 0};
+AttrCatRec AttrCat_numRecs = {offsetof(RelCatRec, numRecs), sizeof(int), "i", "numRecs", RELCAT, 0, 0, 0, ENC_NONE};
 
 //attrcat record for numPgs column of relcat
-AttrCatRec AttrCat_numPgs = {offsetof(RelCatRec, numPgs), sizeof(int), "i", "numPgs", RELCAT, 0, 0, 0};
+AttrCatRec AttrCat_numPgs = {offsetof(RelCatRec, numPgs), sizeof(int), "i", "numPgs", RELCAT, 0, 0, 0, ENC_NONE};
+
+//attrcat record for layout column of relcat
+AttrCatRec AttrCat_layout = {offsetof(RelCatRec, layout), sizeof(int), "i", "layout", RELCAT, 0, 0, 0, ENC_NONE};
 
 //attrcat record for offset column of attrcat
-AttrCatRec AttrCat_offset = {offsetof(AttrCatRec, offset), sizeof(int), "i", "offset", ATTRCAT, 0, 0, 0};
+AttrCatRec AttrCat_offset = {offsetof(AttrCatRec, offset), sizeof(int), "i", "offset", ATTRCAT, 0, 0, 0, ENC_NONE};
 
 //attrcat record for length column of attrcat
-AttrCatRec AttrCat_length = {offsetof(AttrCatRec, length), sizeof(int), "i", "length", ATTRCAT, 0, 0, 0};
+AttrCatRec AttrCat_length = {offsetof(AttrCatRec, length), sizeof(int), "i", "length", ATTRCAT, 0, 0, 0, ENC_NONE};
 
 //attrcat record for type column of attrcat
-AttrCatRec AttrCat_type = {offsetof(AttrCatRec, type), TYPE_COL_SIZE, "s", "type", ATTRCAT, 0, 0, 0};
+AttrCatRec AttrCat_type = {offsetof(AttrCatRec, type), TYPE_COL_SIZE, "s", "type", ATTRCAT, 0, 0, 0, ENC_NONE};
 
 //attrcat record for attrName column of attrCat
-AttrCatRec AttrCat_attrName = {offsetof(AttrCatRec, attrName), ATTRNAME, "s", "attrName", ATTRCAT, 0, 0, 0};
+AttrCatRec AttrCat_attrName = {offsetof(AttrCatRec, attrName), ATTRNAME, "s", "attrName", ATTRCAT, 0, 0, 0, ENC_NONE};
 
 //attrcat record for relName column of attrCat
-AttrCatRec AttrCat_arelName = {offsetof(AttrCatRec, relName), RELNAME, "s", "relName", ATTRCAT, 0, 0, 0};
+AttrCatRec AttrCat_arelName = {offsetof(AttrCatRec, relName), RELNAME, "s", "relName", ATTRCAT, 0, 0, 0, ENC_NONE};
 
 //attrcat record for hasIndex column of attrCat
-AttrCatRec AttrCat_hasIndex = {offsetof(AttrCatRec, hasIndex), sizeof(int), "i", "hasIndex", ATTRCAT, 0, 0, 0};
+AttrCatRec AttrCat_hasIndex = {offsetof(AttrCatRec, hasIndex), sizeof(int), "i", "hasIndex", ATTRCAT, 0, 0, 0, ENC_NONE};
 
 //attrcat record for nPages column of attrCat
-AttrCatRec AttrCat_nPages = {offsetof(AttrCatRec, nPages), sizeof(int), "i", "nPages", ATTRCAT, 0, 0, 0};
+AttrCatRec AttrCat_nPages = {offsetof(AttrCatRec, nPages), sizeof(int), "i", "nPages", ATTRCAT, 0, 0, 0, ENC_NONE};
 
 //attrcat record for nKeys column of attrCat
-AttrCatRec AttrCat_nKeys = {offsetof(AttrCatRec, nKeys), sizeof(int), "i", "nKeys", ATTRCAT, 0, 0, 0};
\ No newline at end of file
+AttrCatRec AttrCat_nKeys = {offsetof(AttrCatRec, nKeys), sizeof(int), "i", "nKeys", ATTRCAT, 0, 0, 0, ENC_NONE};
+
+//attrcat record for encoding column of attrCat
+AttrCatRec AttrCat_encoding = {offsetof(AttrCatRec, encoding), sizeof(int), "i", "encoding", ATTRCAT, 0, 0, 0, ENC_NONE};
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include <limits.h>
 #include <errno.h>
 #include <ctype.h>
 #include <string.h>
@@ -732,7 +734,9 @@ bool isValidFloat(char *str)
 FUNCTION isValidForType(type, size, value, dstValuePtr):
 
 DESCRIPTION:
-    Validates a string literal for type (i,f,s) and converts it into the binary representation stored at dstValuePtr.
+    Validates a string literal for type (i,f,d,s) and converts it into the binary representation stored at dstValuePtr.
+    Ints of 1, 2 and 8 bytes reject literals out of their range; a 4-byte int keeps the atoi() conversion.
+    Floats of 8 bytes are parsed as doubles.  Dates are "YYYY-MM-DD" (parseDate()).
 
 RETURNS:
     true  – valid literal + conversion stored
@@ -752,7 +756,25 @@ bool isValidForType(char type, int size, void *value, void *dstValuePtr)
             return false;
         }
 
-        *(int *)(dstValuePtr) = atoi(value);
+        if(size == sizeof(int))
+        {
+            int x = atoi(value);
+            memcpy(dstValuePtr, &x, sizeof(int));
+            return true;
+        }
+
+        long long min = size == 8 ? LLONG_MIN : -(1LL << (8 * size - 1));
+        long long max = size == 8 ? LLONG_MAX : (1LL << (8 * size - 1)) - 1;
+
+        errno = 0;
+        long long x = strtoll(value, NULL, 10);
+
+        if(errno == ERANGE || x < min || x > max)
+        {
+            return false;
+        }
+
+        putIntValue(dstValuePtr, size, x);
     }
     else if(type == 'f')
     {
@@ -761,7 +783,27 @@ bool isValidForType(char type, int size, void *value, void *dstValuePtr)
             return false;
         }
 
-        *(float *)(dstValuePtr) = atof(value);
+        if(size == sizeof(double))
+        {
+            double d = strtod(value, NULL);
+            memcpy(dstValuePtr, &d, sizeof(double));
+        }
+        else
+        {
+            float f = atof(value);
+            memcpy(dstValuePtr, &f, sizeof(float));
+        }
+    }
+    else if(type == 'd')
+    {
+        int days;
+
+        if(!parseDate(value, &days))
+        {
+            return false;
+        }
+
+        memcpy(dstValuePtr, &days, sizeof(int));
     }
     else if(type == 's')
     {
@@ -779,11 +821,11 @@ bool isValidForType(char type, int size, void *value, void *dstValuePtr)
 FUNCTION compareVals(valPtr1, valPtr2, type, size, cmpOp):
 
 FUNCTION DESCRIPTION:
-    Compares two attribute values of type i,f,s for equality.
+    Compares two attribute values of type i,f,d,s for equality.
     Supports CMP_EQ only (used in duplicate detection, tuple comparison).
-        • int     → integer equality
-        • float   → tolerance-based equality via float_cmp()
-        • string  → strncmp() for fixed-length attribute
+        • int, date → integer equality, at the attribute's width
+        • float     → tolerance-based equality via float_cmp(); exact for 8-byte doubles
+        • string    → strncmp() for fixed-length attribute
 
 RETURNS:
     true  – equal
@@ -793,13 +835,17 @@ RETURNS:
 
 bool compareVals(void *valPtr1, void *valPtr2, char type, int size, int cmpOp)
 {
-    if(type == 'i')
+    if(type == 'i' || type == 'd')
+    {
+        return getIntValue(valPtr1, size) == getIntValue(valPtr2, size);
+    }
+    else if(type == 'f' && size == sizeof(double))
     {
-        return *(int *)(valPtr1) == *(int *)(valPtr2);
+        return getFloatValue(valPtr1, size) == getFloatValue(valPtr2, size);
     }
     else if(type == 'f')
     {
-        return float_cmp(*(float *)(valPtr1), *(float *)(valPtr2), FLOAT_REL_EPS, FLOAT_ABS_EPS) == 0;
+        return float_cmp(getFloatValue(valPtr1, size), getFloatValue(valPtr2, size), FLOAT_REL_EPS, FLOAT_ABS_EPS) == 0;
     }
     else if(type == 's')
     {
@@ -808,32 +854,234 @@ bool compareVals(void *valPtr1, void *valPtr2, char type, int size, int cmpOp)
 }
 
 
+/*------------------------------------------------------------
+
+FUNCTION isSameTuple (r, recPtr, newRecord)
+
+PARAMETER DESCRIPTION:
+    r         → open relation whose schema both records follow.
+    recPtr    → first record.
+    newRecord → second record.
+
+FUNCTION DESCRIPTION:
+    Returns true iff the two records agree on every attribute of the relation (floats compared with compareVals() tolerance, strings up to the attribute length).
+    Used for the duplicate check of Insert() and for set semantics in Union()/Intersect()/Except().
+
+------------------------------------------------------------*/
+
+bool isSameTuple(int r, void *recPtr, void *newRecord)
+{
+    return isSameTupleAttrs(catcache[r].attrList, recPtr, newRecord);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION isSameTupleAttrs (attrList, recPtr, newRecord)
+
+FUNCTION DESCRIPTION:
+    isSameTuple() for two records described by attrList rather than by an open relation.
+
+------------------------------------------------------------*/
+
+bool isSameTupleAttrs(AttrDesc *attrList, void *recPtr, void *newRecord)
+{
+    AttrDesc *ptr = attrList;
+
+    for(;ptr;ptr=ptr->next)
+    {
+        char type = (ptr->attr).type[0];
+        int offset = (ptr->attr).offset;
+        int size = (ptr->attr).length;
+
+        if(!compareVals((char *)recPtr + offset, (char *)newRecord + offset, type, size, CMP_EQ))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
 /*------------------------------------------------------------
 
 FUNCTION writeAttrToRec(dstRecPtr, valuePtr, type, size, offset):
 
 FUNCTION DESCRIPTION:
     Writes a single attribute into the destination record at the specified byte offset.
-        • type 'i' → copy 4 bytes
-        • type 'f' → copy 4 bytes
-        • type 's' → copy size bytes and null-terminate
+        • type 'i', 'f', 'd' → copy size bytes
+        • type 's' → copy size bytes, the last one being the terminator
 
 ----------------------------------------------------------------*/
 
 void writeAttrToRec(void *dstRecPtr, void *valuePtr, int type, int size, int offset)
 {
-    if(type == 'i')
+    if(type == 'i' || type == 'f' || type == 'd')
     {
-        *(int *)((char *)dstRecPtr + offset) = *(int *)valuePtr;
-    }
-    else if(type == 'f')
-    {
-        *(float *)((char *)dstRecPtr + offset) = *(float *)valuePtr;
+        memcpy((char *)dstRecPtr + offset, valuePtr, size);
     }
     else if(type == 's')
     {
         strncpy(dstRecPtr + offset, valuePtr, size);
-        *((char *)dstRecPtr + offset + size) = '\0';
+        *((char *)dstRecPtr + offset + size - 1) = '\0';   // size counts the terminator
+    }
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION getIntValue(v, size) / putIntValue(dst, size, x) / getFloatValue(v, size)
+
+DESCRIPTION:
+    Read and write numeric attribute values of every width: ints of 1, 2, 4 or 8 bytes ("i1", "i2", "i", "i8"),
+    dates, which are 4-byte ints, and floats of 4 or 8 bytes ("f", "f8").  Values may be unaligned.
+
+------------------------------------------------------------*/
+
+long long getIntValue(const void *v, int size)
+{
+    switch(size)
+    {
+        case 1: { int8_t x;  memcpy(&x, v, sizeof(x)); return x; }
+        case 2: { int16_t x; memcpy(&x, v, sizeof(x)); return x; }
+        case 8: { int64_t x; memcpy(&x, v, sizeof(x)); return x; }
+        default: { int32_t x; memcpy(&x, v, sizeof(x)); return x; }
+    }
+}
+
+void putIntValue(void *dst, int size, long long x)
+{
+    switch(size)
+    {
+        case 1: { int8_t v = x;  memcpy(dst, &v, sizeof(v)); break; }
+        case 2: { int16_t v = x; memcpy(dst, &v, sizeof(v)); break; }
+        case 8: { int64_t v = x; memcpy(dst, &v, sizeof(v)); break; }
+        default: { int32_t v = x; memcpy(dst, &v, sizeof(v)); break; }
+    }
+}
+
+double getFloatValue(const void *v, int size)
+{
+    if(size == sizeof(double))
+    {
+        double d;
+        memcpy(&d, v, sizeof(d));
+        return d;
+    }
+
+    float f;
+    memcpy(&f, v, sizeof(f));
+    return f;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION compareNumeric(a, b, type, size)
+
+DESCRIPTION:
+    Exact three-way comparison of two int, date or float values of size bytes, as sort and index keys order them.
+    A NaN compares equal to everything.
+
+RETURNS:
+    -1, 0 or 1.
+
+------------------------------------------------------------*/
+
+int compareNumeric(const void *a, const void *b, char type, int size)
+{
+    if(type == 'f')
+    {
+        double x = getFloatValue(a, size), y = getFloatValue(b, size);
+        return (x > y) - (x < y);
+    }
+
+    long long x = getIntValue(a, size), y = getIntValue(b, size);
+    return (x > y) - (x < y);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION parseDate(str, days) / formatDate(days, buf)
+
+DESCRIPTION:
+    Convert between a "YYYY-MM-DD" date, years 1 to 9999, and the days since 1970-01-01 that a 'd' attribute
+    stores, so that dates order and compare as ints.  buf receives 11 bytes.
+
+RETURNS:
+    parseDate(): true iff str is a valid date.
+
+------------------------------------------------------------*/
+
+/* Days from 1970-01-01 to y-m-d of the proleptic Gregorian calendar */
+static int daysFromCivil(int y, int m, int d)
+{
+    y -= m <= 2;
+    int era = y / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+bool parseDate(const char *str, int *days)
+{
+    static const int monthDays[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if(strlen(str) != 10)
+        return false;
+
+    for(int i = 0; i < 10; i++)
+    {
+        if(i == 4 || i == 7 ? str[i] != '-' : !isdigit((unsigned char)str[i]))
+            return false;
+    }
+
+    int y = atoi(str), m = atoi(str + 5), d = atoi(str + 8);
+
+    bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+
+    if(y < 1 || m < 1 || m > 12 || d < 1 || d > monthDays[m - 1] || (m == 2 && d == 29 && !leap))
+        return false;
+
+    *days = daysFromCivil(y, m, d);
+    return true;
+}
+
+void formatDate(int days, char *buf)
+{
+    int z = days + 719468;
+    int era = (z >= 0 ? z : z - 146096) / 146097;
+    int doe = z - era * 146097;
+    int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int mp = (5 * doy + 2) / 153;
+    int d = doy - (153 * mp + 2) / 5 + 1;
+    int m = mp + (mp < 10 ? 3 : -9);
+    int y = yoe + era * 400 + (m <= 2);
+
+    snprintf(buf, 11, "%04d-%02d-%02d", y, m, d);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION typeName(type)
+
+RETURNS:
+    The name of an attribute type in messages: "INTEGER", "FLOAT", "DATE" or "STRING".
+
+------------------------------------------------------------*/
+
+const char *typeName(char type)
+{
+    switch(type)
+    {
+        case 'i': return "INTEGER";
+        case 'f': return "FLOAT";
+        case 'd': return "DATE";
+        default:  return "STRING";
     }
 }
 
@@ -0,0 +1,37 @@
+#ifndef _BITMAP_IDX_H
+#define _BITMAP_IDX_H
+#include "defs.h"
+
+#define BMAP_HDR_MAGIC  '^'     /* type character of a bitmap index file */
+#define WAH_GROUP       31      /* record positions per WAH word */
+
+/* Word-aligned hybrid (WAH) compressed bitmap over record positions pid * recsPerPg + slot */
+typedef struct wahbitmap
+{
+    unsigned int *words;    // literal words (MSB 0) and fill words (MSB 1, bit 30 = fill bit, 30-bit group count)
+    int numWords;
+    int cap;
+} WahBitmap;
+
+/* Header of every "<rel>.<attr>.bmap" file; the value directory follows it */
+typedef struct bmaphdr
+{
+    char magic[MAGIC_SIZE];     // BMAP_HDR_MAGIC followed by GEN_MAGIC
+    int numValues;              // distinct values, one bitmap each
+    int keyLen;                 // length of the indexed attribute
+    int recsPerPg;              // slots per heap page, to map Rids to positions
+    char type;                  // 'i' or 's'
+} BitmapHeader;
+
+void WahInit(WahBitmap *bm);
+void WahFree(WahBitmap *bm);
+int WahAnd(const WahBitmap *a, const WahBitmap *b, WahBitmap *out);
+int WahOr(const WahBitmap *a, const WahBitmap *b, WahBitmap *out);
+long WahCount(const WahBitmap *bm);
+int WahToRids(const WahBitmap *bm, int recsPerPg, Rid **rids, int *numRids);
+
+int BitmapBuild(const char *fname, int relNum, AttrCatRec *attr, int *nPages, int *nKeys);
+int BitmapInsert(const char *fname, void *key, Rid rid);
+int BitmapDelete(const char *fname, void *key, Rid rid);
+int BitmapLookup(const char *fname, void *key, int compOp, WahBitmap *out, int *recsPerPg);
+#endif
\ No newline at end of file
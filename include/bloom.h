@@ -0,0 +1,26 @@
+#ifndef _BLOOM_H
+#define _BLOOM_H
+#include "defs.h"
+
+#define BLOOM_HDR_MAGIC     '~'     /* type character of a Bloom filter file */
+
+/* Head of "<rel>.<attr>.bloom" and "<rel>.rbloom"; numCounters one-byte counters follow */
+typedef struct bloomhdr
+{
+    char magic[MAGIC_SIZE];     // BLOOM_HDR_MAGIC followed by GEN_MAGIC
+    int numCounters;            // power of two
+    int numHashes;
+    int numItems;               // items currently added
+    int capacity;               // items the filter was sized for; past it the filter is rebuilt
+} BloomHeader;
+
+void build_rbloom_filename(const char *relName, char *fname, size_t buflen);
+unsigned long long BloomHashValue(char attrType, int attrSize, const void *key);
+unsigned long long BloomHashRecord(int relNum, const void *recPtr);
+unsigned long long BloomHashAttrs(AttrDesc *attrList, const void *recPtr);
+int BloomBuild(const char *fname, int relNum, AttrCatRec *attr);
+int BloomAdd(const char *fname, unsigned long long h);
+int BloomRemove(const char *fname, unsigned long long h);
+int BloomMayContain(const char *fname, unsigned long long h);
+int BloomRefresh(int relNum);
+#endif
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef _BTREE_H
+#define _BTREE_H
+#include "defs.h"
+
+#define BT_LEAF_MAGIC   '#'     /* type character of a B+-tree leaf page */
+#define BT_NODE_MAGIC   '%'     /* type character of a B+-tree internal page */
+#define BT_HDR_MAGIC    '&'     /* type character of the B+-tree header page */
+#define BT_NO_PAGE      -1      /* terminates the leaf chain */
+
+/* Page 0 of every "<rel>.<attr>.idx" file */
+typedef struct bthdr
+{
+    char magic[MAGIC_SIZE];     // BT_HDR_MAGIC followed by GEN_MAGIC
+    int root;                   // page number of the root node
+    int height;                 // number of levels, 1 when the root is a leaf
+    int numPages;               // pages in the file including this header
+    int numKeys;                // distinct key values at build time
+    int keyLen;                 // length of the indexed attribute
+    char type;                  // 'i', 'f' or 's'
+} BtHeader;
+
+int BtBulkBuild(const char *fname, int relNum, AttrCatRec *attr, int fillPct, int *nPages, int *nKeys);
+int BtInsert(const char *fname, void *key, Rid rid);
+int BtDelete(const char *fname, void *key, Rid rid);
+int BtFindRids(const char *fname, void *key, int compOp, Rid **rids, int *numRids);
+#endif
\ No newline at end of file
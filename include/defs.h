@@ -14,6 +14,7 @@
 #define MAGIC_SIZE          8       /* size of magic number for page */
 #define HEADER_SIZE	        16	    /* number of bytes in header */
 #define	MAXRECORD	        (PAGESIZE - HEADER_SIZE)	/* PAGESIZE minus number of bytes taken up for header */
+#define MAX_RECS_PER_PG     (SLOTMAP * 8)   /* one slotmap bit per record slot */
 #define RELNAME		        20	    /* max length of a relation name */
 #define MAXOPEN		        20      /* max number of files that can be open at the same time */
 #define ATTRNAME	        20      /* max length of an attribute name */
@@ -48,11 +49,44 @@
 #define RELCAT_CACHE    0
 #define ATTRCAT_CACHE   1
 
-#define RELCAT_NUMATTRS  6
-#define ATTRCAT_NUMATTRS 8
+#define RELCAT_NUMATTRS  7
+#define ATTRCAT_NUMATTRS 9
 
 #define NUM_CATS         2
 
+#define LAYOUT_ROW       0  /* relcat layout: records stored whole, one after the other */
+#define LAYOUT_PAX       1  /* relcat layout: a minipage of values per attribute (include/pagelayout.h) */
+#define LAYOUT_SLOTTED   2  /* relcat layout: variable-length records behind an offset directory */
+
+#define ENC_NONE         0  /* attrcat encoding: values stored as they are */
+#define ENC_DICT         1  /* attrcat encoding: int codes of "<rel>.<attr>.dict" on the page (include/dict.h) */
+#define ENC_VAR          2  /* attrcat encoding: a length byte and the characters of the string (LAYOUT_SLOTTED) */
+
+#define IDX_BTREE        1  /* hasIndex bit: "<rel>.<attr>.idx" B+-tree */
+#define IDX_HASH         2  /* hasIndex bit: "<rel>.<attr>.hash" + ".hdir" extendible hash */
+#define IDX_BITMAP       4  /* hasIndex bit: "<rel>.<attr>.bmap" WAH bitmap per distinct value */
+#define IDX_BLOOM        8  /* hasIndex bit: "<rel>.<attr>.bloom" counting Bloom filter */
+
+#define BTREE_FILL_PCT   100        /* default leaf/node fill of a bulk-built B+-tree */
+#define SORT_MEM_BYTES   (1 << 20)  /* default memory budget of the external sort */
+#define SORT_MERGE_BUF   (8 * PAGESIZE) /* stdio buffer of every run file during a merge */
+#define SORT_MAX_THREADS 16         /* worker threads of a parallel sort */
+#define SORT_PAR_MIN_PGS 64         /* heap pages per worker below which a sort stays single-threaded */
+#define SORT_SAMPLES     32         /* splitter samples taken from every worker's sorted output */
+#define SETOP_MEM_BYTES  (1 << 20)  /* memory of a hash set operation before its inputs are partitioned to disk */
+#define SETOP_MAX_DEPTH  3          /* partitioning passes of a hash set operation before it stays in memory regardless */
+#define AGG_MEM_BYTES    (1 << 20)  /* memory of the groups of a hash aggregation before new groups spill to disk */
+#define AGG_SPILL_PARTS  16         /* partition files a hash aggregation spills into */
+#define AGG_MAX_DEPTH    3          /* spilling passes of a hash aggregation before it stays in memory regardless */
+#define JOIN_MEM_BYTES   (1 << 20)  /* memory of a join: hash table of its build side, or block of outer records */
+#define STAT_SAMPLE_ROWS 10000      /* records sampled by analyze for distinct counts and histograms */
+#define STAT_DRIFT_PCT   20         /* change of numRecs, in percent, past which statistics are recomputed when used */
+#define STAT_DRIFT_MIN   100        /* records the drift is measured against at least, so small relations are not re-analyzed on every insert */
+#define BITMAP_MAX_VALUES 256       /* distinct values a bitmap index is built for */
+#define BLOOM_MIN_ITEMS  1024       /* smallest capacity a Bloom filter is sized for */
+#define BLOOM_BITS_PER_ITEM 10      /* counters per item of capacity (~1% false positives) */
+#define BLOOM_NUM_HASHES 7
+
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 #define INVALID_RID ((Rid){-1, -1})
@@ -86,6 +120,7 @@ typedef struct relcat_rec
     int numAttrs;               	// number of attributes
     int numRecs;                	// number of records
     int numPgs;                 	// number of pages
+    int layout;                     // LAYOUT_ROW, LAYOUT_PAX or LAYOUT_SLOTTED
 } RelCatRec;
 
 typedef struct attrcat_rec 
@@ -98,6 +133,7 @@ typedef struct attrcat_rec
     int hasIndex;
     int nPages;
     int nKeys;   
+    int encoding;                   // ENC_NONE, ENC_DICT or ENC_VAR
 } AttrCatRec;
 
 typedef struct attrDesc 
@@ -105,6 +141,9 @@ typedef struct attrDesc
     AttrCatRec attr;                // attribute catalog record
     Rid attrCatRid;  				// Pointer to attrcat record where changes should be written
     struct attrDesc *next;			// pointer to next attribute catalog record
+    int pageOffset;                 // offset of the attribute within a record as stored in a page (ENC_VAR: ordinal)
+    int pageLength;                 // bytes the attribute takes in a page (ENC_VAR: 0, its value is not at a fixed place)
+    struct dict *dict;              // dictionary of an ENC_DICT attribute, NULL otherwise
 } AttrDesc;
 
 typedef struct cacheentry {
@@ -114,6 +153,12 @@ typedef struct cacheentry {
     int status;                     // LSB is for dirty and 2nd LSB for valid/invalid
     uint32_t timestamp;         //  4 byte UNIX timestamp to implement LRU policy
     AttrDesc *attrList; 		    // linked list of attributes
+    int pageRecLength;              // bytes a record takes in a page; recLength unless encoded (slotted: its fixed part)
+    int pageVarAttrs;               // ENC_VAR attributes, whose values follow the fixed part of a slotted record
+    char *zoneMap;                  // in-memory copy of "<relName>.zmap", NULL until first used
+    int zoneMapPgs;                 // pages described by zoneMap
+    struct relstats *stats;         // "<relName>.stat" as last read or analyzed, NULL until first used
+    unsigned openSeq;               // number of the OpenRel() that loaded the entry, to tell a reloaded slot
 } CacheEntry;
 
 typedef struct buffer 
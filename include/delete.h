@@ -0,0 +1,5 @@
+#ifndef _DELETE_H
+#define _DELETE_H
+#include "planner.h"
+int DeleteConj(int r, Conjunct *conj, int numConj);
+#endif
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef _DICT_H
+#define _DICT_H
+#include "defs.h"
+
+/*
+ * Dictionary of a dictionary-encoded string attribute (physical/dict.c).
+ * "<rel>.<attr>.dict" lists the distinct values in code order, attr.length NUL padded bytes each;
+ * a page stores the int code of a value in place of its string.  Codes are never reused or
+ * reassigned, so the file only grows.
+ */
+typedef struct dict
+{
+    int strLen;                 // bytes of an entry: the attribute's length
+    int numCodes;               // entries; codes are 0 .. numCodes - 1
+    int cap;                    // entries strs has room for
+    char *strs;                 // entry of code c at c * strLen
+    int *table;                 // open addressing on the entries: code + 1, or 0 for a free bucket
+    int tableSize;              // buckets, a power of two above twice numCodes
+    char fileName[RELNAME + ATTRNAME + 8];
+} Dict;
+
+/* Value of a code of d, strLen bytes */
+#define DictString(d, code)     ((d)->strs + (size_t)(code) * (d)->strLen)
+
+Dict *DictOpen(const char *relName, const char *attrName, int strLen);
+void DictClose(Dict *d);
+int DictLookup(const Dict *d, const char *value);
+int DictEncode(Dict *d, const char *value, int *code);
+unsigned char *DictMatch(const Dict *d, const char *value, int compOp);
+int RemoveDict(const char *relName, const char *attrName);
+#endif
\ No newline at end of file
@@ -14,6 +14,7 @@ int ErrorMsgs(int errorNum, bool printFlag);
 #define INVALID_FORMAT 604 /* Attribute has invalid format */
 #define STR_LEN_INVALID 605 /* String length limit for attribute is more than 50 */
 #define TOO_MANY_ARGS   606 /* Too many command line arguments passed */
+#define INVALID_OPTION  607 /* Unknown option of a command, such as a page layout or an output format */
 #define RELNOEXIST  101   /* Relation does not exist */
 #define RELEXIST    102   /* Relation already exists */
 #define REL_LENGTH_EXCEEDED 103 /* Relation name too long */
@@ -22,6 +23,9 @@ int ErrorMsgs(int errorNum, bool printFlag);
 #define INVALID_RELNUM 106 /* Relation number is invalid */
 #define IDXNOEXIST   107  /* Index does NOT exist for given attribute of the relation */
 #define IDXEXIST     108 /* Index already exists for the given relation attribute */
+#define IDX_TYPE_INVALID 109 /* Index kind cannot be built on the attribute type */
+#define IDX_TOO_MANY_VALUES 110 /* Attribute has too many distinct values for a bitmap index */
+#define VIEW_READONLY 111 /* Relation is a view, which cannot be changed or indexed */
 #define ATTRNOEXIST 201   /* Attribute does not exist */
 #define ATTREXIST   202   /* Attribute already exists */
 #define ATTR_NAME_EXCEEDED 203 /* Attribute name too long */
@@ -33,6 +37,12 @@ int ErrorMsgs(int errorNum, bool printFlag);
 #define REC_INS_ERR     208 /* Some error in inserting record */
 #define REC_DEL_ERR     209 /* Some error in deleting a record */
 #define INCOMPATIBLE_TYPES  210 /* Attribute types for Join are incompatible */
+#define NOT_UNION_COMPATIBLE 211 /* Relations of a set operation differ in their attribute types */
+#define AGG_INVALID     212 /* Unknown aggregate function, or one that does not apply to the attribute's type */
+#define STMT_NOEXIST    213 /* No statement has been prepared under that name */
+#define STMT_INVALID    214 /* A parameter stands where only a literal or the result relation may */
+#define STMT_ARGS       215 /* Execute gives a different number of values than the statement has parameters */
+#define AGG_NO_ROWS     216 /* min, max or avg of an ungrouped aggregate over no rows */
 #define CAT_CREATE_ERROR   301 /* Error in creating catalog tables */
 #define CAT_OPEN_ERROR 302 /* Error in opening catalog files */
 #define CAT_ALREADY_EXISTS 303 /* Something went wrong. Catalog files already exist */
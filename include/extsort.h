@@ -0,0 +1,51 @@
+#ifndef _EXT_SORT_H
+#define _EXT_SORT_H
+#include <stdio.h>
+#include "defs.h"
+
+typedef int (*ExtSortCmp)(const void *a, const void *b, void *ctx);
+
+/* k-way merge of sorted run files through a tournament (loser) tree */
+typedef struct extmerge
+{
+    int recSize;                    // size of every record
+    ExtSortCmp cmp;                 // comparator, qsort_r style
+    void *ctx;                      // opaque context passed to cmp
+    int k;                          // number of runs being merged
+    FILE **runs;                    // open run files, owned by the merge
+    long *left;                     // records still to be read from each run, -1 = up to end of file
+    char *heads;                    // current head record of every run
+    char *done;                     // done[i] once run i is exhausted
+    int *tree;                      // tree[0] = winner, tree[1..k-1] = loser of each match
+} ExtMerge;
+
+typedef struct extsort
+{
+    int recSize;                    // size of every record being sorted
+    ExtSortCmp cmp;                 // comparator, qsort_r style
+    void *ctx;                      // opaque context passed to cmp
+    char prefix[RELNAME + ATTRNAME + 8]; // prefix of temporary run files
+    long memBytes;                  // memory budget
+    char *mem;                      // replacement-selection workspace
+    long memRecs;                   // capacity of mem in records
+    long nInMem;                    // records currently held in mem
+    int *heap;                      // min-heap of mem slots keyed on (run, record)
+    int *slotRun;                   // run each held record is destined for
+    int curRun;                     // run being written, -1 before the first spill
+    FILE *out;                      // file of curRun
+    char *lastOut;                  // last record written to curRun
+    int numRuns;                    // run files created so far (including merge passes)
+    int finished;                   // ExtSortFinish() has been called
+    long nextMem;                   // cursor into mem when nothing was spilled
+    ExtMerge merge;                 // final merge
+} ExtSort;
+
+int ExtSortOpen(ExtSort *s, int recSize, ExtSortCmp cmp, void *ctx, long memBytes, const char *prefix);
+int ExtSortAdd(ExtSort *s, const void *rec);
+int ExtSortFinish(ExtSort *s);
+int ExtSortNext(ExtSort *s, void *rec);
+void ExtSortClose(ExtSort *s);
+int ExtMergeOpen(ExtMerge *m, int recSize, ExtSortCmp cmp, void *ctx, FILE **runs, const long *counts, int k);
+int ExtMergeNext(ExtMerge *m, void *rec);
+void ExtMergeClose(ExtMerge *m);
+#endif
\ No newline at end of file
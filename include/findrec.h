@@ -1,5 +1,6 @@
 #ifndef _FINDREC_H
 #define _FINDREC_H
 #include "defs.h"
+int compareRecs(void *curRec, void *valuePtr, char attrType, int attrSize, int attrOffset, int compOp);
 int FindRec(int relNum, Rid startRid, Rid *foundRid, void *recPtr, char attrType, int attrSize, int attrOffset, void *valuePtr, int compOp);
 #endif
@@ -3,7 +3,6 @@
 void build_fmap_filename(const char *relName, char *fname, size_t buflen);
 int FreeMapExists(const char *relName);
 int CreateFreeMap(const char *relName);
-int AddToFreeMap(const char *relName, short pageNum);
-int DeleteFromFreeMap(const char *relName, short pageNum);
-int FindFreeSlot(const char *relName);
+int SetFreeSpace(const char *relName, short pageNum, int freeBytes);
+int FindFreePage(const char *relName, int numPgs, int needBytes);
 #endif
\ No newline at end of file
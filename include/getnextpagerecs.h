@@ -0,0 +1,5 @@
+#ifndef _GETNEXTPAGERECS_H
+#define _GETNEXTPAGERECS_H
+#include "../include/defs.h"
+int GetNextPageRecs(int relNum, short *pid, Rid *rids, char **recs, int *numRecs);
+#endif
\ No newline at end of file
@@ -0,0 +1,5 @@
+#ifndef _GETREC_H
+#define _GETREC_H
+#include "../include/defs.h"
+int GetRec(int relNum, Rid rid, void *recPtr);
+#endif
\ No newline at end of file
@@ -14,7 +14,7 @@ extern char DB_DIR[MAX_PATH_LENGTH];
 extern bool db_open;
 extern bool print_flag;
 extern bool debug_flag;
-extern int db_err_code;
+extern _Thread_local int db_err_code;
 
 extern const int relcat_recLength;
 extern const int attrcat_recLength;
@@ -32,6 +32,7 @@ extern AttrCatRec Attrcat_recsPerPg;
 extern AttrCatRec AttrCat_numAttrs;
 extern AttrCatRec AttrCat_numRecs;
 extern AttrCatRec AttrCat_numPgs;
+extern AttrCatRec AttrCat_layout;
 extern AttrCatRec AttrCat_offset;
 extern AttrCatRec AttrCat_length;
 extern AttrCatRec AttrCat_type;
@@ -40,6 +41,7 @@ extern AttrCatRec AttrCat_arelName;
 extern AttrCatRec AttrCat_hasIndex;
 extern AttrCatRec AttrCat_nPages;
 extern AttrCatRec AttrCat_nKeys;
+extern AttrCatRec AttrCat_encoding;
 #endif
 
 int Create (int argc, char **argv);
@@ -53,6 +55,15 @@ int Insert (int argc, char **argv);
 int Delete (int argc, char **argv);
 int Project (int argc, char **argv);
 int Select (int argc, char **argv);
+int Sort (int argc, char **argv);
 int Join (int argc, char **argv);
+int Union (int argc, char **argv);
+int Intersect (int argc, char **argv);
+int Except (int argc, char **argv);
+int Aggregate (int argc, char **argv);
+int Analyze (int argc, char **argv);
+int Explain (int argc, char **argv);
+int Prepare (int argc, char **argv, const short *isParam);
+int Execute (int argc, char **argv);
 int FlushPage(int relNum);
 int FindRelNum(const char *relName);
@@ -0,0 +1,36 @@
+#ifndef _HASH_IDX_H
+#define _HASH_IDX_H
+#include "defs.h"
+
+#define HASH_HDR_MAGIC      '*'     /* type character of the hash header page */
+#define HASH_BUCKET_MAGIC   '+'     /* type character of a bucket or overflow page */
+#define HASH_MAX_DEPTH      16      /* directory never grows past 2^16 slots */
+
+/* Page 0 of every "<rel>.<attr>.hash" file; the directory lives in "<rel>.<attr>.hdir" */
+typedef struct hashhdr
+{
+    char magic[MAGIC_SIZE];     // HASH_HDR_MAGIC followed by GEN_MAGIC
+    int globalDepth;            // directory has 2^globalDepth slots
+    int numPages;               // pages in the bucket file including this header
+    int numBuckets;             // primary bucket pages; the rest are overflow pages
+    int numKeys;                // distinct key values currently indexed
+    int keyLen;                 // length of the indexed attribute
+    char type;                  // 'i' or 's'
+} HashHeader;
+
+typedef struct hashstats
+{
+    int globalDepth;
+    int numBuckets;
+    int numOverflow;            // overflow pages hanging off bucket pages
+    int longestChain;           // pages in the longest bucket chain
+    int numPages;
+    int numKeys;
+} HashStats;
+
+int HashBuild(const char *fname, const char *dname, int relNum, AttrCatRec *attr, int *nPages, int *nKeys);
+int HashInsert(const char *fname, const char *dname, void *key, Rid rid);
+int HashDelete(const char *fname, const char *dname, void *key, Rid rid);
+int HashLookup(const char *fname, const char *dname, void *key, Rid **rids, int *numRids);
+int HashGetStats(const char *fname, const char *dname, HashStats *stats);
+#endif
\ No newline at end of file
@@ -18,6 +18,15 @@ bool isValidFloat(char *str);
 bool isValidInteger(char *str);
 bool isValidForType(char type, int size, void *value, void *resultPtr);
 bool compareVals(void *valPtr1, void *valPtr2, char type, int size, int cmpOp);
+bool isSameTuple(int r, void *recPtr, void *newRecord);
+bool isSameTupleAttrs(AttrDesc *attrList, void *recPtr, void *newRecord);
 void writeAttrToRec(void *dstRecPtr, void *valuePtr, int type, int size, int offset);
+long long getIntValue(const void *v, int size);
+void putIntValue(void *dst, int size, long long x);
+double getFloatValue(const void *v, int size);
+int compareNumeric(const void *a, const void *b, char type, int size);
+bool parseDate(const char *str, int *days);
+void formatDate(int days, char *buf);
+const char *typeName(char type);
 void printCloseStrings(int catRelNum, int offset, char *typedVal, char *filter);
 #endif
\ No newline at end of file
@@ -0,0 +1,14 @@
+#ifndef _IDX_MAINT_H
+#define _IDX_MAINT_H
+#include <stddef.h>
+#include "defs.h"
+#include "bitmapidx.h"
+void build_idx_filename(const char *relName, const char *attrName, const char *ext, char *fname, size_t buflen);
+int InsertIndexEntries(int relNum, void *recPtr, Rid rid);
+int DeleteIndexEntries(int relNum, void *recPtr, Rid rid);
+int RemoveIndexFiles(const char *relName, AttrCatRec *attr);
+int IndexAnswers(const AttrCatRec *attr, int compOp);
+int IndexRulesOut(int relNum, const AttrCatRec *attr, const void *valuePtr, int compOp);
+int FindBitmapByIndex(int relNum, const AttrCatRec *attr, void *valuePtr, int compOp, WahBitmap *bm, int *recsPerPg);
+int FindRidsByIndex(int relNum, AttrCatRec *attr, void *valuePtr, int compOp, Rid **rids, int *numRids);
+#endif
\ No newline at end of file
@@ -0,0 +1,5 @@
+#ifndef _INSERT_H
+#define _INSERT_H
+#include <stdbool.h>
+int InsertTuple(int r, void *newRecord, bool flag);
+#endif
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef _ITERATOR_H
+#define _ITERATOR_H
+#include "defs.h"
+
+typedef struct iter Iter;
+
+/* Rows of a batch: about 16 to 1000 pages of a relation, depending on its record length */
+#define BATCH_SIZE  1024
+
+/*
+ * Column batch passed between the pipelined operators: cols[k] holds numRows values of the k-th
+ * attribute of the schema, attr.length bytes apart, and sel lists the rows that are part of the
+ * result.  A filter only shortens sel; a projection only picks columns.
+ */
+typedef struct batch
+{
+    int numRows;                // values in every column
+    int numSel;                 // rows selected, 1 .. numRows
+    short sel[BATCH_SIZE];      // selected rows, ascending
+    char **cols;                // one vector per attribute, in attrList order
+} Batch;
+
+/*
+ * Open/next/close interface of the pipelined operators (algebra/iterator.c).
+ * An operator pulls batches of its inputs' rows, so a composed query writes nothing but its final result.
+ */
+struct iter
+{
+    int (*nextBatch)(Iter *it, Batch **batch); // 1 with *batch set, 0 at the end, NOTOK on error
+    int (*rewind)(Iter *it);            // restart from the first row
+    void (*close)(Iter *it);            // close the inputs and free the iterator
+    AttrDesc *attrList;                 // schema of the rows returned, packed offsets
+    int numAttrs;                       // attributes in attrList
+    int recSize;                        // length of a row as a record
+    char name[RELNAME];                 // relation or view read, for messages
+    void *state;                        // operator specific
+    Batch *cur;                         // batch IterNext() is reading
+    int curPos;                         // next entry of cur->sel
+    char *rec;                          // record IterNext() returned
+};
+
+/* *batch stays valid until the next call on the iterator */
+#define IterNextBatch(it, batch)    ((it)->nextBatch((it), (batch)))
+#define IterClose(it)               ((it)->close((it)))
+
+Iter *IterOpen(const char *name);
+Iter *ScanIterOpen(const char *relName);
+Iter *ScanIterOpenCols(const char *relName, int numAttrs, char **attrNames);
+Iter *FilterIterOpen(Iter *child, int numConj, char **conj);
+Iter *ProjectIterOpen(Iter *child, int numAttrs, char **attrNames);
+Iter *JoinIterOpen(Iter *left, const char *attrName1, Iter *right, const char *attrName2);
+Iter *PlanSelect(int argc, char **argv);
+Iter *PlanProject(int argc, char **argv);
+Iter *PlanJoin(int argc, char **argv);
+int IterNext(Iter *it, char **rec);
+int IterRewind(Iter *it);
+int IterMaterialize(Iter *it, const char *dstRelName);
+#endif
\ No newline at end of file
@@ -0,0 +1,5 @@
+#ifndef _JOIN_H
+#define _JOIN_H
+#include "defs.h"
+int JoinAttrList(AttrDesc *head1, AttrDesc *head2, AttrDesc *ad2, const char *attrName2, AttrDesc **resHeadOut);
+#endif
\ No newline at end of file
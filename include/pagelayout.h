@@ -0,0 +1,45 @@
+#ifndef _PAGELAYOUT_H
+#define _PAGELAYOUT_H
+#include "defs.h"
+
+/*
+ * Where a record's values sit in a heap page (physical/pagelayout.c).
+ * An attribute takes pageLength bytes of a page: its length, or sizeof(int) for the code of an
+ * ENC_DICT attribute.  pageOffset adds up the pageLength of the attributes before it, and
+ * pageRecLength of all of them.
+ * LAYOUT_ROW keeps slot s whole at HEADER_SIZE + s * pageRecLength.  LAYOUT_PAX gives every attribute a
+ * minipage of recsPerPg values: attribute a is at HEADER_SIZE + a->pageOffset * recsPerPg + s * a->pageLength.
+ * Both use recsPerPg * pageRecLength bytes of the page.
+ * LAYOUT_SLOTTED, the layout of relations with ENC_VAR attributes, follows the header with an offset
+ * directory: an unsigned short per slot up to the last live one, giving where the slot's record starts.
+ * Records are packed from the end of the page towards the directory: the fixed part of pageRecLength
+ * bytes, then a length byte and the characters of every ENC_VAR value, in attrList order.  Deleting
+ * leaves a hole, which is compacted away when an insert needs the room.  PageAttrPos() and
+ * PageAttrStride() do not apply to such pages; PageAttrValue() does.
+ */
+
+/* Page offset of slot's value of attribute a of the relation of cache entry entry (row and PAX pages) */
+#define PageAttrPos(entry, slot, a)                                                                 \
+    ((entry)->relcat_rec.layout == LAYOUT_PAX                                                       \
+        ? HEADER_SIZE + (a)->pageOffset * (entry)->relcat_rec.recsPerPg + (slot) * (a)->pageLength  \
+        : HEADER_SIZE + (slot) * (entry)->pageRecLength + (a)->pageOffset)
+
+/* Distance between the values of consecutive slots of attribute a (row and PAX pages) */
+#define PageAttrStride(entry, a) \
+    ((entry)->relcat_rec.layout == LAYOUT_PAX ? (a)->pageLength : (entry)->pageRecLength)
+
+/* Slots of a page hold records exactly as the layers above see them */
+#define PageRecsInPlace(entry) \
+    ((entry)->relcat_rec.layout == LAYOUT_ROW && (entry)->pageRecLength == (entry)->relcat_rec.recLength)
+
+int PageAttrLength(const AttrCatRec *attr);
+int PageLayoutInit(CacheEntry *entry);
+void PageLayoutRelease(CacheEntry *entry);
+AttrDesc *PageAttrAt(const CacheEntry *entry, int offset);
+void PageGetValue(const AttrDesc *attr, const char *v, char *dst);
+const char *PageAttrValue(const CacheEntry *entry, const char *page, int slot, const AttrDesc *attr, char *buf);
+void PageGetRec(const CacheEntry *entry, const char *page, int slot, void *rec);
+int PagePutRec(const CacheEntry *entry, char *page, int slot, const void *rec);
+int PageRecBytes(const CacheEntry *entry, const void *rec);
+int PageFreeBytes(const CacheEntry *entry, const char *page);
+#endif
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef _PAR_SORT_H
+#define _PAR_SORT_H
+#include "defs.h"
+#include "extsort.h"
+
+/* Receives the sorted entries of ParSortRel() in order; returns OK or NOTOK */
+typedef int (*ParSortSink)(const void *ent, void *arg);
+
+int ParSortThreads(int relNum);
+int ParSortRel(int relNum, int numThreads, ExtSortCmp cmp, void *ctx, long memBytes, const char *prefix,
+               ParSortSink sink, void *arg);
+#endif
\ No newline at end of file
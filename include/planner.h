@@ -0,0 +1,71 @@
+#ifndef _PLANNER_H
+#define _PLANNER_H
+#include <stdbool.h>
+#include "defs.h"
+#include "predicate.h"
+
+/* Access paths of a select or delete */
+#define ACCESS_SCAN     0   /* every page is read */
+#define ACCESS_ZONEMAP  1   /* FindRec() on the driving conjunct, skipping the pages its zone map rules out */
+#define ACCESS_INDEX    2   /* only the Rids FindRidsByIndex() gives for the driving conjunct are read */
+#define ACCESS_BITMAP   3   /* only the Rids of the AND of the bitmaps of every conjunct a bitmap index answers are read */
+#define ACCESS_METHODS  4
+
+/* Join methods; the order is that of preference between plans of equal cost */
+#define JOIN_HASH       0   /* hash table on the build side, probed by the other */
+#define JOIN_INL        1   /* index of the inner side probed for every outer record */
+#define JOIN_SORTMERGE  2   /* both sides sorted on the join attribute, then merged */
+#define JOIN_BNL        3   /* inner side scanned once per block of outer records */
+#define JOIN_NL         4   /* inner side scanned once per outer record */
+#define JOIN_METHODS    5
+
+#define PLAN_CPU_REC    0.01    /* cost of handling one record, in page reads */
+#define PLAN_CPU_CMP    0.002   /* cost of comparing two keys, in page reads */
+#define PLAN_NO_COST    1e300   /* cost of a method that does not apply */
+
+/* One conjunct "attr op literal" of a select or delete predicate */
+typedef struct conjunct
+{
+    int arg;            // position of the conjunct in the command
+    AttrDesc *attrDesc; // attribute being compared
+    AttrCatRec *attr;   // its catalog record
+    int compOp;         // CMP_* code
+    void *valuePtr;     // literal converted to the attribute type
+    Pred pred;          // compiled "attr op literal"
+    double sel;         // estimated fraction of records satisfying the conjunct
+    double rank;        // evaluation order key; lower is evaluated first
+} Conjunct;
+
+/* Access path chosen for a conjunction over a heap relation */
+typedef struct accessplan
+{
+    int method;                     // ACCESS_* chosen
+    int driver[ACCESS_METHODS];     // conjunct each path is driven by (FindRec() or the index), -1 when it does not apply
+    double pages[ACCESS_METHODS];   // estimated page reads of each path
+    double cost[ACCESS_METHODS];    // estimated cost of each path, PLAN_NO_COST when it does not apply
+    double rows;                    // estimated records satisfying every conjunct
+} AccessPlan;
+
+/* Method chosen for an equi-join of two heap relations */
+typedef struct joinplan
+{
+    int method;                     // JOIN_*
+    int swap;                       // the right relation is the outer (NL, BNL, INL) or the probe is the left one (hash)
+    double rows1, rows2;            // records of the left and right relations
+    double pages1, pages2;          // and their pages
+    double distinct1, distinct2;    // estimated distinct join keys on each side
+    double rows;                    // estimated joined records
+    double cost[JOIN_METHODS];      // best cost of every method, PLAN_NO_COST when it does not apply
+    int costSwap[JOIN_METHODS];     // side giving that cost
+    double total;                   // cost of the plan chosen
+} JoinPlan;
+
+int ConjResolve(int relNum, const char *relName, int numConj, char **args, Conjunct **conjOut);
+int ConjBind(int relNum, Conjunct *conj, int numConj, char **args);
+int ConjBuild(int relNum, const char *relName, int numConj, char **args, Conjunct **conjOut);
+void ConjFree(Conjunct *conj, int numConj);
+bool ConjMatch(const void *recPtr, Conjunct *conj, int numConj, int skip);
+void PlanAccess(int relNum, Conjunct *conj, int numConj, AccessPlan *plan);
+int PlanFindRids(int relNum, Conjunct *conj, int numConj, const AccessPlan *plan, Rid **rids, int *numRids);
+void PlanJoinMethod(int r1, AttrDesc *ad1, int r2, AttrDesc *ad2, JoinPlan *plan);
+#endif
\ No newline at end of file
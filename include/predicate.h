@@ -0,0 +1,37 @@
+#ifndef _PREDICATE_H
+#define _PREDICATE_H
+#include "defs.h"
+
+typedef struct pred Pred;
+
+/* Kernel evaluating one compiled predicate on a record image; returns 1 on a match */
+typedef int (*PredFn)(const void *rec, const Pred *p);
+
+/* Kernel evaluating a predicate on the first numSlots records of a page; returns the match bitmask ANDed with live */
+typedef unsigned long (*PredPageFn)(const Pred *p, const char *recs, int recSize, int numSlots, unsigned long live);
+
+/* Predicate "attr op literal" resolved once into the kernel for its (type, op) pair */
+struct pred
+{
+    PredFn fn;          // specialised kernel
+    PredPageFn pageFn;  // page-at-a-time kernel (SIMD when the CPU allows it)
+    int offset;         // attribute offset within the record
+    int size;           // attribute length
+    int ival;           // literal of a 4-byte int or date attribute
+    long long lval;     // literal of a 1, 2 or 8-byte int attribute
+    double fval;        // literal of a float or double attribute
+    double ftol;        // max(FLOAT_ABS_EPS, FLOAT_REL_EPS * |fval|)
+    const char *sval;   // literal of a string attribute (the caller's buffer)
+    int slen;           // bytes of sval that may be read: through its NUL, or attrSize + 1 without one
+    const unsigned char *codeMatch; // flag per dictionary code, for PredInitCodes() (the caller's buffer)
+    int numCodes;       // entries of codeMatch
+};
+
+#define PredEval(p, rec)    ((p)->fn((rec), (p)))
+#define PredEvalPage(p, recs, recSize, numSlots, live) \
+    ((p)->pageFn((p), (recs), (recSize), (numSlots), (live)))
+
+void PredInit(Pred *p, char attrType, int attrSize, int attrOffset, const void *valuePtr, int compOp);
+void PredInitCodes(Pred *p, int attrOffset, const unsigned char *codeMatch, int numCodes);
+int PredEvalSel(const Pred *p, const char *col, int numRows, const short *sel, int numSel, short *out);
+#endif
\ No newline at end of file
@@ -0,0 +1,25 @@
+#ifndef _PREPARE_H
+#define _PREPARE_H
+#include "defs.h"
+#include "planner.h"
+
+/* A select into, insert or delete kept for the session, executed with new literals for its parameters '?' */
+typedef struct prepared
+{
+    char name[RELNAME];
+    int argc;
+    char **argv;            // copy of the command arguments, argv[0] = "select", "insert" or "delete"
+    int numParams;
+    int *paramArg;          // argument each parameter stands for, in the order of the command
+    int relNum;             // relation the statement is resolved on, NOTOK while unresolved
+    unsigned openSeq;       // catcache[relNum].openSeq when it was resolved
+    Conjunct *conj;         // select, delete: conjuncts resolved on relNum, bound again at every execution
+    int numConj;
+    char *record;           // insert: record holding the literals that are not parameters
+    AttrDesc **attrs;       // insert: attribute of every (attribute, value) pair
+    struct prepared *next;
+} Prepared;
+
+Prepared *PrepareFind(const char *name);
+void PrepareDropAll(void);
+#endif
\ No newline at end of file
@@ -0,0 +1,5 @@
+#ifndef _SELECT_H
+#define _SELECT_H
+#include "planner.h"
+int SelectConj(int r2, const char *dstRelName, Conjunct *conj, int numConj);
+#endif
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef _STATS_H
+#define _STATS_H
+#include "defs.h"
+
+#define STAT_VALUE      16  /* bytes of a value kept as a bound; ints, floats and dates fit whole, strings keep a prefix */
+#define STAT_BUCKETS    16  /* buckets of an equi-depth histogram */
+
+/* Statistics of one attribute, as last analyzed */
+typedef struct attrstats
+{
+    int numValues;                      // values a comparison can match: every record but those holding a float NaN
+    int numDistinct;                    // estimated distinct values
+    int numBuckets;                     // histogram buckets in use; 0 when numValues is 0
+    char lo[STAT_VALUE];                // smallest value
+    char hi[STAT_VALUE];                // largest value
+    char bound[STAT_BUCKETS][STAT_VALUE];   // largest value of each bucket; bound[numBuckets - 1] is hi
+    int bucketRows[STAT_BUCKETS];       // values falling in each bucket
+    int bucketDistinct[STAT_BUCKETS];   // distinct values in each bucket
+} AttrStats;
+
+/* Head of "<relName>.stat"; numAttrs AttrStats follow in attrList order */
+typedef struct relstats
+{
+    int numRecs;            // records of the relation when it was analyzed
+    int sampleRecs;         // records the histograms and distinct counts were computed from
+    int numAttrs;
+} RelStats;
+
+void build_stat_filename(const char *relName, char *fname, size_t buflen);
+int StatsAnalyze(int relNum);
+const AttrStats *StatsGet(int relNum, const AttrDesc *attrDesc);
+int StatsSelectivity(int relNum, const AttrDesc *attrDesc, const void *valuePtr, int compOp, double *sel);
+void StatsRelease(int relNum);
+int RemoveStats(const char *relName);
+#endif
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifndef _VIEW_H
+#define _VIEW_H
+#include <stdbool.h>
+#include "iterator.h"
+
+#define VIEW_TMP_PREFIX "_view"     /* temporary relations a view is materialized into */
+
+/* Builds the iterator of a select, project or join from its command arguments */
+typedef Iter *(*PlanFn)(int argc, char **argv);
+
+/* A named query kept for the session; it is evaluated only when read */
+typedef struct viewdef
+{
+    char name[RELNAME];
+    PlanFn plan;            // PlanSelect(), PlanProject() or PlanJoin()
+    int argc;
+    char **argv;            // copy of the command arguments, argv[1] = name
+    struct viewdef *next;
+} ViewDef;
+
+int ViewDefine(PlanFn plan, int argc, char **argv);
+ViewDef *ViewFind(const char *name);
+int ViewDrop(const char *name);
+void ViewDropAll(void);
+bool ViewIsReadOnly(const char *name);
+int ViewMaterialize(const char *name, char *tmpName);
+void ViewUnmaterialize(const char *tmpName);
+#endif
\ No newline at end of file
@@ -0,0 +1,30 @@
+#ifndef _ZONEMAP_H
+#define _ZONEMAP_H
+#include "defs.h"
+
+#define ZMAP_PREFIX     8   /* bytes of a string kept as its min/max; ints and floats fit whole */
+
+#define ZONE_HAS_VALUE  1   /* lo/hi hold the bounds of at least one non-NaN value */
+#define ZONE_HAS_NAN    2   /* some record on the page holds a float NaN */
+
+/* Synopsis of one attribute on one page */
+typedef struct zoneentry
+{
+    char lo[ZMAP_PREFIX];
+    char hi[ZMAP_PREFIX];
+    int flags;
+} ZoneEntry;
+
+/* Head of a page's block in "<relName>.zmap"; numAttrs ZoneEntry follow in attrList order */
+typedef struct zonepage
+{
+    short valid;        // 0 until the page was summarised; such pages are never skipped
+    short numLive;      // occupied slots; an empty page is skipped for every predicate
+} ZonePage;
+
+void build_zmap_filename(const char *relName, char *fname, size_t buflen);
+int ZoneMapUpdate(int relNum, short pid);
+int ZoneMapCanSkip(int relNum, short pid, char attrType, int attrSize, int attrOffset, void *valuePtr, int compOp);
+void ZoneMapRelease(int relNum);
+int RemoveZoneMap(const char *relName);
+#endif
\ No newline at end of file
@@ -0,0 +1,967 @@
+/************************INCLUDES*******************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/helpers.h"
+#include "../include/getnextrec.h"
+#include "../include/bitmapidx.h"
+
+/*
+ * Bitmap index, one compressed bitmap per distinct value of the attribute.
+ *
+ * Bit p of a value's bitmap is set when the record at position p = pid * recsPerPg + slot holds
+ * that value, so a bitmap maps straight back to Rids and two bitmaps over the same relation can be
+ * ANDed/ORed without touching the heap.
+ *
+ * Bitmaps are word-aligned hybrid (WAH) encoded in 32-bit words covering WAH_GROUP positions each:
+ *   literal word : MSB 0, low 31 bits are the bits of one group
+ *   fill word    : MSB 1, bit 30 is the fill bit, low 30 bits count the groups it stands for
+ * Runs of empty (or full) groups collapse into one fill word, which for a low-cardinality
+ * attribute keeps each bitmap far below one bit per record.
+ *
+ * File layout ("<rel>.<attr>.bmap"):
+ *   BitmapHeader
+ *   numValues times: key[keyLen] int numWords unsigned int words[numWords]
+ */
+
+#define WAH_FILL_FLAG   0x80000000U
+#define WAH_FILL_BIT    0x40000000U
+#define WAH_MAX_COUNT   0x3FFFFFFFU
+#define WAH_ALL_ONES    0x7FFFFFFFU
+
+typedef struct bitmapfile
+{
+    BitmapHeader hdr;
+    char *keys;             /* numValues keys of keyLen bytes */
+    WahBitmap *bms;         /* bitmap of each key */
+    int cap;                /* allocated entries of keys/bms */
+} BitmapFile;
+
+/* Run-by-run reader over a compressed bitmap */
+typedef struct wahcursor
+{
+    const WahBitmap *bm;
+    int idx;                /* next word to load */
+    long remain;            /* groups left in the current word; 0 once exhausted */
+    int isFill;
+    unsigned int lit;       /* 31 bits of each group of the current word */
+} WahCursor;
+
+
+/*------------------------------------------------------------
+
+FUNCTION WahInit / WahFree (bm)
+
+FUNCTION DESCRIPTION:
+    Initialise an empty bitmap / release its words.
+
+------------------------------------------------------------*/
+
+void WahInit(WahBitmap *bm)
+{
+    bm->words = NULL;
+    bm->numWords = 0;
+    bm->cap = 0;
+}
+
+void WahFree(WahBitmap *bm)
+{
+    free(bm->words);
+    WahInit(bm);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION wahPush / wahAppendFill / wahAppendLiteral
+
+FUNCTION DESCRIPTION:
+    Append encoded groups to the end of a bitmap.
+    A fill is merged into a preceding fill of the same bit; a literal that is all zeros or all ones is stored as a one-group fill, so encoding is canonical.
+
+ERRORS REPORTED:
+    MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+static int wahPush(WahBitmap *bm, unsigned int word)
+{
+    if(bm->numWords == bm->cap)
+    {
+        int ncap = bm->cap ? bm->cap * 2 : 16;
+        unsigned int *w = realloc(bm->words, ncap * sizeof(unsigned int));
+        if(!w)
+        {
+            db_err_code = MEM_ALLOC_ERROR;
+            return NOTOK;
+        }
+        bm->words = w;
+        bm->cap = ncap;
+    }
+
+    bm->words[bm->numWords++] = word;
+    return OK;
+}
+
+static int wahAppendFill(WahBitmap *bm, int bit, long count)
+{
+    unsigned int bitFlag = bit ? WAH_FILL_BIT : 0;
+
+    if(count > 0 && bm->numWords > 0)
+    {
+        unsigned int *last = &bm->words[bm->numWords - 1];
+        if((*last & WAH_FILL_FLAG) && (*last & WAH_FILL_BIT) == bitFlag)
+        {
+            long room = WAH_MAX_COUNT - (*last & WAH_MAX_COUNT);
+            long n = count < room ? count : room;
+            *last += n;
+            count -= n;
+        }
+    }
+
+    while(count > 0)
+    {
+        long n = count < (long)WAH_MAX_COUNT ? count : (long)WAH_MAX_COUNT;
+        if(wahPush(bm, WAH_FILL_FLAG | bitFlag | (unsigned int)n) == NOTOK)
+            return NOTOK;
+        count -= n;
+    }
+
+    return OK;
+}
+
+static int wahAppendLiteral(WahBitmap *bm, unsigned int lit)
+{
+    if(lit == 0)
+        return wahAppendFill(bm, 0, 1);
+    if(lit == WAH_ALL_ONES)
+        return wahAppendFill(bm, 1, 1);
+    return wahPush(bm, lit);
+}
+
+/* Trailing zero groups are implicit; dropping them keeps equal bitmaps byte-identical */
+static void wahTrim(WahBitmap *bm)
+{
+    if(bm->numWords > 0)
+    {
+        unsigned int last = bm->words[bm->numWords - 1];
+        if((last & WAH_FILL_FLAG) && !(last & WAH_FILL_BIT))
+            bm->numWords--;
+    }
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION cursor helpers
+
+FUNCTION DESCRIPTION:
+    cursorLoad() decodes the next word into a run; cursorSkip() consumes n groups of the current run.
+
+------------------------------------------------------------*/
+
+static void cursorLoad(WahCursor *c)
+{
+    if(c->idx >= c->bm->numWords)
+    {
+        c->remain = 0;
+        return;
+    }
+
+    unsigned int w = c->bm->words[c->idx++];
+    if(w & WAH_FILL_FLAG)
+    {
+        c->isFill = 1;
+        c->remain = w & WAH_MAX_COUNT;
+        c->lit = (w & WAH_FILL_BIT) ? WAH_ALL_ONES : 0;
+    }
+    else
+    {
+        c->isFill = 0;
+        c->remain = 1;
+        c->lit = w;
+    }
+}
+
+static void cursorInit(WahCursor *c, const WahBitmap *bm)
+{
+    c->bm = bm;
+    c->idx = 0;
+    cursorLoad(c);
+}
+
+static void cursorSkip(WahCursor *c, long n)
+{
+    c->remain -= n;
+    if(c->remain == 0)
+        cursorLoad(c);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION wahCombine (a, b, out, isAnd)
+
+PARAMETER DESCRIPTION:
+    a, b  → operand bitmaps (positions past the end of a bitmap are 0).
+    out   → (OUT) result; must not alias a or b.
+    isAnd → 1 for AND, 0 for OR.
+
+FUNCTION DESCRIPTION:
+    Combines two compressed bitmaps without decompressing them.
+
+ALGORITHM:
+    Walk both bitmaps run by run.  When both cursors sit on fills, the overlap is emitted as one fill in a single step;
+    otherwise one group is combined literal by literal.  After the shorter bitmap ends, AND stops and OR copies the rest of the longer one.
+
+RETURNS:
+    OK or NOTOK (MEM_ALLOC_ERROR).
+
+------------------------------------------------------------*/
+
+static int wahCombine(const WahBitmap *a, const WahBitmap *b, WahBitmap *out, int isAnd)
+{
+    WahCursor ca, cb;
+
+    WahInit(out);
+    cursorInit(&ca, a);
+    cursorInit(&cb, b);
+
+    while(ca.remain > 0 && cb.remain > 0)
+    {
+        int rc;
+        if(ca.isFill && cb.isFill)
+        {
+            long n = ca.remain < cb.remain ? ca.remain : cb.remain;
+            int bit = isAnd ? (ca.lit && cb.lit) : (ca.lit || cb.lit);
+            rc = wahAppendFill(out, bit, n);
+            cursorSkip(&ca, n);
+            cursorSkip(&cb, n);
+        }
+        else
+        {
+            rc = wahAppendLiteral(out, isAnd ? (ca.lit & cb.lit) : (ca.lit | cb.lit));
+            cursorSkip(&ca, 1);
+            cursorSkip(&cb, 1);
+        }
+
+        if(rc == NOTOK)
+        {
+            WahFree(out);
+            return NOTOK;
+        }
+    }
+
+    if(!isAnd)
+    {
+        WahCursor *rest = ca.remain > 0 ? &ca : &cb;
+        while(rest->remain > 0)
+        {
+            int rc = rest->isFill ? wahAppendFill(out, rest->lit != 0, rest->remain)
+                                  : wahAppendLiteral(out, rest->lit);
+            if(rc == NOTOK)
+            {
+                WahFree(out);
+                return NOTOK;
+            }
+            cursorSkip(rest, rest->remain);
+        }
+    }
+
+    wahTrim(out);
+    return OK;
+}
+
+int WahAnd(const WahBitmap *a, const WahBitmap *b, WahBitmap *out)
+{
+    return wahCombine(a, b, out, 1);
+}
+
+int WahOr(const WahBitmap *a, const WahBitmap *b, WahBitmap *out)
+{
+    return wahCombine(a, b, out, 0);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION WahCount (bm)
+
+RETURNS:
+    Number of set positions, computed from the compressed words.
+
+------------------------------------------------------------*/
+
+long WahCount(const WahBitmap *bm)
+{
+    long n = 0;
+
+    for(int i = 0; i < bm->numWords; i++)
+    {
+        unsigned int w = bm->words[i];
+        if(w & WAH_FILL_FLAG)
+        {
+            if(w & WAH_FILL_BIT)
+                n += (long)(w & WAH_MAX_COUNT) * WAH_GROUP;
+        }
+        else
+            n += __builtin_popcount(w);
+    }
+
+    return n;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION WahToRids (bm, recsPerPg, rids, numRids)
+
+PARAMETER DESCRIPTION:
+    bm        → bitmap to expand.
+    recsPerPg → slots per heap page of the relation.
+    rids      → (OUT) malloc'd array of Rids in heap order; NULL when empty.
+    numRids   → (OUT) number of Rids.
+
+RETURNS:
+    OK or NOTOK (MEM_ALLOC_ERROR).
+
+------------------------------------------------------------*/
+
+int WahToRids(const WahBitmap *bm, int recsPerPg, Rid **rids, int *numRids)
+{
+    long count = WahCount(bm), group = 0;
+    int n = 0;
+
+    *rids = NULL;
+    *numRids = 0;
+    if(count == 0)
+        return OK;
+
+    Rid *out = malloc(count * sizeof(Rid));
+    if(!out)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    for(int i = 0; i < bm->numWords; i++)
+    {
+        unsigned int w = bm->words[i];
+        long runs = (w & WAH_FILL_FLAG) ? (long)(w & WAH_MAX_COUNT) : 1;
+        unsigned int lit = (w & WAH_FILL_FLAG) ? ((w & WAH_FILL_BIT) ? WAH_ALL_ONES : 0) : w;
+
+        for(long g = 0; g < runs && lit; g++)
+        {
+            for(unsigned int bits = lit; bits; bits &= bits - 1)
+            {
+                long pos = (group + g) * WAH_GROUP + __builtin_ctz(bits);
+                out[n].pid = pos / recsPerPg;
+                out[n].slotnum = pos % recsPerPg;
+                n++;
+            }
+        }
+        group += runs;
+    }
+
+    *rids = out;
+    *numRids = n;
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION wahSetBit (bm, pos, value)
+
+PARAMETER DESCRIPTION:
+    bm    → bitmap to update in place.
+    pos   → record position to change.
+    value → 1 to set the bit, 0 to clear it.
+
+FUNCTION DESCRIPTION:
+    Changes one bit of a compressed bitmap.
+
+ALGORITHM:
+    Copy the words before the run holding pos unchanged, split that run into (groups before, the group of pos, groups after),
+    re-encode the middle group, then copy the remaining words.  Cost is linear in the compressed size, never the record count.
+
+RETURNS:
+    OK or NOTOK (MEM_ALLOC_ERROR).
+
+------------------------------------------------------------*/
+
+static int wahSetBit(WahBitmap *bm, long pos, int value)
+{
+    long target = pos / WAH_GROUP, group = 0;
+    unsigned int mask = 1U << (pos % WAH_GROUP);
+    WahBitmap out;
+    int i, rc = OK;
+
+    WahInit(&out);
+
+    for(i = 0; i < bm->numWords && rc == OK; i++)
+    {
+        unsigned int w = bm->words[i];
+        long runs = (w & WAH_FILL_FLAG) ? (long)(w & WAH_MAX_COUNT) : 1;
+
+        if(group + runs <= target)
+        {
+            rc = (w & WAH_FILL_FLAG) ? wahAppendFill(&out, (w & WAH_FILL_BIT) != 0, runs) : wahPush(&out, w);
+            group += runs;
+            continue;
+        }
+
+        if(w & WAH_FILL_FLAG)
+        {
+            int bit = (w & WAH_FILL_BIT) != 0;
+            unsigned int lit = bit ? WAH_ALL_ONES : 0;
+            lit = value ? (lit | mask) : (lit & ~mask);
+
+            rc = wahAppendFill(&out, bit, target - group);
+            if(rc == OK)
+                rc = wahAppendLiteral(&out, lit);
+            if(rc == OK)
+                rc = wahAppendFill(&out, bit, group + runs - target - 1);
+        }
+        else
+            rc = wahAppendLiteral(&out, value ? (w | mask) : (w & ~mask));
+
+        group += runs;
+        break;
+    }
+
+    /* pos lies past the last encoded group: pad with zero groups and append */
+    if(rc == OK && i >= bm->numWords && group <= target)
+    {
+        if(!value)
+        {
+            WahFree(&out);
+            return OK;
+        }
+        rc = wahAppendFill(&out, 0, target - group);
+        if(rc == OK)
+            rc = wahAppendLiteral(&out, mask);
+    }
+    else
+    {
+        for(i++; i < bm->numWords && rc == OK; i++)
+        {
+            unsigned int w = bm->words[i];
+            rc = (w & WAH_FILL_FLAG) ? wahAppendFill(&out, (w & WAH_FILL_BIT) != 0, w & WAH_MAX_COUNT) : wahPush(&out, w);
+        }
+    }
+
+    if(rc == NOTOK)
+    {
+        WahFree(&out);
+        return NOTOK;
+    }
+
+    wahTrim(&out);
+    WahFree(bm);
+    *bm = out;
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION keyEqual (hdr, a, b)
+
+FUNCTION DESCRIPTION:
+    Equality of two keys of the indexed attribute, with the strncmp() semantics used elsewhere for strings.
+
+------------------------------------------------------------*/
+
+static int keyEqual(const BitmapHeader *hdr, const char *a, const char *b)
+{
+    if(hdr->type == 'i' || hdr->type == 'd')
+        return memcmp(a, b, hdr->keyLen) == 0;
+    return strncmp(a, b, hdr->keyLen) == 0;
+}
+
+static long ridPos(const BitmapHeader *hdr, Rid rid)
+{
+    return (long)rid.pid * hdr->recsPerPg + rid.slotnum;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION bmapFree / bmapAddValue / bmapFind
+
+FUNCTION DESCRIPTION:
+    Manage the in-memory image of a bitmap index: release it, append a new value with an empty bitmap,
+    and find the index of a value (-1 when absent).
+
+ERRORS REPORTED:
+    MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+static void bmapFree(BitmapFile *bf)
+{
+    for(int i = 0; i < bf->hdr.numValues; i++)
+        WahFree(&bf->bms[i]);
+    free(bf->keys);
+    free(bf->bms);
+    bf->keys = NULL;
+    bf->bms = NULL;
+    bf->cap = 0;
+}
+
+static int bmapAddValue(BitmapFile *bf, const char *key)
+{
+    if(bf->hdr.numValues == bf->cap)
+    {
+        int ncap = bf->cap ? bf->cap * 2 : 8;
+        char *keys = realloc(bf->keys, (size_t)ncap * bf->hdr.keyLen);
+        if(keys)
+            bf->keys = keys;
+        WahBitmap *bms = realloc(bf->bms, ncap * sizeof(WahBitmap));
+        if(bms)
+            bf->bms = bms;
+        if(!keys || !bms)
+        {
+            db_err_code = MEM_ALLOC_ERROR;
+            return NOTOK;
+        }
+        bf->cap = ncap;
+    }
+
+    int v = bf->hdr.numValues++;
+    memcpy(bf->keys + (size_t)v * bf->hdr.keyLen, key, bf->hdr.keyLen);
+    WahInit(&bf->bms[v]);
+    return v;
+}
+
+static int bmapFind(const BitmapFile *bf, const char *key)
+{
+    for(int v = 0; v < bf->hdr.numValues; v++)
+        if(keyEqual(&bf->hdr, bf->keys + (size_t)v * bf->hdr.keyLen, key))
+            return v;
+    return -1;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION bmapReadHeader / bmapLoad / bmapStore
+
+FUNCTION DESCRIPTION:
+    bmapReadHeader() opens fname and validates its header.
+    bmapLoad() reads the whole index into memory; bmapStore() rewrites fname from the in-memory image.
+
+ERRORS REPORTED:
+    FILE_NO_EXIST
+    PAGE_MAGIC_ERROR
+    FILESYSTEM_ERROR
+    MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+static int bmapReadHeader(const char *fname, BitmapHeader *hdr)
+{
+    int fd = open(fname, O_RDONLY);
+    if(fd < 0)
+    {
+        db_err_code = FILE_NO_EXIST;
+        return NOTOK;
+    }
+
+    if(read(fd, hdr, sizeof(BitmapHeader)) != sizeof(BitmapHeader))
+    {
+        close(fd);
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+
+    if(hdr->magic[0] != BMAP_HDR_MAGIC || strncmp(hdr->magic + 1, GEN_MAGIC, MAGIC_SIZE - 1))
+    {
+        close(fd);
+        db_err_code = PAGE_MAGIC_ERROR;
+        return NOTOK;
+    }
+
+    return fd;
+}
+
+static int bmapLoad(const char *fname, BitmapFile *bf)
+{
+    memset(bf, 0, sizeof(BitmapFile));
+
+    int fd = bmapReadHeader(fname, &bf->hdr);
+    if(fd == NOTOK)
+        return NOTOK;
+
+    int numValues = bf->hdr.numValues;
+    char *key = malloc(bf->hdr.keyLen);
+    if(!key)
+    {
+        close(fd);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    bf->hdr.numValues = 0;
+    for(int i = 0; i < numValues; i++)
+    {
+        int numWords, v;
+
+        if(read(fd, key, bf->hdr.keyLen) != bf->hdr.keyLen ||
+           read(fd, &numWords, sizeof(int)) != sizeof(int))
+        {
+            db_err_code = FILESYSTEM_ERROR;
+            goto fail;
+        }
+
+        if((v = bmapAddValue(bf, key)) == NOTOK)
+            goto fail;
+
+        WahBitmap *bm = &bf->bms[v];
+        if(numWords > 0)
+        {
+            bm->words = malloc(numWords * sizeof(unsigned int));
+            if(!bm->words)
+            {
+                db_err_code = MEM_ALLOC_ERROR;
+                goto fail;
+            }
+            bm->cap = bm->numWords = numWords;
+            if(read(fd, bm->words, numWords * sizeof(unsigned int)) != (ssize_t)(numWords * sizeof(unsigned int)))
+            {
+                db_err_code = FILESYSTEM_ERROR;
+                goto fail;
+            }
+        }
+    }
+
+    free(key);
+    close(fd);
+    return OK;
+
+fail:
+    free(key);
+    close(fd);
+    bmapFree(bf);
+    return NOTOK;
+}
+
+static int bmapStore(const char *fname, BitmapFile *bf)
+{
+    int fd = open(fname, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+
+    int ok = write(fd, &bf->hdr, sizeof(BitmapHeader)) == sizeof(BitmapHeader);
+    for(int v = 0; ok && v < bf->hdr.numValues; v++)
+    {
+        WahBitmap *bm = &bf->bms[v];
+        ok = write(fd, bf->keys + (size_t)v * bf->hdr.keyLen, bf->hdr.keyLen) == bf->hdr.keyLen &&
+             write(fd, &bm->numWords, sizeof(int)) == sizeof(int) &&
+             write(fd, bm->words, bm->numWords * sizeof(unsigned int)) == (ssize_t)(bm->numWords * sizeof(unsigned int));
+    }
+
+    close(fd);
+    if(!ok)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION BitmapBuild (fname, relNum, attr, nPages, nKeys)
+
+PARAMETER DESCRIPTION:
+    fname  → index file to create (truncated if it exists).
+    relNum → open relation being indexed.
+    attr   → attrcat record of the indexed attribute ('i' or 's').
+    nPages → (OUT) size of the index file in pages.
+    nKeys  → (OUT) distinct values indexed.
+
+FUNCTION DESCRIPTION:
+    Builds the bitmaps of all distinct values in one sequential scan.
+
+ALGORITHM:
+    The scan visits positions in increasing order, so each value keeps an open literal for its current group
+    and only appends: moving to a later group flushes the literal and a zero fill for the groups skipped in between.
+
+RETURNS:
+    OK or NOTOK (db_err_code set); on failure the file is removed.
+
+ERRORS REPORTED:
+    IDX_TOO_MANY_VALUES
+    FILESYSTEM_ERROR
+    MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+int BitmapBuild(const char *fname, int relNum, AttrCatRec *attr, int *nPages, int *nKeys)
+{
+    BitmapFile bf;
+    long curGroup[BITMAP_MAX_VALUES];
+    unsigned int curLit[BITMAP_MAX_VALUES];
+    int recSize = catcache[relNum].relcat_rec.recLength;
+    char *rec = malloc(recSize);
+    int rc = NOTOK;
+
+    if(!rec)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    memset(&bf, 0, sizeof(BitmapFile));
+    bf.hdr.magic[0] = BMAP_HDR_MAGIC;
+    strncpy(bf.hdr.magic + 1, GEN_MAGIC, MAGIC_SIZE - 1);
+    bf.hdr.keyLen = attr->length;
+    bf.hdr.recsPerPg = catcache[relNum].relcat_rec.recsPerPg;
+    bf.hdr.type = attr->type[0];
+
+    Rid rid = INVALID_RID;
+    for(;;)
+    {
+        if(GetNextRec(relNum, rid, &rid, rec) == NOTOK)
+            goto done;
+        if(!isValidRid(rid))
+            break;
+
+        char *key = rec + attr->offset;
+        int v = bmapFind(&bf, key);
+        if(v < 0)
+        {
+            if(bf.hdr.numValues == BITMAP_MAX_VALUES)
+            {
+                db_err_code = IDX_TOO_MANY_VALUES;
+                goto done;
+            }
+            if((v = bmapAddValue(&bf, key)) == NOTOK)
+                goto done;
+            curGroup[v] = 0;
+            curLit[v] = 0;
+        }
+
+        long pos = ridPos(&bf.hdr, rid), g = pos / WAH_GROUP;
+        if(g != curGroup[v])
+        {
+            if(wahAppendLiteral(&bf.bms[v], curLit[v]) == NOTOK ||
+               wahAppendFill(&bf.bms[v], 0, g - curGroup[v] - 1) == NOTOK)
+                goto done;
+            curGroup[v] = g;
+            curLit[v] = 0;
+        }
+        curLit[v] |= 1U << (pos % WAH_GROUP);
+    }
+
+    for(int v = 0; v < bf.hdr.numValues; v++)
+        if(wahAppendLiteral(&bf.bms[v], curLit[v]) == NOTOK)
+            goto done;
+
+    if(bmapStore(fname, &bf) == NOTOK)
+        goto done;
+
+    long bytes = sizeof(BitmapHeader);
+    for(int v = 0; v < bf.hdr.numValues; v++)
+        bytes += bf.hdr.keyLen + sizeof(int) + bf.bms[v].numWords * sizeof(unsigned int);
+
+    *nPages = (bytes + PAGESIZE - 1) / PAGESIZE;
+    *nKeys = bf.hdr.numValues;
+    rc = OK;
+
+done:
+    bmapFree(&bf);
+    free(rec);
+    if(rc == NOTOK)
+        remove(fname);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION bitmapUpdate (fname, key, rid, value)
+
+FUNCTION DESCRIPTION:
+    Shared body of BitmapInsert() and BitmapDelete(): set or clear the bit of rid in the bitmap of key.
+    A value seen for the first time gets a new bitmap; a value whose bitmap becomes empty is dropped.
+
+IMPLEMENTATION NOTES:
+    - Only the bitmap of key is re-encoded, in time linear in its compressed size; the file is then rewritten,
+      which for the low-cardinality attributes this index is meant for is a few pages.
+
+------------------------------------------------------------*/
+
+static int bitmapUpdate(const char *fname, void *key, Rid rid, int value)
+{
+    BitmapFile bf;
+
+    if(bmapLoad(fname, &bf) == NOTOK)
+        return NOTOK;
+
+    int v = bmapFind(&bf, key);
+    if(v < 0)
+    {
+        if(!value)
+        {
+            bmapFree(&bf);
+            return OK;
+        }
+        if((v = bmapAddValue(&bf, key)) == NOTOK)
+        {
+            bmapFree(&bf);
+            return NOTOK;
+        }
+    }
+
+    if(wahSetBit(&bf.bms[v], ridPos(&bf.hdr, rid), value) == NOTOK)
+    {
+        bmapFree(&bf);
+        return NOTOK;
+    }
+
+    if(bf.bms[v].numWords == 0)
+    {
+        int last = bf.hdr.numValues - 1;
+        WahFree(&bf.bms[v]);
+        if(v != last)
+        {
+            memcpy(bf.keys + (size_t)v * bf.hdr.keyLen, bf.keys + (size_t)last * bf.hdr.keyLen, bf.hdr.keyLen);
+            bf.bms[v] = bf.bms[last];
+        }
+        bf.hdr.numValues--;
+    }
+
+    int rc = bmapStore(fname, &bf);
+    bmapFree(&bf);
+    return rc;
+}
+
+int BitmapInsert(const char *fname, void *key, Rid rid)
+{
+    return bitmapUpdate(fname, key, rid, 1);
+}
+
+int BitmapDelete(const char *fname, void *key, Rid rid)
+{
+    return bitmapUpdate(fname, key, rid, 0);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION BitmapLookup (fname, key, compOp, out, recsPerPg)
+
+PARAMETER DESCRIPTION:
+    fname     → bitmap index file.
+    key       → typed literal of the predicate.
+    compOp    → CMP_EQ or CMP_NE.
+    out       → (OUT) bitmap of the matching positions; the caller frees it with WahFree().
+    recsPerPg → (OUT) slots per heap page, for WahToRids().
+
+FUNCTION DESCRIPTION:
+    CMP_EQ returns the bitmap of key, reading only the directory entries in front of it.
+    CMP_NE returns the OR of the bitmaps of every other value.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+ERRORS REPORTED:
+    FILE_NO_EXIST
+    PAGE_MAGIC_ERROR
+    FILESYSTEM_ERROR
+    MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+int BitmapLookup(const char *fname, void *key, int compOp, WahBitmap *out, int *recsPerPg)
+{
+    BitmapHeader hdr;
+    WahBitmap cur;
+    int fd, rc = NOTOK;
+
+    WahInit(out);
+    WahInit(&cur);
+
+    if((fd = bmapReadHeader(fname, &hdr)) == NOTOK)
+        return NOTOK;
+    *recsPerPg = hdr.recsPerPg;
+
+    char *k = malloc(hdr.keyLen);
+    if(!k)
+    {
+        close(fd);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    for(int v = 0; v < hdr.numValues; v++)
+    {
+        int numWords;
+
+        if(read(fd, k, hdr.keyLen) != hdr.keyLen || read(fd, &numWords, sizeof(int)) != sizeof(int))
+        {
+            db_err_code = FILESYSTEM_ERROR;
+            goto done;
+        }
+
+        int match = keyEqual(&hdr, k, key);
+        if(match != (compOp == CMP_EQ))
+        {
+            if(lseek(fd, (off_t)numWords * sizeof(unsigned int), SEEK_CUR) < 0)
+            {
+                db_err_code = FILESYSTEM_ERROR;
+                goto done;
+            }
+            continue;
+        }
+
+        WahFree(&cur);
+        if(numWords > 0 && !(cur.words = malloc(numWords * sizeof(unsigned int))))
+        {
+            db_err_code = MEM_ALLOC_ERROR;
+            goto done;
+        }
+        cur.cap = cur.numWords = numWords;
+        if(read(fd, cur.words, numWords * sizeof(unsigned int)) != (ssize_t)(numWords * sizeof(unsigned int)))
+        {
+            db_err_code = FILESYSTEM_ERROR;
+            goto done;
+        }
+
+        if(compOp == CMP_EQ)
+        {
+            *out = cur;
+            WahInit(&cur);
+            rc = OK;
+            goto done;
+        }
+
+        WahBitmap merged;
+        if(WahOr(out, &cur, &merged) == NOTOK)
+            goto done;
+        WahFree(out);
+        *out = merged;
+    }
+    rc = OK;
+
+done:
+    WahFree(&cur);
+    free(k);
+    close(fd);
+    if(rc == NOTOK)
+        WahFree(out);
+    return rc;
+}
\ No newline at end of file
@@ -0,0 +1,465 @@
+/************************INCLUDES*******************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/helpers.h"
+#include "../include/getnextrec.h"
+#include "../include/idxmaint.h"
+#include "../include/bloom.h"
+
+/*
+ * Counting Bloom filters.
+ *
+ * A filter is an array of one-byte counters.  Adding an item increments the numHashes counters its
+ * hash selects, removing it decrements them, and an item whose counters are not all non-zero was
+ * certainly never added.  A counter that reaches 255 sticks there, since it can no longer tell how
+ * many items share it; this only costs false positives.
+ *
+ * Two kinds of filters are kept:
+ *   "<rel>.<attr>.bloom" → values of one attribute (hasIndex bit IDX_BLOOM), for equality probes
+ *   "<rel>.rbloom"       → fingerprints of whole records, for Insert()'s duplicate check
+ * Both are updated by InsertRec()/DeleteRec() through the index maintenance hooks and rebuilt by
+ * BloomRefresh() once more items than they were sized for have been added.
+ */
+
+#define BLOOM_SATURATED 255
+
+
+/*------------------------------------------------------------
+
+FUNCTION build_rbloom_filename (relName, fname, buflen)
+
+FUNCTION DESCRIPTION:
+    Constructs "<relName>.rbloom", the record fingerprint filter kept next to the freemap.
+
+------------------------------------------------------------*/
+
+void build_rbloom_filename(const char *relName, char *fname, size_t buflen)
+{
+    snprintf(fname, buflen, "%s.rbloom", relName);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION fnvMix (h, data, len)
+
+FUNCTION DESCRIPTION:
+    Feeds len bytes into a 64-bit FNV-1a hash.
+
+------------------------------------------------------------*/
+
+static unsigned long long fnvMix(unsigned long long h, const void *data, size_t len)
+{
+    const unsigned char *p = data;
+
+    for(size_t i = 0; i < len; i++)
+    {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+#define FNV_OFFSET 14695981039346656037ULL
+
+static size_t keyBytes(char attrType, int attrSize, const void *key)
+{
+    return attrType == 's' ? strnlen(key, attrSize) : (size_t)attrSize;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION BloomHashValue (attrType, attrSize, key)
+
+FUNCTION DESCRIPTION:
+    Hashes one attribute value.  Strings are hashed up to their first NUL, matching the strncmp() equality used by compareRecs().
+
+------------------------------------------------------------*/
+
+unsigned long long BloomHashValue(char attrType, int attrSize, const void *key)
+{
+    return fnvMix(FNV_OFFSET, key, keyBytes(attrType, attrSize, key));
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION BloomHashRecord (relNum, recPtr)
+
+FUNCTION DESCRIPTION:
+    Fingerprint of a whole record for the duplicate check.
+
+IMPLEMENTATION NOTES:
+    - Float attributes are left out: Insert() treats floats within FLOAT_REL_EPS as equal, so their bits cannot be hashed.
+      A relation of only floats therefore gets one fingerprint for every record and the filter never rules anything out.
+
+------------------------------------------------------------*/
+
+unsigned long long BloomHashRecord(int relNum, const void *recPtr)
+{
+    return BloomHashAttrs(catcache[relNum].attrList, recPtr);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION BloomHashAttrs (attrList, recPtr)
+
+FUNCTION DESCRIPTION:
+    BloomHashRecord() for a record described by attrList rather than by an open relation
+    (the records of an iterator, algebra/iterator.c).
+
+------------------------------------------------------------*/
+
+unsigned long long BloomHashAttrs(AttrDesc *attrList, const void *recPtr)
+{
+    unsigned long long h = FNV_OFFSET;
+    const char sep = '\0';
+
+    for(AttrDesc *a = attrList; a; a = a->next)
+    {
+        const char *v = (const char *)recPtr + a->attr.offset;
+
+        if(a->attr.type[0] == 'f')
+            continue;
+
+        h = fnvMix(h, v, keyBytes(a->attr.type[0], a->attr.length, v));
+        h = fnvMix(h, &sep, 1);     /* so that "ab","c" and "a","bc" differ */
+    }
+    return h;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION bloomOpen (fname, hdr, flags)
+
+FUNCTION DESCRIPTION:
+    Opens a filter file and reads and validates its header.
+
+RETURNS:
+    File descriptor, or NOTOK.
+
+ERRORS REPORTED:
+    FILE_NO_EXIST
+    PAGE_MAGIC_ERROR
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+static int bloomOpen(const char *fname, BloomHeader *hdr, int flags)
+{
+    int fd = open(fname, flags);
+    if(fd < 0)
+    {
+        db_err_code = FILE_NO_EXIST;
+        return NOTOK;
+    }
+
+    if(read(fd, hdr, sizeof(BloomHeader)) != sizeof(BloomHeader))
+    {
+        close(fd);
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+
+    if(hdr->magic[0] != BLOOM_HDR_MAGIC || strncmp(hdr->magic + 1, GEN_MAGIC, MAGIC_SIZE - 1))
+    {
+        close(fd);
+        db_err_code = PAGE_MAGIC_ERROR;
+        return NOTOK;
+    }
+
+    return fd;
+}
+
+/* i-th counter of h by double hashing; h2 is odd, so it cycles through all counters */
+static unsigned int bloomSlot(const BloomHeader *hdr, unsigned long long h, int i)
+{
+    unsigned int h1 = (unsigned int)h, h2 = (unsigned int)(h >> 32) | 1U;
+    return (h1 + (unsigned int)i * h2) & (unsigned int)(hdr->numCounters - 1);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION bloomUpdate (fname, h, delta)
+
+PARAMETER DESCRIPTION:
+    fname → filter file.
+    h     → item hash.
+    delta → +1 to add the item, -1 to remove it.
+
+FUNCTION DESCRIPTION:
+    Adjusts the numHashes counters of h in place and the item count in the header.
+    Only the touched counter bytes are read and written.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+------------------------------------------------------------*/
+
+static int bloomUpdate(const char *fname, unsigned long long h, int delta)
+{
+    BloomHeader hdr;
+    int fd = bloomOpen(fname, &hdr, O_RDWR);
+
+    if(fd == NOTOK)
+        return NOTOK;
+
+    for(int i = 0; i < hdr.numHashes; i++)
+    {
+        off_t off = sizeof(BloomHeader) + bloomSlot(&hdr, h, i);
+        unsigned char c;
+
+        if(pread(fd, &c, 1, off) != 1)
+            goto fail;
+
+        if(c == BLOOM_SATURATED || (delta < 0 && c == 0))
+            continue;
+
+        c += delta;
+        if(pwrite(fd, &c, 1, off) != 1)
+            goto fail;
+    }
+
+    hdr.numItems += delta;
+    if(hdr.numItems < 0)
+        hdr.numItems = 0;
+    if(pwrite(fd, &hdr, sizeof(BloomHeader), 0) != sizeof(BloomHeader))
+        goto fail;
+
+    close(fd);
+    return OK;
+
+fail:
+    close(fd);
+    db_err_code = FILESYSTEM_ERROR;
+    return NOTOK;
+}
+
+int BloomAdd(const char *fname, unsigned long long h)
+{
+    return bloomUpdate(fname, h, 1);
+}
+
+int BloomRemove(const char *fname, unsigned long long h)
+{
+    return bloomUpdate(fname, h, -1);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION BloomMayContain (fname, h)
+
+RETURNS:
+    1     → h may have been added.
+    0     → h was definitely not added.
+    NOTOK → the filter could not be read (db_err_code set).
+
+------------------------------------------------------------*/
+
+int BloomMayContain(const char *fname, unsigned long long h)
+{
+    BloomHeader hdr;
+    int fd = bloomOpen(fname, &hdr, O_RDONLY);
+
+    if(fd == NOTOK)
+        return NOTOK;
+
+    for(int i = 0; i < hdr.numHashes; i++)
+    {
+        unsigned char c;
+
+        if(pread(fd, &c, 1, sizeof(BloomHeader) + bloomSlot(&hdr, h, i)) != 1)
+        {
+            close(fd);
+            db_err_code = FILESYSTEM_ERROR;
+            return NOTOK;
+        }
+
+        if(c == 0)
+        {
+            close(fd);
+            return 0;
+        }
+    }
+
+    close(fd);
+    return 1;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION BloomBuild (fname, relNum, attr)
+
+PARAMETER DESCRIPTION:
+    fname  → filter file to create (truncated if it exists).
+    relNum → open relation to summarise.
+    attr   → attribute whose values are added, or NULL for record fingerprints.
+
+FUNCTION DESCRIPTION:
+    Sizes a filter for twice the current record count (at least BLOOM_MIN_ITEMS) and fills it in one heap scan.
+
+ALGORITHM:
+    1) capacity = 2 * MAX(numRecs, BLOOM_MIN_ITEMS).
+    2) numCounters = smallest power of two >= capacity * BLOOM_BITS_PER_ITEM; numHashes = BLOOM_NUM_HASHES
+       (about 1% false positives at capacity).
+    3) Scan with GetNextRec() and increment the counters of every record's hash in memory.
+    4) Write header and counters.
+
+RETURNS:
+    OK or NOTOK (db_err_code set); on failure the file is removed.
+
+ERRORS REPORTED:
+    MEM_ALLOC_ERROR
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+int BloomBuild(const char *fname, int relNum, AttrCatRec *attr)
+{
+    BloomHeader hdr;
+    int recSize = catcache[relNum].relcat_rec.recLength;
+    int rc = NOTOK;
+
+    memset(&hdr, 0, sizeof(BloomHeader));
+    hdr.magic[0] = BLOOM_HDR_MAGIC;
+    strncpy(hdr.magic + 1, GEN_MAGIC, MAGIC_SIZE - 1);
+    hdr.capacity = 2 * MAX(catcache[relNum].relcat_rec.numRecs, BLOOM_MIN_ITEMS);
+    hdr.numHashes = BLOOM_NUM_HASHES;
+    hdr.numCounters = 1;
+    while(hdr.numCounters < hdr.capacity * BLOOM_BITS_PER_ITEM)
+        hdr.numCounters <<= 1;
+
+    unsigned char *counters = calloc(hdr.numCounters, 1);
+    char *rec = malloc(recSize);
+    if(!counters || !rec)
+    {
+        free(counters);
+        free(rec);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    Rid rid = INVALID_RID;
+    for(;;)
+    {
+        if(GetNextRec(relNum, rid, &rid, rec) == NOTOK)
+            goto done;
+        if(!isValidRid(rid))
+            break;
+
+        unsigned long long h = attr ? BloomHashValue(attr->type[0], attr->length, rec + attr->offset)
+                                    : BloomHashRecord(relNum, rec);
+
+        for(int i = 0; i < hdr.numHashes; i++)
+        {
+            unsigned char *c = &counters[bloomSlot(&hdr, h, i)];
+            if(*c != BLOOM_SATURATED)
+                (*c)++;
+        }
+        hdr.numItems++;
+    }
+
+    int fd = open(fname, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        goto done;
+    }
+
+    if(write(fd, &hdr, sizeof(BloomHeader)) == sizeof(BloomHeader) &&
+       write(fd, counters, hdr.numCounters) == hdr.numCounters)
+        rc = OK;
+    else
+        db_err_code = FILESYSTEM_ERROR;
+    close(fd);
+
+done:
+    free(counters);
+    free(rec);
+    if(rc == NOTOK)
+        remove(fname);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION bloomRefreshFile (fname, relNum, attr, create)
+
+FUNCTION DESCRIPTION:
+    Rebuilds the filter fname when it holds more items than its capacity, or creates it when it is missing and create is set.
+
+------------------------------------------------------------*/
+
+static int bloomRefreshFile(const char *fname, int relNum, AttrCatRec *attr, int create)
+{
+    BloomHeader hdr;
+
+    if(access(fname, F_OK) != 0)
+        return create ? BloomBuild(fname, relNum, attr) : OK;
+
+    int fd = bloomOpen(fname, &hdr, O_RDONLY);
+    if(fd == NOTOK)
+        return BloomBuild(fname, relNum, attr);
+    close(fd);
+
+    if(hdr.numItems > hdr.capacity)
+        return BloomBuild(fname, relNum, attr);
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION BloomRefresh (relNum)
+
+PARAMETER DESCRIPTION:
+    relNum → open user relation.
+
+FUNCTION DESCRIPTION:
+    Periodic maintenance of the filters of a relation, run by Insert() and Load() before they add records.
+    Creates the record fingerprint filter if the relation has none yet, and rebuilds any filter that has grown past its capacity,
+    which also clears counters that saturated or were left set by deleted items.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+------------------------------------------------------------*/
+
+int BloomRefresh(int relNum)
+{
+    char fname[RELNAME + ATTRNAME + 8];
+    const char *relName = catcache[relNum].relcat_rec.relName;
+
+    if(relNum < NUM_CATS)
+        return OK;
+
+    build_rbloom_filename(relName, fname, sizeof(fname));
+    if(bloomRefreshFile(fname, relNum, NULL, 1) == NOTOK)
+        return NOTOK;
+
+    for(AttrDesc *a = catcache[relNum].attrList; a; a = a->next)
+    {
+        if(!(a->attr.hasIndex & IDX_BLOOM))
+            continue;
+
+        build_idx_filename(relName, a->attr.attrName, "bloom", fname, sizeof(fname));
+        if(bloomRefreshFile(fname, relNum, &(a->attr), 0) == NOTOK)
+            return NOTOK;
+    }
+
+    return OK;
+}
\ No newline at end of file
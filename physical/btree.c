@@ -0,0 +1,970 @@
+/************************INCLUDES*******************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/helpers.h"
+#include "../include/getnextrec.h"
+#include "../include/extsort.h"
+#include "../include/btree.h"
+
+/*
+ * Node layout (PAGESIZE bytes):
+ *   bytes 0-7   : type character + GEN_MAGIC
+ *   bytes 8-9   : number of entries (short)
+ *   bytes 12-15 : leaf  → page number of the right sibling (BT_NO_PAGE at the end)
+ *                 inner → page number of the leftmost child
+ *   bytes 16-   : entries
+ *
+ * Leaf entry  : key[keyLen] Rid
+ * Inner entry : key[keyLen] Rid child
+ *
+ * Every entry is ordered on (key, Rid), so duplicate key values still give unique entries and a
+ * delete can always descend straight to the leaf holding its entry.
+ * Child i of an inner entry holds every entry >= that entry's (key, Rid).
+ */
+
+#define BT_NUMKEYS_OFF  MAGIC_SIZE
+#define BT_NEXT_OFF     (MAGIC_SIZE + 4)
+
+typedef struct btfile
+{
+    int fd;
+    BtHeader hdr;
+    int leafEnt;        /* bytes per leaf entry */
+    int nodeEnt;        /* bytes per inner entry */
+    int leafCap;        /* entries that fit in a leaf */
+    int nodeCap;        /* entries that fit in an inner node */
+} BtFile;
+
+
+/*------------------------------------------------------------
+
+FUNCTION btKeyCmp (bt, a, b)
+
+PARAMETER DESCRIPTION:
+    bt → open index descriptor (supplies key type and length).
+    a  → first key.
+    b  → second key.
+
+FUNCTION DESCRIPTION:
+    Orders two key values of the indexed attribute.
+    Floats are ordered exactly here; ε-tolerant matching is left to the caller, which re-checks candidates with compareRecs().
+
+RETURNS:
+    <0, 0 or >0.
+
+------------------------------------------------------------*/
+
+static int btKeyCmp(BtFile *bt, const char *a, const char *b)
+{
+    switch(bt->hdr.type)
+    {
+        case 'i':
+        case 'f':
+        case 'd':
+            return compareNumeric(a, b, bt->hdr.type, bt->hdr.keyLen);
+        default:
+            return strncmp(a, b, bt->hdr.keyLen);
+    }
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION btEntryCmp (a, b, ctx)
+
+PARAMETER DESCRIPTION:
+    a, b → entries beginning with key[keyLen] followed by a Rid.
+    ctx  → BtFile descriptor.
+
+FUNCTION DESCRIPTION:
+    Orders entries on (key, Rid).
+    Has the ExtSortCmp signature so the bulk build can sort entries with the external sorter.
+
+------------------------------------------------------------*/
+
+static int btEntryCmp(const void *a, const void *b, void *ctx)
+{
+    BtFile *bt = ctx;
+    int c = btKeyCmp(bt, a, b);
+
+    if(c)
+        return c;
+
+    Rid ra, rb;
+    memcpy(&ra, (const char *)a + bt->hdr.keyLen, sizeof(Rid));
+    memcpy(&rb, (const char *)b + bt->hdr.keyLen, sizeof(Rid));
+
+    if(ra.pid != rb.pid)
+        return (ra.pid > rb.pid) - (ra.pid < rb.pid);
+    return (ra.slotnum > rb.slotnum) - (ra.slotnum < rb.slotnum);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION btSetup (bt)
+
+FUNCTION DESCRIPTION:
+    Derives entry sizes and node capacities from the key length stored in bt->hdr.
+
+------------------------------------------------------------*/
+
+static void btSetup(BtFile *bt)
+{
+    bt->leafEnt = bt->hdr.keyLen + sizeof(Rid);
+    bt->nodeEnt = bt->leafEnt + sizeof(int);
+    bt->leafCap = (PAGESIZE - HEADER_SIZE) / bt->leafEnt;
+    bt->nodeCap = (PAGESIZE - HEADER_SIZE) / bt->nodeEnt;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION btReadPage / btWritePage (bt, pno, page)
+
+FUNCTION DESCRIPTION:
+    Transfer one PAGESIZE page of the index file, positioning with lseek() like ReadPage()/FlushPage().
+
+ERRORS REPORTED:
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+static int btReadPage(BtFile *bt, int pno, char *page)
+{
+    if(lseek(bt->fd, (off_t)pno * PAGESIZE, SEEK_SET) < 0 ||
+       read(bt->fd, page, PAGESIZE) != PAGESIZE)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+    return OK;
+}
+
+static int btWritePage(BtFile *bt, int pno, const char *page)
+{
+    if(lseek(bt->fd, (off_t)pno * PAGESIZE, SEEK_SET) < 0 ||
+       write(bt->fd, page, PAGESIZE) != PAGESIZE)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION btInitNode (page, magic)
+
+FUNCTION DESCRIPTION:
+    Formats an empty node with the given type character.
+
+------------------------------------------------------------*/
+
+static void btInitNode(char *page, char magic)
+{
+    int next = BT_NO_PAGE;
+
+    memset(page, 0, PAGESIZE);
+    page[0] = magic;
+    strncpy(page + 1, GEN_MAGIC, MAGIC_SIZE - 1);
+    memcpy(page + BT_NEXT_OFF, &next, sizeof(int));
+}
+
+static short btNumKeys(const char *page)
+{
+    short n;
+    memcpy(&n, page + BT_NUMKEYS_OFF, sizeof(short));
+    return n;
+}
+
+static void btSetNumKeys(char *page, short n)
+{
+    memcpy(page + BT_NUMKEYS_OFF, &n, sizeof(short));
+}
+
+static int btNext(const char *page)
+{
+    int n;
+    memcpy(&n, page + BT_NEXT_OFF, sizeof(int));
+    return n;
+}
+
+static void btSetNext(char *page, int next)
+{
+    memcpy(page + BT_NEXT_OFF, &next, sizeof(int));
+}
+
+static int btChild(BtFile *bt, const char *page, int i)
+{
+    int c;
+    memcpy(&c, page + HEADER_SIZE + i * bt->nodeEnt + bt->leafEnt, sizeof(int));
+    return c;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION btOpen (fname, bt)
+
+PARAMETER DESCRIPTION:
+    fname → index file name.
+    bt    → (OUT) descriptor filled from the header page.
+
+FUNCTION DESCRIPTION:
+    Opens an existing index file and validates its header page.
+
+ERRORS REPORTED:
+    FILE_NO_EXIST
+    PAGE_MAGIC_ERROR
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+static int btOpen(const char *fname, BtFile *bt)
+{
+    char page[PAGESIZE];
+
+    bt->fd = open(fname, O_RDWR);
+    if(bt->fd < 0)
+    {
+        db_err_code = FILE_NO_EXIST;
+        return NOTOK;
+    }
+
+    if(btReadPage(bt, 0, page) == NOTOK)
+    {
+        close(bt->fd);
+        return NOTOK;
+    }
+
+    memcpy(&bt->hdr, page, sizeof(BtHeader));
+    if(bt->hdr.magic[0] != BT_HDR_MAGIC || strncmp(bt->hdr.magic + 1, GEN_MAGIC, MAGIC_SIZE - 1))
+    {
+        close(bt->fd);
+        db_err_code = PAGE_MAGIC_ERROR;
+        return NOTOK;
+    }
+
+    btSetup(bt);
+    return OK;
+}
+
+
+static int btWriteHeader(BtFile *bt)
+{
+    char page[PAGESIZE];
+
+    memset(page, 0, PAGESIZE);
+    memcpy(page, &bt->hdr, sizeof(BtHeader));
+    return btWritePage(bt, 0, page);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION btFindChild (bt, page, ent)
+
+PARAMETER DESCRIPTION:
+    bt   → open index descriptor.
+    page → inner node.
+    ent  → (key, Rid) being searched for.
+
+FUNCTION DESCRIPTION:
+    Binary-searches an inner node for the last separator <= ent.
+
+RETURNS:
+    Position of that separator, or -1 if ent sorts before every separator (follow the leftmost child).
+
+------------------------------------------------------------*/
+
+static int btFindChild(BtFile *bt, const char *page, const char *ent)
+{
+    int lo = 0, hi = btNumKeys(page) - 1, pos = -1;
+
+    while(lo <= hi)
+    {
+        int mid = (lo + hi) / 2;
+
+        if(btEntryCmp(page + HEADER_SIZE + mid * bt->nodeEnt, ent, bt) <= 0)
+        {
+            pos = mid;
+            lo = mid + 1;
+        }
+        else
+            hi = mid - 1;
+    }
+
+    return pos;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION btLowerBound (bt, page, ent)
+
+FUNCTION DESCRIPTION:
+    Binary-searches a leaf for the first entry >= ent.
+
+RETURNS:
+    Position in [0, numKeys].
+
+------------------------------------------------------------*/
+
+static int btLowerBound(BtFile *bt, const char *page, const char *ent)
+{
+    int lo = 0, hi = btNumKeys(page);
+
+    while(lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+
+        if(btEntryCmp(page + HEADER_SIZE + mid * bt->leafEnt, ent, bt) < 0)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION btInsertEntry (bt, pno, ent, upEnt, upPage, split)
+
+PARAMETER DESCRIPTION:
+    bt     → open index descriptor.
+    pno    → page of the subtree root being inserted into.
+    ent    → leaf entry (key, Rid) to insert.
+    upEnt  → (OUT) separator (key, Rid) to post in the parent when the node splits.
+    upPage → (OUT) page number of the new right sibling when the node splits.
+    split  → (OUT) set to 1 when the node split.
+
+FUNCTION DESCRIPTION:
+    Recursive B+-tree insertion.
+    Leaves copy their first right-hand entry up on a split; inner nodes push their middle separator up and hand its child to the new right node as the leftmost child.
+    Inserting an entry that is already present is a no-op.
+
+ALGORITHM:
+    1) Read the node.
+    2) Leaf: find the insertion point, build the merged entry list in a scratch area, and write it back, splitting in half if it overflows.
+    3) Inner: pick the child with btFindChild() and recurse; if the child split, insert (upEnt, upPage) after the chosen separator, splitting this node if it overflows.
+
+ERRORS REPORTED:
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+static int btInsertEntry(BtFile *bt, int pno, const char *ent, char *upEnt, int *upPage, int *split)
+{
+    char page[PAGESIZE], right[PAGESIZE];
+    char work[2 * PAGESIZE];
+    *split = 0;
+
+    if(btReadPage(bt, pno, page) == NOTOK)
+        return NOTOK;
+
+    int n = btNumKeys(page);
+
+    if(page[0] == BT_LEAF_MAGIC)
+    {
+        int sz = bt->leafEnt;
+        int pos = btLowerBound(bt, page, ent);
+
+        if(pos < n && btEntryCmp(page + HEADER_SIZE + pos * sz, ent, bt) == 0)
+            return OK;
+
+        memcpy(work, page + HEADER_SIZE, pos * sz);
+        memcpy(work + pos * sz, ent, sz);
+        memcpy(work + (pos + 1) * sz, page + HEADER_SIZE + pos * sz, (n - pos) * sz);
+        n++;
+
+        if(n <= bt->leafCap)
+        {
+            memcpy(page + HEADER_SIZE, work, n * sz);
+            btSetNumKeys(page, n);
+            return btWritePage(bt, pno, page);
+        }
+
+        int left = n / 2;
+        int newPno = bt->hdr.numPages++;
+
+        btInitNode(right, BT_LEAF_MAGIC);
+        memcpy(right + HEADER_SIZE, work + left * sz, (n - left) * sz);
+        btSetNumKeys(right, n - left);
+        btSetNext(right, btNext(page));
+
+        memcpy(page + HEADER_SIZE, work, left * sz);
+        btSetNumKeys(page, left);
+        btSetNext(page, newPno);
+
+        memcpy(upEnt, right + HEADER_SIZE, bt->leafEnt);
+        *upPage = newPno;
+        *split = 1;
+
+        if(btWritePage(bt, newPno, right) == NOTOK)
+            return NOTOK;
+        return btWritePage(bt, pno, page);
+    }
+
+    int sz = bt->nodeEnt;
+    int pos = btFindChild(bt, page, ent);
+    int child = (pos < 0) ? btNext(page) : btChild(bt, page, pos);
+    char childUp[PAGESIZE];
+    int childPage, childSplit;
+
+    if(btInsertEntry(bt, child, ent, childUp, &childPage, &childSplit) == NOTOK)
+        return NOTOK;
+
+    if(!childSplit)
+        return OK;
+
+    /* Post (childUp, childPage) right after separator pos */
+    pos++;
+    memcpy(work, page + HEADER_SIZE, pos * sz);
+    memcpy(work + pos * sz, childUp, bt->leafEnt);
+    memcpy(work + pos * sz + bt->leafEnt, &childPage, sizeof(int));
+    memcpy(work + (pos + 1) * sz, page + HEADER_SIZE + pos * sz, (n - pos) * sz);
+    n++;
+
+    if(n <= bt->nodeCap)
+    {
+        memcpy(page + HEADER_SIZE, work, n * sz);
+        btSetNumKeys(page, n);
+        return btWritePage(bt, pno, page);
+    }
+
+    int left = n / 2;
+    int newPno = bt->hdr.numPages++;
+    int midChild;
+
+    memcpy(&midChild, work + left * sz + bt->leafEnt, sizeof(int));
+    memcpy(upEnt, work + left * sz, bt->leafEnt);
+
+    btInitNode(right, BT_NODE_MAGIC);
+    memcpy(right + HEADER_SIZE, work + (left + 1) * sz, (n - left - 1) * sz);
+    btSetNumKeys(right, n - left - 1);
+    btSetNext(right, midChild);
+
+    memcpy(page + HEADER_SIZE, work, left * sz);
+    btSetNumKeys(page, left);
+
+    *upPage = newPno;
+    *split = 1;
+
+    if(btWritePage(bt, newPno, right) == NOTOK)
+        return NOTOK;
+    return btWritePage(bt, pno, page);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION BtInsert (fname, key, rid)
+
+PARAMETER DESCRIPTION:
+    fname → index file name ("<rel>.<attr>.idx").
+    key   → pointer to the attribute value of the new record.
+    rid   → Rid of the new record.
+
+FUNCTION DESCRIPTION:
+    Adds (key, rid) to a B+-tree index, growing a new root when the old root splits.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+ERRORS REPORTED:
+    FILE_NO_EXIST
+    PAGE_MAGIC_ERROR
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+int BtInsert(const char *fname, void *key, Rid rid)
+{
+    BtFile bt;
+    char ent[PAGESIZE], upEnt[PAGESIZE];
+    int upPage, split;
+
+    if(btOpen(fname, &bt) == NOTOK)
+        return NOTOK;
+
+    memcpy(ent, key, bt.hdr.keyLen);
+    memcpy(ent + bt.hdr.keyLen, &rid, sizeof(Rid));
+
+    int rc = btInsertEntry(&bt, bt.hdr.root, ent, upEnt, &upPage, &split);
+
+    if(rc == OK && split)
+    {
+        char root[PAGESIZE];
+        int newRoot = bt.hdr.numPages++;
+
+        btInitNode(root, BT_NODE_MAGIC);
+        btSetNext(root, bt.hdr.root);
+        memcpy(root + HEADER_SIZE, upEnt, bt.leafEnt);
+        memcpy(root + HEADER_SIZE + bt.leafEnt, &upPage, sizeof(int));
+        btSetNumKeys(root, 1);
+
+        bt.hdr.root = newRoot;
+        bt.hdr.height++;
+        rc = btWritePage(&bt, newRoot, root);
+    }
+
+    if(rc == OK)
+        rc = btWriteHeader(&bt);
+
+    close(bt.fd);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION BtDelete (fname, key, rid)
+
+PARAMETER DESCRIPTION:
+    fname → index file name.
+    key   → attribute value of the record being deleted.
+    rid   → Rid of the record being deleted.
+
+FUNCTION DESCRIPTION:
+    Removes (key, rid) from a B+-tree index.
+    Because entries are unique on (key, Rid) the descent reaches exactly one leaf.
+    Under-full nodes are not merged; separators stay valid bounds, and a later buildindex repacks the tree.
+
+RETURNS:
+    OK (also when the entry is absent) or NOTOK (db_err_code set).
+
+ERRORS REPORTED:
+    FILE_NO_EXIST
+    PAGE_MAGIC_ERROR
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+int BtDelete(const char *fname, void *key, Rid rid)
+{
+    BtFile bt;
+    char ent[PAGESIZE], page[PAGESIZE];
+
+    if(btOpen(fname, &bt) == NOTOK)
+        return NOTOK;
+
+    memcpy(ent, key, bt.hdr.keyLen);
+    memcpy(ent + bt.hdr.keyLen, &rid, sizeof(Rid));
+
+    int pno = bt.hdr.root;
+    int rc = OK;
+
+    for(;;)
+    {
+        if((rc = btReadPage(&bt, pno, page)) == NOTOK)
+            break;
+
+        if(page[0] == BT_LEAF_MAGIC)
+        {
+            int n = btNumKeys(page);
+            int pos = btLowerBound(&bt, page, ent);
+
+            if(pos < n && btEntryCmp(page + HEADER_SIZE + pos * bt.leafEnt, ent, &bt) == 0)
+            {
+                memmove(page + HEADER_SIZE + pos * bt.leafEnt,
+                        page + HEADER_SIZE + (pos + 1) * bt.leafEnt,
+                        (n - pos - 1) * bt.leafEnt);
+                btSetNumKeys(page, n - 1);
+                rc = btWritePage(&bt, pno, page);
+            }
+            break;
+        }
+
+        int pos = btFindChild(&bt, page, ent);
+        pno = (pos < 0) ? btNext(page) : btChild(&bt, page, pos);
+    }
+
+    close(bt.fd);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION BtFindRids (fname, key, compOp, rids, numRids)
+
+PARAMETER DESCRIPTION:
+    fname   → index file name.
+    key     → typed literal of the predicate.
+    compOp  → CMP_EQ, CMP_GT, CMP_GTE, CMP_LT or CMP_LTE.
+    rids    → (OUT) malloc'd array of matching Rids, in key order; the caller frees it.
+    numRids → (OUT) number of Rids.
+
+FUNCTION DESCRIPTION:
+    Range scan: answers "attr compOp key" from the leaf chain.
+    For '=', '>' and '>=' the scan descends to the first entry (key, lowest Rid); for '<' and '<=' it starts at the leftmost leaf.
+    It stops at the first entry past the range, so only the leaves holding qualifying entries are read.
+    Keys are compared exactly; callers whose predicate is tolerant (floats) must not rely on the result being complete.
+
+RETURNS:
+    OK or NOTOK.
+
+ERRORS REPORTED:
+    FILE_NO_EXIST
+    PAGE_MAGIC_ERROR
+    FILESYSTEM_ERROR
+    MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+int BtFindRids(const char *fname, void *key, int compOp, Rid **rids, int *numRids)
+{
+    BtFile bt;
+    char ent[PAGESIZE], page[PAGESIZE];
+    Rid lowest = {-1, -1};
+    int cap = 0, rc = OK;
+    bool fromLeft = (compOp == CMP_LT || compOp == CMP_LTE);
+
+    *rids = NULL;
+    *numRids = 0;
+
+    if(btOpen(fname, &bt) == NOTOK)
+        return NOTOK;
+
+    memcpy(ent, key, bt.hdr.keyLen);
+    memcpy(ent + bt.hdr.keyLen, &lowest, sizeof(Rid));
+
+    int pno = bt.hdr.root, pos = 0;
+
+    /* Descend to the leaf where the range starts */
+    for(;;)
+    {
+        if((rc = btReadPage(&bt, pno, page)) == NOTOK)
+            break;
+
+        if(page[0] == BT_LEAF_MAGIC)
+        {
+            pos = fromLeft ? 0 : btLowerBound(&bt, page, ent);
+            break;
+        }
+
+        int c = fromLeft ? -1 : btFindChild(&bt, page, ent);
+        pno = (c < 0) ? btNext(page) : btChild(&bt, page, c);
+    }
+
+    /* Walk the leaf chain until the first entry past the range */
+    while(rc == OK)
+    {
+        int n = btNumKeys(page), done = 0;
+
+        for(; pos < n; pos++)
+        {
+            const char *e = page + HEADER_SIZE + pos * bt.leafEnt;
+            int c = btKeyCmp(&bt, e, key);
+
+            if((compOp == CMP_EQ && c > 0) || (compOp == CMP_LT && c >= 0) || (compOp == CMP_LTE && c > 0))
+            {
+                done = 1;
+                break;
+            }
+            if(compOp == CMP_GT && c == 0)
+                continue;
+
+            if(*numRids == cap)
+            {
+                cap = cap ? 2 * cap : 64;
+                Rid *grown = realloc(*rids, cap * sizeof(Rid));
+                if(!grown)
+                {
+                    db_err_code = MEM_ALLOC_ERROR;
+                    rc = NOTOK;
+                    break;
+                }
+                *rids = grown;
+            }
+            memcpy(&(*rids)[(*numRids)++], e + bt.hdr.keyLen, sizeof(Rid));
+        }
+
+        if(rc == NOTOK || done || btNext(page) == BT_NO_PAGE)
+            break;
+
+        rc = btReadPage(&bt, btNext(page), page);
+        pos = 0;
+    }
+
+    close(bt.fd);
+    if(rc == NOTOK)
+    {
+        free(*rids);
+        *rids = NULL;
+        *numRids = 0;
+    }
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION btBuildLevel (bt, items, numItems, fillPct, out)
+
+PARAMETER DESCRIPTION:
+    bt       → index being built.
+    items    → (separator, child page) pairs of the level below, in key order.
+    numItems → number of pairs.
+    fillPct  → percentage of each node to fill.
+    out      → (OUT) freshly malloc'd pairs describing the new level.
+
+FUNCTION DESCRIPTION:
+    Packs one inner level on top of the level described by items.
+    Each node takes one pair as its leftmost child and up to the fill count of further pairs as entries.
+    The separator of the first pair of each node is passed up as that node's own separator.
+
+RETURNS:
+    Number of nodes written, or NOTOK.
+
+ERRORS REPORTED:
+    MEM_ALLOC_ERROR
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+static int btBuildLevel(BtFile *bt, char *items, int numItems, int fillPct, char **out)
+{
+    int sz = bt->nodeEnt;
+    int fill = MAX(2, bt->nodeCap * fillPct / 100);
+    int numNodes = 0;
+    char page[PAGESIZE];
+
+    *out = malloc((size_t)(numItems / (fill + 1) + 2) * sz);
+    if(!*out)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    for(int i = 0; i < numItems; )
+    {
+        int take = MIN(fill, numItems - i - 1);
+
+        /* Do not leave a single orphan child for the last node */
+        if(numItems - i - 1 - take == 1 && take > 1)
+            take--;
+
+        int pno = bt->hdr.numPages++;
+        int leftmost;
+
+        btInitNode(page, BT_NODE_MAGIC);
+        memcpy(&leftmost, items + i * sz + bt->leafEnt, sizeof(int));
+        btSetNext(page, leftmost);
+        memcpy(page + HEADER_SIZE, items + (i + 1) * sz, take * sz);
+        btSetNumKeys(page, take);
+
+        memcpy(*out + numNodes * sz, items + i * sz, bt->leafEnt);
+        memcpy(*out + numNodes * sz + bt->leafEnt, &pno, sizeof(int));
+        numNodes++;
+
+        if(btWritePage(bt, pno, page) == NOTOK)
+            return NOTOK;
+
+        i += take + 1;
+    }
+
+    return numNodes;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION BtBulkBuild (fname, relNum, attr, fillPct, nPages, nKeys)
+
+PARAMETER DESCRIPTION:
+    fname   → index file to create (truncated if it exists).
+    relNum  → open relation being indexed.
+    attr    → attrcat record of the indexed attribute.
+    fillPct → percentage (1-100) of every node to fill; the slack absorbs later inserts without splits.
+    nPages  → (OUT) pages in the finished index file.
+    nKeys   → (OUT) distinct key values found.
+
+FUNCTION DESCRIPTION:
+    Builds a B+-tree bottom-up over a (possibly populated) relation instead of inserting keys one at a time.
+
+ALGORITHM:
+    1) One sequential GetNextRec() pass over the heap feeds every (key, Rid) pair to an external sort.
+    2) The sorted stream is cut into leaves of fillPct * capacity entries, written left to right with sibling links; distinct keys are counted on the way.
+    3) The first entry and page of every leaf form the input of btBuildLevel(), which is repeated until a single root remains.
+    4) The header page is written last.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+ERRORS REPORTED:
+    FILESYSTEM_ERROR
+    MEM_ALLOC_ERROR
+
+IMPLEMENTATION NOTES:
+    - Page 0 is the header, so leaves start at page 1 and are physically contiguous in key order.
+    - An empty relation yields a single empty leaf as the root.
+
+------------------------------------------------------------*/
+
+int BtBulkBuild(const char *fname, int relNum, AttrCatRec *attr, int fillPct, int *nPages, int *nKeys)
+{
+    BtFile bt;
+    ExtSort sorter;
+    int recSize = catcache[relNum].relcat_rec.recLength;
+    char *rec = malloc(recSize);
+    char ent[PAGESIZE], prev[PAGESIZE], page[PAGESIZE];
+    char *items = NULL, *upper = NULL;
+    int numItems = 0, itemCap = 64, rc = NOTOK;
+
+    memset(&bt, 0, sizeof(BtFile));
+    bt.hdr.magic[0] = BT_HDR_MAGIC;
+    strncpy(bt.hdr.magic + 1, GEN_MAGIC, MAGIC_SIZE - 1);
+    bt.hdr.keyLen = attr->length;
+    bt.hdr.type = attr->type[0];
+    bt.hdr.numPages = 1;
+    btSetup(&bt);
+
+    fillPct = MAX(1, MIN(100, fillPct));
+    int fill = MAX(1, bt.leafCap * fillPct / 100);
+
+    items = malloc((size_t)itemCap * bt.nodeEnt);
+    if(!rec || !items)
+    {
+        free(rec);
+        free(items);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    bt.fd = open(fname, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(bt.fd < 0)
+    {
+        free(rec);
+        free(items);
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+
+    if(ExtSortOpen(&sorter, bt.leafEnt, btEntryCmp, &bt, SORT_MEM_BYTES, fname) == NOTOK)
+        goto done;
+
+    /* -------- 1. One pass over the heap -------- */
+    Rid rid = INVALID_RID;
+    for(;;)
+    {
+        if(GetNextRec(relNum, rid, &rid, rec) == NOTOK)
+            goto done;
+        if(!isValidRid(rid))
+            break;
+
+        memcpy(ent, rec + attr->offset, bt.hdr.keyLen);
+        memcpy(ent + bt.hdr.keyLen, &rid, sizeof(Rid));
+
+        if(ExtSortAdd(&sorter, ent) == NOTOK)
+            goto done;
+    }
+
+    if(ExtSortFinish(&sorter) == NOTOK)
+        goto done;
+
+    /* -------- 2. Packed leaves -------- */
+    int distinct = 0, inLeaf = 0, r;
+    int leafPno = bt.hdr.numPages++;
+
+    btInitNode(page, BT_LEAF_MAGIC);
+
+    while((r = ExtSortNext(&sorter, ent)) == 1)
+    {
+        if(distinct == 0 || btKeyCmp(&bt, prev, ent))
+            distinct++;
+        memcpy(prev, ent, bt.leafEnt);
+
+        if(inLeaf == fill)
+        {
+            int nextPno = bt.hdr.numPages++;
+
+            btSetNumKeys(page, inLeaf);
+            btSetNext(page, nextPno);
+            if(btWritePage(&bt, leafPno, page) == NOTOK)
+                goto done;
+
+            leafPno = nextPno;
+            inLeaf = 0;
+            btInitNode(page, BT_LEAF_MAGIC);
+        }
+
+        if(inLeaf == 0)
+        {
+            if(numItems == itemCap)
+            {
+                itemCap *= 2;
+                char *grown = realloc(items, (size_t)itemCap * bt.nodeEnt);
+                if(!grown)
+                {
+                    db_err_code = MEM_ALLOC_ERROR;
+                    goto done;
+                }
+                items = grown;
+            }
+
+            memcpy(items + numItems * bt.nodeEnt, ent, bt.leafEnt);
+            memcpy(items + numItems * bt.nodeEnt + bt.leafEnt, &leafPno, sizeof(int));
+            numItems++;
+        }
+
+        memcpy(page + HEADER_SIZE + inLeaf * bt.leafEnt, ent, bt.leafEnt);
+        inLeaf++;
+    }
+
+    if(r == NOTOK)
+        goto done;
+
+    btSetNumKeys(page, inLeaf);
+    if(btWritePage(&bt, leafPno, page) == NOTOK)
+        goto done;
+
+    /* -------- 3. Inner levels -------- */
+    bt.hdr.root = leafPno;
+    bt.hdr.height = 1;
+
+    while(numItems > 1)
+    {
+        int n = btBuildLevel(&bt, items, numItems, fillPct, &upper);
+        if(n == NOTOK)
+            goto done;
+
+        free(items);
+        items = upper;
+        upper = NULL;
+        numItems = n;
+        memcpy(&bt.hdr.root, items + bt.leafEnt, sizeof(int));
+        bt.hdr.height++;
+    }
+
+    /* -------- 4. Header -------- */
+    bt.hdr.numKeys = distinct;
+    if(btWriteHeader(&bt) == NOTOK)
+        goto done;
+
+    *nPages = bt.hdr.numPages;
+    *nKeys = distinct;
+    rc = OK;
+
+done:
+    ExtSortClose(&sorter);
+    close(bt.fd);
+    free(rec);
+    free(items);
+    free(upper);
+
+    if(rc == NOTOK)
+        remove(fname);
+    return rc;
+}
\ No newline at end of file
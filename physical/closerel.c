@@ -11,6 +11,9 @@
 #include "../include/globals.h"
 #include "../include/helpers.h"
 #include "../include/writerec.h"
+#include "../include/zonemap.h"
+#include "../include/stats.h"
+#include "../include/pagelayout.h"
 
 
 /*------------------------------------------------------------
@@ -35,7 +38,7 @@ ALGORITHM:
     2) If the cache slot is not valid, return OK immediately. (Caller may safely call CloseRel on unopened slots.)
     3) If the catalog metadata in catcache[relNum] has been modified (DIRTY_MASK set), write updated RelCatRec to relcat using WriteRec().
     4) Check whether the buffer page for this relation is dirty; if yes, write it to disk using FlushPage().
-    5) Free the linked list of AttrDesc nodes via FreeLinkedList(), disconnecting catalog attribute metadata associated with this relation.
+    5) Free the linked list of AttrDesc nodes via FreeLinkedList(), disconnecting catalog attribute metadata associated with this relation, after its dictionaries (PageLayoutRelease()), the in-memory zone map (ZoneMapRelease()) and statistics (StatsRelease()).
     6) Close the file descriptor for this relation.
     7) Clear VALID_MASK in status, marking the slot free.
 
@@ -83,8 +86,11 @@ int CloseRel(int relNum)
     //Step 3: Invalidate cache entry
     (entry->status) &= ~VALID_MASK;
 
-    //Step 4: Free the linked list of attribute descriptors
+    //Step 4: Free the linked list of attribute descriptors, the zone map and the statistics
+    PageLayoutRelease(entry);
     FreeLinkedList((void **)&(entry->attrList), offsetof(AttrDesc, next));
+    ZoneMapRelease(relNum);
+    StatsRelease(relNum);
 
     // Step 5: Close file
     close(entry->relFile);
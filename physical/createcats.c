@@ -98,6 +98,7 @@ int CreateAttrCat()
         AttrCat_numAttrs,
         AttrCat_numRecs,
         AttrCat_numPgs,
+        AttrCat_layout,
         AttrCat_offset,
         AttrCat_length,
         AttrCat_type,
@@ -106,6 +107,7 @@ int CreateAttrCat()
         AttrCat_hasIndex,
         AttrCat_nPages,
         AttrCat_nKeys,
+        AttrCat_encoding,
     };
 
     // Write the records in an array to the catalog file in pages
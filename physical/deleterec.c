@@ -5,11 +5,14 @@
 #include <stdbool.h>
 #include <string.h>
 #include "../include/defs.h"
+#include "../include/pagelayout.h"
 #include "../include/globals.h"
 #include "../include/error.h"
 #include "../include/readpage.h"
 #include "../include/writerec.h"
 #include "../include/freemap.h"
+#include "../include/idxmaint.h"
+#include "../include/zonemap.h"
 
 /*------------------------------------------------------------
 
@@ -132,15 +135,15 @@ ALGORITHM:
         - slotnum ≥ 0, pid ≥ 0
         - pid < numPgs, slotnum < recsPerPg
         Else report PAGE_OUT_OF_BOUNDS.
-    2) Call deleteFromPage() to:
+    2) For user relations, remove the record's entries from every index (DeleteIndexEntries()).
+    3) Call deleteFromPage() to:
         - clear slot bit,
         - decrement numRecs,
         - update relcat,
         - return page state transitions.
-    3) If freemap exists for this relation:
-        If the page was full before and the page now has at least one free slot:
-            → Add page to freemap (AddToFreeMap()).
-    4) Return OK.
+    4) If freemap exists for this relation:
+        → Record the page's free bytes now (SetFreeSpace() of PageFreeBytes()).
+    5) Return OK.
 
 BUGS:
     None found.
@@ -182,22 +185,31 @@ int DeleteRec(int relNum, Rid recRid)
     bool wasFullBefore = false;
     bool hasFreeAfter  = false;
 
+    /* Index entries are keyed on the record's values, so drop them while the slot still holds it */
+    if (relNum >= NUM_CATS && entry->attrList)
+    {
+        char recBuf[PAGESIZE];
+
+        if (ReadPage(relNum, recRid.pid) == NOTOK)
+            return NOTOK;
+
+        PageGetRec(entry, buffer[relNum].page, recRid.slotnum, recBuf);
+
+        if (DeleteIndexEntries(relNum, recBuf, recRid) == NOTOK)
+            return NOTOK;
+    }
+
     int rc = deleteFromPage(relNum, recRid, &wasFullBefore, &hasFreeAfter);
     if (rc == NOTOK)
         return NOTOK;
 
-    /* Freemap maintenance (if it exists) */
-    bool useFreeMap = (FreeMapExists(relName) == 1);
+    if (ZoneMapUpdate(relNum, recRid.pid) == NOTOK)
+        return NOTOK;
 
-    if (useFreeMap)
-    {
-        /* Only if page was full before AND now has a free slot,
-           do we need to add it to the freemap. */
-        if (wasFullBefore && hasFreeAfter)
-        {
-            AddToFreeMap(relName, (short)recRid.pid);
-        }
-    }
+    /* Freemap maintenance (if it exists): the page gained the slot, and on a slotted page its bytes */
+    if (FreeMapExists(relName) == 1 &&
+        SetFreeSpace(relName, recRid.pid, PageFreeBytes(entry, buffer[relNum].page)) == NOTOK)
+        return NOTOK;
 
     return OK;
 }
\ No newline at end of file
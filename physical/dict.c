@@ -0,0 +1,303 @@
+/************************INCLUDES*******************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/bloom.h"
+#include "../include/idxmaint.h"
+#include "../include/predicate.h"
+#include "../include/dict.h"
+
+/*
+ * Dictionary encoding.
+ *
+ * An attribute created as "eN" is a string attribute of length N + 1 like "sN" everywhere above the
+ * page: records, literals, comparisons and results are strings.  On a heap page it takes the
+ * sizeof(int) code of its value in the relation's dictionary instead (include/pagelayout.h), which
+ * shrinks pages of long, repetitive strings and turns an equality predicate into an int compare.
+ * The dictionary of an open relation is held in memory in its AttrDesc, with a hash table from
+ * value to code.
+ */
+
+
+/* Bucket of value: the entries are hashed like BloomHashValue() hashes a string key */
+static unsigned dictBucket(const Dict *d, const char *value)
+{
+    return (unsigned)BloomHashValue('s', d->strLen, value) & (d->tableSize - 1);
+}
+
+/* Bucket holding value, or the free bucket where it would go */
+static int dictProbe(const Dict *d, const char *value)
+{
+    unsigned b = dictBucket(d, value);
+
+    while(d->table[b] && strncmp(DictString(d, d->table[b] - 1), value, d->strLen) != OK)
+        b = (b + 1) & (d->tableSize - 1);
+    return b;
+}
+
+/* Makes room for one more entry: doubles strs and, past half full, the hash table */
+static int dictGrow(Dict *d)
+{
+    if(d->numCodes == d->cap)
+    {
+        int cap = d->cap ? 2 * d->cap : 16;
+        char *strs = realloc(d->strs, (size_t)cap * d->strLen);
+
+        if(!strs)
+            return NOTOK;
+        d->strs = strs;
+        d->cap = cap;
+    }
+
+    if(2 * (d->numCodes + 1) <= d->tableSize)
+        return OK;
+
+    int size = d->tableSize ? 2 * d->tableSize : 32;
+    int *table = calloc(size, sizeof(int));
+
+    if(!table)
+        return NOTOK;
+
+    free(d->table);
+    d->table = table;
+    d->tableSize = size;
+
+    for(int c = 0; c < d->numCodes; c++)
+        d->table[dictProbe(d, DictString(d, c))] = c + 1;
+    return OK;
+}
+
+/* Appends value as code numCodes; the caller has checked that it is absent */
+static int dictAdd(Dict *d, const char *value)
+{
+    if(dictGrow(d) == NOTOK)
+        return NOTOK;
+
+    char *entry = DictString(d, d->numCodes);
+
+    memset(entry, 0, d->strLen);
+    memcpy(entry, value, strnlen(value, d->strLen));
+    d->table[dictProbe(d, entry)] = ++d->numCodes;
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION DictOpen (relName, attrName, strLen)
+
+PARAMETER DESCRIPTION:
+    relName  → relation owning the attribute.
+    attrName → dictionary-encoded attribute.
+    strLen   → length of the attribute.
+
+FUNCTION DESCRIPTION:
+    Reads "<relName>.<attrName>.dict" into memory; a missing file is an empty dictionary, as after Create().
+
+RETURNS:
+    The dictionary, or NULL with db_err_code set.
+
+ERRORS REPORTED:
+    MEM_ALLOC_ERROR
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+Dict *DictOpen(const char *relName, const char *attrName, int strLen)
+{
+    Dict *d = calloc(1, sizeof(Dict));
+
+    if(!d)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NULL;
+    }
+
+    d->strLen = strLen;
+    build_idx_filename(relName, attrName, "dict", d->fileName, sizeof(d->fileName));
+
+    FILE *fp = fopen(d->fileName, "rb");
+
+    if(!fp && errno != ENOENT)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        free(d);
+        return NULL;
+    }
+
+    char value[MAXRECORD];
+
+    while(fp && fread(value, strLen, 1, fp) == 1)
+    {
+        if(dictAdd(d, value) == NOTOK)
+        {
+            fclose(fp);
+            DictClose(d);
+            db_err_code = MEM_ALLOC_ERROR;
+            return NULL;
+        }
+    }
+
+    if(fp)
+        fclose(fp);
+    return d;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION DictClose (d)
+
+FUNCTION DESCRIPTION:
+    Frees an in-memory dictionary; NULL is ignored.  The file is always up to date.
+
+------------------------------------------------------------*/
+
+void DictClose(Dict *d)
+{
+    if(!d)
+        return;
+    free(d->strs);
+    free(d->table);
+    free(d);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION DictLookup (d, value)
+
+RETURNS:
+    The code of value, or -1 when no record has ever held it.  Strings compare like strncmp() over
+    the attribute's length, so a longer literal has no code.
+
+------------------------------------------------------------*/
+
+int DictLookup(const Dict *d, const char *value)
+{
+    if(!d->tableSize)
+        return -1;
+    return d->table[dictProbe(d, value)] - 1;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION DictEncode (d, value, code)
+
+PARAMETER DESCRIPTION:
+    d     → dictionary of the attribute.
+    value → string value of a record being stored.
+    code  → (OUT) its code.
+
+FUNCTION DESCRIPTION:
+    Gives the code of value, adding value to the dictionary, file first, when it is new.
+
+RETURNS:
+    OK or NOTOK.
+
+ERRORS REPORTED:
+    FILESYSTEM_ERROR
+    MEM_ALLOC_ERROR
+
+IMPLEMENTATION NOTES:
+    • The entry is on disk before any page holds its code, so a dictionary never misses a code.
+
+------------------------------------------------------------*/
+
+int DictEncode(Dict *d, const char *value, int *code)
+{
+    if((*code = DictLookup(d, value)) >= 0)
+        return OK;
+
+    char entry[MAXRECORD] = {0};
+    FILE *fp = fopen(d->fileName, "ab");
+
+    memcpy(entry, value, strnlen(value, d->strLen));
+
+    if(!fp || fwrite(entry, d->strLen, 1, fp) != 1)
+    {
+        if(fp)
+            fclose(fp);
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+
+    if(fclose(fp) != 0)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+
+    if(dictAdd(d, entry) == NOTOK)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    *code = d->numCodes - 1;
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION DictMatch (d, value, compOp)
+
+FUNCTION DESCRIPTION:
+    Evaluates "attr compOp value" once per entry of the dictionary, for predicates that codes cannot
+    answer by themselves: codes follow first appearance, not string order.
+
+RETURNS:
+    A malloc'd array of numCodes flags, 1 for the codes whose value satisfies the predicate, or NULL
+    with db_err_code = MEM_ALLOC_ERROR.
+
+------------------------------------------------------------*/
+
+unsigned char *DictMatch(const Dict *d, const char *value, int compOp)
+{
+    unsigned char *match = malloc(d->numCodes + 1);
+    Pred pred;
+
+    if(!match)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NULL;
+    }
+
+    PredInit(&pred, 's', d->strLen, 0, value, compOp);
+    for(int c = 0; c < d->numCodes; c++)
+        match[c] = PredEval(&pred, DictString(d, c));
+    return match;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION RemoveDict (relName, attrName)
+
+FUNCTION DESCRIPTION:
+    Unlinks "<relName>.<attrName>.dict"; a missing file is not an error.
+
+RETURNS:
+    OK or NOTOK (FILESYSTEM_ERROR).
+
+------------------------------------------------------------*/
+
+int RemoveDict(const char *relName, const char *attrName)
+{
+    char fname[RELNAME + ATTRNAME + 8];
+
+    build_idx_filename(relName, attrName, "dict", fname, sizeof(fname));
+    if(remove(fname) != 0 && errno != ENOENT)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+    return OK;
+}
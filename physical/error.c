@@ -73,6 +73,18 @@ int ErrorMsgs(int errorNum, bool printFlag)
                     printf("Error %d: Index already exists on given attribute of the relation.\n", errorNum);
                     break;
 
+            case IDX_TYPE_INVALID:
+                    printf("Error %d: This kind of index CANNOT be built on an attribute of this type.\n", errorNum);
+                    break;
+
+            case IDX_TOO_MANY_VALUES:
+                    printf("Error %d: Attribute has too many distinct values for a bitmap index.\n", errorNum);
+                    break;
+
+            case VIEW_READONLY:
+                    printf("Error %d: A view CANNOT be changed or indexed; use a relation created with \"into\".\n", errorNum);
+                    break;
+
             case RELNOEXIST:
                 printf("Error %d: Relation does not exist.\n"
                        "→ Check the relation name for typos or create the relation before use.\n",
@@ -139,6 +151,30 @@ int ErrorMsgs(int errorNum, bool printFlag)
             case INCOMPATIBLE_TYPES:
                     printf("Error %d: Join attributes of BOTH the relations are of incompatible types..\n", errorNum);
                     break;
+
+            case NOT_UNION_COMPATIBLE:
+                    printf("Error %d: Relations must have the same number of attributes with matching types and lengths.\n", errorNum);
+                    break;
+
+            case AGG_INVALID:
+                    printf("Error %d: Aggregates are count(*), count(attr), sum(attr), avg(attr), min(attr) and max(attr); sum and avg need an INTEGER or FLOAT attribute.\n", errorNum);
+                    break;
+
+            case STMT_NOEXIST:
+                    printf("Error %d: No statement has been prepared under that name.\n", errorNum);
+                    break;
+
+            case STMT_INVALID:
+                    printf("Error %d: Only select into, insert and delete can be prepared; a parameter '?' stands for a literal, or for the result relation of a select.\n", errorNum);
+                    break;
+
+            case STMT_ARGS:
+                    printf("Error %d: Execute needs exactly one value for each parameter '?' of the statement.\n", errorNum);
+                    break;
+
+            case AGG_NO_ROWS:
+                    printf("Error %d: min, max and avg of no rows have no value; only count and sum can be computed.\n", errorNum);
+                    break;
             
             case INVALID_FORMAT:
                     printf("Error %d: One or more type(s) you have specified CANNOT be understood..", errorNum);
@@ -147,6 +183,10 @@ int ErrorMsgs(int errorNum, bool printFlag)
             case STR_LEN_INVALID:
                     printf("Error %d: Length of a string attribute has to be between 0 and 50.\n", errorNum);
                     break;
+
+            case INVALID_OPTION:
+                    printf("Error %d: The command was given an option it does NOT know.\n", errorNum);
+                    break;
             
             case CAT_CREATE_ERROR:
                 printf("Error %d: The catalog files could NOT be created.\n"
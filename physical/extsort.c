@@ -0,0 +1,743 @@
+/************************INCLUDES*******************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/extsort.h"
+
+/*
+ * External merge sort of fixed-size records.
+ *
+ * Run generation uses replacement selection: the workspace is a min-heap keyed on (run, record).
+ * Once it is full, every new record evicts the smallest one to the current run, and joins that run
+ * itself if it does not sort before the record just written; otherwise it waits for the next run.
+ * Runs therefore average twice the workspace on random input, and sorted input yields a single run.
+ *
+ * Runs are merged through a loser tree, which needs only log2(k) comparisons per record.  When there
+ * are more runs than the budget allows buffers for (memBytes / SORT_MERGE_BUF), groups of runs are
+ * first merged into longer runs until one final merge remains.
+ */
+
+
+/*------------------------------------------------------------
+
+FUNCTION build_run_filename (s, runNum, fname, buflen)
+
+PARAMETER DESCRIPTION:
+    s      → sort descriptor owning the run.
+    runNum → sequence number of the run.
+    fname  → output buffer receiving "<prefix>.run<runNum>".
+    buflen → size of the output buffer.
+
+FUNCTION DESCRIPTION:
+    Builds the name of a temporary run file.
+    Runs live in the current working directory, which is the directory of the open database.
+
+------------------------------------------------------------*/
+
+static void build_run_filename(ExtSort *s, int runNum, char *fname, size_t buflen)
+{
+    snprintf(fname, buflen, "%s.run%d", s->prefix, runNum);
+}
+
+static FILE *openRun(ExtSort *s, int runNum, const char *mode)
+{
+    char fname[sizeof(s->prefix) + 16];
+    build_run_filename(s, runNum, fname, sizeof(fname));
+
+    FILE *fp = fopen(fname, mode);
+    if(!fp)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NULL;
+    }
+
+    setvbuf(fp, NULL, _IOFBF, SORT_MERGE_BUF);
+    return fp;
+}
+
+static void removeRun(ExtSort *s, int runNum)
+{
+    char fname[sizeof(s->prefix) + 16];
+    build_run_filename(s, runNum, fname, sizeof(fname));
+    remove(fname);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION heap helpers (rsLess, rsSiftDown, rsSiftUp)
+
+FUNCTION DESCRIPTION:
+    Maintain s->heap, the replacement-selection heap of workspace slots.
+    A slot sorts before another if it belongs to an earlier run, or to the same run with a smaller record.
+
+------------------------------------------------------------*/
+
+static int rsLess(ExtSort *s, int a, int b)
+{
+    if(s->slotRun[a] != s->slotRun[b])
+        return s->slotRun[a] < s->slotRun[b];
+    return s->cmp(s->mem + (long)a * s->recSize, s->mem + (long)b * s->recSize, s->ctx) < 0;
+}
+
+static void rsSiftDown(ExtSort *s, long i)
+{
+    for(;;)
+    {
+        long l = 2 * i + 1, r = l + 1, m = i;
+
+        if(l < s->nInMem && rsLess(s, s->heap[l], s->heap[m]))
+            m = l;
+        if(r < s->nInMem && rsLess(s, s->heap[r], s->heap[m]))
+            m = r;
+        if(m == i)
+            return;
+
+        int t = s->heap[i];
+        s->heap[i] = s->heap[m];
+        s->heap[m] = t;
+        i = m;
+    }
+}
+
+static void rsSiftUp(ExtSort *s, long i)
+{
+    while(i > 0)
+    {
+        long p = (i - 1) / 2;
+        if(!rsLess(s, s->heap[i], s->heap[p]))
+            return;
+
+        int t = s->heap[i];
+        s->heap[i] = s->heap[p];
+        s->heap[p] = t;
+        i = p;
+    }
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION emitTop (s)
+
+PARAMETER DESCRIPTION:
+    s → sort descriptor with a non-empty workspace heap.
+
+FUNCTION DESCRIPTION:
+    Writes the smallest held record to its run, switching to a new run file first when the record belongs to the next run.
+    The record stays in its slot; the caller either overwrites the slot or removes it from the heap.
+
+RETURNS:
+    Slot that was written, or NOTOK (FILESYSTEM_ERROR).
+
+------------------------------------------------------------*/
+
+static int emitTop(ExtSort *s)
+{
+    int slot = s->heap[0];
+    char *rec = s->mem + (long)slot * s->recSize;
+
+    if(s->slotRun[slot] != s->curRun)
+    {
+        if(s->out)
+            fclose(s->out);
+
+        s->curRun = s->slotRun[slot];
+        s->out = openRun(s, s->curRun, "wb");
+        if(!s->out)
+            return NOTOK;
+        s->numRuns = s->curRun + 1;
+    }
+
+    if(fwrite(rec, s->recSize, 1, s->out) != 1)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+
+    memcpy(s->lastOut, rec, s->recSize);
+    return slot;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ExtSortOpen (s, recSize, cmp, ctx, memBytes, prefix)
+
+PARAMETER DESCRIPTION:
+    s        → sort descriptor to initialize.
+    recSize  → size in bytes of every record that will be sorted.
+    cmp      → comparator returning <0, 0, >0 (qsort_r convention).
+    ctx      → opaque pointer handed to every cmp call.
+    memBytes → memory budget for run generation and for merge buffers.
+    prefix   → prefix used for temporary run files.
+
+FUNCTION DESCRIPTION:
+    Prepares an external merge sort of fixed-size records.
+    If the input never exceeds the workspace, no file is ever written and the records are returned straight from memory.
+
+RETURNS:
+    OK    → descriptor ready for ExtSortAdd().
+    NOTOK → memory could not be allocated.
+
+ERRORS REPORTED:
+    MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+int ExtSortOpen(ExtSort *s, int recSize, ExtSortCmp cmp, void *ctx, long memBytes, const char *prefix)
+{
+    memset(s, 0, sizeof(ExtSort));
+    s->recSize = recSize;
+    s->cmp = cmp;
+    s->ctx = ctx;
+    s->memBytes = memBytes;
+    s->curRun = -1;
+    snprintf(s->prefix, sizeof(s->prefix), "%s", prefix);
+
+    /* each held record also costs a heap entry and a run tag */
+    s->memRecs = memBytes / (recSize + 2 * sizeof(int));
+    if(s->memRecs < 2)
+        s->memRecs = 2;
+
+    s->mem = malloc(s->memRecs * recSize);
+    s->heap = malloc(s->memRecs * sizeof(int));
+    s->slotRun = malloc(s->memRecs * sizeof(int));
+    s->lastOut = malloc(recSize);
+
+    if(!s->mem || !s->heap || !s->slotRun || !s->lastOut)
+    {
+        ExtSortClose(s);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ExtSortAdd (s, rec)
+
+PARAMETER DESCRIPTION:
+    s   → open sort descriptor.
+    rec → record to be added to the input of the sort.
+
+FUNCTION DESCRIPTION:
+    One step of replacement selection.
+
+ALGORITHM:
+    1) While the workspace has room, store rec in the next slot and sift it up (run 0).
+    2) Otherwise write the heap top to its run (emitTop()) and put rec in the freed slot,
+       tagged with the current run if it does not sort before the record just written, else with the next run.
+    3) Sift the slot down.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+------------------------------------------------------------*/
+
+int ExtSortAdd(ExtSort *s, const void *rec)
+{
+    if(s->nInMem < s->memRecs)
+    {
+        int slot = s->nInMem;
+        memcpy(s->mem + (long)slot * s->recSize, rec, s->recSize);
+        s->slotRun[slot] = 0;
+        s->heap[s->nInMem++] = slot;
+        rsSiftUp(s, s->nInMem - 1);
+        return OK;
+    }
+
+    int slot = emitTop(s);
+    if(slot == NOTOK)
+        return NOTOK;
+
+    memcpy(s->mem + (long)slot * s->recSize, rec, s->recSize);
+    s->slotRun[slot] = s->cmp(rec, s->lastOut, s->ctx) < 0 ? s->curRun + 1 : s->curRun;
+    rsSiftDown(s, 0);
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION loser tree (mgBeats, mgAdjust, mgRead)
+
+FUNCTION DESCRIPTION:
+    Leaf index k stands for a virtual minus-infinity record used only while building the tree; an exhausted run is plus infinity.
+    Ties go to the lower run number, so equal records keep the order of the runs.
+
+    mgAdjust(m, i) replays the matches on the path from leaf i to the root after leaf i's head changed:
+    at each node the loser stays and the winner moves up, leaving the overall winner in tree[0].
+
+------------------------------------------------------------*/
+
+static int mgBeats(ExtMerge *m, int a, int b)
+{
+    if(a == m->k) return 1;
+    if(b == m->k) return 0;
+    if(m->done[a]) return 0;
+    if(m->done[b]) return 1;
+
+    int c = m->cmp(m->heads + (long)a * m->recSize, m->heads + (long)b * m->recSize, m->ctx);
+    return c < 0 || (c == 0 && a < b);
+}
+
+static void mgAdjust(ExtMerge *m, int i)
+{
+    int winner = i;
+
+    for(int t = (i + m->k) / 2; t > 0; t /= 2)
+    {
+        if(mgBeats(m, m->tree[t], winner))
+        {
+            int tmp = m->tree[t];
+            m->tree[t] = winner;
+            winner = tmp;
+        }
+    }
+    m->tree[0] = winner;
+}
+
+static int mgRead(ExtMerge *m, int i)
+{
+    if(m->left[i] == 0)
+    {
+        m->done[i] = 1;
+        return OK;
+    }
+
+    if(fread(m->heads + (long)i * m->recSize, m->recSize, 1, m->runs[i]) == 1)
+    {
+        if(m->left[i] > 0)
+            m->left[i]--;
+        return OK;
+    }
+
+    if(ferror(m->runs[i]))
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+    m->done[i] = 1;
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ExtMergeOpen (m, recSize, cmp, ctx, runs, counts, k)
+
+PARAMETER DESCRIPTION:
+    m       → merge descriptor to initialize.
+    recSize → size in bytes of every record.
+    cmp     → comparator returning <0, 0, >0 (qsort_r convention).
+    ctx     → opaque pointer handed to every cmp call.
+    runs    → k files, each positioned at the first record of a sorted run.
+    counts  → number of records to take from each run, or NULL to read every run to its end.
+    k       → number of runs.
+
+FUNCTION DESCRIPTION:
+    Starts a k-way merge of sorted runs through a loser tree, which needs log2(k) comparisons per record.
+    Limiting each run to counts[i] records lets callers merge a key range of larger sorted files (see physical/parsort.c).
+    The merge takes ownership of the files, also when it fails.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+ERRORS REPORTED:
+    MEM_ALLOC_ERROR
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+int ExtMergeOpen(ExtMerge *m, int recSize, ExtSortCmp cmp, void *ctx, FILE **runs, const long *counts, int k)
+{
+    memset(m, 0, sizeof(ExtMerge));
+    m->recSize = recSize;
+    m->cmp = cmp;
+    m->ctx = ctx;
+    m->k = k;
+
+    if(k == 0)
+        return OK;
+
+    m->runs = malloc(k * sizeof(FILE *));
+    m->left = malloc(k * sizeof(long));
+    m->heads = malloc((size_t)k * recSize);
+    m->done = calloc(k, 1);
+    m->tree = malloc(k * sizeof(int));
+
+    if(!m->runs || !m->left || !m->heads || !m->done || !m->tree)
+    {
+        free(m->runs);
+        m->runs = NULL;
+        for(int i = 0; i < k; i++)
+            fclose(runs[i]);
+        ExtMergeClose(m);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    for(int i = 0; i < k; i++)
+    {
+        m->runs[i] = runs[i];
+        m->left[i] = counts ? counts[i] : -1;
+        m->tree[i] = k;
+    }
+
+    for(int i = 0; i < k; i++)
+    {
+        if(mgRead(m, i) == NOTOK)
+        {
+            ExtMergeClose(m);
+            return NOTOK;
+        }
+    }
+
+    for(int i = k - 1; i >= 0; i--)
+        mgAdjust(m, i);
+
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ExtMergeNext (m, rec)
+
+PARAMETER DESCRIPTION:
+    m   → open merge descriptor.
+    rec → (OUT) receives the next record in sorted order.
+
+RETURNS:
+    1 with the next record in rec, 0 once every run is exhausted, NOTOK on a read error (FILESYSTEM_ERROR).
+
+------------------------------------------------------------*/
+
+int ExtMergeNext(ExtMerge *m, void *rec)
+{
+    if(m->k == 0)
+        return 0;
+
+    int w = m->tree[0];
+
+    if(m->done[w])
+        return 0;
+
+    memcpy(rec, m->heads + (long)w * m->recSize, m->recSize);
+    if(mgRead(m, w) == NOTOK)
+        return NOTOK;
+
+    mgAdjust(m, w);
+    return 1;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ExtMergeClose (m)
+
+PARAMETER DESCRIPTION:
+    m → merge descriptor to be released; may be zeroed or partly opened.
+
+FUNCTION DESCRIPTION:
+    Closes the run files and frees the merge state.  The files themselves are left to the caller.
+
+------------------------------------------------------------*/
+
+void ExtMergeClose(ExtMerge *m)
+{
+    for(int i = 0; m->runs && i < m->k; i++)
+        if(m->runs[i])
+            fclose(m->runs[i]);
+
+    free(m->runs);
+    free(m->left);
+    free(m->heads);
+    free(m->done);
+    free(m->tree);
+    memset(m, 0, sizeof(ExtMerge));
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION mergeOpen (s, m, ids, k)
+
+PARAMETER DESCRIPTION:
+    s   → sort descriptor owning the runs.
+    m   → merge descriptor to initialize.
+    ids → run numbers to merge.
+    k   → number of runs.
+
+FUNCTION DESCRIPTION:
+    Opens the given runs of s and starts merging them with ExtMergeOpen().
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+------------------------------------------------------------*/
+
+static int mergeOpen(ExtSort *s, ExtMerge *m, const int *ids, int k)
+{
+    FILE **runs = malloc(k * sizeof(FILE *));
+
+    if(!runs)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    for(int i = 0; i < k; i++)
+    {
+        runs[i] = openRun(s, ids[i], "rb");
+        if(!runs[i])
+        {
+            while(--i >= 0)
+                fclose(runs[i]);
+            free(runs);
+            return NOTOK;
+        }
+    }
+
+    int rc = ExtMergeOpen(m, s->recSize, s->cmp, s->ctx, runs, NULL, k);
+    free(runs);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION mergePass (s, ids, k)
+
+PARAMETER DESCRIPTION:
+    s   → sort descriptor.
+    ids → run numbers to merge.
+    k   → number of runs.
+
+FUNCTION DESCRIPTION:
+    Merges k runs into a new run file and deletes the inputs.
+
+RETURNS:
+    Number of the new run, or NOTOK (db_err_code set).
+
+------------------------------------------------------------*/
+
+static int mergePass(ExtSort *s, const int *ids, int k)
+{
+    ExtMerge m;
+    int id = s->numRuns, rc;
+    char *rec = malloc(s->recSize);
+
+    if(!rec)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    FILE *out = openRun(s, id, "wb");
+    if(!out)
+    {
+        free(rec);
+        return NOTOK;
+    }
+    s->numRuns++;
+
+    if(mergeOpen(s, &m, ids, k) == NOTOK)
+    {
+        fclose(out);
+        free(rec);
+        return NOTOK;
+    }
+
+    while((rc = ExtMergeNext(&m, rec)) == 1)
+    {
+        if(fwrite(rec, s->recSize, 1, out) != 1)
+        {
+            db_err_code = FILESYSTEM_ERROR;
+            rc = NOTOK;
+            break;
+        }
+    }
+
+    ExtMergeClose(&m);
+    free(rec);
+    if(fclose(out) != 0 && rc != NOTOK)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        rc = NOTOK;
+    }
+    if(rc == NOTOK)
+        return NOTOK;
+
+    for(int i = 0; i < k; i++)
+        removeRun(s, ids[i]);
+    return id;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ExtSortFinish (s)
+
+PARAMETER DESCRIPTION:
+    s → open sort descriptor; no more records will be added.
+
+FUNCTION DESCRIPTION:
+    Ends the input phase and prepares the merge.
+
+ALGORITHM:
+    1) If nothing was spilled, sort the workspace in place; ExtSortNext() returns it directly.
+    2) Otherwise drain the heap into the runs and free the workspace.
+    3) fanIn = MAX(2, memBytes / SORT_MERGE_BUF).  While there are more than fanIn runs, merge the oldest fanIn
+       runs into a new one (mergePass()), appending it to the list, so runs of similar length are merged together.
+    4) Open the final loser-tree merge over the remaining runs.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+ERRORS REPORTED:
+    FILESYSTEM_ERROR
+    MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+int ExtSortFinish(ExtSort *s)
+{
+    s->finished = 1;
+
+    if(s->curRun < 0)
+    {
+        qsort_r(s->mem, s->nInMem, s->recSize, s->cmp, s->ctx);
+        s->nextMem = 0;
+        return OK;
+    }
+
+    while(s->nInMem > 0)
+    {
+        if(emitTop(s) == NOTOK)
+            return NOTOK;
+        s->heap[0] = s->heap[--s->nInMem];
+        rsSiftDown(s, 0);
+    }
+
+    if(fclose(s->out) != 0)
+    {
+        s->out = NULL;
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+    s->out = NULL;
+
+    /* The workspace is no longer needed during the merge */
+    free(s->mem);
+    free(s->heap);
+    free(s->slotRun);
+    s->mem = NULL;
+    s->heap = s->slotRun = NULL;
+
+    int n = s->numRuns;
+    int fanIn = MAX(2, (int)(s->memBytes / SORT_MERGE_BUF));
+    int *ids = malloc((n + n / (fanIn - 1) + 1) * sizeof(int));
+
+    if(!ids)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    for(int i = 0; i < n; i++)
+        ids[i] = i;
+
+    int first = 0, last = n;
+    while(last - first > fanIn)
+    {
+        int id = mergePass(s, ids + first, fanIn);
+        if(id == NOTOK)
+        {
+            free(ids);
+            return NOTOK;
+        }
+        first += fanIn;
+        ids[last++] = id;
+    }
+
+    int rc = mergeOpen(s, &s->merge, ids + first, last - first);
+    free(ids);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ExtSortNext (s, rec)
+
+PARAMETER DESCRIPTION:
+    s   → finished sort descriptor.
+    rec → (OUT) receives the next record in sorted order.
+
+FUNCTION DESCRIPTION:
+    Returns the records in ascending cmp order, one per call.
+
+RETURNS:
+    1     → rec holds the next record.
+    0     → all records have been returned.
+    NOTOK → read error while merging (db_err_code set).
+
+ERRORS REPORTED:
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+int ExtSortNext(ExtSort *s, void *rec)
+{
+    if(s->curRun < 0)
+    {
+        if(s->nextMem >= s->nInMem)
+            return 0;
+        memcpy(rec, s->mem + s->nextMem * s->recSize, s->recSize);
+        s->nextMem++;
+        return 1;
+    }
+
+    return ExtMergeNext(&s->merge, rec);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ExtSortClose (s)
+
+PARAMETER DESCRIPTION:
+    s → sort descriptor to be released.
+
+FUNCTION DESCRIPTION:
+    Closes and unlinks every temporary run file and frees all memory held by the descriptor.
+    Safe to call at any stage, including after a failure.
+
+------------------------------------------------------------*/
+
+void ExtSortClose(ExtSort *s)
+{
+    ExtMergeClose(&s->merge);
+
+    if(s->out)
+        fclose(s->out);
+
+    for(int k = 0; k < s->numRuns; k++)
+        removeRun(s, k);
+
+    free(s->mem);
+    free(s->heap);
+    free(s->slotRun);
+    free(s->lastOut);
+    memset(s, 0, sizeof(ExtSort));
+}
\ No newline at end of file
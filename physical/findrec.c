@@ -2,6 +2,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
 #include <string.h>
 #include <math.h>
 #include "../include/defs.h"
@@ -9,28 +10,32 @@
 #include "../include/globals.h"
 #include "../include/readpage.h"
 #include "../include/error.h"
+#include "../include/zonemap.h"
+#include "../include/predicate.h"
+#include "../include/pagelayout.h"
+#include "../include/dict.h"
 
 
 /*--------------------------------------------------------------
 
-FUNCTION modifyRec (foundRid, rid, recPtr, curRec, recSize)
+FUNCTION modifyRec (foundRid, rid, recPtr, entry, page)
 
 PARAMETER DESCRIPTION:
     foundRid  → (OUT) pointer to a Rid structure that will receive the RID of the located record.
     rid       → the RID of the record currently being examined.
     recPtr    → pointer to caller-allocated buffer in which the found record will be copied.
-    curRec    → pointer to a temporary buffer holding the candidate record read from disk.
-    recSize   → the record length in bytes.
+    entry     → cache entry of the relation.
+    page      → page buffer holding the candidate record.
 
 FUNCTION DESCRIPTION:
     This helper routine is used inside FindRec() to finalize the discovery of a qualifying record.
     When a predicate matches:
         - foundRid is set to rid.
-        - recPtr is populated with the contents of curRec.
+        - recPtr is populated with the record in slot rid.slotnum of page.
 
 ALGORITHM:
        1) *foundRid = rid.
-       2) Copy recSize bytes from curRec to recPtr.
+       2) Copy the record out of the page with PageGetRec(), which follows the relation's page layout.
 
 GLOBAL VARIABLES MODIFIED:
        None.
@@ -41,10 +46,10 @@ ERRORS REPORTED:
 --------------------------------------------------------------*/
 
 
-void modifyRec(Rid *foundRid, Rid rid, void *recPtr, void *curRec, int recSize)
+void modifyRec(Rid *foundRid, Rid rid, void *recPtr, const CacheEntry *entry, const char *page)
 {
     *foundRid = rid;
-    memcpy(recPtr, curRec, recSize);
+    PageGetRec(entry, page, rid.slotnum, recPtr);
 }
 
 
@@ -65,30 +70,16 @@ FUNCTION DESCRIPTION:
         curRec[attr] <op> literal
     The attribute is extracted from curRec using attrOffset and interpreted based on attrType:
         For INTEGER:      compare as signed 4-byte ints.
-        For FLOAT:        compare using float_cmp() with ε-based stable float comparison.
-        For STRING:       fixed-length comparison using strncmp() over attrSize bytes.
+        For FLOAT:        compare with the ε-based stable comparison of float_cmp().
+        For STRING:       fixed-length comparison with strncmp() semantics over attrSize bytes.
     Returns TRUE (1) if the predicate holds, otherwise FALSE (0).
     Special handling exists for floating-point NaN values:
         - Ordered comparisons (<, <=, >, >=) return FALSE.
         - Only inequality (CMP_NE) returns TRUE.
 
 ALGORITHM:
-    1) Extract attribute from curRec based on attrType.
-    2) Compute cmp:
-        -1 if attribute < literal
-        0 if attribute == literal
-        1 if attribute > literal
-        2 if NaN detected (float only)
-    3) If cmp == 2 (NaN case):
-        return (compOp == CMP_NE).
-    4) For normal cases, apply compOp semantics:
-        CMP_EQ:  cmp == 0
-        CMP_NE:  cmp != 0
-        CMP_LT:  cmp <  0
-        CMP_LTE: cmp <= 0
-        CMP_GT:  cmp >  0
-        CMP_GTE: cmp >= 0
-    5) Return 1 if predicate true, else 0.
+    1) Compile the predicate with PredInit().
+    2) Return PredEval() on curRec.
 
 GLOBAL VARIABLES MODIFIED:
        None.
@@ -96,56 +87,17 @@ GLOBAL VARIABLES MODIFIED:
 ERRORS REPORTED:
        None.
 
+IMPLEMENTATION NOTES:
+    - One-off comparisons only: loops over many records should PredInit() once and call PredEval() per record.
+
 --------------------------------------------------------------*/
 
 int compareRecs(void *curRec, void *valuePtr, char attrType, int attrSize, int attrOffset, int compOp)
 {
-    int cmp = 0;   /* -1,0,1 like strcmp/float_cmp; special 2 for NaN in floats */
-
-    switch (attrType) {
-        case 'i': {
-            int curVal = *(int *)((char *)curRec + attrOffset);
-            int val = *(int *)valuePtr;
-            if (curVal < val) cmp = -1;
-            else if (curVal > val) cmp = 1;
-            else cmp = 0;
-            break;
-        }
-        case 'f': {
-            double curVal = (double)(*(float *)((char *)curRec + attrOffset));
-            double val = (double)(*(float *)valuePtr);
-            cmp = float_cmp(curVal, val, FLOAT_REL_EPS, FLOAT_ABS_EPS);
-            break;
-        }
-        case 's': {
-            char *curVal = (char *)curRec + attrOffset;
-            char *val = (char *)valuePtr;
-            int s = strncmp(curVal, val, attrSize);
-            if (s < 0) cmp = -1;
-            else if (s > 0) cmp = 1;
-            else cmp = 0;
-            break;
-        }
-        default:
-            return 0; /* unknown type -> treat as no match */
-    }
-
-    /* If float comparison produced NaN indicator: ordered comparisons are false,
-       only 'not equal' should be true (NaN != anything) */
-    if (cmp == 2) {
-        if (compOp == CMP_NE) return 1;
-        return 0;
-    }
+    Pred pred;
 
-    switch (compOp) {
-        case CMP_EQ:  return (cmp == 0);
-        case CMP_NE:  return (cmp != 0);
-        case CMP_GT:  return (cmp > 0);
-        case CMP_GTE: return (cmp > 0 || cmp == 0);
-        case CMP_LT:  return (cmp < 0);
-        case CMP_LTE: return (cmp < 0 || cmp == 0);
-        default:      return 0;
-    }
+    PredInit(&pred, attrType, attrSize, attrOffset, valuePtr, compOp);
+    return PredEval(&pred, curRec);
 }
 
 
@@ -167,14 +119,15 @@ PARAMETER DESCRIPTION:
 FUNCTION DESCRIPTION:
     This routine implements the predicate-based scan underlying SELECT and DELETE operations.
     Starting just after startRid, every occupied slot in every subsequent page is examined. 
-    For each record:
+    Before a page is read its zone map block is consulted (ZoneMapCanSkip()); a page whose min/max cannot satisfy the predicate is skipped without being read.
+    Each page is evaluated as a whole:
         1) The page is loaded (ReadPage).
-        2) The slotmap is checked to ensure the slot is active.
-        3) The record is copied into a temporary buffer.
-        4) The attribute at attrOffset is compared with the literal stored in valuePtr using compareRecs().
-        5) If the predicate holds, the record is copied into recPtr, foundRid is set, and OK is returned.
+        2) The predicate, compiled once per call with PredInit(), is evaluated on every slot by PredEvalPage(),
+           which returns a bitmask of matching occupied slots (AVX2 gathers for int and float attributes when the CPU has them).
+        3) Slots before the current position are masked off.
+        4) If a bit remains, the lowest one is the next match: the record is copied from the page into recPtr, foundRid is set, and OK is returned.
     If no matching record exists, OK is returned with foundRid = { -1, -1 }.
-    Errors occur only if page access fails or memory cannot be allocated for a temporary record buffer.
+    Errors occur only if page access fails.
 
 RETURNS:
     OK     → success (record matched OR scan exhausted).
@@ -183,22 +136,17 @@ RETURNS:
 ALGORITHM:
     1) rid = IncRid(startRid, recsPerPg).
     2) Set *foundRid = { -1, -1 }.
-    3) Clear recPtr to eliminate stale data.
+    3) Compile the predicate with PredInit().
     4) While rid.pid < numPgs:
-        a) Call ReadPage(relNum, rid.pid).
+        a) If ZoneMapCanSkip() says the page cannot match, move rid to slot 0 of the next page and continue.
+        b) Call ReadPage(relNum, rid.pid).
             If NOTOK → return NOTOK.
-        b) Read slotmap from page.
-        c) If slot is occupied:
-            - Allocate buffer curRec = malloc(recSize).
-            - Copy record into curRec.
-            - If compareRecs(curRec, valuePtr, …, compOp)
-                then:
-                    *foundRid = rid;
-                    copy curRec → recPtr;
-                    free curRec;
-                    return OK;
-            - free(curRec).
-        d) rid = IncRid(rid, recsPerPg).
+        c) match = PredEvalPage(pred, records of the page, slotmap) with the bits below rid.slotnum cleared.
+        d) If match ≠ 0:
+                rid.slotnum = lowest set bit of match;
+                modifyRec(foundRid, rid, recPtr, &catcache[relNum], page);
+                return OK;
+        e) rid = slot 0 of the next page.
     5) No match found → return OK.
 
 GLOBAL VARIABLES MODIFIED:
@@ -208,12 +156,23 @@ BUGS:
     None found.
 
 ERRORS REPORTED:
-    MEM_ALLOC_ERROR     – failure to allocate temporary record.
+    ATTRNOEXIST     – no attribute of the relation starts at attrOffset.
+    MEM_ALLOC_ERROR – see DictMatch().
+    ReadPage() errors are propagated.
 
 IMPLEMENTATION NOTES:
     - The caller interprets “no match” by checking foundRid->pid < 0.
-    - compareRecs() handles integer, float (with NaN support), and fixed-length string comparisons.
+    - The kernels handle integer, float (with NaN support), and fixed-length string comparisons exactly like compareRecs().
     - This routine does NOT skip deleted pages; it only checks bit-level slot occupancy.
+    - Each call re-evaluates the rest of the page it resumes on; selective predicates rarely have more than one match per page.
+    - Records are tested in place in the page buffer; only a match is copied, and recPtr is left untouched when the scan is exhausted.
+    - The predicate runs over the attribute's values PageAttrStride() bytes apart: on a PAX page it reads the
+      attribute's minipage only.
+    - On an ENC_DICT attribute the predicate runs on the codes: "=" and "<>" compare them with the code of
+      the literal (-1 when the dictionary does not hold it), and the other operators look every code up in
+      the flags DictMatch() computed once over the dictionary.
+    - On a slotted page (LAYOUT_SLOTTED) the values of the occupied slots are first copied into a column with
+      PageAttrValue(), decoded, and the predicate runs on that column.
 
 --------------------------------------------------------------*/
 
@@ -221,44 +180,81 @@ int FindRec(int relNum, Rid startRid, Rid *foundRid, void *recPtr, char attrType
 {
     int numPgs = catcache[relNum].relcat_rec.numPgs;
     int recsPerPg = catcache[relNum].relcat_rec.recsPerPg;
-    int recSize = catcache[relNum].relcat_rec.recLength;
+    const CacheEntry *entry = &catcache[relNum];
+    const AttrDesc *attr = PageAttrAt(entry, attrOffset);
     char *page = buffer[relNum].page;
-    
     Rid rid = IncRid(startRid, recsPerPg);
+
     *foundRid = (Rid){-1, -1};
-    memset(recPtr, 0, recSize);
+
+    if(!attr)
+    {
+        db_err_code = ATTRNOEXIST;
+        return NOTOK;
+    }
+
+    /* The attribute's values form a column of the page, stride bytes apart; a slotted page's are gathered into col */
+    static char col[MAX_RECS_PER_PG * (MAX_N + 1)];
+    bool gather = entry->relcat_rec.layout == LAYOUT_SLOTTED;
+    int first = gather ? 0 : PageAttrPos(entry, 0, attr);
+    int stride = gather ? attrSize : PageAttrStride(entry, attr);
+    unsigned char *codeMatch = NULL;
+    Pred pred;
+
+    if(!attr->dict || gather)
+    {
+        PredInit(&pred, attrType, attrSize, 0, valuePtr, compOp);
+    }
+    else if(compOp == CMP_EQ || compOp == CMP_NE)
+    {
+        /* A value without a code is held by no record: -1 equals no code */
+        int code = DictLookup(attr->dict, valuePtr);
+        PredInit(&pred, 'i', sizeof(int), 0, &code, compOp);
+    }
+    else
+    {
+        if(!(codeMatch = DictMatch(attr->dict, valuePtr, compOp)))
+            return NOTOK;
+        PredInitCodes(&pred, 0, codeMatch, attr->dict->numCodes);
+    }
 
     while(rid.pid < numPgs)
     {
+        if(ZoneMapCanSkip(relNum, rid.pid, attrType, attrSize, attrOffset, valuePtr, compOp))
+        {
+            rid = (Rid){rid.pid + 1, 0};
+            continue;
+        }
+
         if(ReadPage(relNum, rid.pid) == NOTOK)
-        return NOTOK;
+        {
+            free(codeMatch);
+            return NOTOK;
+        }
 
         unsigned long slotmap;
         memcpy(&slotmap, page+MAGIC_SIZE, sizeof(slotmap));
 
-        if(slotmap & (1UL << rid.slotnum))
+        for(unsigned long live = gather ? slotmap : 0; live; live &= live - 1)
         {
-            void *curRec = malloc(recSize);
-
-            if(!curRec)
-            {
-                db_err_code = MEM_ALLOC_ERROR;
-                return NOTOK;
-            }
-
-            memcpy(curRec, page+HEADER_SIZE+recSize*rid.slotnum, recSize);
+            int s = __builtin_ctzl(live);
+            memmove(col + s * stride, PageAttrValue(entry, page, s, attr, col + s * stride), attrSize);
+        }
 
-            if(compareRecs(curRec, valuePtr, attrType, attrSize, attrOffset, compOp))
-            {
-                modifyRec(foundRid, rid, recPtr, curRec, recSize);
-                return OK;
-            }
+        unsigned long match = PredEvalPage(&pred, (gather ? col : page) + first, stride, recsPerPg, slotmap);
+        match &= ~((1UL << rid.slotnum) - 1);
 
-            free(curRec);
+        if(match)
+        {
+            rid.slotnum = __builtin_ctzl(match);
+            modifyRec(foundRid, rid, recPtr, entry, page);
+            free(codeMatch);
+            return OK;
         }
 
-        rid = IncRid(rid, recsPerPg);
+        rid = (Rid){rid.pid + 1, 0};
     }
 
+    free(codeMatch);
     return OK;
 }
\ No newline at end of file
@@ -21,7 +21,7 @@ PARAMETER DESCRIPTION:
     buflen  → Size of output buffer.
 
 FUNCTION DESCRIPTION:
-    Constructs the filename used to store the freemap bitmap for a relation.
+    Constructs the filename used to store the freemap of a relation.
     The freemap file always follows the naming rule:
             "<relName>.fmap"
 
@@ -40,9 +40,8 @@ IMPLEMENTATION NOTES:
     - The function is used by:
         • FreeMapExists()
         • CreateFreeMap()
-        • AddToFreeMap()
-        • DeleteFromFreeMap()
-        • FindFreeSlot()
+        • SetFreeSpace()
+        • FindFreePage()
     - Keeping filename logic in one helper avoids duplication and ensures consistency.
 
 BUGS
@@ -51,12 +50,13 @@ BUGS
 ------------------------------------------------------------*/
 
 /*
- * We use a fixed-size bitmap indexed by pageNum (short, 0..32767).
- * That’s 32768 bits = 4096 bytes per relation -> very small.
+ * The freemap holds one unsigned short per heap page, indexed by pageNum (short, 0..32767): the bytes a
+ * record may still take in the page (PageFreeBytes()), so 0 for a full page.  With fixed-length records
+ * that is a whole number of records; a slotted page (LAYOUT_SLOTTED) fits any record up to that size.
+ * Pages past the end of the file have nothing recorded and read as full.
  */
 
 #define MAX_FREEMAP_PAGES   32768
-#define FREEMAP_BYTES       (MAX_FREEMAP_PAGES / 8)
 
 void build_fmap_filename(const char *relName, char *fname, size_t buflen)
 {
@@ -72,7 +72,7 @@ PARAMETER DESCRIPTION:
     relName → Name of the relation whose freemap file is being queried.
 
 FUNCTION DESCRIPTION:
-    A freemap is an auxiliary bitmap file "<relName>.fmap" that tracks which pages of the heap file contain free slots.  
+    A freemap is an auxiliary file "<relName>.fmap" that records the free bytes of every page of the heap file.  
     This routine checks whether the freemap file exists and returns:
          1  → freemap exists  
          0  → freemap does NOT exist  
@@ -124,19 +124,18 @@ PARAMETER DESCRIPTION:
     relName → Name of the relation for which the freemap file "<relName>.fmap" must be created or reset.
 
 FUNCTION DESCRIPTION:
-    Creates a freemap file of fixed size (4096 bytes) with all bits = 0, meaning all pages are “not free / not yet allocated”.
+    Creates an empty freemap file: no page has free space recorded yet.
     Called when:
         - A new relation is created.
-        - set_freemap_bit() discovers that no freemap exists.
+        - SetFreeSpace() discovers that no freemap exists.
 
 ALGORITHM:
     1) Construct freemap filename.
-    2) Open file in write-binary mode ("wb").
-    3) Write FREEMAP_BYTES of zero bytes.
-    4) Close file and return OK.
+    2) Open file in write-binary mode ("wb"), truncating an old one.
+    3) Close file and return OK.
 
 GLOBAL VARIABLES MODIFIED:
-    db_err_code → set to FILESYSTEM_ERROR on write/open failure.
+    db_err_code → set to FILESYSTEM_ERROR on open failure.
 
 ERRORS REPORTED:
     FILESYSTEM_ERROR
@@ -158,16 +157,6 @@ int CreateFreeMap(const char *relName)
         return NOTOK;
     }
 
-    unsigned char zero[FREEMAP_BYTES];
-    memset(zero, 0, sizeof(zero));
-
-    if (fwrite(zero, 1, sizeof(zero), fp) != sizeof(zero))
-    {
-        fclose(fp);
-        db_err_code = FILESYSTEM_ERROR;
-        return NOTOK;
-    }
-
     fclose(fp);
     return OK;
 }
@@ -175,29 +164,24 @@ int CreateFreeMap(const char *relName)
 
 /*------------------------------------------------------------
 
-FUNCTION  set_freemap_bit(relName, pageNum, value):
+FUNCTION  SetFreeSpace(relName, pageNum, freeBytes):
 
 PARAMETER DESCRIPTION:
-    relName → Relation name
-    pageNum → Page number whose freemap bit must be set/cleared
-    value   → 1 to mark page as having free space, 0 to mark as full
+    relName   → Relation name
+    pageNum   → Page whose entry must be set
+    freeBytes → Bytes a record may take in the page now, 0 when it is full
 
 FUNCTION DESCRIPTION:
-    Low-level helper routine that performs a single-bit update in the freemap file. 
-    One byte is read, modified, and re-written.
+    Records the free space of a page after InsertRec(), DeleteRec() or WriteRec() changed it.
+    One entry is written in place; writing past the end of the file extends it, and the pages skipped read as full.
 
 ALGORITHM:
     1) Validate that pageNum ∈ [0, MAX_FREEMAP_PAGES).
     2) Build filename "<relName>.fmap".
     3) Try opening file in "rb+" mode.
             If ENOENT → create freemap via CreateFreeMap() and reopen.
-    4) Seek to corresponding byte = pageNum/8.
-    5) Read the byte (assume 0 if EOF).
-    6) Modify the bit:
-            value == 1 → set bit  
-            value == 0 → clear bit
-    7) Seek back and write modified byte.
-    8) Close file and return OK.
+    4) Seek to the entry of the page and write freeBytes.
+    5) Close file and return OK.
 
 GLOBAL VARIABLES MODIFIED:
     db_err_code → set to FILESYSTEM_ERROR on fseek/fwrite failure.
@@ -210,7 +194,7 @@ BUGS:
 
 ------------------------------------------------------------*/
 
-int set_freemap_bit(const char *relName, short pageNum, int value /*0 or 1*/)
+int SetFreeSpace(const char *relName, short pageNum, int freeBytes)
 {
     if (pageNum < 0 || pageNum >= MAX_FREEMAP_PAGES)
         return NOTOK;
@@ -219,6 +203,7 @@ int set_freemap_bit(const char *relName, short pageNum, int value /*0 or 1*/)
     build_fmap_filename(relName, fname, sizeof(fname));
 
     FILE *fp = fopen(fname, "rb+");
+
     if (!fp)
     {
         /* If the file doesn't exist, create it and reopen. */
@@ -226,6 +211,7 @@ int set_freemap_bit(const char *relName, short pageNum, int value /*0 or 1*/)
         {
             if (CreateFreeMap(relName) != OK)
                 return NOTOK;
+
             fp = fopen(fname, "rb+");
             if (!fp)
             {
@@ -239,38 +225,9 @@ int set_freemap_bit(const char *relName, short pageNum, int value /*0 or 1*/)
         }
     }
 
-    long byteIndex = pageNum / 8;
-    int  bitIndex  = pageNum % 8;
-
-    /* Seek to the correct byte in the bitmap */
-    if (fseek(fp, byteIndex, SEEK_SET) != 0)
-    {
-        fclose(fp);
-        return NOTOK;
-    }
+    unsigned short entry = (unsigned short)freeBytes;
 
-    unsigned char byte;
-    size_t n = fread(&byte, 1, 1, fp);
-    if (n != 1)
-    {
-        /* If EOF, treat as zero and extend */
-        byte = 0;
-    }
-
-    if (value)
-        byte |= (1u << bitIndex);   /* set bit */
-    else
-        byte &= ~(1u << bitIndex);  /* clear bit */
-
-    /* Seek back and write updated byte */
-    if (fseek(fp, byteIndex, SEEK_SET) != 0)
-    {
-        db_err_code = FILESYSTEM_ERROR;
-        fclose(fp);
-        return NOTOK;
-    }
-
-    if (fwrite(&byte, 1, 1, fp) != 1)
+    if (fseek(fp, (long)pageNum * sizeof(entry), SEEK_SET) != 0 || fwrite(&entry, sizeof(entry), 1, fp) != 1)
     {
         db_err_code = FILESYSTEM_ERROR;
         fclose(fp);
@@ -284,118 +241,69 @@ int set_freemap_bit(const char *relName, short pageNum, int value /*0 or 1*/)
 
 /*------------------------------------------------------------
 
-FUNCTION  AddToFreeMap(relName, pageNum):
+FUNCTION  FindFreePage(relName, numPgs, needBytes):
 
 PARAMETER DESCRIPTION:
-    relName → name of the relation
-    pageNum → page that just gained at least one free slot
-
-FUNCTION DESCRIPTION:
-    Marks a page as having free space by setting its freemap bit to 1.
-    O(1): single-byte read–modify–write.
-    Returns OK or NOTOK depending upon the success of set_freemap_bit function.
-
-------------------------------------------------------------*/
-
-int AddToFreeMap(const char *relName, short pageNum)
-{
-    return set_freemap_bit(relName, pageNum, 1);
-}
-
-
-/*------------------------------------------------------------
-
-FUNCTION  DeleteFromFreeMap(relName, pageNum)
-
-PARAMETER DESCRIPTION
-    relName → name of the relation
-    pageNum → page that became full (no free slots)
+       relName   → Name of the relation whose freemap must be scanned.
+       numPgs    → Pages of the relation; entries past them are ignored.
+       needBytes → Bytes the record to insert takes in a page (PageRecBytes()).
 
 FUNCTION DESCRIPTION:
-       Clears the freemap bit for this page (sets bit to 0) to indicate that it is no longer free..
-       O(1): single-byte read–modify–write.
-       Returns OK or NOTOK depending upon success of set_freemap_bit function.
-
-------------------------------------------------------------*/
-
-int DeleteFromFreeMap(const char *relName, short pageNum)
-{
-    return set_freemap_bit(relName, pageNum, 0);
-}
-
-
-/*------------------------------------------------------------
-
-FUNCTION  FindFreeSlot(relName):
+    Finds the first page whose recorded free space holds needBytes.
+    Only the entries of the relation's pages are read, so the cost is O(numPgs).
 
-PARAMETER DESCRIPTION:
-       relName → Name of the relation whose freemap must be scanned.
-
-FUNCTION DESCRIPTION:
-    Scans the bitmap file "<relName>.fmap" to find ANY page whose bit=1.
-    That page has free slots available for insertion.   
-    Return the page number of ANY page with bit=1 (i.e., has free slot), or -1 if none exist or file missing.
-    This is O(#pages/8) = O(FREEMAP_BYTES). With MAX_FREEMAP_PAGES fixed, this is bounded (4096 bytes) and very fast.
+RETURNS:
+    The page number, or numPgs if no page has room or the file is missing; NOTOK on error.
 
 ALGORITHM:
     1) Build freemap filename and attempt to open in "rb".
-        If open fails → return -1.
-    2) Read full bitmap (FREEMAP_BYTES).
-        If fread() returns 0 → set db_err_code and return NOTOK.
-    3) For each byte:
-        If byte != 0:
-            Scan each of the 8 bits:
-                If bit == 1 → compute pageNum and return it.
-    4) If no bits found, return -1.
+        If open fails → return numPgs.
+    2) Read the entries of pages 0 .. numPgs-1 that the file holds.
+    3) Return the first page whose entry ≥ needBytes, or numPgs.
 
 GLOBAL VARIABLES MODIFIED:
-    db_err_code → set to FILESYSTEM_ERROR on read failure.
+    db_err_code → set to MEM_ALLOC_ERROR when the entries cannot be buffered.
 
 ERRORS REPORTED:
-    FILESYSTEM_ERROR
+    MEM_ALLOC_ERROR
 
 BUGS:
     None known.
 
 ------------------------------------------------------------*/
 
-int FindFreeSlot(const char *relName)
+int FindFreePage(const char *relName, int numPgs, int needBytes)
 {
     char fname[RELNAME + 6];
     build_fmap_filename(relName, fname, sizeof(fname));
 
+    if (numPgs <= 0)
+        return numPgs;
+
     FILE *fp = fopen(fname, "rb");
     if (!fp)
-        return -1;   /* no fmap or cannot open => assume no known free page */
+        return numPgs;   /* no fmap or cannot open => assume no known free page */
 
-    unsigned char buf[FREEMAP_BYTES];
-    size_t n = fread(buf, 1, sizeof(buf), fp);
-    fclose(fp);
+    unsigned short *entries = malloc(MIN(numPgs, MAX_FREEMAP_PAGES) * sizeof(unsigned short));
 
-    if (n == 0)
+    if (!entries)
     {
-        db_err_code = FILESYSTEM_ERROR;
+        fclose(fp);
+        db_err_code = MEM_ALLOC_ERROR;
         return NOTOK;
     }
 
-    /* Scan for first non-zero byte */
-    for (int byteIndex = 0; byteIndex < (int)n; byteIndex++)
-    {
-        unsigned char byte = buf[byteIndex];
-        if (byte == 0)
-            continue;
+    size_t n = fread(entries, sizeof(unsigned short), MIN(numPgs, MAX_FREEMAP_PAGES), fp);
+    int pageNum = numPgs;
 
-        /* Find first 1-bit in this byte */
-        for (int bit = 0; bit < 8; bit++)
-        {
-            if (byte & (1u << bit))
-            {
-                int pageNum = byteIndex * 8 + bit;
-                if (pageNum < MAX_FREEMAP_PAGES)
-                    return pageNum;
-            }
-        }
+    fclose(fp);
+
+    for (size_t i = 0; i < n && pageNum == numPgs; i++)
+    {
+        if (entries[i] >= needBytes)
+            pageNum = (int)i;
     }
 
-    return -1;
-}
\ No newline at end of file
+    free(entries);
+    return pageNum;
+}
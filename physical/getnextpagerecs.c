@@ -0,0 +1,107 @@
+/************************INCLUDES*******************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "../include/readpage.h"
+#include "../include/defs.h"
+#include "../include/globals.h"
+#include "../include/error.h"
+#include "../include/getnextpagerecs.h"
+#include "../include/pagelayout.h"
+
+/* Records of the last page returned for every relation whose slots do not hold records as they are (PAX, encoded) */
+static char pageRecs[MAXOPEN][MAX_RECS_PER_PG * MAXRECORD];
+
+
+/*--------------------------------------------------------------
+
+FUNCTION GetNextPageRecs (relNum, pid, rids, recs, numRecs)
+
+PARAMETER DESCRIPTION:
+    relNum   → relation number (index in catcache[]).
+    pid      → (IN/OUT) page at which the scan continues; 0 starts a scan. On return, the page after the one returned.
+    rids     → (OUT, may be NULL) array of MAX_RECS_PER_PG Rids receiving the Rid of every live record of the page.
+    recs     → (OUT, may be NULL) array of MAX_RECS_PER_PG pointers receiving the address of every live record in the page buffer.
+    numRecs  → (OUT) number of records returned; 0 once the relation is exhausted.
+
+FUNCTION DESCRIPTION:
+    Page-at-a-time counterpart of GetNextRec().
+    Reads pages from *pid on until one has a live record, and returns all of its records in slot order with one call:
+    the occupied slots are enumerated from the slotmap with count-trailing-zeros, so empty slots and empty pages cost nothing per slot.
+    Records of a row page are not copied: recs[i] points into buffer[relNum].page.  Those of a PAX page, or of a
+    relation with dictionary-encoded attributes, are assembled once per call into a per-relation area, and recs[i] points there.
+
+RETURNS:
+    OK     → success (a page was returned OR the scan is exhausted, *numRecs = 0).
+    NOTOK  → an error occurred (db_err_code set).
+
+ALGORITHM:
+    1) *numRecs = 0.
+    2) While *pid < numPgs:
+        a) ReadPage(relNum, *pid); if NOTOK → return NOTOK.
+        b) Load slotmap and advance *pid.
+        c) For every set bit of slotmap, lowest first: fill rids[n] and recs[n], n++.
+        d) If n > 0: *numRecs = n, return OK.
+    3) No more records: return OK.
+
+BUGS:
+    None found.
+
+GLOBAL VARIABLES MODIFIED:
+    None.
+
+ERRORS REPORTED:
+    None directly (ReadPage() errors are propagated).
+
+IMPLEMENTATION NOTES:
+    - The pointers stay valid until the next page of relNum is read (or, for records assembled by the call, until the next call): by the next call, or by any other routine
+      that reads relNum (GetNextRec(), FindRec(), InsertRec(), ...). Callers that interleave such calls must copy the records first.
+
+--------------------------------------------------------------*/
+
+int GetNextPageRecs(int relNum, short *pid, Rid *rids, char **recs, int *numRecs)
+{
+    int numPgs = catcache[relNum].relcat_rec.numPgs;
+    int recSize = catcache[relNum].relcat_rec.recLength;
+    bool inPlace = PageRecsInPlace(&catcache[relNum]);
+    char *page = buffer[relNum].page;
+
+    *numRecs = 0;
+
+    while(*pid < numPgs)
+    {
+        short cur = *pid;
+
+        if(ReadPage(relNum, cur) == NOTOK)
+        return NOTOK;
+
+        unsigned long slotmap;
+        memcpy(&slotmap, page+MAGIC_SIZE, sizeof(slotmap));
+        (*pid)++;
+
+        int n = 0;
+
+        for(; slotmap; slotmap &= slotmap - 1, n++)
+        {
+            short slot = __builtin_ctzl(slotmap);
+
+            if(rids)
+                rids[n] = (Rid){cur, slot};
+            if(recs && !inPlace)
+            {
+                recs[n] = pageRecs[relNum] + recSize * n;
+                PageGetRec(&catcache[relNum], page, slot, recs[n]);
+            }
+            else if(recs)
+                recs[n] = page+HEADER_SIZE+recSize*slot;
+        }
+
+        if(n)
+        {
+            *numRecs = n;
+            return OK;
+        }
+    }
+
+    return OK;
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <string.h>
 #include "../include/readpage.h"
 #include "../include/defs.h"
+#include "../include/pagelayout.h"
 #include "../include/globals.h"
 #include "../include/error.h"
 #include "../include/helpers.h"
@@ -39,8 +40,7 @@ RETURNS:
 ALGORITHM:
     1) Compute the next RID: rid = IncRid(startRid, recsPerPg).
     2) Initialize foundRid = { -1, -1 }.
-    3) Zero-out recPtr to remove stale data.
-    4) While rid.pid < numPgs:
+    3) While rid.pid < numPgs:
         a) Read the page using ReadPage().
             If NOTOK → return NOTOK.
         b) Load slotmap.
@@ -49,7 +49,7 @@ ALGORITHM:
             - set *foundRid = rid,
             - return OK.
         d) Otherwise increment rid = IncRid(rid, recsPerPg).
-    5) No more records: return OK.
+    4) No more records: return OK.
 
 BUGS:
     None found.
@@ -60,6 +60,9 @@ GLOBAL VARIABLES MODIFIED:
 ERRORS REPORTED:
     None directly.
 
+IMPLEMENTATION NOTES:
+    - recPtr is only written when a record is found; callers must test foundRid before using it.
+
 --------------------------------------------------------------*/
 
 int GetNextRec(int relNum, Rid startRid, Rid *foundRid, void *recPtr)
@@ -67,12 +70,10 @@ int GetNextRec(int relNum, Rid startRid, Rid *foundRid, void *recPtr)
     int numPgs = catcache[relNum].relcat_rec.numPgs;
     int numRecs = catcache[relNum].relcat_rec.numRecs;
     int recsPerPg = catcache[relNum].relcat_rec.recsPerPg;
-    int recSize = catcache[relNum].relcat_rec.recLength;
     char *page = buffer[relNum].page;
     
     Rid rid = IncRid(startRid, recsPerPg);
     *foundRid = (Rid){-1, -1};
-    memset(recPtr, 0, recSize);
 
     while(rid.pid < numPgs)
     {
@@ -85,7 +86,7 @@ int GetNextRec(int relNum, Rid startRid, Rid *foundRid, void *recPtr)
         if(slotmap & (1UL << rid.slotnum))
         {
             *foundRid = rid;
-            memcpy(recPtr, page+HEADER_SIZE+recSize*rid.slotnum, recSize);
+            PageGetRec(&catcache[relNum], page, rid.slotnum, recPtr);
             return OK;
         }
 
@@ -0,0 +1,58 @@
+/************************INCLUDES*******************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "../include/readpage.h"
+#include "../include/defs.h"
+#include "../include/pagelayout.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+
+
+/*--------------------------------------------------------------
+
+FUNCTION GetRec (relNum, rid, recPtr)
+
+PARAMETER DESCRIPTION:
+    relNum → relation number (index in catcache[]).
+    rid    → Rid of the record to fetch, typically obtained from an index.
+    recPtr → buffer receiving a copy of the record.
+
+FUNCTION DESCRIPTION:
+    Random-access counterpart of GetNextRec(): reads the page holding rid and copies the record out if its slot is occupied.
+    Index lookups use it to visit only the heap pages that hold matching records.
+
+RETURNS:
+    1      → record copied into recPtr.
+    0      → rid is out of range or its slot is empty (stale index entry).
+    NOTOK  → the page could not be read (db_err_code set).
+
+GLOBAL VARIABLES MODIFIED:
+    None.
+
+ERRORS REPORTED:
+    None directly (ReadPage() errors are propagated).
+
+--------------------------------------------------------------*/
+
+int GetRec(int relNum, Rid rid, void *recPtr)
+{
+    int numPgs = catcache[relNum].relcat_rec.numPgs;
+    int recsPerPg = catcache[relNum].relcat_rec.recsPerPg;
+    char *page = buffer[relNum].page;
+
+    if(rid.pid < 0 || rid.pid >= numPgs || rid.slotnum < 0 || rid.slotnum >= recsPerPg)
+        return 0;
+
+    if(ReadPage(relNum, rid.pid) == NOTOK)
+        return NOTOK;
+
+    unsigned long slotmap;
+    memcpy(&slotmap, page+MAGIC_SIZE, sizeof(slotmap));
+
+    if(!(slotmap & (1UL << rid.slotnum)))
+        return 0;
+
+    PageGetRec(&catcache[relNum], page, rid.slotnum, recPtr);
+    return 1;
+}
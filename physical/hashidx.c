@@ -0,0 +1,883 @@
+/************************INCLUDES*******************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/helpers.h"
+#include "../include/getnextrec.h"
+#include "../include/hashidx.h"
+
+/*
+ * Extendible hashing.
+ *
+ * "<rel>.<attr>.hdir" is an array of 2^globalDepth ints, slot i holding the bucket page for hash
+ * values whose low globalDepth bits equal i.  A lookup therefore costs one 4-byte directory read
+ * and one bucket page read (plus overflow pages for heavily duplicated keys).
+ *
+ * Bucket page layout (PAGESIZE bytes):
+ *   bytes 0-7   : HASH_BUCKET_MAGIC + GEN_MAGIC
+ *   bytes 8-9   : number of entries (short)
+ *   bytes 10-11 : local depth (short)
+ *   bytes 12-15 : next overflow page, -1 at the end of the chain
+ *   bytes 16-   : entries key[keyLen] Rid
+ *
+ * A full bucket is split on bit localDepth; only when localDepth reaches globalDepth is the
+ * directory doubled, by appending a copy of itself.  Buckets whose entries all share one hash value
+ * (duplicates of one key) cannot be separated by splitting and grow an overflow chain instead.
+ */
+
+#define HB_NUM_OFF      MAGIC_SIZE
+#define HB_DEPTH_OFF    (MAGIC_SIZE + 2)
+#define HB_NEXT_OFF     (MAGIC_SIZE + 4)
+
+typedef struct hashfile
+{
+    int fd;             /* bucket file */
+    int dfd;            /* directory file */
+    HashHeader hdr;
+    int entSize;        /* bytes per entry */
+    int cap;            /* entries per page */
+} HashFile;
+
+
+/*------------------------------------------------------------
+
+FUNCTION hashKey (ht, key)
+
+FUNCTION DESCRIPTION:
+    Hashes a key of the indexed attribute.
+    Integers and dates go through the murmur3 finalizer (8-byte ints folded to 32 bits first); strings use FNV-1a up to the first NUL, matching the strncmp() equality used elsewhere.
+
+------------------------------------------------------------*/
+
+static unsigned int hashKey(HashFile *ht, const char *key)
+{
+    if(ht->hdr.type == 'i' || ht->hdr.type == 'd')
+    {
+        unsigned long long x = getIntValue(key, ht->hdr.keyLen);
+        unsigned int h = (unsigned int)(ht->hdr.keyLen == 8 ? x ^ (x >> 32) : x);
+
+        h ^= h >> 16;
+        h *= 0x85ebca6bU;
+        h ^= h >> 13;
+        h *= 0xc2b2ae35U;
+        h ^= h >> 16;
+        return h;
+    }
+
+    unsigned int h = 2166136261U;
+    for(int i = 0; i < ht->hdr.keyLen && key[i]; i++)
+    {
+        h ^= (unsigned char)key[i];
+        h *= 16777619U;
+    }
+    return h;
+}
+
+static int keyEqual(HashFile *ht, const char *a, const char *b)
+{
+    if(ht->hdr.type == 'i' || ht->hdr.type == 'd')
+        return memcmp(a, b, ht->hdr.keyLen) == 0;
+    return strncmp(a, b, ht->hdr.keyLen) == 0;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION page and directory accessors
+
+FUNCTION DESCRIPTION:
+    Thin lseek()+read()/write() wrappers over the bucket file and the directory file.
+
+ERRORS REPORTED:
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+static int hashReadPage(HashFile *ht, int pno, char *page)
+{
+    if(lseek(ht->fd, (off_t)pno * PAGESIZE, SEEK_SET) < 0 ||
+       read(ht->fd, page, PAGESIZE) != PAGESIZE)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+    return OK;
+}
+
+static int hashWritePage(HashFile *ht, int pno, const char *page)
+{
+    if(lseek(ht->fd, (off_t)pno * PAGESIZE, SEEK_SET) < 0 ||
+       write(ht->fd, page, PAGESIZE) != PAGESIZE)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+    return OK;
+}
+
+static int dirRead(HashFile *ht, unsigned int slot, int *pno)
+{
+    if(lseek(ht->dfd, (off_t)slot * sizeof(int), SEEK_SET) < 0 ||
+       read(ht->dfd, pno, sizeof(int)) != sizeof(int))
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+    return OK;
+}
+
+static short pgNum(const char *page)       { short n; memcpy(&n, page + HB_NUM_OFF, sizeof(short)); return n; }
+static void  pgSetNum(char *page, short n) { memcpy(page + HB_NUM_OFF, &n, sizeof(short)); }
+static short pgDepth(const char *page)     { short d; memcpy(&d, page + HB_DEPTH_OFF, sizeof(short)); return d; }
+static int   pgNext(const char *page)      { int n; memcpy(&n, page + HB_NEXT_OFF, sizeof(int)); return n; }
+static void  pgSetNext(char *page, int n)  { memcpy(page + HB_NEXT_OFF, &n, sizeof(int)); }
+
+static void initBucket(char *page, short depth)
+{
+    int next = -1;
+
+    memset(page, 0, PAGESIZE);
+    page[0] = HASH_BUCKET_MAGIC;
+    strncpy(page + 1, GEN_MAGIC, MAGIC_SIZE - 1);
+    memcpy(page + HB_DEPTH_OFF, &depth, sizeof(short));
+    memcpy(page + HB_NEXT_OFF, &next, sizeof(int));
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION hashOpen (fname, dname, ht) / hashClose (ht)
+
+FUNCTION DESCRIPTION:
+    hashOpen() opens both files and validates the header page.
+    hashClose() rewrites the header (counters may have changed) and closes both files.
+
+ERRORS REPORTED:
+    FILE_NO_EXIST
+    PAGE_MAGIC_ERROR
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+static int hashOpen(const char *fname, const char *dname, HashFile *ht)
+{
+    char page[PAGESIZE];
+
+    ht->fd = open(fname, O_RDWR);
+    ht->dfd = open(dname, O_RDWR);
+    if(ht->fd < 0 || ht->dfd < 0)
+    {
+        if(ht->fd >= 0) close(ht->fd);
+        if(ht->dfd >= 0) close(ht->dfd);
+        db_err_code = FILE_NO_EXIST;
+        return NOTOK;
+    }
+
+    if(hashReadPage(ht, 0, page) == NOTOK)
+    {
+        close(ht->fd);
+        close(ht->dfd);
+        return NOTOK;
+    }
+
+    memcpy(&ht->hdr, page, sizeof(HashHeader));
+    if(ht->hdr.magic[0] != HASH_HDR_MAGIC || strncmp(ht->hdr.magic + 1, GEN_MAGIC, MAGIC_SIZE - 1))
+    {
+        close(ht->fd);
+        close(ht->dfd);
+        db_err_code = PAGE_MAGIC_ERROR;
+        return NOTOK;
+    }
+
+    ht->entSize = ht->hdr.keyLen + sizeof(Rid);
+    ht->cap = (PAGESIZE - HEADER_SIZE) / ht->entSize;
+    return OK;
+}
+
+static int hashClose(HashFile *ht, int writeHeader)
+{
+    int rc = OK;
+
+    if(writeHeader)
+    {
+        char page[PAGESIZE];
+        memset(page, 0, PAGESIZE);
+        memcpy(page, &ht->hdr, sizeof(HashHeader));
+        rc = hashWritePage(ht, 0, page);
+    }
+
+    close(ht->fd);
+    close(ht->dfd);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION writeChain (ht, head, ents, n, depth)
+
+PARAMETER DESCRIPTION:
+    ht    → open hash index.
+    head  → first page of the chain to (re)fill.
+    ents  → entries to store.
+    n     → number of entries.
+    depth → local depth stamped on every page of the chain.
+
+FUNCTION DESCRIPTION:
+    Lays ents out over the chain starting at head, reusing its existing overflow pages and appending new ones when the chain is too short.
+    Chain pages left over at the end are emptied but stay linked, so they are reused by later inserts.
+
+------------------------------------------------------------*/
+
+static int writeChain(HashFile *ht, int head, const char *ents, int n, short depth)
+{
+    char page[PAGESIZE];
+    int pno = head, done = 0;
+
+    while(pno != -1)
+    {
+        if(hashReadPage(ht, pno, page) == NOTOK)
+            return NOTOK;
+
+        int next = pgNext(page);
+        int take = MIN(ht->cap, n - done);
+
+        initBucket(page, depth);
+        memcpy(page + HEADER_SIZE, ents + (size_t)done * ht->entSize, (size_t)take * ht->entSize);
+        pgSetNum(page, take);
+        done += take;
+
+        if(next == -1 && done < n)
+        {
+            next = ht->hdr.numPages++;
+
+            char fresh[PAGESIZE];
+            initBucket(fresh, depth);
+            if(hashWritePage(ht, next, fresh) == NOTOK)
+                return NOTOK;
+        }
+
+        pgSetNext(page, next);
+        if(hashWritePage(ht, pno, page) == NOTOK)
+            return NOTOK;
+
+        pno = next;
+    }
+
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION splitBucket (ht, slot, head)
+
+PARAMETER DESCRIPTION:
+    ht   → open hash index.
+    slot → directory slot that led to the full bucket.
+    head → first page of the full bucket.
+
+FUNCTION DESCRIPTION:
+    Splits one bucket on bit localDepth.
+
+ALGORITHM:
+    1) Gather every entry of the bucket chain.
+    2) If localDepth == globalDepth, double the directory by appending a copy of it.
+    3) Allocate a new bucket; entries whose hash has bit localDepth set move there, the rest are rewritten into the old chain.
+    4) Redirect the directory slots that share the old bucket's low localDepth bits and have bit localDepth set.
+
+ERRORS REPORTED:
+    MEM_ALLOC_ERROR
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+static int splitBucket(HashFile *ht, unsigned int slot, int head)
+{
+    char page[PAGESIZE];
+    char *ents = NULL, *lo = NULL, *hi = NULL;
+    int *dir = NULL;
+    int n = 0, cap = 0, rc = NOTOK;
+    short depth = 0;
+
+    /* -------- 1. Gather the chain -------- */
+    for(int pno = head; pno != -1; pno = pgNext(page))
+    {
+        if(hashReadPage(ht, pno, page) == NOTOK)
+            goto done;
+
+        if(pno == head)
+            depth = pgDepth(page);
+
+        int k = pgNum(page);
+        if(n + k > cap)
+        {
+            cap = 2 * (n + k);
+            char *grown = realloc(ents, (size_t)cap * ht->entSize);
+            if(!grown)
+            {
+                db_err_code = MEM_ALLOC_ERROR;
+                goto done;
+            }
+            ents = grown;
+        }
+
+        memcpy(ents + (size_t)n * ht->entSize, page + HEADER_SIZE, (size_t)k * ht->entSize);
+        n += k;
+    }
+
+    /* -------- 2. Directory doubling -------- */
+    int dirSize = 1 << ht->hdr.globalDepth;
+    int doubling = (depth == ht->hdr.globalDepth);
+
+    dir = malloc((size_t)(doubling ? 2 * dirSize : dirSize) * sizeof(int));
+    lo = malloc((size_t)(n ? n : 1) * ht->entSize);
+    hi = malloc((size_t)(n ? n : 1) * ht->entSize);
+    if(!dir || !lo || !hi)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        goto done;
+    }
+
+    if(lseek(ht->dfd, 0, SEEK_SET) < 0 ||
+       read(ht->dfd, dir, dirSize * sizeof(int)) != (ssize_t)(dirSize * sizeof(int)))
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        goto done;
+    }
+
+    if(doubling)
+    {
+        memcpy(dir + dirSize, dir, dirSize * sizeof(int));
+        dirSize *= 2;
+        ht->hdr.globalDepth++;
+    }
+
+    /* -------- 3. Redistribute -------- */
+    int nLo = 0, nHi = 0;
+    unsigned int bit = 1U << depth;
+
+    for(int i = 0; i < n; i++)
+    {
+        const char *e = ents + (size_t)i * ht->entSize;
+
+        if(hashKey(ht, e) & bit)
+            memcpy(hi + (size_t)nHi++ * ht->entSize, e, ht->entSize);
+        else
+            memcpy(lo + (size_t)nLo++ * ht->entSize, e, ht->entSize);
+    }
+
+    int newHead = ht->hdr.numPages++;
+    ht->hdr.numBuckets++;
+
+    initBucket(page, depth + 1);
+    if(hashWritePage(ht, newHead, page) == NOTOK)
+        goto done;
+
+    if(writeChain(ht, head, lo, nLo, depth + 1) == NOTOK ||
+       writeChain(ht, newHead, hi, nHi, depth + 1) == NOTOK)
+        goto done;
+
+    /* -------- 4. Redirect directory slots -------- */
+    unsigned int low = slot & (bit - 1);
+
+    for(int i = 0; i < dirSize; i++)
+    {
+        if(((unsigned int)i & (bit - 1)) == low && ((unsigned int)i & bit))
+            dir[i] = newHead;
+    }
+
+    if(lseek(ht->dfd, 0, SEEK_SET) < 0 ||
+       write(ht->dfd, dir, dirSize * sizeof(int)) != (ssize_t)(dirSize * sizeof(int)))
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        goto done;
+    }
+
+    rc = OK;
+
+done:
+    free(ents);
+    free(lo);
+    free(hi);
+    free(dir);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION hashInsertEntry (ht, ent)
+
+PARAMETER DESCRIPTION:
+    ht  → open hash index.
+    ent → entry key[keyLen] Rid to insert.
+
+FUNCTION DESCRIPTION:
+    Inserts one entry, splitting or chaining as needed.
+
+ALGORITHM:
+    1) Locate the bucket through the directory.
+    2) Walk its chain: return if the entry is already present, note whether the key is already present, and remember the first page with room.
+    3) If a page has room, store the entry there.
+    4) Otherwise, if some entry hashes differently from the new one and the local depth is below HASH_MAX_DEPTH, split the bucket and retry.
+    5) Otherwise append an overflow page to the chain.
+
+------------------------------------------------------------*/
+
+static int hashInsertEntry(HashFile *ht, const char *ent)
+{
+    char page[PAGESIZE];
+    unsigned int h = hashKey(ht, ent);
+
+    for(;;)
+    {
+        unsigned int slot = h & ((1U << ht->hdr.globalDepth) - 1);
+        int head, freePno = -1, lastPno = -1, keySeen = 0, separable = 0;
+        short depth = 0;
+
+        if(dirRead(ht, slot, &head) == NOTOK)
+            return NOTOK;
+
+        for(int pno = head; pno != -1; pno = pgNext(page))
+        {
+            if(hashReadPage(ht, pno, page) == NOTOK)
+                return NOTOK;
+
+            if(pno == head)
+                depth = pgDepth(page);
+
+            int n = pgNum(page);
+            for(int i = 0; i < n; i++)
+            {
+                const char *e = page + HEADER_SIZE + i * ht->entSize;
+
+                if(keyEqual(ht, e, ent))
+                {
+                    if(memcmp(e + ht->hdr.keyLen, ent + ht->hdr.keyLen, sizeof(Rid)) == 0)
+                        return OK;
+                    keySeen = 1;
+                }
+                else if(hashKey(ht, e) != h)
+                    separable = 1;
+            }
+
+            if(n < ht->cap && freePno == -1)
+                freePno = pno;
+            lastPno = pno;
+        }
+
+        if(freePno != -1)
+        {
+            if(!keySeen)
+                ht->hdr.numKeys++;
+
+            if(hashReadPage(ht, freePno, page) == NOTOK)
+                return NOTOK;
+
+            int n = pgNum(page);
+            memcpy(page + HEADER_SIZE + n * ht->entSize, ent, ht->entSize);
+            pgSetNum(page, n + 1);
+            return hashWritePage(ht, freePno, page);
+        }
+
+        if(separable && depth < HASH_MAX_DEPTH)
+        {
+            if(splitBucket(ht, slot, head) == NOTOK)
+                return NOTOK;
+            continue;
+        }
+
+        /* Chain an overflow page */
+        if(!keySeen)
+            ht->hdr.numKeys++;
+
+        char fresh[PAGESIZE];
+        int newPno = ht->hdr.numPages++;
+
+        initBucket(fresh, depth);
+        memcpy(fresh + HEADER_SIZE, ent, ht->entSize);
+        pgSetNum(fresh, 1);
+        if(hashWritePage(ht, newPno, fresh) == NOTOK)
+            return NOTOK;
+
+        if(hashReadPage(ht, lastPno, page) == NOTOK)
+            return NOTOK;
+        pgSetNext(page, newPno);
+        return hashWritePage(ht, lastPno, page);
+    }
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION HashInsert (fname, dname, key, rid)
+
+PARAMETER DESCRIPTION:
+    fname → bucket file "<rel>.<attr>.hash".
+    dname → directory file "<rel>.<attr>.hdir".
+    key   → attribute value of the new record.
+    rid   → Rid of the new record.
+
+FUNCTION DESCRIPTION:
+    Adds (key, rid) to an extendible hash index.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+------------------------------------------------------------*/
+
+int HashInsert(const char *fname, const char *dname, void *key, Rid rid)
+{
+    HashFile ht;
+    char ent[PAGESIZE];
+
+    if(hashOpen(fname, dname, &ht) == NOTOK)
+        return NOTOK;
+
+    memcpy(ent, key, ht.hdr.keyLen);
+    memcpy(ent + ht.hdr.keyLen, &rid, sizeof(Rid));
+
+    int rc = hashInsertEntry(&ht, ent);
+    if(hashClose(&ht, 1) == NOTOK)
+        rc = NOTOK;
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION HashDelete (fname, dname, key, rid)
+
+PARAMETER DESCRIPTION:
+    fname, dname → index files.
+    key          → attribute value of the record being deleted.
+    rid          → Rid of the record being deleted.
+
+FUNCTION DESCRIPTION:
+    Removes (key, rid) from the bucket chain of key, filling the hole with the last entry of the same page.
+    Buckets are never merged and the directory never shrinks.
+
+RETURNS:
+    OK (also when the entry is absent) or NOTOK (db_err_code set).
+
+------------------------------------------------------------*/
+
+int HashDelete(const char *fname, const char *dname, void *key, Rid rid)
+{
+    HashFile ht;
+    char page[PAGESIZE];
+    int head, removed = 0, keyLeft = 0, rc = OK;
+
+    if(hashOpen(fname, dname, &ht) == NOTOK)
+        return NOTOK;
+
+    unsigned int h = hashKey(&ht, key);
+
+    if(dirRead(&ht, h & ((1U << ht.hdr.globalDepth) - 1), &head) == NOTOK)
+    {
+        hashClose(&ht, 0);
+        return NOTOK;
+    }
+
+    for(int pno = head; pno != -1; pno = pgNext(page))
+    {
+        if((rc = hashReadPage(&ht, pno, page)) == NOTOK)
+            break;
+
+        int n = pgNum(page);
+        for(int i = 0; i < n; i++)
+        {
+            char *e = page + HEADER_SIZE + i * ht.entSize;
+
+            if(!keyEqual(&ht, e, key))
+                continue;
+
+            if(!removed && memcmp(e + ht.hdr.keyLen, &rid, sizeof(Rid)) == 0)
+            {
+                memmove(e, page + HEADER_SIZE + (n - 1) * ht.entSize, ht.entSize);
+                pgSetNum(page, --n);
+                if((rc = hashWritePage(&ht, pno, page)) == NOTOK)
+                    break;
+                removed = 1;
+                i--;
+                continue;
+            }
+
+            keyLeft = 1;
+        }
+
+        if(rc == NOTOK)
+            break;
+    }
+
+    if(removed && !keyLeft)
+        ht.hdr.numKeys--;
+
+    if(hashClose(&ht, removed) == NOTOK)
+        rc = NOTOK;
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION HashLookup (fname, dname, key, rids, numRids)
+
+PARAMETER DESCRIPTION:
+    fname, dname → index files.
+    key          → value being probed with '='.
+    rids         → (OUT) malloc'd array of matching Rids; the caller frees it.
+    numRids      → (OUT) number of Rids returned.
+
+FUNCTION DESCRIPTION:
+    Returns the Rids of every record whose attribute equals key.
+    Costs one directory read plus the pages of a single bucket chain.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+ERRORS REPORTED:
+    MEM_ALLOC_ERROR
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+int HashLookup(const char *fname, const char *dname, void *key, Rid **rids, int *numRids)
+{
+    HashFile ht;
+    char page[PAGESIZE];
+    int head, cap = 16, rc = OK;
+
+    *rids = NULL;
+    *numRids = 0;
+
+    if(hashOpen(fname, dname, &ht) == NOTOK)
+        return NOTOK;
+
+    if(dirRead(&ht, hashKey(&ht, key) & ((1U << ht.hdr.globalDepth) - 1), &head) == NOTOK)
+    {
+        hashClose(&ht, 0);
+        return NOTOK;
+    }
+
+    *rids = malloc(cap * sizeof(Rid));
+    if(!*rids)
+    {
+        hashClose(&ht, 0);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    for(int pno = head; pno != -1 && rc == OK; pno = pgNext(page))
+    {
+        if((rc = hashReadPage(&ht, pno, page)) == NOTOK)
+            break;
+
+        int n = pgNum(page);
+        for(int i = 0; i < n; i++)
+        {
+            const char *e = page + HEADER_SIZE + i * ht.entSize;
+
+            if(!keyEqual(&ht, e, key))
+                continue;
+
+            if(*numRids == cap)
+            {
+                cap *= 2;
+                Rid *grown = realloc(*rids, cap * sizeof(Rid));
+                if(!grown)
+                {
+                    db_err_code = MEM_ALLOC_ERROR;
+                    rc = NOTOK;
+                    break;
+                }
+                *rids = grown;
+            }
+
+            memcpy(&(*rids)[(*numRids)++], e + ht.hdr.keyLen, sizeof(Rid));
+        }
+    }
+
+    hashClose(&ht, 0);
+
+    if(rc == NOTOK)
+    {
+        free(*rids);
+        *rids = NULL;
+        *numRids = 0;
+    }
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION HashGetStats (fname, dname, stats)
+
+PARAMETER DESCRIPTION:
+    fname, dname → index files.
+    stats        → (OUT) directory and overflow-chain statistics.
+
+FUNCTION DESCRIPTION:
+    Reports the directory depth, the number of primary and overflow pages and the longest bucket chain.
+    Each distinct bucket is visited once by walking the directory slots below 2^localDepth that point to it.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+------------------------------------------------------------*/
+
+int HashGetStats(const char *fname, const char *dname, HashStats *stats)
+{
+    HashFile ht;
+    char page[PAGESIZE];
+
+    if(hashOpen(fname, dname, &ht) == NOTOK)
+        return NOTOK;
+
+    stats->globalDepth = ht.hdr.globalDepth;
+    stats->numBuckets = ht.hdr.numBuckets;
+    stats->numPages = ht.hdr.numPages;
+    stats->numOverflow = ht.hdr.numPages - 1 - ht.hdr.numBuckets;
+    stats->numKeys = ht.hdr.numKeys;
+    stats->longestChain = 0;
+
+    for(unsigned int slot = 0; slot < (1U << ht.hdr.globalDepth); slot++)
+    {
+        int head, len = 0;
+
+        if(dirRead(&ht, slot, &head) == NOTOK || hashReadPage(&ht, head, page) == NOTOK)
+        {
+            hashClose(&ht, 0);
+            return NOTOK;
+        }
+
+        /* Only the lowest slot of each bucket visits it */
+        if(slot >= (1U << pgDepth(page)))
+            continue;
+
+        for(int pno = head; pno != -1; pno = pgNext(page))
+        {
+            if(pno != head && hashReadPage(&ht, pno, page) == NOTOK)
+            {
+                hashClose(&ht, 0);
+                return NOTOK;
+            }
+            len++;
+        }
+
+        stats->longestChain = MAX(stats->longestChain, len);
+    }
+
+    hashClose(&ht, 0);
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION HashBuild (fname, dname, relNum, attr, nPages, nKeys)
+
+PARAMETER DESCRIPTION:
+    fname, dname → index files to create (truncated if they exist).
+    relNum       → open relation being indexed.
+    attr         → attrcat record of the indexed attribute ('i' or 's').
+    nPages       → (OUT) pages of the bucket file.
+    nKeys        → (OUT) distinct keys indexed.
+
+FUNCTION DESCRIPTION:
+    Creates an empty index of global depth 0 (one bucket) and inserts every record of the relation in one sequential pass.
+    Each insert is O(1) expected page accesses, so no sort is needed.
+
+RETURNS:
+    OK or NOTOK (db_err_code set); on failure both files are removed.
+
+ERRORS REPORTED:
+    FILESYSTEM_ERROR
+    MEM_ALLOC_ERROR
+
+------------------------------------------------------------*/
+
+int HashBuild(const char *fname, const char *dname, int relNum, AttrCatRec *attr, int *nPages, int *nKeys)
+{
+    HashFile ht;
+    char page[PAGESIZE], ent[PAGESIZE];
+    int recSize = catcache[relNum].relcat_rec.recLength;
+    char *rec = malloc(recSize);
+    int rc = NOTOK;
+
+    if(!rec)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    memset(&ht, 0, sizeof(HashFile));
+    ht.hdr.magic[0] = HASH_HDR_MAGIC;
+    strncpy(ht.hdr.magic + 1, GEN_MAGIC, MAGIC_SIZE - 1);
+    ht.hdr.globalDepth = 0;
+    ht.hdr.numPages = 2;
+    ht.hdr.numBuckets = 1;
+    ht.hdr.keyLen = attr->length;
+    ht.hdr.type = attr->type[0];
+    ht.entSize = ht.hdr.keyLen + sizeof(Rid);
+    ht.cap = (PAGESIZE - HEADER_SIZE) / ht.entSize;
+
+    ht.fd = open(fname, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    ht.dfd = open(dname, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(ht.fd < 0 || ht.dfd < 0)
+    {
+        if(ht.fd >= 0) close(ht.fd);
+        if(ht.dfd >= 0) close(ht.dfd);
+        free(rec);
+        db_err_code = FILESYSTEM_ERROR;
+        goto cleanup;
+    }
+
+    int first = 1;
+    initBucket(page, 0);
+    if(hashWritePage(&ht, first, page) == NOTOK || write(ht.dfd, &first, sizeof(int)) != sizeof(int))
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        goto done;
+    }
+
+    Rid rid = INVALID_RID;
+    for(;;)
+    {
+        if(GetNextRec(relNum, rid, &rid, rec) == NOTOK)
+            goto done;
+        if(!isValidRid(rid))
+            break;
+
+        memcpy(ent, rec + attr->offset, ht.hdr.keyLen);
+        memcpy(ent + ht.hdr.keyLen, &rid, sizeof(Rid));
+
+        if(hashInsertEntry(&ht, ent) == NOTOK)
+            goto done;
+    }
+
+    *nPages = ht.hdr.numPages;
+    *nKeys = ht.hdr.numKeys;
+    rc = OK;
+
+done:
+    if(hashClose(&ht, 1) == NOTOK)
+        rc = NOTOK;
+    free(rec);
+
+cleanup:
+    if(rc == NOTOK)
+    {
+        remove(fname);
+        remove(dname);
+    }
+    return rc;
+}
\ No newline at end of file
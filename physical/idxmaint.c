@@ -0,0 +1,406 @@
+/************************INCLUDES*******************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/btree.h"
+#include "../include/hashidx.h"
+#include "../include/bitmapidx.h"
+#include "../include/bloom.h"
+#include "../include/idxmaint.h"
+
+
+/*------------------------------------------------------------
+
+FUNCTION build_idx_filename (relName, attrName, ext, fname, buflen)
+
+PARAMETER DESCRIPTION:
+    relName  → name of the indexed relation.
+    attrName → name of the indexed attribute.
+    ext      → extension identifying the index kind (e.g. "idx").
+    fname    → output buffer receiving "<relName>.<attrName>.<ext>".
+    buflen   → size of the output buffer.
+
+FUNCTION DESCRIPTION:
+    Constructs the name of an index file.
+    Like the freemap, index files live next to the heap file in the database directory.
+
+IMPLEMENTATION NOTES:
+    - Caller must provide a buffer of at least RELNAME + ATTRNAME + 8 bytes.
+
+------------------------------------------------------------*/
+
+void build_idx_filename(const char *relName, const char *attrName, const char *ext, char *fname, size_t buflen)
+{
+    snprintf(fname, buflen, "%s.%s.%s", relName, attrName, ext);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION InsertIndexEntries (relNum, recPtr, rid)
+
+PARAMETER DESCRIPTION:
+    relNum → open relation the record was inserted into.
+    recPtr → the inserted record.
+    rid    → Rid at which InsertRec() placed the record.
+
+FUNCTION DESCRIPTION:
+    Keeps every index of the relation in step with InsertRec().
+    For each attribute, (value, rid) is added to its B+-tree (IDX_BTREE), extendible hash (IDX_HASH), bitmap index (IDX_BITMAP) and/or Bloom filter (IDX_BLOOM).
+    The record's fingerprint is added to the relation's "<rel>.rbloom" filter, if it has one.
+
+RETURNS:
+    OK or NOTOK (db_err_code set by the index routine).
+
+GLOBAL VARIABLES MODIFIED:
+    None.
+
+IMPLEMENTATION NOTES:
+    - Catalog relations are never indexed and are skipped outright.
+    - An attribute flagged in attrcat whose index file is missing (flag set by an older build that created no file) is skipped.
+
+------------------------------------------------------------*/
+
+int InsertIndexEntries(int relNum, void *recPtr, Rid rid)
+{
+    if(relNum < NUM_CATS)
+        return OK;
+
+    const char *relName = catcache[relNum].relcat_rec.relName;
+
+    char fname[RELNAME + ATTRNAME + 8], dname[RELNAME + ATTRNAME + 8];
+
+    for(AttrDesc *a = catcache[relNum].attrList; a; a = a->next)
+    {
+        void *key = (char *)recPtr + a->attr.offset;
+
+        if(a->attr.hasIndex & IDX_BTREE)
+        {
+            build_idx_filename(relName, a->attr.attrName, "idx", fname, sizeof(fname));
+            if(access(fname, F_OK) == 0 && BtInsert(fname, key, rid) == NOTOK)
+                return NOTOK;
+        }
+
+        if(a->attr.hasIndex & IDX_HASH)
+        {
+            build_idx_filename(relName, a->attr.attrName, "hash", fname, sizeof(fname));
+            build_idx_filename(relName, a->attr.attrName, "hdir", dname, sizeof(dname));
+            if(access(fname, F_OK) == 0 && HashInsert(fname, dname, key, rid) == NOTOK)
+                return NOTOK;
+        }
+
+        if(a->attr.hasIndex & IDX_BITMAP)
+        {
+            build_idx_filename(relName, a->attr.attrName, "bmap", fname, sizeof(fname));
+            if(access(fname, F_OK) == 0 && BitmapInsert(fname, key, rid) == NOTOK)
+                return NOTOK;
+        }
+
+        if(a->attr.hasIndex & IDX_BLOOM)
+        {
+            build_idx_filename(relName, a->attr.attrName, "bloom", fname, sizeof(fname));
+            if(access(fname, F_OK) == 0 &&
+               BloomAdd(fname, BloomHashValue(a->attr.type[0], a->attr.length, key)) == NOTOK)
+                return NOTOK;
+        }
+    }
+
+    build_rbloom_filename(relName, fname, sizeof(fname));
+    if(access(fname, F_OK) == 0 && BloomAdd(fname, BloomHashRecord(relNum, recPtr)) == NOTOK)
+        return NOTOK;
+
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION DeleteIndexEntries (relNum, recPtr, rid)
+
+PARAMETER DESCRIPTION:
+    relNum → open relation the record is being deleted from.
+    recPtr → image of the record being deleted.
+    rid    → Rid of the record being deleted.
+
+FUNCTION DESCRIPTION:
+    Counterpart of InsertIndexEntries() called from DeleteRec().
+    Removes (value, rid) from every index of the relation and the record's fingerprint from its "<rel>.rbloom" filter.
+
+RETURNS:
+    OK or NOTOK (db_err_code set by the index routine).
+
+------------------------------------------------------------*/
+
+int DeleteIndexEntries(int relNum, void *recPtr, Rid rid)
+{
+    if(relNum < NUM_CATS)
+        return OK;
+
+    const char *relName = catcache[relNum].relcat_rec.relName;
+
+    char fname[RELNAME + ATTRNAME + 8], dname[RELNAME + ATTRNAME + 8];
+
+    for(AttrDesc *a = catcache[relNum].attrList; a; a = a->next)
+    {
+        void *key = (char *)recPtr + a->attr.offset;
+
+        if(a->attr.hasIndex & IDX_BTREE)
+        {
+            build_idx_filename(relName, a->attr.attrName, "idx", fname, sizeof(fname));
+            if(access(fname, F_OK) == 0 && BtDelete(fname, key, rid) == NOTOK)
+                return NOTOK;
+        }
+
+        if(a->attr.hasIndex & IDX_HASH)
+        {
+            build_idx_filename(relName, a->attr.attrName, "hash", fname, sizeof(fname));
+            build_idx_filename(relName, a->attr.attrName, "hdir", dname, sizeof(dname));
+            if(access(fname, F_OK) == 0 && HashDelete(fname, dname, key, rid) == NOTOK)
+                return NOTOK;
+        }
+
+        if(a->attr.hasIndex & IDX_BITMAP)
+        {
+            build_idx_filename(relName, a->attr.attrName, "bmap", fname, sizeof(fname));
+            if(access(fname, F_OK) == 0 && BitmapDelete(fname, key, rid) == NOTOK)
+                return NOTOK;
+        }
+
+        if(a->attr.hasIndex & IDX_BLOOM)
+        {
+            build_idx_filename(relName, a->attr.attrName, "bloom", fname, sizeof(fname));
+            if(access(fname, F_OK) == 0 &&
+               BloomRemove(fname, BloomHashValue(a->attr.type[0], a->attr.length, key)) == NOTOK)
+                return NOTOK;
+        }
+    }
+
+    build_rbloom_filename(relName, fname, sizeof(fname));
+    if(access(fname, F_OK) == 0 && BloomRemove(fname, BloomHashRecord(relNum, recPtr)) == NOTOK)
+        return NOTOK;
+
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION RemoveIndexFiles (relName, attr)
+
+PARAMETER DESCRIPTION:
+    relName → relation owning the attribute.
+    attr    → attrcat record of the attribute.
+
+FUNCTION DESCRIPTION:
+    Unlinks every index file that the hasIndex bits of attr refer to.
+    Used by DropIndex() and Destroy(); a file that is already gone is not an error.
+
+RETURNS:
+    OK or NOTOK.
+
+ERRORS REPORTED:
+    FILESYSTEM_ERROR
+
+------------------------------------------------------------*/
+
+int RemoveIndexFiles(const char *relName, AttrCatRec *attr)
+{
+    static const struct { int bit; const char *ext; } files[] = {
+        { IDX_BTREE, "idx" },
+        { IDX_HASH,  "hash" },
+        { IDX_HASH,  "hdir" },
+        { IDX_BITMAP, "bmap" },
+        { IDX_BLOOM, "bloom" },
+    };
+    char fname[RELNAME + ATTRNAME + 8];
+
+    for(size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++)
+    {
+        if(!(attr->hasIndex & files[i].bit))
+            continue;
+
+        build_idx_filename(relName, attr->attrName, files[i].ext, fname, sizeof(fname));
+        if(remove(fname) != 0 && errno != ENOENT)
+        {
+            db_err_code = FILESYSTEM_ERROR;
+            return NOTOK;
+        }
+    }
+
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION IndexAnswers (attr, compOp)
+
+FUNCTION DESCRIPTION:
+    Tells which index FindRidsByIndex() would answer "attr compOp value" with, by the same rules, without reading it.
+    A Bloom filter is not counted: it answers only for the values it rules out.
+
+RETURNS:
+    IDX_HASH, IDX_BITMAP or IDX_BTREE, or 0 when the predicate needs a scan.
+
+------------------------------------------------------------*/
+
+int IndexAnswers(const AttrCatRec *attr, int compOp)
+{
+    if(compOp == CMP_EQ && (attr->hasIndex & IDX_HASH))
+        return IDX_HASH;
+    if((compOp == CMP_EQ || compOp == CMP_NE) && (attr->hasIndex & IDX_BITMAP))
+        return IDX_BITMAP;
+    if(compOp != CMP_NE && attr->type[0] != 'f' && (attr->hasIndex & IDX_BTREE))
+        return IDX_BTREE;
+    return 0;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION IndexRulesOut (relNum, attr, valuePtr, compOp)
+
+FUNCTION DESCRIPTION:
+    Tells whether the Bloom filter of the attribute proves that no record satisfies "attr compOp value", which
+    FindRidsByIndex() then answers with no candidates.  Only equality can be ruled out.
+
+RETURNS:
+    1 when ruled out, 0 otherwise (also without a filter, or when it cannot be read).
+
+------------------------------------------------------------*/
+
+int IndexRulesOut(int relNum, const AttrCatRec *attr, const void *valuePtr, int compOp)
+{
+    char fname[RELNAME + ATTRNAME + 8];
+
+    if(compOp != CMP_EQ || !(attr->hasIndex & IDX_BLOOM))
+        return 0;
+
+    build_idx_filename(catcache[relNum].relcat_rec.relName, attr->attrName, "bloom", fname, sizeof(fname));
+    return access(fname, F_OK) == 0 && BloomMayContain(fname, BloomHashValue(attr->type[0], attr->length, valuePtr)) == 0;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION FindBitmapByIndex (relNum, attr, valuePtr, compOp, bm, recsPerPg)
+
+PARAMETER DESCRIPTION:
+    relNum    → open relation being searched.
+    attr      → attrcat record of the attribute in the predicate.
+    valuePtr  → typed literal of the predicate.
+    compOp    → comparison operator of the predicate.
+    bm        → (OUT) bitmap of the matching record positions; the caller frees it with WahFree().
+    recsPerPg → (OUT) slots per heap page, for WahToRids().
+
+FUNCTION DESCRIPTION:
+    Answers "attr = value" or "attr != value" from the bitmap index of the attribute (BitmapLookup()), as a bitmap
+    that can still be combined with those of other predicates (WahAnd()) before it is turned into Rids.
+
+RETURNS:
+    1     → the attribute has a bitmap index answering the predicate; bm holds the positions.
+    0     → it has none.
+    NOTOK → the index could not be read (db_err_code set).
+
+------------------------------------------------------------*/
+
+int FindBitmapByIndex(int relNum, const AttrCatRec *attr, void *valuePtr, int compOp, WahBitmap *bm, int *recsPerPg)
+{
+    char fname[RELNAME + ATTRNAME + 8];
+
+    if((compOp != CMP_EQ && compOp != CMP_NE) || !(attr->hasIndex & IDX_BITMAP))
+        return 0;
+
+    build_idx_filename(catcache[relNum].relcat_rec.relName, attr->attrName, "bmap", fname, sizeof(fname));
+    if(access(fname, F_OK) != 0)
+        return 0;
+
+    return BitmapLookup(fname, valuePtr, compOp, bm, recsPerPg) == NOTOK ? NOTOK : 1;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION FindRidsByIndex (relNum, attr, valuePtr, compOp, rids, numRids)
+
+PARAMETER DESCRIPTION:
+    relNum   → open relation being searched.
+    attr     → attrcat record of the attribute in the predicate.
+    valuePtr → typed literal of the predicate.
+    compOp   → comparison operator of the predicate.
+    rids     → (OUT) malloc'd array of candidate Rids; the caller frees it.
+    numRids  → (OUT) number of candidate Rids.
+
+FUNCTION DESCRIPTION:
+    Answers "attr compOp value" from an index instead of a scan when a suitable one exists.
+    An equality predicate on a value that the attribute's Bloom filter rules out yields no candidates without any further I/O.
+    Otherwise an equality predicate is answered by an extendible hash index, or failing that a bitmap index;
+    an inequality predicate by a bitmap index, as the OR of the bitmaps of all other values.
+    Any other predicate on an int or string attribute, and equality without a hash or bitmap index, is a range scan of the B+-tree (BtFindRids()).
+    Callers should still fetch each candidate with GetRec() and may re-check it with compareRecs().
+
+RETURNS:
+    1     → an index was used; rids/numRids hold the candidates.
+    0     → no usable index; the caller must scan.
+    NOTOK → the index could not be read (db_err_code set).
+
+------------------------------------------------------------*/
+
+int FindRidsByIndex(int relNum, AttrCatRec *attr, void *valuePtr, int compOp, Rid **rids, int *numRids)
+{
+    char fname[RELNAME + ATTRNAME + 8], dname[RELNAME + ATTRNAME + 8];
+    const char *relName = catcache[relNum].relcat_rec.relName;
+
+    *rids = NULL;
+    *numRids = 0;
+
+    if(compOp == CMP_EQ && (attr->hasIndex & IDX_BLOOM))
+    {
+        build_idx_filename(relName, attr->attrName, "bloom", fname, sizeof(fname));
+        if(access(fname, F_OK) == 0)
+        {
+            int rc = BloomMayContain(fname, BloomHashValue(attr->type[0], attr->length, valuePtr));
+            if(rc == NOTOK)
+                return NOTOK;
+            if(rc == 0)
+                return 1;
+        }
+    }
+
+    if(compOp == CMP_EQ && (attr->hasIndex & IDX_HASH))
+    {
+        build_idx_filename(relName, attr->attrName, "hash", fname, sizeof(fname));
+        build_idx_filename(relName, attr->attrName, "hdir", dname, sizeof(dname));
+        if(access(fname, F_OK) == 0)
+            return HashLookup(fname, dname, valuePtr, rids, numRids) == NOTOK ? NOTOK : 1;
+    }
+
+    WahBitmap bm;
+    int recsPerPg;
+    int found = FindBitmapByIndex(relNum, attr, valuePtr, compOp, &bm, &recsPerPg);
+
+    if(found)
+    {
+        if(found == NOTOK)
+            return NOTOK;
+        int rc = WahToRids(&bm, recsPerPg, rids, numRids);
+        WahFree(&bm);
+        return rc == NOTOK ? NOTOK : 1;
+    }
+
+    /* The tree compares floats exactly, which would miss values within the tolerance of compareRecs() */
+    if(compOp != CMP_NE && attr->type[0] != 'f' && (attr->hasIndex & IDX_BTREE))
+    {
+        build_idx_filename(relName, attr->attrName, "idx", fname, sizeof(fname));
+        if(access(fname, F_OK) == 0)
+            return BtFindRids(fname, valuePtr, compOp, rids, numRids) == NOTOK ? NOTOK : 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -5,26 +5,28 @@
 #include <stdbool.h>
 #include <string.h>
 #include "../include/defs.h"
+#include "../include/pagelayout.h"
 #include "../include/globals.h"
 #include "../include/helpers.h"
 #include "../include/error.h"
 #include "../include/readpage.h"
 #include "../include/writerec.h"
 #include "../include/freemap.h"
+#include "../include/idxmaint.h"
+#include "../include/zonemap.h"
 
 #define INS_NO_FREE_SLOT  2  /* internal code: page has no free slot */
 
 
 /*------------------------------------------------------------
 
-FUNCTION insertIntoPage (relNum, pidx, recPtr, becameFull, hasFreeAfter)
+FUNCTION insertIntoPage (relNum, pidx, recPtr, slotOut)
 
 PARAMETER DESCRIPTION:
     relNum       → relation number in the open-relation cache.
     pidx         → page index within the relation.
     recPtr       → pointer to the record to be inserted.
-    becameFull   → set to TRUE iff the page was not previously full but becomes full after insert.
-    hasFreeAfter → set to TRUE iff, after insertion, the page still contains at least one free slot.
+    slotOut      → receives the slot the record was placed in.
 
 FUNCTION DESCRIPTION:
     This routine attempts to insert a single record into a specific page of a relation. 
@@ -37,23 +39,18 @@ FUNCTION DESCRIPTION:
 
 RETURNS:
        OK               → record successfully inserted.
-       INS_NO_FREE_SLOT → page contains no empty slot.
+       INS_NO_FREE_SLOT → page has no empty slot, or not the bytes the record takes.
        NOTOK            → error encountered (db_err_code set).
 
 ALGORITHM:
     1) Read the target page into the buffer using ReadPage().
     2) Validate page magic bytes.
-    3) Load the slotmap and compute the mask of valid bits.
-    4) Identify whether the page was previously full.
-    5) Scan for the first free slot.
-    6) When found:
-        a) Increment numRecs for the relation.
-        b) Update the relcat entry via WriteRec().
-        c) Copy the new record into the slot’s data region.
-        d) Set the bit in the slotmap; mark buffer page dirty.
-        e) Set becameFull and hasFreeAfter as appropriate.
-        f) Return OK.
-    7) If no free slot, return INS_NO_FREE_SLOT.
+    3) If PageFreeBytes() of the page is below PageRecBytes() of the record, return INS_NO_FREE_SLOT.
+    4) Take the first free slot:
+        a) Store the record in it (PagePutRec()).
+        b) Set the bit in the slotmap; mark buffer page dirty.
+        c) Increment numRecs for the relation and update the relcat entry via WriteRec().
+        d) Return OK.
 
 GLOBAL VARIABLES MODIFIED:
     catcache[relNum].relcat_rec.numRecs
@@ -71,14 +68,11 @@ IMPLEMENTATION NOTES:
 
 --------------------------------------------------------------*/
 
-static int insertIntoPage(int relNum, short pidx, void *recPtr, bool *becameFull, bool *hasFreeAfter)
+static int insertIntoPage(int relNum, short pidx, void *recPtr, short *slotOut)
 {
     CacheEntry *entry = &catcache[relNum];
     char *page        = buffer[relNum].page;
 
-    int recSize   = entry->relcat_rec.recLength;
-    int recsPerPg = entry->relcat_rec.recsPerPg;
-
     if(ReadPage(relNum, pidx) == NOTOK)
     {
         return NOTOK;
@@ -91,55 +85,33 @@ static int insertIntoPage(int relNum, short pidx, void *recPtr, bool *becameFull
         return NOTOK;
     }
 
+    /* No free slot, or too few bytes left in a slotted page */
+    if (PageFreeBytes(entry, page) < PageRecBytes(entry, recPtr))
+        return INS_NO_FREE_SLOT;
+
     unsigned long slotmap = 0;
     memcpy(&slotmap, page + MAGIC_SIZE, SLOTMAP);
 
-    /* Compute mask of all valid slots */
-    unsigned long fullMask;
-    if (recsPerPg >= (int)(sizeof(unsigned long) << 3))
-        fullMask = ~0UL;
-    else
-        fullMask = (1UL << recsPerPg) - 1;
+    short slot = __builtin_ctzl(~slotmap);
 
-    bool wasFull = ((slotmap & fullMask) == fullMask);
+    if(PagePutRec(entry, page, slot, recPtr) == NOTOK)
+        return NOTOK;
 
-    /* Find a free slot */
-    for (short slot = 0; slot < recsPerPg; slot++)
-    {
-        if (!(slotmap & (1UL << slot)))  /* free slot */
-        {
-            entry->relcat_rec.numRecs += 1;
-            entry->status |= DIRTY_MASK;
-            
-            int offset = HEADER_SIZE + slot * recSize;
-            memcpy(page + offset, recPtr, recSize);
-            
-            slotmap |= (1UL << slot);
-            memcpy(page + MAGIC_SIZE, &slotmap, SLOTMAP);
-            buffer[relNum].dirty = true;
-
-            if(WriteRec(RELCAT_CACHE, &(entry->relcat_rec), entry->relcatRid) == NOTOK)
-            {
-                entry->relcat_rec.numRecs -= 1;
-                return NOTOK;
-            }
+    entry->relcat_rec.numRecs += 1;
+    entry->status |= DIRTY_MASK;
 
-            if (becameFull)
-                *becameFull = (!wasFull && ((slotmap & fullMask) == fullMask));
-            if (hasFreeAfter)
-                *hasFreeAfter = ((slotmap & fullMask) != fullMask);
+    slotmap |= (1UL << slot);
+    memcpy(page + MAGIC_SIZE, &slotmap, SLOTMAP);
+    buffer[relNum].dirty = true;
 
-            return OK;
-        }
+    if(WriteRec(RELCAT_CACHE, &(entry->relcat_rec), entry->relcatRid) == NOTOK)
+    {
+        entry->relcat_rec.numRecs -= 1;
+        return NOTOK;
     }
 
-    /* No free slot in this page */
-    if (becameFull)
-        *becameFull = false;
-    if (hasFreeAfter)
-        *hasFreeAfter = false;
-    
-    return INS_NO_FREE_SLOT;
+    *slotOut = slot;
+    return OK;
 }
 
 
@@ -154,15 +126,15 @@ PARAMETER DESCRIPTION:
 FUNCTION DESCRIPTION:
     Implements the core file insertion routine.
     Attempts to place the incoming tuple in:
-        1) a free page identified via freemap (if available),
-        2) otherwise a linear scan of all existing pages,
+        1) the first page the freemap gives room for the record (if the relation has one),
+        2) otherwise, without a freemap, a linear scan of all existing pages,
         3) otherwise a newly allocated page.
-    Works with fixed-length records. Maintains:
+    Works with fixed-length records and with the variable-length records of slotted pages. Maintains:
         - relation page count,
         - tuple count,
         - slotmaps,
         - page flushes,
-        - freemap bitmap.
+        - freemap free bytes.
 
 RETURNS:
     OK    → record inserted successfully.
@@ -170,24 +142,23 @@ RETURNS:
 
 ALGORITHM:
     1) Validate relation is open and entry is marked VALID_MASK.
-    2) Retrieve relation metadata: recsPerPg, numPages, relation name, etc.
-    3) If freemap file available for the relation.
-        a) Obtain a page number from FindFreeSlot().
+    2) Retrieve relation metadata: numPages, relation name, and the bytes the record takes (PageRecBytes()).
+    3) If freemap file available for the relation, until it has no page with room:
+        a) Obtain a page number from FindFreePage().
         b) Attempt insertion into that page via insertIntoPage().
-        c) If successful:
-            - update freemap: remove page if it became full, or ensure page remains marked free if still not full.
-            - return OK.
-        d) If page was stale (INS_NO_FREE_SLOT), clear it in freemap.
+        c) Record the page's free bytes now (SetFreeSpace() of PageFreeBytes()); a stale entry is corrected.
+        d) If successful, return OK.
     4) Else scan all existing pages sequentially.
         - For each page pidx: call insertIntoPage().
-        - If OK: update freemap accordingly, return OK.
-    5) If all pages full, allocate a new page:
+        - If OK: return OK.
+    5) If no page has room, allocate a new page:
         a) Flush current buffer page (FlushPage()).
-        b) Initialize a new empty page with: page-type marker, magic bytes, slotmap containing only slot 0 occupied.
-        c) Copy record into slot 0.
+        b) Initialize a new empty page with: page-type marker, magic bytes, the record in slot 0.
+        c) Set the slotmap to slot 0 occupied.
         d) Update relation metadata: numRecs++, numPgs++, WriteRec() the relcat entry.
-        e) If using freemap and recsPerPg > 1: Add the new page to freemap.
-    6) Return OK.
+        e) If using freemap: record the new page's free bytes.
+    6) Add the record's Rid to every index of the relation (InsertIndexEntries()).
+    7) Return OK.
 
 BUGS:
     None found.
@@ -207,6 +178,9 @@ ERRORS REPORTED:
     REL_PAGE_LIMIT_REACHED
     REL_OPEN_ERROR
 
+IMPLEMENTATION NOTES:
+    • The freemap, when there is one, is trusted: a page it records as full is not read.
+
 --------------------------------------------------------------*/
 
 int InsertRec(int relNum, void *recPtr)
@@ -219,76 +193,55 @@ int InsertRec(int relNum, void *recPtr)
         return NOTOK;
     }
 
-    int recsPerPg = entry->relcat_rec.recsPerPg;
     int numPages  = entry->relcat_rec.numPgs;
     char *page    = buffer[relNum].page;
     const char *relName = entry->relcat_rec.relName;
+    int need      = PageRecBytes(entry, recPtr);
+    short slot;
 
     /* Whether to use freemap for this relation */
     bool useFreeMap = (FreeMapExists(relName) == 1);
 
-    /* -------- 1. Try freemap first if available -------- */
+    /* -------- 1. Try the pages the freemap gives room -------- */
     if (useFreeMap)
     {
-        int freePg = FindFreeSlot(relName);
+        int freePg;
 
-        if (freePg >= 0 && freePg < numPages)
+        while ((freePg = FindFreePage(relName, numPages, need)) >= 0 && freePg < numPages)
         {
             short pidx = (short)freePg;
-            bool becameFull = false;
-            bool hasFreeAfter = false;
-
-            int rc = insertIntoPage(relNum, pidx, recPtr,
-                                    &becameFull, &hasFreeAfter);
 
-            if (rc == OK)
-            {
-                if (becameFull)
-                {
-                    /* Page just became full: remove from freemap */
-                    DeleteFromFreeMap(relName, pidx);
-                }
-                else if (hasFreeAfter)
-                {
-                    /* Page still has space: ensure in freemap */
-                    AddToFreeMap(relName, pidx);
-                }
-                return OK;
-            }
+            int rc = insertIntoPage(relNum, pidx, recPtr, &slot);
 
             if (rc == NOTOK)
                 return NOTOK;
 
-            /* rc == INS_NO_FREE_SLOT:
-               freemap was stale for this page -> clean it up and fall back */
-            DeleteFromFreeMap(relName, pidx);
+            /* After an insert, or to correct a stale entry */
+            if (SetFreeSpace(relName, pidx, PageFreeBytes(entry, page)) == NOTOK)
+                return NOTOK;
+
+            if (rc == OK)
+            {
+                if (ZoneMapUpdate(relNum, pidx) == NOTOK)
+                    return NOTOK;
+                return InsertIndexEntries(relNum, recPtr, (Rid){pidx, slot});
+            }
         }
+
+        if (freePg == NOTOK)
+            return NOTOK;
     }
 
-    /* -------- 2. Fallback: linear scan over all existing pages -------- */
-    for (short pidx = 0; pidx < numPages; pidx++)
+    /* -------- 2. Without a freemap: linear scan over all existing pages -------- */
+    for (short pidx = 0; !useFreeMap && pidx < numPages; pidx++)
     {
-        bool becameFull = false;
-        bool hasFreeAfter = false;
-
-        int rc = insertIntoPage(relNum, pidx, recPtr,
-                                &becameFull, &hasFreeAfter);
+        int rc = insertIntoPage(relNum, pidx, recPtr, &slot);
 
         if (rc == OK)
         {
-            if (useFreeMap)
-            {
-                if (becameFull)
-                {
-                    DeleteFromFreeMap(relName, pidx);
-                }
-                else if (hasFreeAfter)
-                {
-                    AddToFreeMap(relName, pidx);
-                }
-            }
-
-            return OK;
+            if (ZoneMapUpdate(relNum, pidx) == NOTOK)
+                return NOTOK;
+            return InsertIndexEntries(relNum, recPtr, (Rid){pidx, slot});
         }
 
         if (rc == NOTOK)
@@ -297,7 +250,7 @@ int InsertRec(int relNum, void *recPtr)
         /* rc == INS_NO_FREE_SLOT: just try next page */
     }
 
-    /* -------- 3. No free slot: allocate a new page -------- */
+    /* -------- 3. No page has room: allocate a new page -------- */
     if(FlushPage(relNum) == NOTOK)
     {
         return NOTOK;
@@ -318,10 +271,16 @@ int InsertRec(int relNum, void *recPtr)
 
     page[0] = c;
     strncpy(page + 1, GEN_MAGIC, MAGIC_SIZE - 1);
-    memcpy(page + MAGIC_SIZE, &newMap, SLOTMAP);
 
-    int recSize = entry->relcat_rec.recLength;
-    memcpy(page + HEADER_SIZE, recPtr, recSize);
+    if(PagePutRec(entry, page, 0, recPtr) == NOTOK)
+    {
+        /* Forget the page, which was never written */
+        buffer[relNum].pid = -1;
+        buffer[relNum].dirty = false;
+        return NOTOK;
+    }
+
+    memcpy(page + MAGIC_SIZE, &newMap, SLOTMAP);
 
     entry->relcat_rec.numRecs += 1;
     entry->relcat_rec.numPgs  += 1;
@@ -334,9 +293,10 @@ int InsertRec(int relNum, void *recPtr)
         return NOTOK;
     }
 
-    /* New page has free slots if recsPerPg > 1 */
-    if (useFreeMap && recsPerPg > 1)
-        AddToFreeMap(relName, (short)numPages);
+    if (useFreeMap && SetFreeSpace(relName, (short)numPages, PageFreeBytes(entry, page)) == NOTOK)
+        return NOTOK;
 
-    return OK;
+    if (ZoneMapUpdate(relNum, (short)numPages) == NOTOK)
+        return NOTOK;
+    return InsertIndexEntries(relNum, recPtr, (Rid){(short)numPages, 0});
 }
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include "../include/globals.h"
 #include "../include/helpers.h"
 #include "../include/readpage.h"
+#include "../include/pagelayout.h"
 
 
 /*------------------------------------------------------------
@@ -109,6 +110,7 @@ ALGORITHM:
     4) Build attribute lists:
         catcache[0].attrList ← BuildAttrList(rel_attrs,…)
         catcache[1].attrList ← BuildAttrList(attr_attrs,…)
+        PageLayoutInit() on both entries
     5) Populate cache entries for relcat (slot 0) and attrcat (slot 1):
         – relFile = file descriptor
         – relcat_rec = metadata record
@@ -168,7 +170,8 @@ int OpenCats()
         &Attrcat_recsPerPg,
         &AttrCat_numAttrs,
         &AttrCat_numRecs,
-        &AttrCat_numPgs
+        &AttrCat_numPgs,
+        &AttrCat_layout
     };
 
     // Attributes of attrcat relation
@@ -180,7 +183,8 @@ int OpenCats()
         &AttrCat_arelName,
         &AttrCat_hasIndex,
         &AttrCat_nPages,
-        &AttrCat_nKeys
+        &AttrCat_nKeys,
+        &AttrCat_encoding
     };
 
     // Load relcat entry into cache[0]
@@ -201,6 +205,11 @@ int OpenCats()
     catcache[1].relcatRid.slotnum = 1;
     catcache[1].attrList = BuildAttrList(attr_attrs, ATTRCAT_NUMATTRS);
 
+    if(PageLayoutInit(&catcache[0]) == NOTOK || PageLayoutInit(&catcache[1]) == NOTOK)
+    {
+        return NOTOK;
+    }
+
     // Initialize buffer pool
     for (int i = 0; i < MAXOPEN; i++) 
     {
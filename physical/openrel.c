@@ -16,6 +16,7 @@
 #include "../include/closerel.h"
 #include "../include/pinrel.h"
 #include "../include/unpinrel.h"
+#include "../include/pagelayout.h"
 
 /*------------------------------------------------------------
 
@@ -43,9 +44,11 @@ ALGORITHM:
         - relFile descriptor,
         - status = VALID_MASK,
         - relcatRid for future catalog writes,
+        - openSeq, so that holders of a relNum (prepared statements) tell a slot reloaded since,
         - timestamp for LRU bookkeeping.
     8) Build the linked list of attribute descriptors for this relation by repeatedly scanning attrcat using FindRec() on attrCat.relName = relName, and allocate AttrDesc nodes.
-    9) Return the cache slot index.
+    9) Place the attributes in a page and open the dictionaries of encoded ones with PageLayoutInit().
+    10) Return the cache slot index.
 
 BUGS:
     None found.
@@ -62,6 +65,9 @@ GLOBAL VARIABLES MODIFIED:
 
 ------------------------------------------------------------*/
 
+/* Relations loaded into the cache so far; numbers every load (CacheEntry.openSeq) */
+static unsigned openCount = 0;
+
 int OpenRel(const char *relName)
 {
     // Step 1: Check if already open
@@ -141,6 +147,7 @@ int OpenRel(const char *relName)
     catcache[freeSlot].relFile = fd;
     catcache[freeSlot].status = (VALID_MASK | PINNED_MASK);
     catcache[freeSlot].relcatRid = startRid;
+    catcache[freeSlot].openSeq = ++openCount;
     catcache[freeSlot].attrList = NULL; 
 
     AttrDesc *ptr = NULL;
@@ -187,6 +194,12 @@ int OpenRel(const char *relName)
         }
     }
     while(1);
+
+    if(PageLayoutInit(&catcache[freeSlot]) == NOTOK)
+    {
+        CloseRel(freeSlot);
+        return NOTOK;
+    }
     
     if(found)
     {
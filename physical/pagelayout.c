@@ -0,0 +1,544 @@
+/************************INCLUDES*******************************/
+
+#include <string.h>
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/dict.h"
+#include "../include/pagelayout.h"
+
+
+/*------------------------------------------------------------
+
+FUNCTION PageAttrLength (attr)
+
+RETURNS:
+    Bytes the attribute takes at a fixed place of a page record: sizeof(int) for the code of an ENC_DICT
+    attribute, 0 for an ENC_VAR one, whose value follows the fixed part, its length otherwise.
+
+------------------------------------------------------------*/
+
+int PageAttrLength(const AttrCatRec *attr)
+{
+    switch(attr->encoding)
+    {
+        case ENC_DICT:  return sizeof(int);
+        case ENC_VAR:   return 0;
+        default:        return attr->length;
+    }
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PageLayoutInit (entry)
+
+PARAMETER DESCRIPTION:
+    entry → cache entry whose relcat record and attrList were just loaded.
+
+FUNCTION DESCRIPTION:
+    Works out where every attribute sits in a page (pageOffset, pageLength, pageRecLength) and
+    opens the dictionaries of the ENC_DICT attributes.  Called by OpenRel() and OpenCats().
+
+RETURNS:
+    OK or NOTOK.
+
+ERRORS REPORTED:
+    Errors of DictOpen().
+
+IMPLEMENTATION NOTES:
+    • pageOffset follows the record offsets rather than the order of attrList, so the two need not agree.
+    • The values of ENC_VAR attributes follow in attrList order, which is that of their attrcat records
+      and so the same every time the relation is opened; their pageOffset is their rank in it.
+
+------------------------------------------------------------*/
+
+int PageLayoutInit(CacheEntry *entry)
+{
+    entry->pageRecLength = 0;
+    entry->pageVarAttrs = 0;
+
+    for(AttrDesc *p = entry->attrList; p; p = p->next)
+    {
+        p->pageLength = PageAttrLength(&p->attr);
+        p->pageOffset = 0;
+        p->dict = NULL;
+        entry->pageRecLength += p->pageLength;
+
+        if(p->attr.encoding == ENC_VAR)
+        {
+            p->pageOffset = entry->pageVarAttrs++;
+            continue;
+        }
+
+        for(AttrDesc *q = entry->attrList; q; q = q->next)
+        {
+            if(q->attr.offset < p->attr.offset)
+                p->pageOffset += PageAttrLength(&q->attr);
+        }
+    }
+
+    for(AttrDesc *p = entry->attrList; p; p = p->next)
+    {
+        if(p->attr.encoding == ENC_DICT &&
+           !(p->dict = DictOpen(entry->relcat_rec.relName, p->attr.attrName, p->attr.length)))
+        {
+            PageLayoutRelease(entry);
+            return NOTOK;
+        }
+    }
+
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PageLayoutRelease (entry)
+
+FUNCTION DESCRIPTION:
+    Frees the dictionaries PageLayoutInit() opened; called before the attrList of entry is freed.
+
+------------------------------------------------------------*/
+
+void PageLayoutRelease(CacheEntry *entry)
+{
+    for(AttrDesc *p = entry->attrList; p; p = p->next)
+    {
+        DictClose(p->dict);
+        p->dict = NULL;
+    }
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PageAttrAt (entry, offset)
+
+RETURNS:
+    The attribute of entry at record offset offset, or NULL.
+
+------------------------------------------------------------*/
+
+AttrDesc *PageAttrAt(const CacheEntry *entry, int offset)
+{
+    for(AttrDesc *p = entry->attrList; p; p = p->next)
+    {
+        if(p->attr.offset == offset)
+            return p;
+    }
+    return NULL;
+}
+
+
+/* Slotted pages: the offset directory entry of slot */
+static int dirGet(const char *page, int slot)
+{
+    unsigned short off;
+    memcpy(&off, page + HEADER_SIZE + slot * sizeof(off), sizeof(off));
+    return off;
+}
+
+static void dirSet(char *page, int slot, int off)
+{
+    unsigned short v = off;
+    memcpy(page + HEADER_SIZE + slot * sizeof(v), &v, sizeof(v));
+}
+
+/* Directory entries in use: up to the last live slot */
+static int dirLen(unsigned long live)
+{
+    return live ? (int)(8 * sizeof(live)) - __builtin_clzl(live) : 0;
+}
+
+/* Bytes of the record stored at prec */
+static int slottedRecBytes(const CacheEntry *entry, const char *prec)
+{
+    int n = entry->pageRecLength;
+
+    for(int k = 0; k < entry->pageVarAttrs; k++)
+        n += 1 + (unsigned char)prec[n];
+    return n;
+}
+
+/* Bytes the live records take, and where the lowest one starts (PAGESIZE when there is none) */
+static int slottedUsed(const CacheEntry *entry, const char *page, unsigned long live, int *top)
+{
+    int used = 0;
+
+    *top = PAGESIZE;
+    for(; live; live &= live - 1)
+    {
+        int off = dirGet(page, __builtin_ctzl(live));
+
+        used += slottedRecBytes(entry, page + off);
+        *top = MIN(*top, off);
+    }
+    return used;
+}
+
+/* Moves the live records to the end of the page, closing the holes deleted ones left */
+static void slottedCompact(const CacheEntry *entry, char *page, unsigned long live)
+{
+    char heap[PAGESIZE];
+    int top = PAGESIZE;
+
+    for(; live; live &= live - 1)
+    {
+        int slot = __builtin_ctzl(live);
+        const char *prec = page + dirGet(page, slot);
+        int n = slottedRecBytes(entry, prec);
+
+        top -= n;
+        memcpy(heap + top, prec, n);
+        dirSet(page, slot, top);
+    }
+    memcpy(page + top, heap + top, PAGESIZE - top);
+}
+
+/* Writes rec as a slotted page record into prec, with the codes of its ENC_DICT values; returns its bytes */
+static int slottedEncode(const CacheEntry *entry, const char *rec, const int *codes, char *prec)
+{
+    int n = entry->pageRecLength;
+    int k = 0;
+
+    for(AttrDesc *p = entry->attrList; p; p = p->next)
+    {
+        const char *v = rec + p->attr.offset;
+
+        if(p->dict)
+        {
+            memcpy(prec + p->pageOffset, &codes[k++], sizeof(int));
+        }
+        else if(p->attr.encoding != ENC_VAR)
+        {
+            memcpy(prec + p->pageOffset, v, p->attr.length);
+        }
+        else
+        {
+            int len = strnlen(v, p->attr.length - 1);
+
+            prec[n] = len;
+            memcpy(prec + n + 1, v, len);
+            n += 1 + len;
+        }
+    }
+    return n;
+}
+
+/* Value of the ENC_VAR attribute attr in the record at prec, NUL padded into dst */
+static void slottedGetVar(const CacheEntry *entry, const char *prec, const AttrDesc *attr, char *dst)
+{
+    int pos = entry->pageRecLength;
+
+    for(int k = 0; k < attr->pageOffset; k++)
+        pos += 1 + (unsigned char)prec[pos];
+
+    int len = (unsigned char)prec[pos];
+
+    memcpy(dst, prec + pos + 1, len);
+    memset(dst + len, 0, attr->attr.length - len);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PageGetValue (attr, v, dst)
+
+PARAMETER DESCRIPTION:
+    attr → attribute of an open relation.
+    v    → its value in a page, pageLength bytes.
+    dst  → (OUT) attr.length bytes receiving the value as a record holds it.
+
+FUNCTION DESCRIPTION:
+    Copies a value out of a page, decoding the code of an ENC_DICT attribute.  A code the
+    dictionary does not hold gives an empty string.
+
+------------------------------------------------------------*/
+
+void PageGetValue(const AttrDesc *attr, const char *v, char *dst)
+{
+    if(!attr->dict)
+    {
+        memcpy(dst, v, attr->attr.length);
+        return;
+    }
+
+    int code;
+    memcpy(&code, v, sizeof(int));
+
+    if(code >= 0 && code < attr->dict->numCodes)
+        memcpy(dst, DictString(attr->dict, code), attr->attr.length);
+    else
+        memset(dst, 0, attr->attr.length);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PageAttrValue (entry, page, slot, attr, buf)
+
+PARAMETER DESCRIPTION:
+    entry → cache entry of the relation the page belongs to.
+    page  → page image.
+    slot  → occupied slot.
+    attr  → attribute of the relation.
+    buf   → attr.length bytes the value may be decoded into.
+
+FUNCTION DESCRIPTION:
+    Finds one value of a record without copying the rest of it, whatever the page layout and encoding.
+
+RETURNS:
+    The value as a record holds it: in the page, in the attribute's dictionary, or in buf.
+
+------------------------------------------------------------*/
+
+const char *PageAttrValue(const CacheEntry *entry, const char *page, int slot, const AttrDesc *attr, char *buf)
+{
+    const char *v;
+
+    if(entry->relcat_rec.layout != LAYOUT_SLOTTED)
+    {
+        v = page + PageAttrPos(entry, slot, attr);
+    }
+    else if(attr->attr.encoding == ENC_VAR)
+    {
+        slottedGetVar(entry, page + dirGet(page, slot), attr, buf);
+        return buf;
+    }
+    else
+    {
+        v = page + dirGet(page, slot) + attr->pageOffset;
+    }
+
+    if(!attr->dict)
+        return v;
+
+    int code;
+    memcpy(&code, v, sizeof(int));
+    return code >= 0 && code < attr->dict->numCodes ? DictString(attr->dict, code) : memset(buf, 0, attr->attr.length);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PageGetRec (entry, page, slot, rec)
+
+PARAMETER DESCRIPTION:
+    entry → cache entry of the relation the page belongs to.
+    page  → page image.
+    slot  → occupied slot.
+    rec   → (OUT) recLength bytes receiving the record.
+
+FUNCTION DESCRIPTION:
+    Copies the record in slot out of the page, gathering its values from the minipages of a PAX page,
+    finding it through the directory of a slotted page, and decoding the codes of ENC_DICT attributes.
+
+------------------------------------------------------------*/
+
+void PageGetRec(const CacheEntry *entry, const char *page, int slot, void *rec)
+{
+    if(PageRecsInPlace(entry))
+    {
+        memcpy(rec, page + HEADER_SIZE + slot * entry->pageRecLength, entry->pageRecLength);
+        return;
+    }
+
+    if(entry->relcat_rec.layout != LAYOUT_SLOTTED)
+    {
+        for(AttrDesc *p = entry->attrList; p; p = p->next)
+            PageGetValue(p, page + PageAttrPos(entry, slot, p), (char *)rec + p->attr.offset);
+        return;
+    }
+
+    const char *prec = page + dirGet(page, slot);
+    int pos = entry->pageRecLength;
+
+    for(AttrDesc *p = entry->attrList; p; p = p->next)
+    {
+        char *dst = (char *)rec + p->attr.offset;
+
+        if(p->attr.encoding != ENC_VAR)
+        {
+            PageGetValue(p, prec + p->pageOffset, dst);
+            continue;
+        }
+
+        int len = (unsigned char)prec[pos];
+
+        memcpy(dst, prec + pos + 1, len);
+        memset(dst + len, 0, p->attr.length - len);
+        pos += 1 + len;
+    }
+}
+
+
+/* PagePutRec() on a slotted page, once the codes of the ENC_DICT values are known */
+static int slottedPut(const CacheEntry *entry, char *page, int slot, const void *rec, const int *codes)
+{
+    char prec[PAGESIZE];
+    int n = slottedEncode(entry, rec, codes, prec);
+    unsigned long slotmap;
+
+    memcpy(&slotmap, page + MAGIC_SIZE, sizeof(slotmap));
+
+    /* A live record that does not grow is rewritten where it is */
+    if((slotmap >> slot) & 1)
+    {
+        int off = dirGet(page, slot);
+
+        if(n <= slottedRecBytes(entry, page + off))
+        {
+            memcpy(page + off, prec, n);
+            return OK;
+        }
+    }
+
+    unsigned long others = slotmap & ~(1UL << slot);
+    int dirEnd = HEADER_SIZE + MAX(dirLen(others), slot + 1) * (int)sizeof(unsigned short);
+    int top;
+    int used = slottedUsed(entry, page, others, &top);
+
+    if(dirEnd + used + n > PAGESIZE)
+    {
+        db_err_code = REC_TOO_LONG;
+        return NOTOK;
+    }
+
+    if(top - n < dirEnd)
+    {
+        slottedCompact(entry, page, others);
+        top = PAGESIZE - used;
+    }
+
+    memcpy(page + top - n, prec, n);
+    dirSet(page, slot, top - n);
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PagePutRec (entry, page, slot, rec)
+
+PARAMETER DESCRIPTION:
+    entry → cache entry of the relation the page belongs to.
+    page  → page image.
+    slot  → slot to overwrite; the slotmap is left to the caller.
+    rec   → record of recLength bytes.
+
+FUNCTION DESCRIPTION:
+    Stores a record in slot, scattering its values to the minipages of a PAX page and replacing the
+    values of ENC_DICT attributes by their codes.  On a slotted page the record goes below the lowest
+    one, after compacting the page when the room is only there in holes, and the directory points to it.
+
+RETURNS:
+    OK, or NOTOK when a new value could not be added to a dictionary or a slotted page has no room
+    (callers check PageFreeBytes() first); the page is then unchanged.
+
+ERRORS REPORTED:
+    Errors of DictEncode().
+    REC_TOO_LONG
+
+------------------------------------------------------------*/
+
+int PagePutRec(const CacheEntry *entry, char *page, int slot, const void *rec)
+{
+    if(PageRecsInPlace(entry))
+    {
+        memcpy(page + HEADER_SIZE + slot * entry->pageRecLength, rec, entry->pageRecLength);
+        return OK;
+    }
+
+    int codes[MAXRECORD];           /* an encoded attribute takes at least one byte of a record */
+    int k = 0;
+
+    /* Encode first, so that a failure leaves the page as it was */
+    for(AttrDesc *p = entry->attrList; p; p = p->next)
+    {
+        if(p->dict && DictEncode(p->dict, (const char *)rec + p->attr.offset, &codes[k++]) == NOTOK)
+            return NOTOK;
+    }
+
+    if(entry->relcat_rec.layout == LAYOUT_SLOTTED)
+        return slottedPut(entry, page, slot, rec, codes);
+
+    k = 0;
+    for(AttrDesc *p = entry->attrList; p; p = p->next)
+    {
+        char *v = page + PageAttrPos(entry, slot, p);
+
+        if(p->dict)
+            memcpy(v, &codes[k++], sizeof(int));
+        else
+            memcpy(v, (const char *)rec + p->attr.offset, p->attr.length);
+    }
+
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PageRecBytes (entry, rec)
+
+RETURNS:
+    Bytes rec takes in a page of the relation: pageRecLength, or for a slotted page the fixed part plus a
+    length byte and the characters of every ENC_VAR value.
+
+------------------------------------------------------------*/
+
+int PageRecBytes(const CacheEntry *entry, const void *rec)
+{
+    int n = entry->pageRecLength;
+
+    if(entry->relcat_rec.layout != LAYOUT_SLOTTED)
+        return n;
+
+    for(AttrDesc *p = entry->attrList; p; p = p->next)
+    {
+        if(p->attr.encoding == ENC_VAR)
+            n += 1 + strnlen((const char *)rec + p->attr.offset, p->attr.length - 1);
+    }
+    return n;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PageFreeBytes (entry, page)
+
+FUNCTION DESCRIPTION:
+    Room left in a page for one more record, as recorded in the freemap.
+
+RETURNS:
+    0 when every slot is taken.  Otherwise the free slots times pageRecLength, or for a slotted page the bytes
+    neither the header, the directory (counting the entry of the next free slot) nor the live records take.
+    A record fits iff PageRecBytes() is at most this, compacting the page if need be.
+
+------------------------------------------------------------*/
+
+int PageFreeBytes(const CacheEntry *entry, const char *page)
+{
+    int recsPerPg = entry->relcat_rec.recsPerPg;
+    unsigned long slotmap;
+
+    memcpy(&slotmap, page + MAGIC_SIZE, sizeof(slotmap));
+
+    unsigned long free = ~slotmap;
+
+    if(recsPerPg < (int)(8 * sizeof(slotmap)))
+        free &= (1UL << recsPerPg) - 1;
+
+    if(!free)
+        return 0;
+
+    if(entry->relcat_rec.layout != LAYOUT_SLOTTED)
+        return __builtin_popcountl(free) * entry->pageRecLength;
+
+    int top;
+    int used = slottedUsed(entry, page, slotmap, &top);
+    int dir = MAX(dirLen(slotmap), __builtin_ctzl(free) + 1);
+
+    return MAX(0, PAGESIZE - HEADER_SIZE - dir * (int)sizeof(unsigned short) - used);
+}
@@ -0,0 +1,586 @@
+/************************INCLUDES*******************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/extsort.h"
+#include "../include/parsort.h"
+#include "../include/pagelayout.h"
+
+/*
+ * Parallel sort of a heap relation.
+ *
+ * Phase 1: every worker reads a disjoint range of heap pages straight from the relation file and sorts it with its own
+ * ExtSort (replacement selection + loser-tree merge) under 1/P of the memory budget, leaving one sorted part file.
+ * Splitters: SORT_SAMPLES evenly spaced entries of every part are sorted, and P-1 of them cut the key space into P
+ * ranges; a binary search locates every splitter in every part.
+ * Phase 2: worker j merges range j of all parts into its own output file.  The ranges are disjoint and ordered,
+ * so the caller receives output 0, then 1, ... while the later workers are still merging.
+ *
+ * Entries are the record followed by its int position pid * recsPerPg + slot, so the comparator can break ties on
+ * the position and make the sort stable.  Workers never touch the buffer pool, and only read the catalog cache entry.
+ */
+
+typedef struct parsort
+{
+    int fd;                             // relation file, read with pread()
+    const CacheEntry *entry;            // layout of its pages; only read
+    int recSize;
+    int recsPerPg;
+    int entSize;                        // recSize + sizeof(int)
+    ExtSortCmp cmp;
+    void *ctx;
+    long memBytes;                      // budget of each worker
+    char prefix[RELNAME + 8];           // prefix of every temporary file
+    int numThreads;
+    long *bounds;                       // bounds[i * (numThreads + 1) + j] = first entry of range j in part i
+} ParSort;
+
+typedef struct parsortjob
+{
+    pthread_t tid;
+    ParSort *ps;
+    int id;
+    int loPg, hiPg;                     // pages [loPg, hiPg) of phase 1
+    long numEnts;                       // entries written to this job's part (phase 1) or output (phase 2)
+    int err;                            // db_err_code of the worker, OK on success
+} ParSortJob;
+
+
+static void build_part_filename(ParSort *ps, const char *kind, int id, char *fname, size_t buflen)
+{
+    snprintf(fname, buflen, "%s.%s%d", ps->prefix, kind, id);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION runWorker (arg)
+
+PARAMETER DESCRIPTION:
+    arg → ParSortJob describing the page range of this worker.
+
+FUNCTION DESCRIPTION:
+    Phase 1: sorts the records on pages [loPg, hiPg) and writes them to "<prefix>.part<id>".
+    Pages are read with pread(), which is safe to share between threads on one descriptor.
+
+RETURNS:
+    NULL; the outcome is left in job->err and job->numEnts.
+
+------------------------------------------------------------*/
+
+static void *runWorker(void *arg)
+{
+    ParSortJob *job = arg;
+    ParSort *ps = job->ps;
+    char pfx[sizeof(ps->prefix) + 16], fname[sizeof(ps->prefix) + 16];
+    char page[PAGESIZE];
+    char *ent = malloc(ps->entSize);
+    ExtSort s;
+    int rc = NOTOK;
+
+    job->numEnts = 0;
+    snprintf(pfx, sizeof(pfx), "%s.t%d", ps->prefix, job->id);
+
+    if(!ent)
+    {
+        job->err = MEM_ALLOC_ERROR;
+        return NULL;
+    }
+
+    if(ExtSortOpen(&s, ps->entSize, ps->cmp, ps->ctx, ps->memBytes, pfx) == NOTOK)
+    {
+        job->err = db_err_code;
+        free(ent);
+        return NULL;
+    }
+
+    for(int pid = job->loPg; pid < job->hiPg; pid++)
+    {
+        if(pread(ps->fd, page, PAGESIZE, (off_t)pid * PAGESIZE) != PAGESIZE)
+        {
+            db_err_code = FILESYSTEM_ERROR;
+            goto done;
+        }
+
+        unsigned long slotmap;
+        memcpy(&slotmap, page + MAGIC_SIZE, sizeof(slotmap));
+
+        for(int slot = 0; slot < ps->recsPerPg; slot++)
+        {
+            if(!(slotmap & (1UL << slot)))
+                continue;
+
+            int pos = pid * ps->recsPerPg + slot;
+            PageGetRec(ps->entry, page, slot, ent);
+            memcpy(ent + ps->recSize, &pos, sizeof(int));
+
+            if(ExtSortAdd(&s, ent) == NOTOK)
+                goto done;
+        }
+    }
+
+    if(ExtSortFinish(&s) == NOTOK)
+        goto done;
+
+    build_part_filename(ps, "part", job->id, fname, sizeof(fname));
+    FILE *out = fopen(fname, "wb");
+    if(!out)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        goto done;
+    }
+
+    int r;
+    while((r = ExtSortNext(&s, ent)) == 1)
+    {
+        if(fwrite(ent, ps->entSize, 1, out) != 1)
+        {
+            db_err_code = FILESYSTEM_ERROR;
+            r = NOTOK;
+            break;
+        }
+        job->numEnts++;
+    }
+
+    if(fclose(out) != 0 && r != NOTOK)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        r = NOTOK;
+    }
+    rc = r == NOTOK ? NOTOK : OK;
+
+done:
+    job->err = rc == OK ? OK : db_err_code;
+    ExtSortClose(&s);
+    free(ent);
+    return NULL;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION mergeWorker (arg)
+
+PARAMETER DESCRIPTION:
+    arg → ParSortJob of output range job->id.
+
+FUNCTION DESCRIPTION:
+    Phase 2: merges range id of every part file into "<prefix>.out<id>".
+
+RETURNS:
+    NULL; the outcome is left in job->err and job->numEnts.
+
+------------------------------------------------------------*/
+
+static void *mergeWorker(void *arg)
+{
+    ParSortJob *job = arg;
+    ParSort *ps = job->ps;
+    int P = ps->numThreads, k = 0, rc = OK;
+    char fname[sizeof(ps->prefix) + 16];
+    FILE **runs = malloc(P * sizeof(FILE *));
+    long *counts = malloc(P * sizeof(long));
+    char *ent = malloc(ps->entSize);
+    ExtMerge m;
+
+    job->numEnts = 0;
+    memset(&m, 0, sizeof(ExtMerge));
+
+    if(!runs || !counts || !ent)
+    {
+        free(runs);
+        free(counts);
+        free(ent);
+        job->err = MEM_ALLOC_ERROR;
+        return NULL;
+    }
+
+    for(int i = 0; i < P && rc == OK; i++)
+    {
+        long *b = ps->bounds + (long)i * (P + 1);
+
+        if(b[job->id + 1] == b[job->id])
+            continue;
+
+        build_part_filename(ps, "part", i, fname, sizeof(fname));
+        runs[k] = fopen(fname, "rb");
+
+        if(!runs[k] || fseek(runs[k], b[job->id] * ps->entSize, SEEK_SET) != 0)
+        {
+            if(runs[k])
+                fclose(runs[k]);
+            db_err_code = FILESYSTEM_ERROR;
+            rc = NOTOK;
+            break;
+        }
+
+        setvbuf(runs[k], NULL, _IOFBF, SORT_MERGE_BUF);
+        counts[k++] = b[job->id + 1] - b[job->id];
+    }
+
+    if(rc == NOTOK)
+    {
+        while(--k >= 0)
+            fclose(runs[k]);
+    }
+    else
+    {
+        rc = ExtMergeOpen(&m, ps->entSize, ps->cmp, ps->ctx, runs, counts, k);
+    }
+
+    FILE *out = NULL;
+    if(rc == OK)
+    {
+        build_part_filename(ps, "out", job->id, fname, sizeof(fname));
+        out = fopen(fname, "wb");
+        if(!out)
+        {
+            db_err_code = FILESYSTEM_ERROR;
+            rc = NOTOK;
+        }
+    }
+
+    int r;
+    while(rc == OK && (r = ExtMergeNext(&m, ent)) != 0)
+    {
+        if(r == NOTOK || fwrite(ent, ps->entSize, 1, out) != 1)
+        {
+            db_err_code = FILESYSTEM_ERROR;
+            rc = NOTOK;
+            break;
+        }
+        job->numEnts++;
+    }
+
+    if(out && fclose(out) != 0 && rc == OK)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        rc = NOTOK;
+    }
+
+    job->err = rc == OK ? OK : db_err_code;
+    ExtMergeClose(&m);
+    free(runs);
+    free(counts);
+    free(ent);
+    return NULL;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION findSplits (ps, jobs)
+
+PARAMETER DESCRIPTION:
+    ps   → parallel sort descriptor; ps->bounds is filled in.
+    jobs → phase 1 jobs, giving the number of entries of every part.
+
+FUNCTION DESCRIPTION:
+    Chooses numThreads - 1 splitters from a sample of every part and locates each of them in every part.
+
+ALGORITHM:
+    1) Read SORT_SAMPLES evenly spaced entries of every non-empty part and sort them.
+    2) Splitter j (1 <= j < P) is sample j * numSamples / P.
+    3) bounds[i][j] = first entry of part i not below splitter j (binary search with pread()),
+       bounds[i][0] = 0 and bounds[i][P] = number of entries of part i.
+
+RETURNS:
+    OK or NOTOK (db_err_code set).
+
+------------------------------------------------------------*/
+
+static int findSplits(ParSort *ps, ParSortJob *jobs)
+{
+    int P = ps->numThreads, numSamples = 0, rc = OK;
+    char fname[sizeof(ps->prefix) + 16];
+    char *samples = malloc((size_t)P * SORT_SAMPLES * ps->entSize);
+    char *ent = malloc(ps->entSize);
+    int *fds = malloc(P * sizeof(int));
+
+    if(!samples || !ent || !fds)
+    {
+        free(samples);
+        free(ent);
+        free(fds);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    for(int i = 0; i < P; i++)
+        fds[i] = -1;
+
+    for(int i = 0; i < P && rc == OK; i++)
+    {
+        build_part_filename(ps, "part", i, fname, sizeof(fname));
+        fds[i] = open(fname, O_RDONLY);
+
+        if(fds[i] < 0)
+        {
+            rc = NOTOK;
+            break;
+        }
+
+        for(int t = 0; jobs[i].numEnts > 0 && t < SORT_SAMPLES; t++)
+        {
+            long idx = jobs[i].numEnts * (2 * t + 1) / (2 * SORT_SAMPLES);
+            char *dst = samples + (long)numSamples * ps->entSize;
+
+            if(pread(fds[i], dst, ps->entSize, (off_t)idx * ps->entSize) != ps->entSize)
+            {
+                rc = NOTOK;
+                break;
+            }
+            numSamples++;
+        }
+    }
+
+    if(rc == OK)
+        qsort_r(samples, numSamples, ps->entSize, ps->cmp, ps->ctx);
+
+    for(int i = 0; i < P && rc == OK; i++)
+    {
+        long *b = ps->bounds + (long)i * (P + 1);
+        b[0] = 0;
+        b[P] = jobs[i].numEnts;
+
+        for(int j = 1; j < P && rc == OK; j++)
+        {
+            char *split = samples + (long)j * numSamples / P * ps->entSize;
+            long lo = b[j - 1], hi = b[P];
+
+            while(lo < hi)
+            {
+                long mid = lo + (hi - lo) / 2;
+
+                if(pread(fds[i], ent, ps->entSize, (off_t)mid * ps->entSize) != ps->entSize)
+                {
+                    rc = NOTOK;
+                    break;
+                }
+
+                if(ps->cmp(ent, split, ps->ctx) < 0)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            b[j] = lo;
+        }
+    }
+
+    for(int i = 0; i < P; i++)
+        if(fds[i] >= 0)
+            close(fds[i]);
+
+    free(samples);
+    free(ent);
+    free(fds);
+
+    if(rc == NOTOK)
+        db_err_code = FILESYSTEM_ERROR;
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ParSortThreads (relNum)
+
+PARAMETER DESCRIPTION:
+    relNum → open relation to be sorted.
+
+FUNCTION DESCRIPTION:
+    Number of workers worth starting for the relation: one per online CPU, at most SORT_MAX_THREADS,
+    and at least SORT_PAR_MIN_PGS heap pages per worker.
+
+RETURNS:
+    Number of workers; below 2 the caller should sort single-threaded.
+
+------------------------------------------------------------*/
+
+int ParSortThreads(int relNum)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    long n = catcache[relNum].relcat_rec.numPgs / SORT_PAR_MIN_PGS;
+
+    n = MIN(n, MIN(cpus, SORT_MAX_THREADS));
+    return n < 1 ? 1 : (int)n;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ParSortRel (relNum, numThreads, cmp, ctx, memBytes, prefix, sink, arg)
+
+PARAMETER DESCRIPTION:
+    relNum     → open relation to be sorted.
+    numThreads → number of workers (see ParSortThreads()).
+    cmp        → comparator over entries, i.e. a record followed by its int position pid * recsPerPg + slot.
+    ctx        → opaque pointer handed to every cmp call; shared by all workers, so it must not be modified by cmp.
+    memBytes   → total memory budget, split evenly between the workers.
+    prefix     → prefix of the temporary files, created in the database directory.
+    sink       → called on the calling thread with every entry, in cmp order.
+    arg        → opaque pointer handed to every sink call.
+
+FUNCTION DESCRIPTION:
+    Sorts every record of relNum with numThreads workers: parallel run generation over disjoint page ranges,
+    then a merge partitioned by sampled splitters so every worker produces a disjoint range of the output.
+    The sink may write to other relations through the buffer pool; the workers only read the relation file.
+
+ALGORITHM:
+    1) Flush the buffered page of relNum so the file is current.
+    2) Start runWorker() on numThreads page ranges and wait for all of them.
+    3) findSplits().
+    4) Start mergeWorker() for every range; join them in range order, streaming each output file into sink.
+    5) Remove every temporary file.
+
+RETURNS:
+    OK or NOTOK (db_err_code set, taken from the failing worker when it is a worker that failed).
+
+ERRORS REPORTED:
+    MEM_ALLOC_ERROR
+    FILESYSTEM_ERROR
+    UNKNOWN_ERROR (a thread could not be started)
+    Any error returned by sink.
+
+GLOBAL VARIABLES MODIFIED:
+    db_err_code
+
+------------------------------------------------------------*/
+
+int ParSortRel(int relNum, int numThreads, ExtSortCmp cmp, void *ctx, long memBytes, const char *prefix,
+               ParSortSink sink, void *arg)
+{
+    ParSort ps;
+    RelCatRec *rc_rec = &catcache[relNum].relcat_rec;
+    int P = MAX(1, MIN(numThreads, MAX(1, rc_rec->numPgs))), started = 0, rc = OK;
+    char fname[sizeof(ps.prefix) + 16];
+
+    if(FlushPage(relNum) == NOTOK)
+        return NOTOK;
+
+    ps.fd = catcache[relNum].relFile;
+    ps.entry = &catcache[relNum];
+    ps.recSize = rc_rec->recLength;
+    ps.recsPerPg = rc_rec->recsPerPg;
+    ps.entSize = ps.recSize + sizeof(int);
+    ps.cmp = cmp;
+    ps.ctx = ctx;
+    ps.memBytes = MAX(memBytes / P, (long)SORT_MERGE_BUF);
+    ps.numThreads = P;
+    snprintf(ps.prefix, sizeof(ps.prefix), "%s", prefix);
+
+    ParSortJob *jobs = calloc(P, sizeof(ParSortJob));
+    ps.bounds = malloc((size_t)P * (P + 1) * sizeof(long));
+    char *ent = malloc(ps.entSize);
+
+    if(!jobs || !ps.bounds || !ent)
+    {
+        free(jobs);
+        free(ps.bounds);
+        free(ent);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    /* Phase 1: sorted part per page range */
+    for(int i = 0; i < P; i++)
+    {
+        jobs[i].ps = &ps;
+        jobs[i].id = i;
+        jobs[i].loPg = (int)((long)rc_rec->numPgs * i / P);
+        jobs[i].hiPg = (int)((long)rc_rec->numPgs * (i + 1) / P);
+
+        if(pthread_create(&jobs[i].tid, NULL, runWorker, &jobs[i]) != 0)
+        {
+            db_err_code = UNKNOWN_ERROR;
+            rc = NOTOK;
+            break;
+        }
+        started++;
+    }
+
+    for(int i = 0; i < started; i++)
+    {
+        pthread_join(jobs[i].tid, NULL);
+        if(jobs[i].err != OK && rc == OK)
+        {
+            db_err_code = jobs[i].err;
+            rc = NOTOK;
+        }
+    }
+
+    if(rc == OK)
+        rc = findSplits(&ps, jobs);
+
+    /* Phase 2: every worker merges one key range; ranges are consumed in order */
+    started = 0;
+    for(int j = 0; rc == OK && j < P; j++)
+    {
+        if(pthread_create(&jobs[j].tid, NULL, mergeWorker, &jobs[j]) != 0)
+        {
+            db_err_code = UNKNOWN_ERROR;
+            rc = NOTOK;
+            break;
+        }
+        started++;
+    }
+
+    for(int j = 0; j < started; j++)
+    {
+        pthread_join(jobs[j].tid, NULL);
+
+        if(rc == OK && jobs[j].err != OK)
+        {
+            db_err_code = jobs[j].err;
+            rc = NOTOK;
+        }
+        if(rc == NOTOK)
+            continue;
+
+        build_part_filename(&ps, "out", j, fname, sizeof(fname));
+        FILE *in = fopen(fname, "rb");
+
+        if(!in)
+        {
+            db_err_code = FILESYSTEM_ERROR;
+            rc = NOTOK;
+            continue;
+        }
+
+        setvbuf(in, NULL, _IOFBF, SORT_MERGE_BUF);
+        for(long n = 0; rc == OK && n < jobs[j].numEnts; n++)
+        {
+            if(fread(ent, ps.entSize, 1, in) != 1)
+            {
+                db_err_code = FILESYSTEM_ERROR;
+                rc = NOTOK;
+            }
+            else if(sink(ent, arg) == NOTOK)
+            {
+                rc = NOTOK;
+            }
+        }
+        fclose(in);
+    }
+
+    for(int i = 0; i < P; i++)
+    {
+        build_part_filename(&ps, "part", i, fname, sizeof(fname));
+        remove(fname);
+        build_part_filename(&ps, "out", i, fname, sizeof(fname));
+        remove(fname);
+    }
+
+    free(jobs);
+    free(ps.bounds);
+    free(ent);
+    return rc;
+}
\ No newline at end of file
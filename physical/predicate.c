@@ -0,0 +1,531 @@
+/************************INCLUDES*******************************/
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PRED_HAVE_AVX2  1
+#endif
+#include "../include/defs.h"
+#include "../include/helpers.h"
+#include "../include/predicate.h"
+
+/*
+ * Predicate kernels.
+ *
+ * Every (type, operator) pair has its own kernel, generated by the *_KERNEL macros below, so the
+ * per-record work of a scan is one indirect call with no switch on the attribute type or the
+ * comparison operator.  PredInit() picks the kernel and pre-computes whatever only depends on the
+ * literal (the literal's share of the float tolerance), once per scan.
+ *
+ * The kernels reproduce compareRecs() exactly: ints and dates compare as signed ints of their width,
+ * strings as strncmp() over the attribute length, floats with the tolerance of float_cmp() and
+ * 8-byte doubles exactly.  A NaN attribute only satisfies '!=', and so does everything compared
+ * with a NaN literal.
+ *
+ * Page kernels evaluate one predicate over all slots of a page and return a bitmask of matching
+ * slots, which scans AND with the page's slotmap.  Int attributes and float attributes with a
+ * finite literal get AVX2 kernels that gather 8 attributes per instruction from the strided
+ * record array; PredInit() selects them when __builtin_cpu_supports("avx2") says the CPU has the
+ * instructions.  Everything else (strings, other widths, other CPUs) uses pageScalar(), which
+ * applies the record kernel to each live slot.
+ */
+
+/* Kernel tables are indexed by compOp - CMP_EQ, i.e. in the order EQ, GTE, GT, LTE, NE, LT */
+#define DEFINE_KERNELS(FAMILY, KERNEL)  \
+    KERNEL(FAMILY##Eq, ==, 0)           \
+    KERNEL(FAMILY##Ge, >=, 0)           \
+    KERNEL(FAMILY##Gt, >,  0)           \
+    KERNEL(FAMILY##Le, <=, 0)           \
+    KERNEL(FAMILY##Ne, !=, 1)           \
+    KERNEL(FAMILY##Lt, <,  0)
+
+#define KERNEL_TABLE(FAMILY) \
+    { FAMILY##Eq, FAMILY##Ge, FAMILY##Gt, FAMILY##Le, FAMILY##Ne, FAMILY##Lt }
+
+#define KERNEL_TABLE_SUFFIX(FAMILY, SUFFIX) \
+    { FAMILY##Eq##SUFFIX, FAMILY##Ge##SUFFIX, FAMILY##Gt##SUFFIX, FAMILY##Le##SUFFIX, FAMILY##Ne##SUFFIX, FAMILY##Lt##SUFFIX }
+
+/* Nonzero when some byte of the 64-bit word w is 0 */
+#define WORD_HAS_ZERO(w)    (((w) - 0x0101010101010101ULL) & ~(w) & 0x8080808080808080ULL)
+
+
+/*------------------------------------------------------------
+
+FUNCTION strKeyCmp (a, b, n, bLen)
+
+PARAMETER DESCRIPTION:
+    a, b → fixed-width string fields.
+    n    → field width in bytes.
+    bLen → bytes of b that may be read (b may be a literal shorter than the field).
+
+FUNCTION DESCRIPTION:
+    strncmp(a, b, n) reduced to -1, 0 or 1.
+    Equal 8-byte words without a NUL are skipped with one load each; the first word that differs or
+    ends a string is finished byte by byte, so bytes after a terminator never affect the result.
+
+RETURNS:
+    -1, 0 or 1.
+
+------------------------------------------------------------*/
+
+static inline int strKeyCmp(const unsigned char *a, const unsigned char *b, int n, int bLen)
+{
+    int i = 0;
+
+    for(; i + (int)sizeof(uint64_t) <= MIN(n, bLen); i += sizeof(uint64_t))
+    {
+        uint64_t x, y;
+        memcpy(&x, a + i, sizeof(x));
+        memcpy(&y, b + i, sizeof(y));
+
+        if(x != y || WORD_HAS_ZERO(x))
+            break;
+    }
+
+    for(; i < n; i++)
+    {
+        if(a[i] != b[i])
+            return a[i] < b[i] ? -1 : 1;
+        if(!a[i])
+            return 0;
+    }
+    return 0;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION fltKeyCmp (rec, p)
+
+PARAMETER DESCRIPTION:
+    rec → record image.
+    p   → compiled predicate on a float attribute with a finite literal.
+
+FUNCTION DESCRIPTION:
+    float_cmp(attr, literal, FLOAT_REL_EPS, FLOAT_ABS_EPS) with the literal's part of the tolerance taken from p->ftol.
+    max(abs, rel * max(|a|, |b|)) equals max(max(abs, rel * |b|), rel * |a|), so the result is identical.
+
+RETURNS:
+    -1, 0 or 1, or 2 if the attribute is NaN.
+
+------------------------------------------------------------*/
+
+static inline int fltKeyCmp(const void *rec, const Pred *p)
+{
+    float x;
+    memcpy(&x, (const char *)rec + p->offset, sizeof(float));
+    double a = x;
+
+    if(isnan(a))
+        return 2;
+
+    if(isinf(a))
+        return (a > p->fval) - (a < p->fval);
+
+    double diff = a - p->fval;
+    double tol = dmax(p->ftol, FLOAT_REL_EPS * fabs(a));
+
+    if(fabs(diff) <= tol)
+        return 0;
+    return diff > 0 ? 1 : -1;
+}
+
+
+#define INT_KERNEL(NAME, OP, NANRES)                                \
+static int NAME(const void *rec, const Pred *p)                     \
+{                                                                   \
+    int x;                                                          \
+    memcpy(&x, (const char *)rec + p->offset, sizeof(int));         \
+    return x OP p->ival;                                            \
+}
+
+/* Ints of 1, 2 and 8 bytes, compared with the literal widened to long long */
+#define INTN_KERNEL(NAME, OP, CTYPE)                                \
+static int NAME(const void *rec, const Pred *p)                     \
+{                                                                   \
+    CTYPE x;                                                        \
+    memcpy(&x, (const char *)rec + p->offset, sizeof(CTYPE));       \
+    return x OP p->lval;                                            \
+}
+
+#define INT8_KERNEL(NAME, OP, NANRES)   INTN_KERNEL(NAME, OP, int8_t)
+#define INT16_KERNEL(NAME, OP, NANRES)  INTN_KERNEL(NAME, OP, int16_t)
+#define INT64_KERNEL(NAME, OP, NANRES)  INTN_KERNEL(NAME, OP, int64_t)
+
+/* Doubles compare exactly, as compareVals() does */
+#define DBL_KERNEL(NAME, OP, NANRES)                                \
+static int NAME(const void *rec, const Pred *p)                     \
+{                                                                   \
+    double x;                                                       \
+    memcpy(&x, (const char *)rec + p->offset, sizeof(double));      \
+    return x OP p->fval;                                            \
+}
+
+/* Infinite and NaN literals: float_cmp() is exact there, and C comparisons give NaN its '!=' only semantics */
+#define FLT_EXACT_KERNEL(NAME, OP, NANRES)                          \
+static int NAME(const void *rec, const Pred *p)                     \
+{                                                                   \
+    float x;                                                        \
+    memcpy(&x, (const char *)rec + p->offset, sizeof(float));       \
+    return (double)x OP p->fval;                                    \
+}
+
+#define FLT_KERNEL(NAME, OP, NANRES)                                \
+static int NAME(const void *rec, const Pred *p)                     \
+{                                                                   \
+    int c = fltKeyCmp(rec, p);                                      \
+    return c == 2 ? NANRES : c OP 0;                                \
+}
+
+#define STR_KERNEL(NAME, OP, NANRES)                                \
+static int NAME(const void *rec, const Pred *p)                     \
+{                                                                   \
+    return strKeyCmp((const unsigned char *)rec + p->offset,        \
+                     (const unsigned char *)p->sval, p->size, p->slen) OP 0; \
+}
+
+DEFINE_KERNELS(predInt, INT_KERNEL)
+DEFINE_KERNELS(predInt8, INT8_KERNEL)
+DEFINE_KERNELS(predInt16, INT16_KERNEL)
+DEFINE_KERNELS(predInt64, INT64_KERNEL)
+DEFINE_KERNELS(predDbl, DBL_KERNEL)
+DEFINE_KERNELS(predFltExact, FLT_EXACT_KERNEL)
+DEFINE_KERNELS(predFlt, FLT_KERNEL)
+DEFINE_KERNELS(predStr, STR_KERNEL)
+
+static const PredFn intKernels[] = KERNEL_TABLE(predInt);
+static const PredFn int8Kernels[] = KERNEL_TABLE(predInt8);
+static const PredFn int16Kernels[] = KERNEL_TABLE(predInt16);
+static const PredFn int64Kernels[] = KERNEL_TABLE(predInt64);
+static const PredFn dblKernels[] = KERNEL_TABLE(predDbl);
+static const PredFn fltExactKernels[] = KERNEL_TABLE(predFltExact);
+static const PredFn fltKernels[] = KERNEL_TABLE(predFlt);
+static const PredFn strKernels[] = KERNEL_TABLE(predStr);
+
+
+/* Bits 0 .. numSlots - 1 set */
+#define SLOT_MASK(numSlots) \
+    ((numSlots) >= (int)(8 * sizeof(unsigned long)) ? ~0UL : (1UL << (numSlots)) - 1)
+
+
+/* Portable page kernel: the record kernel applied to every live slot */
+static unsigned long pageScalar(const Pred *p, const char *recs, int recSize, int numSlots, unsigned long live)
+{
+    unsigned long match = 0;
+
+    live &= SLOT_MASK(numSlots);
+
+    while(live)
+    {
+        int slot = __builtin_ctzl(live);
+
+        if(PredEval(p, recs + slot * recSize))
+            match |= 1UL << slot;
+        live &= live - 1;
+    }
+    return match;
+}
+
+
+#ifdef PRED_HAVE_AVX2
+
+/*
+ * AVX2 page kernels.  Each iteration gathers the attribute of 8 consecutive slots; lanes past the
+ * last slot re-read the last slot and are cleared by the final AND.  Comparison results become
+ * one bit per slot through movemask.
+ */
+
+#define AVX2_INT_CMP_EQ(v, lit)     _mm256_cmpeq_epi32((v), (lit))
+#define AVX2_INT_CMP_NE(v, lit)     _mm256_xor_si256(_mm256_cmpeq_epi32((v), (lit)), _mm256_set1_epi32(-1))
+#define AVX2_INT_CMP_GT(v, lit)     _mm256_cmpgt_epi32((v), (lit))
+#define AVX2_INT_CMP_LT(v, lit)     _mm256_cmpgt_epi32((lit), (v))
+#define AVX2_INT_CMP_GE(v, lit)     _mm256_xor_si256(_mm256_cmpgt_epi32((lit), (v)), _mm256_set1_epi32(-1))
+#define AVX2_INT_CMP_LE(v, lit)     _mm256_xor_si256(_mm256_cmpgt_epi32((v), (lit)), _mm256_set1_epi32(-1))
+
+#define AVX2_INT_PAGE_KERNEL(NAME, CMP)                                                             \
+__attribute__((target("avx2")))                                                                    \
+static unsigned long NAME(const Pred *p, const char *recs, int recSize, int numSlots, unsigned long live) \
+{                                                                                                   \
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);                                 \
+    const __m256i last = _mm256_set1_epi32(numSlots - 1);                                           \
+    const __m256i stride = _mm256_set1_epi32(recSize);                                              \
+    const __m256i lit = _mm256_set1_epi32(p->ival);                                                 \
+    const int *base = (const int *)(recs + p->offset);                                              \
+    unsigned long match = 0;                                                                        \
+                                                                                                    \
+    for(int s = 0; s < numSlots; s += 8)                                                            \
+    {                                                                                               \
+        __m256i slot = _mm256_min_epi32(_mm256_add_epi32(lane, _mm256_set1_epi32(s)), last);        \
+        __m256i v = _mm256_i32gather_epi32(base, _mm256_mullo_epi32(slot, stride), 1);              \
+        unsigned bits = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(CMP(v, lit)));             \
+        match |= (unsigned long)bits << s;                                                          \
+    }                                                                                               \
+    return match & live & SLOT_MASK(numSlots);                                                      \
+}
+
+AVX2_INT_PAGE_KERNEL(pageIntEqAvx2, AVX2_INT_CMP_EQ)
+AVX2_INT_PAGE_KERNEL(pageIntGeAvx2, AVX2_INT_CMP_GE)
+AVX2_INT_PAGE_KERNEL(pageIntGtAvx2, AVX2_INT_CMP_GT)
+AVX2_INT_PAGE_KERNEL(pageIntLeAvx2, AVX2_INT_CMP_LE)
+AVX2_INT_PAGE_KERNEL(pageIntNeAvx2, AVX2_INT_CMP_NE)
+AVX2_INT_PAGE_KERNEL(pageIntLtAvx2, AVX2_INT_CMP_LT)
+
+/*
+ * Float page kernels work on 4 doubles at a time with the arithmetic of fltKeyCmp():
+ * eq is |a - b| <= max(ftol, rel * |a|) for finite a, and the sign of a - b orders the rest.
+ * Ordered compares are false for NaN lanes, so a NaN attribute only satisfies '!='.
+ */
+#define AVX2_FLT_CMP_EQ(eq, pos, neg)   (eq)
+#define AVX2_FLT_CMP_NE(eq, pos, neg)   _mm256_xor_pd((eq), _mm256_castsi256_pd(_mm256_set1_epi32(-1)))
+#define AVX2_FLT_CMP_GT(eq, pos, neg)   _mm256_andnot_pd((eq), (pos))
+#define AVX2_FLT_CMP_LT(eq, pos, neg)   _mm256_andnot_pd((eq), (neg))
+#define AVX2_FLT_CMP_GE(eq, pos, neg)   _mm256_or_pd((eq), (pos))
+#define AVX2_FLT_CMP_LE(eq, pos, neg)   _mm256_or_pd((eq), (neg))
+
+__attribute__((target("avx2")))
+static inline unsigned fltLanes(__m256d a, const Pred *p, int op)
+{
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+    const __m256d b = _mm256_set1_pd(p->fval);
+    const __m256d zero = _mm256_setzero_pd();
+
+    __m256d absA = _mm256_and_pd(a, absMask);
+    __m256d diff = _mm256_sub_pd(a, b);
+    __m256d tol = _mm256_max_pd(_mm256_mul_pd(_mm256_set1_pd(FLOAT_REL_EPS), absA), _mm256_set1_pd(p->ftol));
+    __m256d inf = _mm256_cmp_pd(absA, _mm256_set1_pd(INFINITY), _CMP_EQ_OQ);
+    __m256d eq = _mm256_andnot_pd(inf, _mm256_cmp_pd(_mm256_and_pd(diff, absMask), tol, _CMP_LE_OQ));
+    __m256d pos = _mm256_cmp_pd(diff, zero, _CMP_GT_OQ);
+    __m256d neg = _mm256_cmp_pd(diff, zero, _CMP_LT_OQ);
+    __m256d r;
+
+    switch(op)
+    {
+        case CMP_EQ:  r = AVX2_FLT_CMP_EQ(eq, pos, neg); break;
+        case CMP_GTE: r = AVX2_FLT_CMP_GE(eq, pos, neg); break;
+        case CMP_GT:  r = AVX2_FLT_CMP_GT(eq, pos, neg); break;
+        case CMP_LTE: r = AVX2_FLT_CMP_LE(eq, pos, neg); break;
+        case CMP_NE:  r = AVX2_FLT_CMP_NE(eq, pos, neg); break;
+        default:      r = AVX2_FLT_CMP_LT(eq, pos, neg);
+    }
+    return (unsigned)_mm256_movemask_pd(r);
+}
+
+/* op is a constant in each instance, so the switch in the inlined fltLanes() folds away */
+#define AVX2_FLT_PAGE_KERNEL(NAME, OP)                                                              \
+__attribute__((target("avx2")))                                                                    \
+static unsigned long NAME(const Pred *p, const char *recs, int recSize, int numSlots, unsigned long live) \
+{                                                                                                   \
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);                                 \
+    const __m256i last = _mm256_set1_epi32(numSlots - 1);                                           \
+    const __m256i stride = _mm256_set1_epi32(recSize);                                              \
+    const float *base = (const float *)(recs + p->offset);                                          \
+    unsigned long match = 0;                                                                        \
+                                                                                                    \
+    for(int s = 0; s < numSlots; s += 8)                                                            \
+    {                                                                                               \
+        __m256i slot = _mm256_min_epi32(_mm256_add_epi32(lane, _mm256_set1_epi32(s)), last);        \
+        __m256 v = _mm256_i32gather_ps(base, _mm256_mullo_epi32(slot, stride), 1);                  \
+        unsigned lo = fltLanes(_mm256_cvtps_pd(_mm256_castps256_ps128(v)), p, OP);                  \
+        unsigned hi = fltLanes(_mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)), p, OP);                \
+        match |= (unsigned long)(lo | hi << 4) << s;                                                \
+    }                                                                                               \
+    return match & live & SLOT_MASK(numSlots);                                                      \
+}
+
+AVX2_FLT_PAGE_KERNEL(pageFltEqAvx2, CMP_EQ)
+AVX2_FLT_PAGE_KERNEL(pageFltGeAvx2, CMP_GTE)
+AVX2_FLT_PAGE_KERNEL(pageFltGtAvx2, CMP_GT)
+AVX2_FLT_PAGE_KERNEL(pageFltLeAvx2, CMP_LTE)
+AVX2_FLT_PAGE_KERNEL(pageFltNeAvx2, CMP_NE)
+AVX2_FLT_PAGE_KERNEL(pageFltLtAvx2, CMP_LT)
+
+static const PredPageFn intPageKernelsAvx2[] = KERNEL_TABLE_SUFFIX(pageInt, Avx2);
+static const PredPageFn fltPageKernelsAvx2[] = KERNEL_TABLE_SUFFIX(pageFlt, Avx2);
+
+#endif
+
+
+/* Kernel of an unknown type or operator; compareRecs() treats those as no match */
+static int predFalse(const void *rec, const Pred *p)
+{
+    (void)rec;
+    (void)p;
+    return 0;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PredInit (p, attrType, attrSize, attrOffset, valuePtr, compOp)
+
+PARAMETER DESCRIPTION:
+    p          → (OUT) predicate to compile.
+    attrType   → 'i', 'f', 'd' or 's'.
+    attrSize   → attribute length in bytes; ints take 1, 2, 4 or 8, floats 4 or 8.
+    attrOffset → byte offset of the attribute inside a record.
+    valuePtr   → literal in the attribute's type.
+    compOp     → CMP_EQ, CMP_NE, CMP_LT, CMP_LTE, CMP_GT or CMP_GTE.
+
+FUNCTION DESCRIPTION:
+    Resolves "attr op literal" into the kernel for its type and operator; PredEval(p, rec) then gives
+    the same answer as compareRecs(rec, valuePtr, attrType, attrSize, attrOffset, compOp).
+    Also selects the page kernel used by PredEvalPage(): AVX2 for 4-byte ints and dates and for 4-byte
+    floats with a finite literal when the CPU supports it, pageScalar() otherwise.
+    Int and float literals are copied into p; a string literal is referenced, so valuePtr must
+    outlive p.
+
+RETURNS:
+    None.
+
+------------------------------------------------------------*/
+
+void PredInit(Pred *p, char attrType, int attrSize, int attrOffset, const void *valuePtr, int compOp)
+{
+    memset(p, 0, sizeof(Pred));
+    p->offset = attrOffset;
+    p->size = attrSize;
+    p->fn = predFalse;
+    p->pageFn = pageScalar;
+
+    if(compOp < CMP_EQ || compOp > CMP_LT)
+        return;
+
+    int op = compOp - CMP_EQ;
+#ifdef PRED_HAVE_AVX2
+    int avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+    switch(attrType)
+    {
+        case 'i':
+        case 'd':
+            if(attrSize != sizeof(int))
+            {
+                p->lval = getIntValue(valuePtr, attrSize);
+                p->fn = attrSize == 1 ? int8Kernels[op] : attrSize == 2 ? int16Kernels[op] : int64Kernels[op];
+                break;
+            }
+            memcpy(&p->ival, valuePtr, sizeof(int));
+            p->fn = intKernels[op];
+#ifdef PRED_HAVE_AVX2
+            if(avx2)
+                p->pageFn = intPageKernelsAvx2[op];
+#endif
+            break;
+        case 'f':
+        {
+            if(attrSize == sizeof(double))
+            {
+                memcpy(&p->fval, valuePtr, sizeof(double));
+                p->fn = dblKernels[op];
+                break;
+            }
+
+            float f;
+            memcpy(&f, valuePtr, sizeof(float));
+            p->fval = f;
+            p->ftol = dmax(FLOAT_ABS_EPS, FLOAT_REL_EPS * fabs(p->fval));
+            p->fn = isfinite(p->fval) ? fltKernels[op] : fltExactKernels[op];
+#ifdef PRED_HAVE_AVX2
+            if(avx2 && isfinite(p->fval))
+                p->pageFn = fltPageKernelsAvx2[op];
+#endif
+            break;
+        }
+        case 's':
+            p->sval = valuePtr;
+            p->slen = strnlen(valuePtr, attrSize) + 1;
+            p->fn = strKernels[op];
+            break;
+    }
+}
+
+/* Kernel of PredInitCodes(): the flag of the record's dictionary code */
+static int predCodeIn(const void *rec, const Pred *p)
+{
+    int code;
+    memcpy(&code, (const char *)rec + p->offset, sizeof(int));
+    return code >= 0 && code < p->numCodes && p->codeMatch[code];
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PredInitCodes (p, attrOffset, codeMatch, numCodes)
+
+PARAMETER DESCRIPTION:
+    p          → (OUT) predicate to compile.
+    attrOffset → byte offset of an int dictionary code inside a record.
+    codeMatch  → numCodes flags, 1 for the codes that satisfy the predicate (see DictMatch()).
+    numCodes   → codes of the dictionary.
+
+FUNCTION DESCRIPTION:
+    Compiles a predicate on the codes of a dictionary-encoded attribute whose operator codes cannot
+    answer by themselves; codeMatch is referenced, so it must outlive p.
+
+------------------------------------------------------------*/
+
+void PredInitCodes(Pred *p, int attrOffset, const unsigned char *codeMatch, int numCodes)
+{
+    memset(p, 0, sizeof(Pred));
+    p->offset = attrOffset;
+    p->size = sizeof(int);
+    p->codeMatch = codeMatch;
+    p->numCodes = numCodes;
+    p->fn = predCodeIn;
+    p->pageFn = pageScalar;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION PredEvalSel (p, col, numRows, sel, numSel, out)
+
+PARAMETER DESCRIPTION:
+    p       → predicate compiled with attrOffset 0, so that a record is one value of the column.
+    col     → column of numRows values, p->size bytes apart.
+    numRows → values in col.
+    sel     → numSel row numbers to test, in ascending order.
+    out     → (OUT) the rows of sel that satisfy p, in the same order; may be sel itself.
+
+FUNCTION DESCRIPTION:
+    Refines the selection vector of a column batch (algebra/iterator.c).
+
+ALGORITHM:
+    1) Gather the rows of sel falling in the same run of 64 rows into a live mask.
+    2) Evaluate the run with the page kernel, which treats the column as 64 records of p->size bytes.
+    3) Append the rows of the match mask to out.
+
+RETURNS:
+    Number of rows written to out.
+
+IMPLEMENTATION NOTES:
+    • A run is read before any of its rows is written, so refining sel in place is safe.
+
+------------------------------------------------------------*/
+
+int PredEvalSel(const Pred *p, const char *col, int numRows, const short *sel, int numSel, short *out)
+{
+    const int runLen = 8 * sizeof(unsigned long);
+    int n = 0;
+
+    for(int k = 0; k < numSel; )
+    {
+        int base = sel[k] & ~(runLen - 1);
+        unsigned long live = 0;
+
+        while(k < numSel && sel[k] - base < runLen)
+            live |= 1UL << (sel[k++] - base);
+
+        unsigned long match = PredEvalPage(p, col + base * p->size, p->size, MIN(runLen, numRows - base), live);
+
+        while(match)
+        {
+            out[n++] = base + __builtin_ctzl(match);
+            match &= match - 1;
+        }
+    }
+    return n;
+}
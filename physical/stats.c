@@ -0,0 +1,613 @@
+/************************INCLUDES*******************************/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/helpers.h"
+#include "../include/getnextpagerecs.h"
+#include "../include/writerec.h"
+#include "../include/stats.h"
+
+/*
+ * Optimizer statistics.
+ *
+ * "<relName>.stat" holds a RelStats header and one AttrStats per attribute: the number of values,
+ * an estimate of the number of distinct values, min/max and an equi-depth histogram.  StatsAnalyze()
+ * computes them in one scan of the relation: counts and min/max over every record, distinct counts
+ * and histograms over a reservoir sample of at most STAT_SAMPLE_ROWS records.  The distinct count
+ * d of a sample of n out of N values is scaled up with the GEE estimator, sqrt(N / n) * f1 + (d - f1),
+ * f1 being the number of values seen exactly once in the sample.
+ *
+ * Updates do not maintain the statistics.  Instead StatsGet() analyzes the relation again once its
+ * numRecs has drifted by more than STAT_DRIFT_PCT percent from the count they were computed on.
+ */
+
+
+/* AttrStats of the k-th attribute in the block following a RelStats */
+#define STATS_ATTR(rs, k) ((AttrStats *)((rs) + 1) + (k))
+
+
+/*------------------------------------------------------------
+
+FUNCTION build_stat_filename (relName, fname, buflen)
+
+FUNCTION DESCRIPTION:
+    Constructs "<relName>.stat", stored next to the heap file and its zone map.
+
+------------------------------------------------------------*/
+
+void build_stat_filename(const char *relName, char *fname, size_t buflen)
+{
+    snprintf(fname, buflen, "%s.stat", relName);
+}
+
+static size_t statsSize(int numAttrs)
+{
+    return sizeof(RelStats) + numAttrs * sizeof(AttrStats);
+}
+
+/* Compares two values of attr that are not NaN; strings over their first n bytes */
+static int statCmp(const void *a, const void *b, const AttrCatRec *attr, int n)
+{
+    if(attr->type[0] == 's')
+        return strncmp(a, b, n);
+    return compareNumeric(a, b, attr->type[0], attr->length);
+}
+
+/* qsort_r() comparator of pointers to values of the attribute passed as arg */
+static int valuePtrCmp(const void *a, const void *b, void *arg)
+{
+    const AttrCatRec *attr = arg;
+    return statCmp(*(char * const *)a, *(char * const *)b, attr, attr->length);
+}
+
+/* A float NaN satisfies no comparison but '!=', so it is left out of the statistics like a NULL */
+static int isNaNValue(const void *v, const AttrCatRec *attr)
+{
+    return attr->type[0] == 'f' && isnan(getFloatValue(v, attr->length));
+}
+
+/* Copies a value into a STAT_VALUE slot; a string keeps its first STAT_VALUE bytes */
+static void statStore(char *slot, const void *v, const AttrCatRec *attr)
+{
+    memset(slot, 0, STAT_VALUE);
+    if(attr->type[0] == 's')
+        strncpy(slot, v, MIN(attr->length, STAT_VALUE));
+    else
+        memcpy(slot, v, attr->length);
+}
+
+/* Square root by Newton's iteration, for x >= 1: MINIREL is not linked with libm */
+static double statSqrt(double x)
+{
+    double r = x;
+
+    for(int i = 0; i < 64 && r * r > x * (1 + 1e-12); i++)
+        r = (r + x / r) / 2;
+    return r;
+}
+
+/* Next value of the xorshift64 generator choosing the records of the sample */
+static unsigned long long statRandom(unsigned long long *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION summariseAttr (s, attr, vals, n, lo, hi)
+
+PARAMETER DESCRIPTION:
+    s    → (OUT) statistics of the attribute; s->numValues is set.
+    attr → attribute.
+    vals → pointers to the n values of the attribute in the sample, NaNs left out; sorted on return.
+    lo   → smallest value of the attribute in the relation.
+    hi   → largest value of the attribute in the relation.
+
+FUNCTION DESCRIPTION:
+    Fills in the distinct count and the histogram of an attribute from its sample.
+    Buckets hold n / STAT_BUCKETS sample values each, but a run of equal values is never split across
+    two buckets, so every value is counted in the bucket whose bound is the first one not below it.
+    Row counts are scaled from the sample to s->numValues, distinct counts to the GEE estimate.
+
+------------------------------------------------------------*/
+
+static void summariseAttr(AttrStats *s, const AttrCatRec *attr, char **vals, int n, const char *lo, const char *hi)
+{
+    if(s->numValues == 0)
+        return;
+
+    statStore(s->lo, lo, attr);
+    statStore(s->hi, hi, attr);
+
+    if(n == 0)
+    {
+        s->numDistinct = 1;
+        return;
+    }
+
+    qsort_r(vals, n, sizeof(char *), valuePtrCmp, (void *)attr);
+
+    int distinct = 0, once = 0;
+
+    for(int i = 0, j; i < n; i = j)
+    {
+        for(j = i + 1; j < n && valuePtrCmp(&vals[i], &vals[j], (void *)attr) == 0; j++)
+            ;
+        distinct++;
+        once += j - i == 1;
+    }
+
+    double estimate = distinct;
+
+    if(n < s->numValues)
+    {
+        estimate = statSqrt((double)s->numValues / n) * once + (distinct - once);
+        estimate = MIN(MAX(estimate, distinct), s->numValues);
+    }
+    s->numDistinct = (int)(estimate + 0.5);
+
+    int numBuckets = MIN(STAT_BUCKETS, n);
+    int b = 0;
+
+    for(int start = 0; start < n; b++)
+    {
+        int end = MAX(start, (int)((long long)(b + 1) * n / numBuckets) - 1);
+
+        while(end + 1 < n && valuePtrCmp(&vals[end], &vals[end + 1], (void *)attr) == 0)
+            end++;
+
+        int runs = 1;
+        for(int i = start + 1; i <= end; i++)
+            runs += valuePtrCmp(&vals[i - 1], &vals[i], (void *)attr) != 0;
+
+        statStore(s->bound[b], vals[end], attr);
+        s->bucketRows[b] = (int)((double)(end - start + 1) * s->numValues / n + 0.5);
+        s->bucketDistinct[b] = MAX(1, (int)(runs * estimate / distinct + 0.5));
+        start = end + 1;
+    }
+
+    s->numBuckets = b;
+    statStore(s->bound[b - 1], hi, attr);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION StatsAnalyze (relNum)
+
+PARAMETER DESCRIPTION:
+    relNum → open relation to analyze.
+
+FUNCTION DESCRIPTION:
+    Recomputes the statistics of every attribute of the relation, writes them to "<relName>.stat" and
+    keeps them in catcache[relNum].stats.  The distinct count of an attribute without an index is
+    also stored as its nKeys in attrcat; that of an indexed one was counted exactly when the index was built.
+
+ALGORITHM:
+    1) Scan the relation a page at a time with GetNextPageRecs().  For every record:
+        a) count the values of each attribute that are not NaN and keep the smallest and largest;
+        b) add the record to the sample while it has fewer than STAT_SAMPLE_ROWS records; otherwise the
+           i-th record replaces a random one of them with probability STAT_SAMPLE_ROWS / i (reservoir sampling).
+    2) For each attribute, sort its values in the sample and summarise them (summariseAttr()).
+    3) Write the header and the AttrStats to the file, then update nKeys in attrcat.
+
+RETURNS:
+    OK or NOTOK.
+
+ERRORS REPORTED:
+    MEM_ALLOC_ERROR
+    FILESYSTEM_ERROR
+
+GLOBAL VARIABLES MODIFIED:
+    catcache[relNum].stats
+    catcache[relNum] attrList[].attr.nKeys of attributes without an index
+
+IMPLEMENTATION NOTES:
+    • The scan neither pins nor unpins the relation, so it can run on behalf of a command that holds it open.
+    • The sample is drawn with a fixed seed: analyzing the same relation twice gives the same statistics.
+
+------------------------------------------------------------*/
+
+int StatsAnalyze(int relNum)
+{
+    CacheEntry *entry = &catcache[relNum];
+    int recLength = entry->relcat_rec.recLength;
+    int numAttrs = entry->relcat_rec.numAttrs;
+    int rc = NOTOK, n = 0, cap = 0;
+    long long seen = 0;
+    unsigned long long seed = 0x9E3779B97F4A7C15ULL;
+    char *sample = NULL;
+    char **vals = NULL;
+    RelStats *rs = calloc(1, statsSize(numAttrs));
+    char *loRec = malloc(recLength), *hiRec = malloc(recLength);
+
+    if(!rs || !loRec || !hiRec)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        goto done;
+    }
+
+    short pid = 0;
+    char *recs[MAX_RECS_PER_PG];
+    int numRecs;
+
+    do
+    {
+        if(GetNextPageRecs(relNum, &pid, NULL, recs, &numRecs) == NOTOK)
+            goto done;
+
+        for(int i = 0; i < numRecs; i++, seen++)
+        {
+            int k = 0;
+
+            for(AttrDesc *a = entry->attrList; a; a = a->next, k++)
+            {
+                const AttrCatRec *attr = &a->attr;
+                const char *v = recs[i] + attr->offset;
+                AttrStats *s = STATS_ATTR(rs, k);
+
+                if(isNaNValue(v, attr))
+                    continue;
+                if(!s->numValues || statCmp(v, loRec + attr->offset, attr, attr->length) < 0)
+                    memcpy(loRec + attr->offset, v, attr->length);
+                if(!s->numValues || statCmp(v, hiRec + attr->offset, attr, attr->length) > 0)
+                    memcpy(hiRec + attr->offset, v, attr->length);
+                s->numValues++;
+            }
+
+            if(n < STAT_SAMPLE_ROWS)
+            {
+                if(n == cap)
+                {
+                    int newCap = cap ? MIN(2 * cap, STAT_SAMPLE_ROWS) : 64;
+                    char *grown = realloc(sample, (size_t)newCap * recLength);
+
+                    if(!grown)
+                    {
+                        db_err_code = MEM_ALLOC_ERROR;
+                        goto done;
+                    }
+                    sample = grown;
+                    cap = newCap;
+                }
+                memcpy(sample + (size_t)n++ * recLength, recs[i], recLength);
+            }
+            else
+            {
+                unsigned long long j = statRandom(&seed) % (unsigned long long)(seen + 1);
+
+                if(j < (unsigned long long)n)
+                    memcpy(sample + j * recLength, recs[i], recLength);
+            }
+        }
+    }
+    while(numRecs > 0);
+
+    if(n && !(vals = malloc(n * sizeof(char *))))
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        goto done;
+    }
+
+    rs->numRecs = (int)seen;
+    rs->sampleRecs = n;
+    rs->numAttrs = numAttrs;
+
+    int k = 0;
+    for(AttrDesc *a = entry->attrList; a; a = a->next, k++)
+    {
+        int numVals = 0;
+
+        for(int i = 0; i < n; i++)
+        {
+            char *v = sample + (size_t)i * recLength + a->attr.offset;
+
+            if(!isNaNValue(v, &a->attr))
+                vals[numVals++] = v;
+        }
+        summariseAttr(STATS_ATTR(rs, k), &a->attr, vals, numVals, loRec + a->attr.offset, hiRec + a->attr.offset);
+    }
+
+    char fname[RELNAME + 6];
+    build_stat_filename(entry->relcat_rec.relName, fname, sizeof(fname));
+
+    FILE *fp = fopen(fname, "wb");
+
+    if(!fp || fwrite(rs, statsSize(numAttrs), 1, fp) != 1)
+    {
+        if(fp)
+            fclose(fp);
+        db_err_code = FILESYSTEM_ERROR;
+        goto done;
+    }
+    if(fclose(fp) != 0)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        goto done;
+    }
+
+    k = 0;
+    for(AttrDesc *a = entry->attrList; a; a = a->next, k++)
+    {
+        int numDistinct = STATS_ATTR(rs, k)->numDistinct;
+
+        if(a->attr.hasIndex || a->attr.nKeys == numDistinct)
+            continue;
+
+        a->attr.nKeys = numDistinct;
+        if(WriteRec(ATTRCAT_CACHE, &(a->attr), a->attrCatRid) == NOTOK)
+            goto done;
+    }
+
+    free(entry->stats);
+    entry->stats = rs;
+    rs = NULL;
+    rc = OK;
+
+done:
+    free(rs);
+    free(loRec);
+    free(hiRec);
+    free(sample);
+    free(vals);
+    return rc;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION statsLoad (relNum)
+
+FUNCTION DESCRIPTION:
+    Reads "<relName>.stat" into catcache[relNum].stats.  A missing file, or one written for a different
+    number of attributes, leaves stats NULL: the relation has not been analyzed.
+
+RETURNS:
+    OK or NOTOK (MEM_ALLOC_ERROR, FILESYSTEM_ERROR).
+
+------------------------------------------------------------*/
+
+static int statsLoad(int relNum)
+{
+    CacheEntry *entry = &catcache[relNum];
+    int numAttrs = entry->relcat_rec.numAttrs;
+    char fname[RELNAME + 6];
+
+    build_stat_filename(entry->relcat_rec.relName, fname, sizeof(fname));
+
+    FILE *fp = fopen(fname, "rb");
+
+    if(!fp)
+    {
+        if(errno == ENOENT)
+            return OK;
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+
+    RelStats *rs = malloc(statsSize(numAttrs));
+
+    if(!rs)
+    {
+        fclose(fp);
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+
+    if(fread(rs, sizeof(RelStats), 1, fp) == 1 && rs->numAttrs == numAttrs &&
+       fread(rs + 1, sizeof(AttrStats), numAttrs, fp) == (size_t)numAttrs)
+    {
+        entry->stats = rs;
+    }
+    else
+    {
+        free(rs);
+    }
+
+    fclose(fp);
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION StatsGet (relNum, attrDesc)
+
+PARAMETER DESCRIPTION:
+    relNum   → open relation.
+    attrDesc → one of its attributes.
+
+FUNCTION DESCRIPTION:
+    Gives the statistics of an attribute, reading them on first use.  When the relation's numRecs differs
+    from the count they were computed on by more than STAT_DRIFT_PCT percent (of at least STAT_DRIFT_MIN
+    records), the relation is analyzed again first.
+
+RETURNS:
+    The statistics, or NULL when the relation has never been analyzed or they could not be read or refreshed.
+
+------------------------------------------------------------*/
+
+const AttrStats *StatsGet(int relNum, const AttrDesc *attrDesc)
+{
+    CacheEntry *entry = &catcache[relNum];
+
+    if(!entry->stats && statsLoad(relNum) == NOTOK)
+        return NULL;
+    if(!entry->stats)
+        return NULL;
+
+    long long drift = (long long)entry->relcat_rec.numRecs - entry->stats->numRecs;
+
+    if(llabs(drift) * 100 > (long long)STAT_DRIFT_PCT * MAX(entry->stats->numRecs, STAT_DRIFT_MIN) &&
+       StatsAnalyze(relNum) == NOTOK)
+    {
+        return NULL;
+    }
+
+    int k = 0;
+    for(AttrDesc *a = entry->attrList; a; a = a->next, k++)
+    {
+        if(a == attrDesc)
+            return STATS_ATTR(entry->stats, k);
+    }
+    return NULL;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION StatsSelectivity (relNum, attrDesc, valuePtr, compOp, sel)
+
+PARAMETER DESCRIPTION:
+    relNum   → open relation.
+    attrDesc → attribute compared.
+    valuePtr → literal, converted to the attribute's type.
+    compOp   → CMP_* operator.
+    sel      → (OUT) estimated fraction of the records satisfying "attr compOp literal".
+
+FUNCTION DESCRIPTION:
+    Estimates a comparison from the histogram of the attribute (StatsGet()).
+    Equality selects the average number of records per distinct value of the bucket holding the literal,
+    or none outside [min, max].  A range takes the buckets whose bound is below the literal, plus the share of the
+    bucket holding it found by linear interpolation between the bucket's bounds (half of it for strings).
+
+RETURNS:
+    OK, or NOTOK when the relation has no statistics.
+
+------------------------------------------------------------*/
+
+int StatsSelectivity(int relNum, const AttrDesc *attrDesc, const void *valuePtr, int compOp, double *sel)
+{
+    const AttrStats *s = StatsGet(relNum, attrDesc);
+
+    if(!s)
+        return NOTOK;
+
+    const AttrCatRec *attr = &attrDesc->attr;
+    double numRecs = catcache[relNum].stats->numRecs;
+    double eqRows = 0, lessRows = 0;
+    int n = MIN(attr->length, STAT_VALUE);
+    char value[STAT_VALUE];
+
+    if(numRecs == 0)
+    {
+        *sel = 0;
+        return OK;
+    }
+
+    statStore(value, valuePtr, attr);
+
+    if(s->numBuckets == 0 || statCmp(value, s->lo, attr, n) < 0)
+    {
+        lessRows = 0;
+    }
+    else if(statCmp(value, s->hi, attr, n) > 0)
+    {
+        lessRows = s->numValues;
+    }
+    else
+    {
+        int b = 0;
+
+        while(b < s->numBuckets - 1 && statCmp(s->bound[b], value, attr, n) < 0)
+            lessRows += s->bucketRows[b++];
+
+        eqRows = (double)s->bucketRows[b] / s->bucketDistinct[b];
+
+        const char *low = b ? s->bound[b - 1] : s->lo;
+        double frac = 0.5;
+
+        if(statCmp(value, s->bound[b], attr, n) == 0)
+        {
+            frac = 1;
+        }
+        else if(attr->type[0] != 's')
+        {
+            double x, l, h;
+
+            if(attr->type[0] == 'f')
+            {
+                x = getFloatValue(value, attr->length);
+                l = getFloatValue(low, attr->length);
+                h = getFloatValue(s->bound[b], attr->length);
+            }
+            else
+            {
+                x = getIntValue(value, attr->length);
+                l = getIntValue(low, attr->length);
+                h = getIntValue(s->bound[b], attr->length);
+            }
+            frac = h > l ? (x - l) / (h - l) : 0;
+        }
+
+        lessRows += MAX(frac * s->bucketRows[b] - eqRows, 0);
+    }
+
+    double rows;
+
+    switch(compOp)
+    {
+        case CMP_EQ:  rows = eqRows;                             break;
+        case CMP_NE:  rows = numRecs - eqRows;                   break;
+        case CMP_LT:  rows = lessRows;                           break;
+        case CMP_LTE: rows = lessRows + eqRows;                  break;
+        case CMP_GT:  rows = s->numValues - lessRows - eqRows;   break;
+        default:      rows = s->numValues - lessRows;
+    }
+
+    *sel = MIN(MAX(rows / numRecs, 0.0), 1.0);
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION StatsRelease (relNum)
+
+FUNCTION DESCRIPTION:
+    Frees the in-memory statistics of a relation; called when its cache slot is closed.
+
+------------------------------------------------------------*/
+
+void StatsRelease(int relNum)
+{
+    free(catcache[relNum].stats);
+    catcache[relNum].stats = NULL;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION RemoveStats (relName)
+
+FUNCTION DESCRIPTION:
+    Unlinks "<relName>.stat"; a missing file is not an error.
+
+RETURNS:
+    OK or NOTOK (FILESYSTEM_ERROR).
+
+------------------------------------------------------------*/
+
+int RemoveStats(const char *relName)
+{
+    char fname[RELNAME + 6];
+
+    build_stat_filename(relName, fname, sizeof(fname));
+    if(remove(fname) != 0 && errno != ENOENT)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+    return OK;
+}
\ No newline at end of file
@@ -6,8 +6,11 @@
 #include <string.h>
 #include "../include/globals.h"
 #include "../include/defs.h"
+#include "../include/pagelayout.h"
+#include "../include/freemap.h"
 #include "../include/error.h"
 #include "../include/readpage.h"
+#include "../include/zonemap.h"
 
 
 /*------------------------------------------------------------
@@ -25,7 +28,8 @@ FUNCTION DESCRIPTION:
         - validates the relation id and record location,
         - loads the target page into the buffer (ReadPage),
         - copies the new tuple into the correct slot,
-        - marks the buffer page dirty.
+        - marks the buffer page dirty,
+        - refreshes the page's zone map block (ZoneMapUpdate()).
     It does NOT:
         - update catalogs,
         - update slotmap,
@@ -42,11 +46,11 @@ ALGORITHM:
         - slotnum < records per page
         If invalid, set PAGE_OUT_OF_BOUNDS and return NOTOK.
     3) Call ReadPage(relNum, recRid.pid) to load the page.
-    4) Compute the memory location of the target slot:
-            offset = HEADER_SIZE + slotnum * recSize.
-    5) Overwrite the record using memcpy().
-    6) Mark the buffer for this relation as dirty.
-    7) Return OK.
+    4) Overwrite the record of the target slot with PagePutRec() (one value per minipage on a PAX page,
+       codes for encoded attributes); return NOTOK if it fails.
+    5) Mark the buffer for this relation as dirty.
+    6) On a slotted page, record the page's free bytes in the freemap (SetFreeSpace()).
+    7) Recompute the zone map block of the page and return its status.
 
 BUGS:
     None found.
@@ -59,12 +63,12 @@ GLOBAL VARIABLES MODIFIED:
 ERRORS REPORTED:
     INVALID_RELNUM     – relation is not open.
     PAGE_OUT_OF_BOUNDS – pid or slotnum outside valid range.
+    Errors of PagePutRec() (a dictionary that cannot grow, a record that outgrows its slotted page).
 
 --------------------------------------------------------------*/
 
 int WriteRec(int relNum, void *recPtr, Rid recRid)
 {
-    int recSize = catcache[relNum].relcat_rec.recLength;
     int numPgs = catcache[relNum].relcat_rec.numPgs;
     int recsPerPg = catcache[relNum].relcat_rec.recsPerPg;
     char *page = buffer[relNum].page;
@@ -92,9 +96,19 @@ int WriteRec(int relNum, void *recPtr, Rid recRid)
         return NOTOK;
     }
 
-    void *recToUpdate = page + HEADER_SIZE + recRid.slotnum * recSize;
-    memcpy(recToUpdate, recPtr, recSize);
+    if(PagePutRec(&catcache[relNum], page, recRid.slotnum, recPtr) == NOTOK)
+    {
+        return NOTOK;
+    }
+
     buffer[relNum].dirty = true;
 
-    return OK;
+    /* A slotted page's free bytes change with the length of the record */
+    if(catcache[relNum].relcat_rec.layout == LAYOUT_SLOTTED && FreeMapExists(catcache[relNum].relcat_rec.relName) == 1 &&
+       SetFreeSpace(catcache[relNum].relcat_rec.relName, recRid.pid, PageFreeBytes(&catcache[relNum], page)) == NOTOK)
+    {
+        return NOTOK;
+    }
+
+    return ZoneMapUpdate(relNum, recRid.pid);
 }
@@ -0,0 +1,440 @@
+/************************INCLUDES*******************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/helpers.h"
+#include "../include/readpage.h"
+#include "../include/zonemap.h"
+#include "../include/pagelayout.h"
+
+/*
+ * Zone maps.
+ *
+ * "<relName>.zmap" holds one fixed-size block per heap page: a ZonePage followed by a ZoneEntry
+ * (min, max, flags) for every attribute.  A scan for "attr op value" consults the block before
+ * reading the page and skips the page when no value in [min, max] can satisfy the predicate.
+ *
+ * Strings longer than ZMAP_PREFIX keep only their first ZMAP_PREFIX bytes.  A truncated minimum
+ * is still a lower bound; a truncated maximum only bounds the prefixes, so for those attributes
+ * the bounds are compared on prefixes with non-strict operators.
+ *
+ * Blocks are rewritten from the page image whenever InsertRec(), DeleteRec() or WriteRec() change
+ * a page, so they are always exact.  Pages without a block (relations older than their zone map)
+ * are simply never skipped.
+ */
+
+
+/*------------------------------------------------------------
+
+FUNCTION build_zmap_filename (relName, fname, buflen)
+
+FUNCTION DESCRIPTION:
+    Constructs "<relName>.zmap", stored next to the heap file and its freemap.
+
+------------------------------------------------------------*/
+
+void build_zmap_filename(const char *relName, char *fname, size_t buflen)
+{
+    snprintf(fname, buflen, "%s.zmap", relName);
+}
+
+static size_t blockSize(int relNum)
+{
+    return sizeof(ZonePage) + catcache[relNum].relcat_rec.numAttrs * sizeof(ZoneEntry);
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION zoneLoad (relNum)
+
+FUNCTION DESCRIPTION:
+    Reads the zone map of an open relation into catcache[relNum].zoneMap on first use.
+    Pages past the end of the file (or all pages, when there is no file yet) get zeroed, i.e. invalid, blocks.
+
+RETURNS:
+    OK or NOTOK (MEM_ALLOC_ERROR).
+
+------------------------------------------------------------*/
+
+static int zoneLoad(int relNum)
+{
+    CacheEntry *entry = &catcache[relNum];
+    char fname[RELNAME + 6];
+
+    if(entry->zoneMap)
+        return OK;
+
+    int numPgs = entry->relcat_rec.numPgs;
+    size_t bsize = blockSize(relNum);
+
+    entry->zoneMap = calloc(numPgs > 0 ? numPgs : 1, bsize);
+    if(!entry->zoneMap)
+    {
+        db_err_code = MEM_ALLOC_ERROR;
+        return NOTOK;
+    }
+    entry->zoneMapPgs = numPgs;
+
+    build_zmap_filename(entry->relcat_rec.relName, fname, sizeof(fname));
+    int fd = open(fname, O_RDONLY);
+    if(fd >= 0)
+    {
+        /* a short read leaves the remaining blocks invalid */
+        if(read(fd, entry->zoneMap, numPgs * bsize) < 0)
+            memset(entry->zoneMap, 0, numPgs * bsize);
+        close(fd);
+    }
+
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION summarisePage (relNum, page, block)
+
+PARAMETER DESCRIPTION:
+    relNum → open relation owning the page.
+    page   → page image.
+    block  → (OUT) zone map block of blockSize(relNum) bytes.
+
+FUNCTION DESCRIPTION:
+    Computes the min/max of every attribute over the occupied slots of the page.
+    Minimum and maximum are found with the full attribute value; only the stored copy of a string is truncated.
+    Those of a dictionary-encoded or variable-length attribute are found on its decoded values (PageAttrValue()), so that
+    the block reads as for an "sN" attribute.
+
+------------------------------------------------------------*/
+
+static void summarisePage(int relNum, const char *page, char *block)
+{
+    const RelCatRec *rc = &catcache[relNum].relcat_rec;
+    int recsPerPg = rc->recsPerPg;
+    ZonePage *zp = (ZonePage *)block;
+    ZoneEntry *ze = (ZoneEntry *)(block + sizeof(ZonePage));
+    unsigned long slotmap;
+
+    memset(block, 0, blockSize(relNum));
+    memcpy(&slotmap, page + MAGIC_SIZE, sizeof(slotmap));
+    zp->valid = 1;
+
+    for(int s = 0; s < recsPerPg; s++)
+        if(slotmap & (1UL << s))
+            zp->numLive++;
+
+    int k = 0;
+    for(AttrDesc *a = catcache[relNum].attrList; a; a = a->next, k++)
+    {
+        const char *loPtr = NULL, *hiPtr = NULL;
+        char buf[MAXRECORD], loBuf[MAXRECORD], hiBuf[MAXRECORD];
+
+        for(int s = 0; s < recsPerPg; s++)
+        {
+            if(!(slotmap & (1UL << s)))
+                continue;
+
+            const char *v = PageAttrValue(&catcache[relNum], page, s, a, buf);
+
+            int lessLo, greaterHi;
+
+            switch(a->attr.type[0])
+            {
+                case 'i':
+                case 'd':
+                {
+                    long long x = getIntValue(v, a->attr.length);
+                    lessLo = !loPtr || x < getIntValue(loPtr, a->attr.length);
+                    greaterHi = !hiPtr || x > getIntValue(hiPtr, a->attr.length);
+                    break;
+                }
+                case 'f':
+                {
+                    double x = getFloatValue(v, a->attr.length);
+                    if(isnan(x))
+                    {
+                        ze[k].flags |= ZONE_HAS_NAN;
+                        continue;
+                    }
+                    lessLo = !loPtr || x < getFloatValue(loPtr, a->attr.length);
+                    greaterHi = !hiPtr || x > getFloatValue(hiPtr, a->attr.length);
+                    break;
+                }
+                default:
+                    lessLo = !loPtr || strncmp(v, loPtr, a->attr.length) < 0;
+                    greaterHi = !hiPtr || strncmp(v, hiPtr, a->attr.length) > 0;
+                    break;
+            }
+
+            /* A value decoded into buf is overwritten by the next one */
+            if(lessLo)
+                loPtr = v != buf ? v : memcpy(loBuf, v, a->attr.length);
+            if(greaterHi)
+                hiPtr = v != buf ? v : memcpy(hiBuf, v, a->attr.length);
+        }
+
+        if(!loPtr)
+            continue;
+
+        ze[k].flags |= ZONE_HAS_VALUE;
+        if(a->attr.type[0] == 's')
+        {
+            strncpy(ze[k].lo, loPtr, MIN(a->attr.length, ZMAP_PREFIX));
+            strncpy(ze[k].hi, hiPtr, MIN(a->attr.length, ZMAP_PREFIX));
+        }
+        else
+        {
+            memcpy(ze[k].lo, loPtr, a->attr.length);
+            memcpy(ze[k].hi, hiPtr, a->attr.length);
+        }
+    }
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ZoneMapUpdate (relNum, pid)
+
+PARAMETER DESCRIPTION:
+    relNum → open relation whose page changed.
+    pid    → page that changed.
+
+FUNCTION DESCRIPTION:
+    Recomputes the zone map block of page pid and writes it to memory and to "<relName>.zmap".
+    Called by InsertRec(), DeleteRec() and WriteRec() once the page in the buffer holds the change.
+
+ALGORITHM:
+    1) Catalog relations have no zone map → return OK.
+    2) Make sure pid is in the buffer (it normally already is).
+    3) summarisePage() into a scratch block.
+    4) Copy it into the in-memory map, growing the map when pid is a new page.
+    5) Write the block at offset pid * blockSize of the file, creating the file if needed.
+
+RETURNS:
+    OK or NOTOK.
+
+ERRORS REPORTED:
+    MEM_ALLOC_ERROR
+    FILESYSTEM_ERROR
+
+GLOBAL VARIABLES MODIFIED:
+    catcache[relNum].zoneMap, zoneMapPgs
+
+------------------------------------------------------------*/
+
+int ZoneMapUpdate(int relNum, short pid)
+{
+    CacheEntry *entry = &catcache[relNum];
+    char fname[RELNAME + 6];
+
+    if(relNum < NUM_CATS)
+        return OK;
+
+    if(ReadPage(relNum, pid) == NOTOK || zoneLoad(relNum) == NOTOK)
+        return NOTOK;
+
+    size_t bsize = blockSize(relNum);
+
+    if(pid >= entry->zoneMapPgs)
+    {
+        char *grown = realloc(entry->zoneMap, (pid + 1) * bsize);
+        if(!grown)
+        {
+            db_err_code = MEM_ALLOC_ERROR;
+            return NOTOK;
+        }
+        memset(grown + entry->zoneMapPgs * bsize, 0, (pid + 1 - entry->zoneMapPgs) * bsize);
+        entry->zoneMap = grown;
+        entry->zoneMapPgs = pid + 1;
+    }
+
+    char *block = entry->zoneMap + pid * bsize;
+    summarisePage(relNum, buffer[relNum].page, block);
+
+    build_zmap_filename(entry->relcat_rec.relName, fname, sizeof(fname));
+    int fd = open(fname, O_WRONLY | O_CREAT, 0644);
+    if(fd < 0 || pwrite(fd, block, bsize, (off_t)pid * bsize) != (ssize_t)bsize)
+    {
+        if(fd >= 0)
+            close(fd);
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+
+    close(fd);
+    return OK;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION zoneCmp (attrType, a, b, n)
+
+FUNCTION DESCRIPTION:
+    Three-way comparison with the semantics of compareRecs(): exact for ints, dates and doubles, float_cmp() for floats, strncmp()
+    over n bytes for strings.  n is the width of a number.  2 when a float or double is NaN.
+
+------------------------------------------------------------*/
+
+static int zoneCmp(char attrType, const char *a, const char *b, int n)
+{
+    switch(attrType)
+    {
+        case 'i':
+        case 'd':
+            return compareNumeric(a, b, attrType, n);
+        case 'f':
+        {
+            if(n == sizeof(double))
+            {
+                double x = getFloatValue(a, n), y = getFloatValue(b, n);
+                return isnan(x) || isnan(y) ? 2 : (x > y) - (x < y);
+            }
+
+            float x, y;
+            memcpy(&x, a, sizeof(float));
+            memcpy(&y, b, sizeof(float));
+            return float_cmp(x, y, FLOAT_REL_EPS, FLOAT_ABS_EPS);
+        }
+        default:
+        {
+            int s = strncmp(a, b, n);
+            return (s > 0) - (s < 0);
+        }
+    }
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ZoneMapCanSkip (relNum, pid, attrType, attrSize, attrOffset, valuePtr, compOp)
+
+PARAMETER DESCRIPTION:
+    relNum     → open relation being scanned.
+    pid        → page about to be read.
+    attrType, attrSize, attrOffset, valuePtr, compOp → the FindRec() predicate.
+
+FUNCTION DESCRIPTION:
+    Decides from the zone map alone whether page pid can be skipped.
+
+ALGORITHM:
+    With lo = C(min, value) and hi = C(max, value):
+        CMP_EQ  → skip if lo > 0 or hi < 0
+        CMP_LT  → skip if lo >= 0        CMP_LTE → skip if lo > 0
+        CMP_GT  → skip if hi <= 0        CMP_GTE → skip if hi < 0
+        CMP_NE  → skip if lo == 0 and hi == 0 (ints and untruncated strings only)
+    For truncated strings C compares prefixes, so CMP_LT/CMP_GT use the non-strict test.
+    Float comparisons go through float_cmp(), whose tolerance grows no faster than the distance, so the bounds stay safe.
+    A page with a NaN is never skipped for CMP_NE; a page with only NaNs is skipped for all other operators.
+
+RETURNS:
+    1 → no record on the page can satisfy the predicate.
+    0 → the page must be read (also when no zone information is available).
+
+IMPLEMENTATION NOTES:
+    - The attribute is identified by its offset, which is unique within a record.
+
+------------------------------------------------------------*/
+
+int ZoneMapCanSkip(int relNum, short pid, char attrType, int attrSize, int attrOffset, void *valuePtr, int compOp)
+{
+    CacheEntry *entry = &catcache[relNum];
+
+    if(relNum < NUM_CATS || zoneLoad(relNum) == NOTOK || pid >= entry->zoneMapPgs)
+        return 0;
+
+    const char *block = entry->zoneMap + pid * blockSize(relNum);
+    const ZonePage *zp = (const ZonePage *)block;
+
+    if(!zp->valid)
+        return 0;
+    if(zp->numLive == 0)
+        return 1;
+
+    int k = 0;
+    AttrDesc *a = entry->attrList;
+    while(a && a->attr.offset != attrOffset)
+    {
+        a = a->next;
+        k++;
+    }
+    if(!a)
+        return 0;
+
+    const ZoneEntry *ze = (const ZoneEntry *)(block + sizeof(ZonePage)) + k;
+
+    if(!(ze->flags & ZONE_HAS_VALUE))
+        return compOp != CMP_NE;
+    if(compOp == CMP_NE && (ze->flags & ZONE_HAS_NAN))
+        return 0;
+
+    int truncated = (attrType == 's' && attrSize > ZMAP_PREFIX);
+    int n = MIN(attrSize, ZMAP_PREFIX);
+    int lo = zoneCmp(attrType, ze->lo, valuePtr, n);
+    int hi = zoneCmp(attrType, ze->hi, valuePtr, n);
+
+    if(lo == 2 || hi == 2)
+        return 0;
+
+    switch(compOp)
+    {
+        case CMP_EQ:  return lo > 0 || hi < 0;
+        case CMP_LT:  return truncated ? lo > 0 : lo >= 0;
+        case CMP_LTE: return lo > 0;
+        case CMP_GT:  return truncated ? hi < 0 : hi <= 0;
+        case CMP_GTE: return hi < 0;
+        case CMP_NE:  return !truncated && attrType != 'f' && lo == 0 && hi == 0;
+        default:      return 0;
+    }
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION ZoneMapRelease (relNum)
+
+FUNCTION DESCRIPTION:
+    Frees the in-memory zone map of a relation; called when its cache slot is closed.
+
+------------------------------------------------------------*/
+
+void ZoneMapRelease(int relNum)
+{
+    free(catcache[relNum].zoneMap);
+    catcache[relNum].zoneMap = NULL;
+    catcache[relNum].zoneMapPgs = 0;
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION RemoveZoneMap (relName)
+
+FUNCTION DESCRIPTION:
+    Unlinks "<relName>.zmap"; a missing file is not an error.
+
+RETURNS:
+    OK or NOTOK (FILESYSTEM_ERROR).
+
+------------------------------------------------------------*/
+
+int RemoveZoneMap(const char *relName)
+{
+    char fname[RELNAME + 6];
+
+    build_zmap_filename(relName, fname, sizeof(fname));
+    if(remove(fname) != 0 && errno != ENOENT)
+    {
+        db_err_code = FILESYSTEM_ERROR;
+        return NOTOK;
+    }
+    return OK;
+}
\ No newline at end of file
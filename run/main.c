@@ -1,6 +1,7 @@
 /************************INCLUDES*******************************/
 
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <stdbool.h>
 #include <signal.h>
@@ -9,6 +10,7 @@
 #include "../include/quit.h"
 
 extern void parser();
+extern int runscript(char *path);
 
 
 /*------------------------------------------------------------
@@ -130,26 +132,28 @@ void sigSegvHandler(int sig)
 
 /*------------------------------------------------------------
 
-FUNCTION main()
+FUNCTION main(argc, argv)
 
 PARAMETER DESCRIPTION:
-    None.
+    argc → number of command line arguments.
+    argv → "minirel", or "minirel -f script" to run a script file.
 
 FUNCTION DESCRIPTION:
     Entry point of the MINIREL system.
-    Initializes signal handlers, saves original working directory, and invokes the parser loop that processes user commands.
+    Initializes signal handlers, saves original working directory, and invokes the parser loop that processes user commands,
+    or runs the queries of a script without prompt or echo (runscript()), printing how long each command took.
 
 PROCESS:
     1) Print welcome banner.
     2) Register SIGINT (Ctrl+C) and SIGSEGV handlers.
     3) Save original working directory.
-    4) If successful, start parser() to accept user commands.
+    4) If successful, run the script given with -f, else start parser() to accept user commands.
     5) Print goodbye message upon exit.
 
 ALGORITHM:
     1) Print welcome message.
     2) Install signal handlers with signal().
-    3) Call saveOrigDir(); if OK → call parser().
+    3) Call saveOrigDir(); if OK → call runscript() for "-f script", else parser().
     4) When parser exits, print closing message.
 
 GLOBAL VARIABLES MODIFIED:
@@ -164,14 +168,21 @@ IMPLEMENTATION NOTES:
 ------------------------------------------------------------*/
 
 
-void main()
+void main(int argc, char **argv)
 {   
     printf("\n\nWelcome to MINIREL Database System\n\n");
     signal(SIGINT, sigIntHandler);
     signal(SIGSEGV, sigSegvHandler);
     if(saveOrigDir() == OK)
     {   
-        parser();
+        if(argc == 3 && strcmp(argv[1], "-f") == OK)
+        {
+            runscript(argv[2]);
+        }
+        else
+        {
+            parser();
+        }
     }
     printf("\nGoodbye from MINIREL\n\n\n");
 }
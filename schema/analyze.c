@@ -0,0 +1,135 @@
+/************************INCLUDES*******************************/
+
+#include "../include/defs.h"
+#include "../include/error.h"
+#include "../include/globals.h"
+#include "../include/helpers.h"
+#include "../include/openrel.h"
+#include "../include/unpinrel.h"
+#include "../include/stats.h"
+#include "../include/view.h"
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+
+/* Prints a bound kept in the statistics of attr; a string shows the prefix that is kept */
+static void formatStatValue(const char *v, const AttrCatRec *attr, char *buf, size_t buflen)
+{
+    switch(attr->type[0])
+    {
+        case 'i': snprintf(buf, buflen, "%lld", getIntValue(v, attr->length));       break;
+        case 'f': snprintf(buf, buflen, "%g", getFloatValue(v, attr->length));       break;
+        case 'd': formatDate((int)getIntValue(v, attr->length), buf);                break;
+        default:  snprintf(buf, buflen, "%.*s", MIN(attr->length, STAT_VALUE), v);
+    }
+}
+
+
+/*------------------------------------------------------------
+
+FUNCTION Analyze (argc, argv)
+
+PARAMETER DESCRIPTION:
+    argc → number of command arguments
+    argv → argument vector
+
+SPECIFICATIONS:
+    argv[0] = "analyze"
+    argv[1] = relation name
+    argv[argc] = NIL
+
+FUNCTION DESCRIPTION:
+    Computes the statistics of every attribute of a relation (StatsAnalyze()): the number of values, an estimate
+    of the number of distinct values, min/max and an equi-depth histogram.  They are kept in "<relName>.stat"
+    for the estimates of later queries, and printed one line per attribute.
+    The statistics are refreshed without another analyze once the relation has grown or shrunk by STAT_DRIFT_PCT
+    percent (StatsGet()).
+
+ALGORITHM:
+    1) Check that a database is open.
+    2) Open the relation with OpenRel() (RELNOEXIST); reject the catalog relations (METADATA_SECURITY).
+    3) Call StatsAnalyze().
+    4) Print the statistics of each attribute, unpin the relation and return OK.
+
+ERRORS REPORTED:
+    DBNOTOPEN
+    RELNOEXIST
+    VIEW_READONLY
+    METADATA_SECURITY
+    MEM_ALLOC_ERROR
+    FILESYSTEM_ERROR
+
+GLOBAL VARIABLES MODIFIED:
+    db_err_code
+    catcache[].stats of the relation
+    nKeys in attrcat of the attributes without an index
+
+------------------------------------------------------------*/
+
+int Analyze(int argc, char **argv)
+{
+    if(!db_open)
+    {
+        db_err_code = DBNOTOPEN;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    char *relName = argv[1];
+
+    if(ViewIsReadOnly(relName))
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    int r = OpenRel(relName);
+
+    if(r == NOTOK)
+    {
+        if(db_err_code == RELNOEXIST)
+        {
+            printf("Relation '%s' does NOT exist in the DB.\n", relName);
+            printCloseStrings(RELCAT_CACHE, offsetof(RelCatRec, relName), relName, NULL);
+        }
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if(strncmp(relName, RELCAT, RELNAME) == OK ||
+    strncmp(relName, ATTRCAT, RELNAME) == OK)
+    {
+        printf("CANNOT analyze catalog relation %s...\n", relName);
+        db_err_code = METADATA_SECURITY;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if(StatsAnalyze(r) == NOTOK)
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    const RelStats *rs = catcache[r].stats;
+
+    printf("Analyzed relation %s: %d records, %d sampled\n", relName, rs->numRecs, rs->sampleRecs);
+    printf("%-*s %-6s %10s %10s %8s  %s\n", ATTRNAME, "attribute", "type", "values", "distinct", "buckets", "min .. max");
+
+    for(AttrDesc *a = catcache[r].attrList; a; a = a->next)
+    {
+        const AttrStats *s = StatsGet(r, a);
+        char type[8], lo[STAT_VALUE + 32], hi[STAT_VALUE + 32];
+
+        snprintf(type, sizeof(type), "%c%d", a->attr.type[0], a->attr.length);
+        strcpy(lo, "-");
+        strcpy(hi, "-");
+        if(s->numValues > 0)
+        {
+            formatStatValue(s->lo, &a->attr, lo, sizeof(lo));
+            formatStatValue(s->hi, &a->attr, hi, sizeof(hi));
+        }
+
+        printf("%-*s %-6s %10d %10d %8d  %s .. %s\n", ATTRNAME, a->attr.attrName, type,
+        s->numValues, s->numDistinct, s->numBuckets, lo, hi);
+    }
+
+    UnPinRel(r);
+    return OK;
+}
\ No newline at end of file
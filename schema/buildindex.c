@@ -8,7 +8,15 @@
 #include "../include/findrelattr.h"
 #include "../include/writerec.h"
 #include "../include/unpinrel.h"
+#include "../include/btree.h"
+#include "../include/hashidx.h"
+#include "../include/bitmapidx.h"
+#include "../include/bloom.h"
+#include "../include/idxmaint.h"
+#include "../include/view.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -25,13 +33,19 @@ SPECIFICATIONS:
     argv[0] = "buildindex"
     argv[1] = relation name
     argv[2] = attribute name
+    argv[3] = (optional) fill factor in percent, given as "fill N" ("" when only "using" is given)
+    argv[4] = (optional) index kind, given as "using btree", "using hash", "using bitmap" or "using bloom"
     argv[argc] = NIL
 
 FUNCTION DESCRIPTION:
-    Creates an index on a specified attribute of a given relation. 
-    The routine enforces strict MINIREL rules: indices may not be created on the system catalogs, relations must be empty before indexing, and an index cannot be rebuilt if it already exists. 
-    The routine accesses metadata via relcat and attrcat, locates the desired attribute descriptor, and updates its hasIndex flag. 
-    No physical index structure is constructed, only catalog metadata is changed.
+    Creates a B+-tree (default), extendible hash, bitmap or Bloom filter index on a specified attribute of a given relation. 
+    Indices may not be created on the system catalogs, and an index of the same kind cannot be rebuilt if it already exists; an attribute may carry both kinds. 
+    The relation may already hold records: the tree is built bottom-up from one sequential scan of the heap and an external sort of the (key, Rid) pairs (BtBulkBuild()), so building after a Load costs a single pass instead of per-row index maintenance. 
+    Leaves and inner nodes are packed to the fill factor (BTREE_FILL_PCT unless "fill N" is given); leaving slack lets later inserts land without splitting. 
+    A hash index ("<rel>.<attr>.hash" plus its directory "<rel>.<attr>.hdir") serves only '=' probes, at O(1) expected page accesses; it is built by inserting every record in one heap pass (HashBuild()) and its directory and overflow-chain statistics are printed. 
+    A bitmap index ("<rel>.<attr>.bmap") keeps one WAH-compressed bitmap over record positions per distinct value and is meant for low-cardinality attributes (at most BITMAP_MAX_VALUES values); '=' and '<>' are answered from the bitmaps alone, and a select or delete with several such conjuncts reads only the records of the AND of their bitmaps (PlanFindRids()). 
+    A Bloom filter ("<rel>.<attr>.bloom") stores no Rids; it lets an '=' select or delete on a value that is not present return without scanning. It uses counting cells so deletes are undone, and is resized by BloomRefresh() once it outgrows its capacity. 
+    The resulting page count and number of distinct keys are recorded in attrcat (nPages, nKeys).
 
 ALGORITHM:
     1) Verify that a database is open.
@@ -39,32 +53,35 @@ ALGORITHM:
     3) Open the relation using OpenRel(); if it does not exist, report RELNOEXIST.
     4) Reject attempts to index catalog relations (relcat, attrcat).
     5) Find the attribute using FindRelAttr(); if not found, report ATTRNOEXIST.
-    6) Ensure the relation is empty:
-        - relcat_rec.numRecs must be 0
-        - relcat_rec.numPgs must be 0
-    7) Check whether the attribute already has an index; if so, report IDXEXIST.
-    8) Set hasIndex = 1 in the AttrCatRec and write the updated record back to attrcat via WriteRec().
-    9) Print a success message and return OK.
+    6) Determine the index kind; if the attribute already has an index of that kind, report IDXEXIST.
+    7) Reject hash, bitmap and Bloom filter indexes on FLOAT attributes (IDX_TYPE_INVALID).
+    8) Validate the optional fill factor (1-100).
+    9) Build "<rel>.<attr>.idx" with BtBulkBuild(), the hash files with HashBuild() and report HashGetStats(), the bitmap file with BitmapBuild(), or the filter with BloomBuild().
+    10) Set the IDX_BTREE/IDX_HASH/IDX_BITMAP/IDX_BLOOM bit of hasIndex, store nPages/nKeys and write the updated record back to attrcat via WriteRec().
+    11) Print a success message and return OK.
 
 BUGS:
-    • Assumes the empty-relation restriction is required, the system cannot build indices on existing data.
-    • Does not validate numeric vs. string attribute types, any attribute may be indexed.
+    • nPages/nKeys describe the index as built; later inserts and deletes do not refresh them.
 
 ERRORS REPORTED:
     DBNOTOPEN
     RELNOEXIST
+    VIEW_READONLY
     METADATA_SECURITY
     ATTRNOEXIST
-    INDEX_NONEMPTY
     IDXEXIST
-    FILESYSTEM_ERROR (via WriteRec)
+    IDX_TYPE_INVALID
+    IDX_TOO_MANY_VALUES
+    INVALID_VALUE
+    FILESYSTEM_ERROR
+    MEM_ALLOC_ERROR
 
 GLOBAL VARIABLES MODIFIED:
     • db_err_code
-        catcache[].attr.hasIndex for the target attribute
+        catcache[].attr.hasIndex, nPages, nKeys for the target attribute
 
 IMPLEMENTATION NOTES:
-    • Only updates the catalog metadata; no on-disk index file or structure is created.
+    • From here on InsertRec()/DeleteRec() keep the tree current (see physical/idxmaint.c).
 
 ------------------------------------------------------------*/
 
@@ -79,6 +96,11 @@ int BuildIndex(int argc, char **argv)
     char *relName = argv[1];
     char *attrName = argv[2];
 
+    if(ViewIsReadOnly(relName))
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
     int r = OpenRel(relName);
 
     if(r == NOTOK)
@@ -104,22 +126,112 @@ int BuildIndex(int argc, char **argv)
         return ErrorMsgs(db_err_code, print_flag);
     }
 
-    int numPgs = catcache[r].relcat_rec.numRecs;
-    int numRecs = catcache[r].relcat_rec.numPgs;
+    int kind = IDX_BTREE;
 
-    if(numPgs || numRecs)
+    if(argc == 5)
     {
-        db_err_code = INDEX_NONEMPTY;
-        return ErrorMsgs(db_err_code, print_flag);
+        if(strcmp(argv[4], "hash") == OK)
+        {
+            kind = IDX_HASH;
+        }
+        else if(strcmp(argv[4], "bitmap") == OK)
+        {
+            kind = IDX_BITMAP;
+        }
+        else if(strcmp(argv[4], "bloom") == OK)
+        {
+            kind = IDX_BLOOM;
+        }
+        else if(strcmp(argv[4], "btree") != OK)
+        {
+            printf("Unknown index kind '%s'; use btree, hash, bitmap or bloom.\n", argv[4]);
+            db_err_code = INVALID_VALUE;
+            return ErrorMsgs(db_err_code, print_flag);
+        }
     }
 
-    if(attrDesc->attr.hasIndex)
+    if(attrDesc->attr.hasIndex & kind)
     {
         db_err_code = IDXEXIST;
         return ErrorMsgs(db_err_code, print_flag);
     }
 
-    attrDesc->attr.hasIndex = 1;
+    if(kind != IDX_BTREE && attrDesc->attr.type[0] == 'f')
+    {
+        printf("Hash, bitmap and bloom indexes support only INTEGER and STRING attributes.\n");
+        db_err_code = IDX_TYPE_INVALID;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    int fillPct = BTREE_FILL_PCT;
+
+    if(argc >= 4 && argv[3][0] != '\0')
+    {
+        fillPct = atoi(argv[3]);
+
+        if(fillPct < 1 || fillPct > 100)
+        {
+            printf("Fill factor must be between 1 and 100.\n");
+            db_err_code = INVALID_VALUE;
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+    }
+
+    char fname[RELNAME + ATTRNAME + 8], dname[RELNAME + ATTRNAME + 8];
+    int nPages, nKeys;
+
+    if(kind == IDX_HASH)
+    {
+        HashStats stats;
+
+        build_idx_filename(relName, attrName, "hash", fname, sizeof(fname));
+        build_idx_filename(relName, attrName, "hdir", dname, sizeof(dname));
+
+        if(HashBuild(fname, dname, r, &(attrDesc->attr), &nPages, &nKeys) == NOTOK ||
+           HashGetStats(fname, dname, &stats) == NOTOK)
+        {
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+
+        printf("Hash index: global depth %d, %d buckets, %d overflow pages, longest chain %d pages\n",
+        stats.globalDepth, stats.numBuckets, stats.numOverflow, stats.longestChain);
+    }
+    else if(kind == IDX_BITMAP)
+    {
+        build_idx_filename(relName, attrName, "bmap", fname, sizeof(fname));
+
+        if(BitmapBuild(fname, r, &(attrDesc->attr), &nPages, &nKeys) == NOTOK)
+        {
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+
+        printf("Bitmap index: %d distinct values in %d pages\n", nKeys, nPages);
+    }
+    else if(kind == IDX_BLOOM)
+    {
+        build_idx_filename(relName, attrName, "bloom", fname, sizeof(fname));
+
+        if(BloomBuild(fname, r, &(attrDesc->attr)) == NOTOK)
+        {
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+
+        nPages = 0;
+        nKeys = catcache[r].relcat_rec.numRecs;
+    }
+    else
+    {
+        build_idx_filename(relName, attrName, "idx", fname, sizeof(fname));
+
+        if(BtBulkBuild(fname, r, &(attrDesc->attr), fillPct, &nPages, &nKeys) == NOTOK)
+        {
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+    }
+
+    attrDesc->attr.hasIndex |= kind;
+    attrDesc->attr.nPages = nPages;
+    attrDesc->attr.nKeys = nKeys;
     if(WriteRec(ATTRCAT_CACHE, &(attrDesc->attr), attrDesc->attrCatRid) == NOTOK)
     {
         return ErrorMsgs(db_err_code, print_flag);
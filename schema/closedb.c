@@ -5,6 +5,8 @@
 #include "../include/globals.h"
 #include "../include/closecats.h"
 #include "../include/closedb.h"
+#include "../include/view.h"
+#include "../include/prepare.h"
 #include <stdio.h>
 #include <stdbool.h>
 #include <unistd.h>
@@ -31,7 +33,8 @@ FUNCTION DESCRIPTION:
 ALGORITHM:
     1) Check whether a database is currently open.
         If not, report DBNOTOPEN.
-    2) Invoke CloseCats() to close the relation and attribute catalogs and release global memory.
+    2) Forget the views and prepared statements of the session (ViewDropAll(), PrepareDropAll()).
+       Invoke CloseCats() to close the relation and attribute catalogs and release global memory.
     3) Change directory back to ORIG_DIR.
     4) Mark db_open = FALSE.
     5) Report success.
@@ -63,6 +66,9 @@ int CloseDB(int argc, char **argv)
         return ErrorMsgs(db_err_code, print_flag);
     }
 
+    ViewDropAll();
+    PrepareDropAll();
+
     if(CloseCats() == OK)
     {
         db_open = false;
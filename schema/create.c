@@ -15,6 +15,30 @@
 #include "../include/findrec.h"
 #include "../include/findrel.h"
 #include "../include/freemap.h"   // <-- for build_fmap_filename
+#include "../include/view.h"
+#include "../include/dict.h"
+
+
+/* Type and length of a numeric or date format ("i", "i1", "i2", "i4", "i8", "f", "f4", "f8", "date"); false for others */
+static bool numericFormat(const char *format, char *type, int *length)
+{
+    static const struct { const char *format; char type; int length; } formats[] = {
+        {"i", 'i', sizeof(int)}, {"i1", 'i', 1}, {"i2", 'i', 2}, {"i4", 'i', 4}, {"i8", 'i', 8},
+        {"f", 'f', sizeof(float)}, {"f4", 'f', sizeof(float)}, {"f8", 'f', sizeof(double)},
+        {"date", 'd', sizeof(int)}
+    };
+
+    for(size_t k = 0; k < sizeof(formats) / sizeof(formats[0]); k++)
+    {
+        if(strcmp(format, formats[k].format) == 0)
+        {
+            *type = formats[k].type;
+            *length = formats[k].length;
+            return true;
+        }
+    }
+    return false;
+}
 
 
 /*------------------------------------------------------------
@@ -29,12 +53,13 @@ SPECIFICATIONS:
     argv[0] = "create"
     argv[1] = relation name
     argv[2] = attribute name 1
-    argv[3] = attribute format 1   ("i", "f", or "sN")
+    argv[3] = attribute format 1   ("i", "i1", "i2", "i8", "f", "f8", "date", "sN", "eN" or "vN")
     argv[4] = attribute name 2
     argv[5] = attribute format 2
     ...
-    argv[argc-2] = attribute name K
-    argv[argc-1] = attribute format K
+    argv[2K]     = attribute name K
+    argv[2K+1]   = attribute format K
+    argv[2K+2]   = (optional) page layout, given as "using row" or "using pax"
     argv[argc]   = NIL
 
 FUNCTION DESCRIPTION:
@@ -44,10 +69,18 @@ FUNCTION DESCRIPTION:
         - Ensures the relation name is legal and does not already exist.
         - Validates attribute names and checks for duplicates.
         - Validates attribute type formats:
-            • "i" → integer (4 bytes)
-            • "f" → float   (4 bytes)
+            • "i" → integer (4 bytes); "i1", "i2", "i4" and "i8" → integer of 1, 2, 4 or 8 bytes
+            • "f" → float   (4 bytes); "f4" likewise, "f8" → double (8 bytes)
+            • "date" → date "YYYY-MM-DD", kept as the int count of days since 1970-01-01 (type "d", 4 bytes)
             • "sN" → string of length N (N+1 bytes stored)
+            • "eN" → dictionary-encoded string of length N: a string attribute of N+1 bytes in records, whose
+                     pages hold the int code of the value in "<relName>.<attrName>.dict" (physical/dict.c)
+            • "vN" → variable-length string of length N: a string attribute of N+1 bytes in records, of which
+                     pages keep a length byte and the characters only
         - Computes the total record length to ensure the record fits within a MINIREL data page.
+        - Records the page layout: row (default) stores records whole; pax stores each attribute in its own
+          minipage of every page (include/pagelayout.h), so scans of one attribute read only its values.
+          A relation with "vN" attributes is always slotted: its pages hold records of varying length.
         - Creates an empty file for the relation.
         - Creates a corresponding freemap file "<relName>.fmap".
         - Inserts a new tuple in relcat describing the relation.
@@ -56,22 +89,26 @@ FUNCTION DESCRIPTION:
 
 ALGORITHM:
     1) Check db_open; if false, report DBNOTOPEN.
-    2) Validate relation name length < RELNAME.
+    2) Validate relation name length < RELNAME, and the layout if one is given.
     3) Validate all attribute names:
         a) Name length < ATTRNAME.
         b) No duplicates across attributes.
     4) For each attribute type:
-        a) Validate allowed formats ("i", "f", "sN").
+        a) Validate allowed formats (numeric and date formats, "sN", "eN", "vN").
         b) For string formats, validate numeric N and ensure N <= MAX_N.
-        c) Accumulate total record length.
-    5) Ensure record length ≤ (PAGESIZE–HEADER_SIZE).
+        c) Accumulate total record length, and the length of a record in a page (sizeof(int) for "eN"); a "vN"
+           attribute only counts its values' length bytes, and makes the layout slotted.
+    5) Ensure record length ≤ (PAGESIZE–HEADER_SIZE), with room for a directory entry on a slotted page.
     6) Check relation does not already exist via FindRel().
     7) Create an empty file.
     8) Create a freemap file "<relName>.fmap".
-    9) Compute recsPerPg = min( (#slots fitting in page), number of bits in slotmap ).
+    9) Compute recsPerPg = min( (#slots of the page record length fitting in page), number of bits in slotmap ).
+       On a slotted page, the shortest record (empty "vN" values) and its directory entry make a slot.
     10) Insert a RelCatRec into relcat using InsertRec().
     11) For each attribute:
-        a) Construct an AttrCatRec with correct offset, type, length.
+        a) Construct an AttrCatRec with correct offset, type, length and encoding; an "eN" attribute has type "s"
+           and encoding ENC_DICT, and any dictionary left by an older relation of the same name is removed;
+           a "vN" attribute has type "s" and encoding ENC_VAR.
         b) Insert into attrcat via InsertRec().
     12) Print success message if invoked by the user.
 
@@ -85,6 +122,8 @@ ERRORS REPORTED:
     DUP_ATTR           – Duplicate attribute names in schema.
     INVALID_FORMAT     – Illegal attribute type format.
     STR_LEN_INVALID    – String length invalid or exceeds limits.
+    INVALID_OPTION     – Unknown page layout.
+    INVALID_FORMAT     – pax asked for "vN" attributes.
     RELEXIST           – Relation already exists in catalogs.
     REC_TOO_LONG       – Record does not fit a single page.
     FILESYSTEM_ERROR   – Unable to create file.
@@ -97,7 +136,7 @@ GLOBAL VARIABLES MODIFIED:
         • attrcat updated with K attribute entries.
 
 IMPLEMENTATION NOTES:
-    - The freemap file is created empty; all bits = 0 until InsertRec() begins populating pages.
+    - The freemap file is created empty; no page has free space recorded until InsertRec() adds pages.
     - This function does not open the relation; it only creates metadata and empty files.
     - The caller must ensure the CREATE command syntax is correct.
     - Relation file is created empty; no pages exist until the first INSERT.
@@ -117,13 +156,33 @@ int Create(int argc, char *argv[])
     
     char *relName = argv[1];
     int recLength = 0;
+    int pageRecLength = 0;
     int recsPerPg, numAttrs, numRecs, numPgs;
+    int layout = LAYOUT_ROW;
+    int numVar = 0;
     
     if(strlen(relName) >= RELNAME)
     {
         db_err_code = REL_LENGTH_EXCEEDED;
         return ErrorMsgs(db_err_code, print_flag && flag);
     }
+
+    /* Attributes come in pairs: an odd count ends with the layout */
+    if(argc % 2 == 1)
+    {
+        char *option = argv[--argc];
+
+        if(strcmp(option, "pax") == OK)
+        {
+            layout = LAYOUT_PAX;
+        }
+        else if(strcmp(option, "row") != OK)
+        {
+            printf("Unknown page layout '%s' (expected row or pax).\n", option);
+            db_err_code = INVALID_OPTION;
+            return ErrorMsgs(db_err_code, print_flag && flag);
+        }
+    }
     
     for(int i=2; i<argc; i+=2)
     {
@@ -155,17 +214,16 @@ int Create(int argc, char *argv[])
     {
         char *format = argv[j];
 
-        if (strcmp(format, "i") == 0)
-        {
-            recLength += sizeof(int);
-            continue;
-        }
-        else if (strcmp(format, "f") == 0)
+        char type;
+        int length;
+
+        if (numericFormat(format, &type, &length))
         {
-            recLength += sizeof(float);
+            recLength += length;
+            pageRecLength += length;
             continue;
         }
-        else if (format[0] == 's')
+        else if (format[0] == 's' || format[0] == 'e' || format[0] == 'v')
         {
             if(strlen(format) < 2)
             {
@@ -201,6 +259,11 @@ int Create(int argc, char *argv[])
             else
             {
                 recLength += (N + 1);
+
+                if(format[0] == 'v')
+                    numVar++;
+                else
+                    pageRecLength += format[0] == 'e' ? (int)sizeof(int) : N + 1;
             }
         }
         else
@@ -211,14 +274,26 @@ int Create(int argc, char *argv[])
         }
     }
 
-    if(FindRel(relName))
+    if(FindRel(relName) || ViewFind(relName))
     {
         printf("Relation '%s' already exists in the DB.\n", relName);
         db_err_code = RELEXIST;
         return ErrorMsgs(db_err_code, print_flag && flag);
     }
 
-    if(recLength > (PAGESIZE - HEADER_SIZE))
+    if(numVar)
+    {
+        if(layout == LAYOUT_PAX)
+        {
+            printf("Variable-length attributes need slotted pages; drop 'using pax'.\n");
+            db_err_code = INVALID_FORMAT;
+            return ErrorMsgs(db_err_code, print_flag && flag);
+        }
+        layout = LAYOUT_SLOTTED;
+    }
+
+    /* A slotted record of full-length values takes recLength bytes and a directory entry */
+    if(recLength + (numVar ? (int)sizeof(unsigned short) : 0) > (PAGESIZE - HEADER_SIZE))
     {
         db_err_code = REC_TOO_LONG;
         return ErrorMsgs(db_err_code, print_flag && flag);
@@ -244,12 +319,15 @@ int Create(int argc, char *argv[])
     }
     fclose(fmap);
 
-    recsPerPg = MIN((PAGESIZE - HEADER_SIZE) / recLength, (sizeof(unsigned long) << 3));
+    if(layout == LAYOUT_SLOTTED)
+        recsPerPg = MIN((PAGESIZE - HEADER_SIZE) / (pageRecLength + numVar + (int)sizeof(unsigned short)), (sizeof(unsigned long) << 3));
+    else
+        recsPerPg = MIN((PAGESIZE - HEADER_SIZE) / pageRecLength, (sizeof(unsigned long) << 3));
     numAttrs  = (argc - 2) >> 1;
     numRecs   = 0;
     numPgs    = 0;
 
-    RelCatRec rc = {"relName", recLength, recsPerPg, numAttrs, numRecs, numPgs};
+    RelCatRec rc = {"relName", recLength, recsPerPg, numAttrs, numRecs, numPgs, layout};
     strncpy(rc.relName, relName, RELNAME);
 
     if(InsertRec(RELCAT_CACHE, &rc) == NOTOK)
@@ -263,27 +341,30 @@ int Create(int argc, char *argv[])
     {
         char *format = argv[j];
         AttrCatRec ac;
+        char type;
+        int length;
 
-        if(strcmp(format, "i") == 0)
+        if(numericFormat(format, &type, &length))
         {
-            ac = (AttrCatRec){offset, sizeof(int), "i", "attrName", "relName", false, 0, 0};
-            offset += sizeof(int);
+            ac = (AttrCatRec){offset, length, {type, '\0'}, "attrName", "relName", false, 0, 0, ENC_NONE};
+            offset += length;
         }
-        else if(strcmp(format, "f") == 0)
-        {
-            ac = (AttrCatRec){offset, sizeof(float), "f", "attrName", "relName", false, 0, 0};
-            offset += sizeof(float);
-        }
-        else if(format[0] == 's')
+        else
         {
             int N = atoi(format + 1);
-            ac = (AttrCatRec){offset, (N + 1), "s", "attrName", "relName", false, 0, 0};
+            int encoding = format[0] == 'e' ? ENC_DICT : (format[0] == 'v' ? ENC_VAR : ENC_NONE);
+            ac = (AttrCatRec){offset, (N + 1), "s", "attrName", "relName", false, 0, 0, encoding};
             offset += (N + 1);
         }
 
         strncpy(ac.relName, relName, RELNAME);
         strncpy(ac.attrName, argv[j-1], ATTRNAME);
 
+        if(ac.encoding == ENC_DICT && RemoveDict(relName, ac.attrName) == NOTOK)
+        {
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+
         if(InsertRec(ATTRCAT_CACHE, &ac) == NOTOK)
         {
             return ErrorMsgs(db_err_code, print_flag);
@@ -79,13 +79,18 @@ int CreateFromAttrList(const char *dstRelName, AttrDesc *head)
         switch (p->attr.type[0])
         {
             case 'i':
-                strcpy(format, "i");
-                break;
             case 'f':
-                strcpy(format, "f");
+                /* 4-byte ints and floats keep the plain format */
+                if (p->attr.length == 4)
+                    snprintf(format, sizeof(format), "%c", p->attr.type[0]);
+                else
+                    snprintf(format, sizeof(format), "%c%d", p->attr.type[0], p->attr.length);
+                break;
+            case 'd':
+                strcpy(format, "date");
                 break;
             case 's':
-                snprintf(format, sizeof(format), "s%d", p->attr.length);
+                snprintf(format, sizeof(format), "s%d", p->attr.length - 1);  // length counts the NUL
                 break;
             default:
                 format[0] = '\0';
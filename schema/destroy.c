@@ -15,6 +15,12 @@
 #include "../include/deleterec.h"
 #include "../include/findrec.h"
 #include "../include/freemap.h"   // for build_fmap_filename
+#include "../include/idxmaint.h"   // for RemoveIndexFiles
+#include "../include/zonemap.h"    // for RemoveZoneMap
+#include "../include/stats.h"      // for RemoveStats
+#include "../include/dict.h"       // for RemoveDict
+#include "../include/bloom.h"      // for build_rbloom_filename
+#include "../include/view.h"       // for ViewDrop
 
 
 /*------------------------------------------------------------
@@ -32,21 +38,22 @@ SPECIFICATIONS:
 
 FUNCTION DESCRIPTION:
     The DESTROY command permanently removes a relation from the database.
-    The relation file and the corresponding freemap file of the relation are deleted from the file system. 
+    The relation file, the corresponding freemap, zone map, statistics and record Bloom filter files and any index and dictionary files of the relation are deleted from the file system. 
     After that, the system catalogs are updated by removing the relation entry from RELCAT and all of its attribute entries from ATTRCAT.
     The routine ensures that catalog relations themselves cannot be destroyed. 
     It also ensures that the relation exists before attempting destruction.
+    Destroying a view (see algebra/view.c) drops it, and the views that read it, with ViewDrop().
 
 ALGORITHM:
     1) Check that a database is currently open.
-    2) Reject attempts to destroy RELCAT or ATTRCAT.
+    2) Reject attempts to destroy RELCAT or ATTRCAT; drop a view and return.
     3) Look up the relation name in RELCAT using FindRec().
         • If not found, report relation does not exist.
     4) If the relation is open, close it using CloseRel().
     5) Remove the relation file from the file system.
-    6) Construct and remove the freemap file for the relation.
+    6) Construct and remove the freemap, zone map, statistics and record Bloom filter files for the relation.
     7) Delete the relation's catalog entry from RELCAT.
-    8) Repeatedly search for and delete all catalog entries in ATTRCAT corresponding to this relation.
+    8) Repeatedly search for and delete all catalog entries in ATTRCAT corresponding to this relation, removing the index files and dictionary each entry refers to.
     9) Report successful destruction.
 
 BUGS:
@@ -103,6 +110,14 @@ int Destroy(int argc, char *argv[])
         return ErrorMsgs(db_err_code, print_flag && flag);
     }
 
+    /* A view has no files or catalog entries */
+    if (flag && ViewFind(relName))
+    {
+        free(relCatRecPtr);
+        free(attrCatRecPtr);
+        return ViewDrop(relName);
+    }
+
     /* Find relation in RelCat */
     int status = FindRec(RELCAT_CACHE, startRid, &startRid,
                          relCatRecPtr, 's', RELNAME,
@@ -142,11 +157,13 @@ int Destroy(int argc, char *argv[])
         return ErrorMsgs(db_err_code, print_flag && flag);
     }
 
-    /* ---------- 2. Remove the freemap file ---------- */
-    char freeMapName[RELNAME + 6];
+    /* ---------- 2. Remove the freemap, zone map, statistics and record filter files ---------- */
+    char freeMapName[RELNAME + 6], rbloomName[RELNAME + 8];
     build_fmap_filename(relName, freeMapName, sizeof(freeMapName));
+    build_rbloom_filename(relName, rbloomName, sizeof(rbloomName));
 
-    if (remove(freeMapName) != 0 && errno != ENOENT)
+    if ((remove(freeMapName) != 0 && errno != ENOENT) || RemoveZoneMap(relName) == NOTOK || RemoveStats(relName) == NOTOK ||
+        (remove(rbloomName) != 0 && errno != ENOENT))
     {
         db_err_code = FILESYSTEM_ERROR;
         free(relCatRecPtr);
@@ -154,7 +171,8 @@ int Destroy(int argc, char *argv[])
         return ErrorMsgs(db_err_code, print_flag && flag);
     }
 
-    printf("Relation %s destroyed successfully.\n", relName);
+    if (flag)
+        printf("Relation %s destroyed successfully.\n", relName);
 
     /* ---------- 3. Now update catalogs ---------- */
 
@@ -184,6 +202,9 @@ int Destroy(int argc, char *argv[])
 
         if (isValidRid(startRid))
         {
+            RemoveIndexFiles(relName, (AttrCatRec *)attrCatRecPtr);
+            RemoveDict(relName, ((AttrCatRec *)attrCatRecPtr)->attrName);
+
             if(DeleteRec(ATTRCAT_CACHE, startRid) == NOTOK)
             {
                 return ErrorMsgs(db_err_code, print_flag && flag);
@@ -8,6 +8,8 @@
 #include "../include/findrelattr.h"
 #include "../include/writerec.h"
 #include "../include/unpinrel.h"
+#include "../include/idxmaint.h"
+#include "../include/view.h"
 #include <stdio.h>
 #include <stddef.h>
 #include <string.h>
@@ -23,13 +25,15 @@ PARAMETER DESCRIPTION:
 FUNCTION DESCRIPTION:
     Clears the index flag for a specific attribute and writes the updated attribute metadata back to the ATTRCAT relation.
     Operational steps:
+        - Remove the index files of the attribute (RemoveIndexFiles()).
         - Set hasIndex = 0 within attrPtr->attr.
         - Persist the modified attribute catalog record using WriteRec().
 
 ALGORITHM:
-    1) Set attrPtr->attr.hasIndex = 0.
-    2) Call WriteRec(ATTRCAT_CACHE, &attrPtr->attr, attrPtr->attrCatRid).
-    3) If WriteRec() fails → return NOTOK, otherwise return OK.
+    1) Unlink the index files named by the hasIndex bits.
+    2) Set attrPtr->attr.hasIndex = 0 and clear nPages/nKeys.
+    3) Call WriteRec(ATTRCAT_CACHE, &attrPtr->attr, attrPtr->attrCatRid).
+    4) If WriteRec() fails → return NOTOK, otherwise return OK.
 
 
 ERRORS REPORTED:
@@ -40,7 +44,7 @@ GLOBAL VARIABLES MODIFIED:
     The corresponding record in ATTRCAT on disk (via WriteRec)
 
 IMPLEMENTATION NOTES:
-    - This function must be invoked only after ensuring that the index exists (hasIndex == 1).
+    - This function must be invoked only after ensuring that the index exists (hasIndex != 0).
     - Caller is responsible for error propagation and user-visible messages.
     - Does not close or flush any relation; purely updates catalog data.
 
@@ -48,7 +52,13 @@ IMPLEMENTATION NOTES:
 
 int removeIndex(AttrDesc *attrPtr)
 {
+    if(RemoveIndexFiles(attrPtr->attr.relName, &(attrPtr->attr)) == NOTOK)
+    {
+        return NOTOK;
+    }
+
     attrPtr->attr.hasIndex = 0;
+    attrPtr->attr.nPages = attrPtr->attr.nKeys = 0;
 
     if(WriteRec(ATTRCAT_CACHE, &(attrPtr->attr), attrPtr->attrCatRid) != OK)
     {
@@ -74,8 +84,8 @@ SPECIFICATIONS:
     argv[argc] = NIL
 
 FUNCTION DESCRIPTION:
-    Removes index metadata from a specified attribute of a relation, or from all attributes if no attribute name is supplied. 
-    This routine only modifies catalog data (attrcat). 
+    Removes the index of a specified attribute of a relation, or of all attributes if no attribute name is supplied. 
+    The index files are deleted and the catalog data (attrcat) is updated. 
     Indexes on catalog relations (relcat, attrcat) are explicitly disallowed.
 
 ALGORITHM:
@@ -98,6 +108,7 @@ ALGORITHM:
 ERRORS REPORTED:
     DBNOTOPEN
     RELNOEXIST
+    VIEW_READONLY
     METADATA_SECURITY
     ATTRNOEXIST
     IDXNOEXIST
@@ -110,7 +121,7 @@ GLOBAL VARIABLES MODIFIED:
 
 IMPLEMENTATION NOTES (IF ANY):
     • removeIndex() is called to sets hasIndex = 0 and write the updated AttrCatRec back to attrcat.
-    • No physical index structures are created or destroyed, MINIREL handles only the catalog metadata at this stage.
+    • removeIndex() also unlinks the "<rel>.<attr>.*" index files named by the hasIndex bits.
 
 ------------------------------------------------------------*/
 
@@ -127,6 +138,11 @@ int DropIndex(int argc, char **argv)
 
     AttrDesc *attrPtr = NULL;
 
+    if(ViewIsReadOnly(relName))
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
     int r = OpenRel(relName);
 
     if(r == NOTOK)
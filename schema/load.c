@@ -9,6 +9,8 @@
 #include "../include/freemap.h"
 #include "../include/insertrec.h"
 #include "../include/unpinrel.h"
+#include "../include/bloom.h"
+#include "../include/view.h"
 #include <stdio.h>
 #include <stddef.h>
 #include <sys/stat.h>
@@ -23,7 +25,7 @@ FUNCTION swap_bytes (data, size)
 
 PARAMETER DESCRIPTION:
     data : Pointer to a byte-buffer containing a single value.
-    size : Number of bytes making up that value (typically sizeof(int) = 4 or sizeof(float) = 4).
+    size : Number of bytes making up that value (the attribute's length: 1, 2, 4 or 8).
 
 FUNCTION DESCRIPTION:
     This routine reverses the byte order of the object stored at *data. 
@@ -82,9 +84,8 @@ FUNCTION DESCRIPTION:
         - Opens the target relation and confirms it exists.
         - Validates the filepath syntax and checks existence of the external file.
         - Determines the system's endian architecture.
-        - Precomputes offsets of INT and FLOAT attributes for on-the-fly byte-swapping.
         - Reads one record at a time from the source file.
-        - Performs endian conversion for INT and FLOAT attributes (external file is assumed big-endian; host system may be little-endian).
+        - Performs endian conversion for INT, FLOAT and DATE attributes of any width (external file is assumed big-endian; host system may be little-endian).
         - Inserts each tuple using InsertRec(), thereby updating the relation file and freemap.
         - Stops on any failed INSERT and reports the appropriate error.
     Upon successful completion, all tuples in the external file appear in the relation (unless InsertRec rejected some tuple due to duplicate keys or other constraints).
@@ -97,26 +98,25 @@ ALGORITHM:
     5) Lookup record size and attribute descriptors from catcache.
     6) Allocate record buffer recPtr.
     7) Detect host endianness.
-    8) Traverse attribute list twice:
-        a) First pass → count number of INT and FLOAT attributes.
-        b) Second pass → record their byte offsets inside the tuple.
+    8) Traverse attribute list once to size the on-disk record (strings are stored without their NUL).
     9) fopen() the external file in "rb" mode.
     10) Repeatedly fread() tuples of size recSize:
-        a) If system is little-endian, swap bytes of all INT/FLOAT fields.
+        a) If system is little-endian, swap bytes of every non-string field over its length.
         b) Call InsertRec() to append tuple into the file.
         c) Stop immediately if InsertRec() returns NOTOK.
     11) Check for incomplete read or file error → FILESYSTEM_ERROR.
-    12) Free all allocated buffers and close file.
+    12) Free all allocated buffers and close file, then resize any Bloom filter the load outgrew (BloomRefresh()).
     13) CloseRel() the target relation.
     14) Print success message indicating number of tuples loaded.
 
 ERRORS REPORTED:
     DBNOTOPEN        – No open database.
     RELNOEXIST       – Target relation not found.
+    VIEW_READONLY    – Target is a view.
     PATH_NOT_VALID   – External filename contains illegal characters.
     FILE_NO_EXIST    – External file does not exist.
     FILESYSTEM_ERROR – OS-level I/O failure while opening or reading file.
-    MEM_ALLOC_ERROR  – Failed to allocate record buffer or offset arrays.
+    MEM_ALLOC_ERROR  – Failed to allocate record buffers.
     REC_INS_ERR      – InsertRec() failure for a particular tuple.
     Any InsertRec()-level error (e.g., DUP_ROWS, REL_PAGE_LIMIT_REACHED) is also propagated.
 
@@ -142,6 +142,11 @@ int Load(int argc, char **argv)
     char *relName = argv[1];
     char *fileName = argv[2];
 
+    if (ViewIsReadOnly(relName))
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
     // Try to open the relation to check if it exists
     int r = OpenRel(relName);
     if (r == NOTOK)
@@ -202,72 +207,16 @@ int Load(int argc, char **argv)
         is_little_endian = 0; // system is big-endian
     }
 
-    // Pre-compute offsets that need endianness conversion
-    int *int_offsets = NULL;
-    int *float_offsets = NULL;
-    int int_count = 0;
-    int float_count = 0;
+    // Count the string attributes, which are one byte shorter on disk
     int string_count = 0;
+    AttrDesc *ptr;
 
-    // First pass: count the number of int, float and string attributes
-    AttrDesc *ptr = catcache[r].attrList;
-    while (ptr)
+    for (ptr = catcache[r].attrList; ptr; ptr = ptr->next)
     {
-        char t = ptr->attr.type[0];
-        if (t == 'i')
-        {
-            int_count++;
-        }
-        else if (t == 'f')
-        {
-            float_count++;
-        }
-        else if (t == 's')  // string attribute (length includes trailing NUL)
+        if (ptr->attr.type[0] == 's')  // string attribute (length includes trailing NUL)
         {
             string_count++;
         }
-        ptr = ptr->next;
-    }
-
-    // Allocate arrays for offsets
-    if (int_count > 0)
-    {
-        int_offsets = malloc(int_count * sizeof(int));
-        if (!int_offsets)
-        {
-            free(recPtr);
-            CloseRel(r);
-            return ErrorMsgs(MEM_ALLOC_ERROR, print_flag);
-        }
-    }
-
-    if (float_count > 0)
-    {
-        float_offsets = malloc(float_count * sizeof(int));
-        if (!float_offsets)
-        {
-            free(int_offsets);
-            free(recPtr);
-            CloseRel(r);
-            return ErrorMsgs(MEM_ALLOC_ERROR, print_flag);
-        }
-    }
-
-    // Second pass: collect the offsets
-    ptr = catcache[r].attrList;
-    int int_idx = 0, float_idx = 0;
-    while (ptr)
-    {
-        char t = ptr->attr.type[0];
-        if (t == 'i')
-        {
-            int_offsets[int_idx++] = ptr->attr.offset;
-        }
-        else if (t == 'f')
-        {
-            float_offsets[float_idx++] = ptr->attr.offset;
-        }
-        ptr = ptr->next;
     }
 
     // Compute on-disk record size: each string attribute on disk lacks the trailing NUL
@@ -278,8 +227,6 @@ int Load(int argc, char **argv)
     if (!file)
     {
         db_err_code = FILESYSTEM_ERROR;
-        free(int_offsets);
-        free(float_offsets);
         free(recPtr);
         CloseRel(r);
         return ErrorMsgs(db_err_code, print_flag);
@@ -290,8 +237,6 @@ int Load(int argc, char **argv)
     if (!fileBuf)
     {
         db_err_code = MEM_ALLOC_ERROR;
-        free(int_offsets);
-        free(float_offsets);
         free(recPtr);
         fclose(file);
         CloseRel(r);
@@ -332,40 +277,25 @@ int Load(int argc, char **argv)
             }
             else
             {
-                // Non-string attribute: copy full length bytes from file
+                // Non-string attribute: copy full length bytes from file, converting
+                // the big-endian int, float or date of any width to host order
                 memcpy(recPtr + offset, fileBuf + file_pos, length);
+                if (is_little_endian)
+                {
+                    swap_bytes(recPtr + offset, length);
+                }
                 file_pos += length;
             }
 
             ptr = ptr->next;
         }
 
-        // Convert integers and floats from big-endian to little-endian if needed
-        if (is_little_endian)
-        {
-            // Convert integers
-            for (int i = 0; i < int_count; i++)
-            {
-                char *int_ptr = recPtr + int_offsets[i];
-                swap_bytes(int_ptr, sizeof(int));
-            }
-
-            // Convert floats
-            for (int i = 0; i < float_count; i++)
-            {
-                char *float_ptr = recPtr + float_offsets[i];
-                swap_bytes(float_ptr, sizeof(float));
-            }
-        }
-
         // Insert the record into the relation
         insertResult = InsertRec(r, recPtr);
 
         if (insertResult == NOTOK)
         {
             // InsertRec failed, db_err_code should already be set by InsertRec
-            free(int_offsets);
-            free(float_offsets);
             free(recPtr);
             free(fileBuf);
             fclose(file);
@@ -378,8 +308,6 @@ int Load(int argc, char **argv)
     if (!feof(file) && ferror(file))
     {
         db_err_code = FILESYSTEM_ERROR;
-        free(int_offsets);
-        free(float_offsets);
         free(recPtr);
         free(fileBuf);
         fclose(file);
@@ -389,11 +317,16 @@ int Load(int argc, char **argv)
 
     // Clean up
     fclose(file);
-    free(int_offsets);
-    free(float_offsets);
     free(recPtr);
     free(fileBuf);
 
+    // Filters sized before a bulk load are rebuilt now rather than on the next Insert()
+    if (BloomRefresh(r) == NOTOK)
+    {
+        CloseRel(r);
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
     // Print success message if all records were loaded successfully
     printf("%s successfully loaded with %d tuples.\n", relName, recordsRead);
     UnPinRel(r);
@@ -4,15 +4,46 @@
 #include "../include/error.h"
 #include "../include/globals.h"
 #include "../include/helpers.h"
-#include "../include/openrel.h"
-#include "../include/getnextrec.h"
-#include "../include/unpinrel.h"
+#include "../include/iterator.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 #include <limits.h>
-#include <float.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+#define DATE_LEN        10          /* "YYYY-MM-DD" */
+#define FLOAT_LEN       11          /* widest of "10000000.00" (9999999.99f), "%.2e" of -FLT_MAX and of -DBL_MAX */
+#define NUM_LEN         32          /* room for any formatted number */
+#define PRINT_BUF_BYTES (1 << 20)   /* output gathered before each write() */
+
+enum { FMT_TABLE, FMT_CSV, FMT_TSV };
+
+/* Output of Print(): rows are formatted into buf, which goes out with one write() whenever it fills */
+typedef struct
+{
+    int fd;
+    char *buf;
+    size_t len;
+    bool failed;            // a write() failed; the rest is dropped
+} OutBuf;
+
+static void outFlush(OutBuf *out);
+static char *outReserve(OutBuf *out, size_t n);
+static void outBytes(OutBuf *out, const char *s, size_t n);
+static void outPadded(OutBuf *out, const char *s, int len, int width, bool left);
+static void outField(OutBuf *out, const char *s, int len, int format);
+static void printSeparator(OutBuf *out, AttrDesc *attrList, int *colWidths);
+static void printHeader(OutBuf *out, AttrDesc *attrList, int *colWidths);
+static int formatIntValue(long long value, char *out);
+static int formatFloatValue(float value, char *out);
+static int formatDoubleValue(double value, char *out);
+static int formatShortest(double value, bool isFloat, char *out);
+static int formatStringValue(const char *data, int length);
 
 
 /*------------------------------------------------------------
@@ -25,37 +56,47 @@ PARAMETER DESCRIPTION:
 
 SPECIFICATIONS:
     argv[0] = "print"
-    argv[1] = relation name
+    argv[1] = relation or view name
+    argv[2] = (optional) file to write to; "" for the screen
+    argv[3] = (optional) "table" (the default), "csv" or "tsv"
     argv[argc] = NIL
 
 FUNCTION DESCRIPTION:
-    This routine implements a formatted table-style display of all tuples stored in a given relation. 
+    This routine implements a formatted table-style display of all tuples stored in a given relation.
     It prints a well-aligned header, column separators, and every record  in the relation using attribute-appropriate formatting (integers, floating-point values, and strings).
-    For floating-point attributes, the routine automatically chooses a readable representation: fixed-point when appropriate and scientific notation when the numeric range or precision requires it. 
+    For floating-point attributes, the routine automatically chooses a readable representation: fixed-point when appropriate and scientific notation when the numeric range or precision requires it.
     String attributes are trimmed of trailing spaces and NULL characters.
+    "print R to "file" format csv|tsv|table" writes the relation to a file instead, for other tools:
+        • csv → a header line of attribute names, then one line per tuple; a string holding a comma, a quote or a
+                line break is quoted, with its quotes doubled (RFC 4180).
+        • tsv → the same separated by tabs; a tab, line break or backslash in a string is escaped as \t, \n, \r, \\.
+        • table → the display above.
+      In csv and tsv a float is written with the fewest digits that read back to the same value.
+    A relative file name is taken from the directory MINIREL was started in, not the database directory.
     This is strictly a read-only operator.
 
 ALGORITHM:
-    1) Ensure a database is currently open.
-    2) Verify that the given relation exists and call OpenRel().
-    3) Count number of attributes in the relation.
-    4) Allocate an array of column widths.
-    5) Determine each column’s width:
+    1) Ensure a database is currently open, and that the format is known.
+    2) Open an iterator over the relation or view with IterOpen(); it reports a missing relation.
+    3) Open (create or truncate) the output file, if one is given.
+    4) Count number of attributes in the relation.
+    5) Allocate an array of column widths.
+    6) Determine each column’s width:
         a) Width = max(attribute-name length, maximum printable data width) + padding.
-        b) For integers, compute max printable width using INT_MIN.
-        c) For floats, compute maximum width across:
-            • normal fixed-decimal printing
-            • scientific notation for FLT_MAX and –FLT_MAX
+        b) For integers, the width of the smallest value of the attribute's width; dates take 10.
+        c) For floats, FLOAT_LEN: the widest of fixed-decimal printing of 9999999.99f and of scientific notation for
+           –FLT_MAX (–DBL_MAX for "f8").
         d) For strings, width is the attribute’s defined length.
-    6) Print header and separators.
-    7) Repeatedly call GetNextRec() to scan every tuple:
+    7) Print header and separators (the attribute names for csv and tsv).
+    8) Pull every tuple with IterNext(), formatting it into the output buffer as it arrives:
         a) For each attribute:
             • Read data at offset
             • Convert to printable string (via helper routines)
-            • Print left/right-aligned depending on type
+            • Print left/right-aligned depending on type, or as a csv/tsv field
         b) Maintain row count.
-    8) Print final separator and summary line showing number of rows.
-    9) Free all dynamic memory and return OK.
+        c) write() the buffer whenever it holds PRINT_BUF_BYTES.
+    9) Print final separator and summary line showing number of rows.
+    10) Write out the rest of the buffer, free all dynamic memory and return OK.
 
 BUGS:
     None known.
@@ -63,26 +104,26 @@ BUGS:
 ERRORS REPORTED:
     DBNOTOPEN        – Database was not opened.
     RELNOEXIST       – Relation not present in catalog.
+    INVALID_OPTION   – Output format other than table, csv or tsv.
+    FILESYSTEM_ERROR – The output file cannot be created or written.
     MEM_ALLOC_ERROR  – Failure during memory allocation.
 
 GLOBAL VARIABLES MODIFIED:
        db_err_code  – Set upon encountering an error.
 
 IMPLEMENTATION NOTES (IF ANY):
-    • Uses GetNextRec for record-by-record sequential scanning.
-    • Uses dynamic formatting helpers:
-        formatIntValue(), formatFloatValue(), formatStringValue(
+    • A relation is scanned a page at a time; a view is computed by the pipelined operators (algebra/iterator.c),
+      so its tuples are printed without being stored anywhere.
+    • Values are formatted by hand straight into the output buffer, which is written with write() rather than
+      through stdio; stdout is flushed first so earlier messages keep their place.
+      Scientific notation and the floats that need more than 17 digits still go through snprintf().
+    • Uses formatting helpers:
+        formatIntValue(), formatFloatValue(), formatDoubleValue(), formatShortest(), formatStringValue(),
+        and formatDate() for dates
+    • csv and tsv on the screen print the data alone, without the banner and row count.
 
 ------------------------------------------------------------*/
 
-/* assume all required headers, types, and globals (db_open, db_err_code, etc.) are defined */
-static void printSeparator(AttrDesc *attrList, int *colWidths);
-static void printHeader(AttrDesc *attrList, int *colWidths);
-static char* formatIntValue(int value);
-static char* formatFloatValue(float value);
-static char* formatStringValue(const char *data, int length);
-
-/* ============================================================= */
 int Print(int argc, char **argv)
 {
     if(!db_open)
@@ -92,28 +133,85 @@ int Print(int argc, char **argv)
     }
 
     char *relName = argv[1];
-    int r = OpenRel(relName);
+    char *fileName = argc > 2 ? argv[2] : "";
+    char *formatName = argc > 3 ? argv[3] : "table";
+    int format;
+
+    if(strcmp(formatName, "table") == OK)
+        format = FMT_TABLE;
+    else if(strcmp(formatName, "csv") == OK)
+        format = FMT_CSV;
+    else if(strcmp(formatName, "tsv") == OK)
+        format = FMT_TSV;
+    else
+    {
+        printf("Unknown output format '%s' (expected table, csv or tsv).\n", formatName);
+        db_err_code = INVALID_OPTION;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    Iter *it = IterOpen(relName);
 
-    if(r == NOTOK)
+    if(!it)
     {
-        if(db_err_code == RELNOEXIST)
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    OutBuf out = { STDOUT_FILENO, malloc(PRINT_BUF_BYTES), 0, false };
+
+    if(!out.buf)
+    {
+        IterClose(it);
+        db_err_code = MEM_ALLOC_ERROR;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if(*fileName)
+    {
+        char path[2 * MAX_PATH_LENGTH];
+
+        if(fileName[0] == '/')
+            snprintf(path, sizeof(path), "%s", fileName);
+        else
+            snprintf(path, sizeof(path), "%s/%s", ORIG_DIR, fileName);
+
+        out.fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+        if(out.fd < 0)
         {
-            printf("Relation '%s' does NOT exist in the DB.\n", relName);
-            printCloseStrings(RELCAT_CACHE, offsetof(RelCatRec, relName), relName, NULL);
+            printf("CANNOT create file '%s'.\n", fileName);
+            free(out.buf);
+            IterClose(it);
+            db_err_code = FILESYSTEM_ERROR;
+            return ErrorMsgs(db_err_code, print_flag);
         }
-        return ErrorMsgs(db_err_code, print_flag);
+    }
+    else
+    {
+        fflush(stdout);
     }
 
-    printf("OK, printing relation %s\n\n", relName);
+    bool banner = format == FMT_TABLE && out.fd == STDOUT_FILENO;
+
+    if(banner)
+    {
+        outBytes(&out, "OK, printing relation ", 22);
+        outBytes(&out, relName, strlen(relName));
+        outBytes(&out, "\n\n", 2);
+    }
 
     /* --------- Count attributes --------- */
-    int attrCount = 0;
-    for(AttrDesc *p = catcache[r].attrList; p; p = p->next)
-        attrCount++;
+    int attrCount = it->numAttrs;
 
     if(attrCount == 0)
     {
-        printf("(Empty relation)\n");
+        if(banner)
+            outBytes(&out, "(Empty relation)\n", 17);
+        outFlush(&out);
+        if(out.fd != STDOUT_FILENO)
+            close(out.fd);
+        free(out.buf);
+        IterClose(it);
         return OK;
     }
 
@@ -121,54 +219,40 @@ int Print(int argc, char **argv)
     int *colWidths = (int *)malloc(sizeof(int) * attrCount);
     if(!colWidths)
     {
+        if(out.fd != STDOUT_FILENO)
+            close(out.fd);
+        free(out.buf);
+        IterClose(it);
         return ErrorMsgs(MEM_ALLOC_ERROR, print_flag);
     }
 
     /* --------- Determine column widths --------- */
     int idx = 0;
-    for(AttrDesc *p = catcache[r].attrList; p; p = p->next, idx++)
+    for(AttrDesc *p = it->attrList; p; p = p->next, idx++)
     {
         int nameLen = (int)strlen(p->attr.attrName);
         int dataLen;
         switch(p->attr.type[0])
         {
-            case 'i': 
-                // Calculate maximum int string length (including sign)
+            case 'i':
+                // Maximum int string length (including sign) for the attribute's width
                 {
-                    char tempBuf[32];
-                    dataLen = snprintf(tempBuf, sizeof(tempBuf), "%d", INT_MIN);
+                    char tempBuf[NUM_LEN];
+                    long long minVal = p->attr.length == 8 ? LLONG_MIN : -(1LL << (8 * p->attr.length - 1));
+                    dataLen = formatIntValue(minVal, tempBuf);
                 }
                 break;
-            case 'f': 
-                // Calculate maximum width needed for float representation
-                // We need to consider both fixed-point and scientific notation
-                {
-                    // Fixed-point representation: "%.2f" for medium-sized numbers
-                    char tempBuf1[64];
-                    int len1 = snprintf(tempBuf1, sizeof(tempBuf1), "%.2f", 9999999.99f);
-                    
-                    // Scientific notation: "%.2e" for extreme values
-                    char tempBuf2[64];
-                    int len2 = snprintf(tempBuf2, sizeof(tempBuf2), "%.2e", FLT_MAX);
-                    
-                    // For negative values in scientific notation
-                    char tempBuf3[64];
-                    int len3 = snprintf(tempBuf3, sizeof(tempBuf3), "%.2e", -FLT_MAX);
-                    
-                    // Take the maximum of all representations
-                    dataLen = len1;
-                    if (len2 > dataLen) dataLen = len2;
-                    if (len3 > dataLen) dataLen = len3;
-                    
-                    // Ensure a reasonable minimum width
-                    if (dataLen < 10) dataLen = 10;
-                }
+            case 'd':
+                dataLen = DATE_LEN;
                 break;
-            case 's': 
-                dataLen = p->attr.length; 
+            case 'f':
+                dataLen = FLOAT_LEN;
                 break;
-            default:  
-                dataLen = 10; 
+            case 's':
+                dataLen = p->attr.length;
+                break;
+            default:
+                dataLen = 10;
                 break;
         }
 
@@ -178,190 +262,355 @@ int Print(int argc, char **argv)
     }
 
     /* --------- Print header --------- */
-    printHeader(catcache[r].attrList, colWidths);
-
-    /* --------- Print records --------- */
-    Rid startRid = INVALID_RID;
-    int recSize = catcache[r].relcat_rec.recLength;
-    void *recPtr = malloc(recSize);
-    if(!recPtr)
+    if(format == FMT_TABLE)
     {
-        free(colWidths);
-        return ErrorMsgs(MEM_ALLOC_ERROR, print_flag);
+        printHeader(&out, it->attrList, colWidths);
+    }
+    else
+    {
+        for(AttrDesc *p = it->attrList; p; p = p->next)
+        {
+            outField(&out, p->attr.attrName, strlen(p->attr.attrName), format);
+            outBytes(&out, p->next ? (format == FMT_CSV ? "," : "\t") : "\n", 1);
+        }
     }
 
+    /* --------- Print records --------- */
+    char *recPtr;
     int rowCount = 0;
 
-    while(true)
+    while(IterNext(it, &recPtr) == 1)
     {
-        int status = GetNextRec(r, startRid, &startRid, recPtr);
-        if(status == NOTOK || !isValidRid(startRid))
-            break;
-
-        printf("|");
+        if(format == FMT_TABLE)
+            outBytes(&out, "|", 1);
         idx = 0;
 
-        for(AttrDesc *p = catcache[r].attrList; p; p = p->next, idx++)
+        for(AttrDesc *p = it->attrList; p; p = p->next, idx++)
         {
             AttrCatRec *ac = &(p->attr);
             char *attrPtr = (char *)recPtr + ac->offset;
+            char num[NUM_LEN];
+            const char *text = num;
+            int len;
+            bool left = false;
 
             switch(ac->type[0])
             {
-                case 'i': {
-                    int ival;
-                    memcpy(&ival, attrPtr, sizeof(int));
-                    char *formatted = formatIntValue(ival);
-                    if (formatted) {
-                        printf(" %*s |", colWidths[idx] - 2, formatted);
-                        free(formatted);
-                    } else {
-                        printf(" %*s |", colWidths[idx] - 2, "ERROR");
-                    }
+                case 'i':
+                    len = formatIntValue(getIntValue(attrPtr, ac->length), num);
                     break;
-                }
 
-                case 'f': {
-                    float fval;
-                    memcpy(&fval, attrPtr, sizeof(float));
-                    char *formatted = formatFloatValue(fval);
-                    if (formatted) {
-                        printf(" %*s |", colWidths[idx] - 2, formatted);
-                        free(formatted);
+                case 'f':
+                    if (format != FMT_TABLE) {
+                        len = formatShortest(getFloatValue(attrPtr, ac->length), ac->length != sizeof(double), num);
+                    } else if (ac->length == sizeof(double)) {
+                        len = formatDoubleValue(getFloatValue(attrPtr, ac->length), num);
                     } else {
-                        printf(" %*s |", colWidths[idx] - 2, "ERROR");
+                        float fval;
+                        memcpy(&fval, attrPtr, sizeof(float));
+                        len = formatFloatValue(fval, num);
                     }
                     break;
-                }
 
-                case 's': {
-                    int len = ac->length;
-                    char *formatted = formatStringValue(attrPtr, len);
-                    if (formatted) {
-                        printf(" %-*s |", colWidths[idx] - 2, formatted);
-                        free(formatted);
-                    } else {
-                        printf(" %-*s |", colWidths[idx] - 2, "ERROR");
-                    }
+                case 'd':
+                    formatDate((int)getIntValue(attrPtr, ac->length), num);
+                    len = (int)strlen(num);
                     break;
-                }
 
-                default: {
-                    char *unknown = strdup("(unknown)");
-                    if (unknown) {
-                        printf(" %-*s |", colWidths[idx] - 2, unknown);
-                        free(unknown);
-                    } else {
-                        printf(" %-*s |", colWidths[idx] - 2, "ERROR");
-                    }
+                case 's':
+                    text = attrPtr;
+                    len = formatStringValue(attrPtr, ac->length);
+                    left = true;
                     break;
-                }
+
+                default:
+                    text = "(unknown)";
+                    len = 9;
+                    left = true;
+                    break;
+            }
+
+            if(format == FMT_TABLE)
+            {
+                outBytes(&out, " ", 1);
+                outPadded(&out, text, len, colWidths[idx] - 2, left);
+                outBytes(&out, " |", 2);
+            }
+            else
+            {
+                outField(&out, text, len, format);
+                if(p->next)
+                    outBytes(&out, format == FMT_CSV ? "," : "\t", 1);
             }
         }
 
-        printf("\n");
+        outBytes(&out, "\n", 1);
         rowCount++;
     }
 
     /* --------- Footer --------- */
-    if (rowCount > 0) {
-        printSeparator(catcache[r].attrList, colWidths);
+    if(format == FMT_TABLE)
+    {
+        if (rowCount > 0) {
+            printSeparator(&out, it->attrList, colWidths);
+        }
+        if(banner)
+        {
+            char count[NUM_LEN];
+
+            outBytes(&out, count, formatIntValue(rowCount, count));
+            outBytes(&out, rowCount == 1 ? " row in set\n" : " rows in set\n", rowCount == 1 ? 12 : 13);
+        }
     }
-    printf("%d row%s in set\n", rowCount, (rowCount == 1 ? "" : "s"));
 
-    free(recPtr);
+    outFlush(&out);
+
+    bool failed = out.failed;
+
+    if(out.fd != STDOUT_FILENO && close(out.fd) != OK)
+        failed = true;
+
+    free(out.buf);
     free(colWidths);
-    UnPinRel(r);
-    
+    IterClose(it);
+
+    if(failed)
+    {
+        printf("CANNOT write relation %s to '%s'.\n", relName, *fileName ? fileName : "stdout");
+        db_err_code = FILESYSTEM_ERROR;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if(*fileName)
+    {
+        printf("Printed %d row%s of %s to %s as %s.\n", rowCount, (rowCount == 1 ? "" : "s"), relName, fileName, formatName);
+    }
+
     return OK;
 }
 
 /* ============================================================= */
 /* --------- Helper functions --------- */
 
-static void printSeparator(AttrDesc *attrList, int *colWidths)
+/* Writes out what the buffer holds, however many write() calls the file takes */
+static void outFlush(OutBuf *out)
+{
+    size_t done = 0;
+
+    while(!out->failed && done < out->len)
+    {
+        ssize_t n = write(out->fd, out->buf + done, out->len - done);
+
+        if(n <= 0)
+            out->failed = true;
+        else
+            done += n;
+    }
+    out->len = 0;
+}
+
+/* Room for n more bytes at the end of the buffer; n is at most PRINT_BUF_BYTES */
+static char *outReserve(OutBuf *out, size_t n)
+{
+    if(out->len + n > PRINT_BUF_BYTES)
+        outFlush(out);
+    return out->buf + out->len;
+}
+
+static void outBytes(OutBuf *out, const char *s, size_t n)
+{
+    while(n > 0)
+    {
+        size_t chunk = n < PRINT_BUF_BYTES ? n : PRINT_BUF_BYTES;
+
+        memcpy(outReserve(out, chunk), s, chunk);
+        out->len += chunk;
+        s += chunk;
+        n -= chunk;
+    }
+}
+
+/* s padded with blanks to width, as printf("%*s") or, when left, printf("%-*s") */
+static void outPadded(OutBuf *out, const char *s, int len, int width, bool left)
+{
+    int pad = width > len ? width - len : 0;
+
+    if(!left)
+    {
+        memset(outReserve(out, pad), ' ', pad);
+        out->len += pad;
+    }
+    outBytes(out, s, len);
+    if(left)
+    {
+        memset(outReserve(out, pad), ' ', pad);
+        out->len += pad;
+    }
+}
+
+/* One csv or tsv field: csv quotes a field holding a comma, quote or line break; tsv escapes tabs and line breaks */
+static void outField(OutBuf *out, const char *s, int len, int format)
+{
+    int special = 0;
+
+    for(int i = 0; i < len; i++)
+    {
+        char c = s[i];
+
+        if(c == '\n' || c == '\r' || (format == FMT_CSV ? (c == ',' || c == '"') : (c == '\t' || c == '\\')))
+            special++;
+    }
+
+    if(!special)
+    {
+        outBytes(out, s, len);
+        return;
+    }
+
+    /* at most two bytes for each byte, and the quotes */
+    char *d = outReserve(out, 2 * (size_t)len + 2), *start = d;
+
+    if(format == FMT_CSV)
+    {
+        *d++ = '"';
+        for(int i = 0; i < len; i++)
+        {
+            if(s[i] == '"')
+                *d++ = '"';
+            *d++ = s[i];
+        }
+        *d++ = '"';
+    }
+    else
+    {
+        for(int i = 0; i < len; i++)
+        {
+            char c = s[i];
+
+            if(c == '\t' || c == '\n' || c == '\r' || c == '\\')
+            {
+                *d++ = '\\';
+                c = c == '\t' ? 't' : c == '\n' ? 'n' : c == '\r' ? 'r' : '\\';
+            }
+            *d++ = c;
+        }
+    }
+    out->len += d - start;
+}
+
+static void printSeparator(OutBuf *out, AttrDesc *attrList, int *colWidths)
 {
     int idx = 0;
-    printf("+");
+    outBytes(out, "+", 1);
     for(AttrDesc *p = attrList; p; p = p->next, idx++)
     {
-        for(int i = 0; i < colWidths[idx]; i++)
-            printf("-");
-        printf("+");
+        memset(outReserve(out, colWidths[idx]), '-', colWidths[idx]);
+        out->len += colWidths[idx];
+        outBytes(out, "+", 1);
     }
-    printf("\n");
+    outBytes(out, "\n", 1);
 }
 
-static void printHeader(AttrDesc *attrList, int *colWidths)
+static void printHeader(OutBuf *out, AttrDesc *attrList, int *colWidths)
 {
-    printSeparator(attrList, colWidths);
-    printf("|");
+    printSeparator(out, attrList, colWidths);
+    outBytes(out, "|", 1);
     int idx = 0;
     for(AttrDesc *p = attrList; p; p = p->next, idx++)
     {
-        printf(" %-*s |", colWidths[idx] - 2, p->attr.attrName);
+        outBytes(out, " ", 1);
+        outPadded(out, p->attr.attrName, strlen(p->attr.attrName), colWidths[idx] - 2, true);
+        outBytes(out, " |", 2);
     }
-    printf("\n");
-    printSeparator(attrList, colWidths);
+    outBytes(out, "\n", 1);
+    printSeparator(out, attrList, colWidths);
 }
 
-static char* formatIntValue(int value)
+/* Decimal digits of value into out, as "%lld"; returns the length */
+static int formatIntValue(long long value, char *out)
 {
-    // First pass: get the length needed
-    int len = snprintf(NULL, 0, "%d", value);
-    if (len < 0) return NULL;
-    
-    // Allocate exactly the right amount
-    char *buffer = (char *)malloc(len + 1);
-    if (!buffer) return NULL;
-    
-    // Second pass: write the formatted string
-    snprintf(buffer, len + 1, "%d", value);
-    return buffer;
+    char digits[NUM_LEN];
+    int n = 0, len = 0;
+    unsigned long long v = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+
+    do
+    {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+
+    if (value < 0)
+        out[len++] = '-';
+    while (n > 0)
+        out[len++] = digits[--n];
+    out[len] = '\0';
+    return len;
 }
 
-static char* formatFloatValue(float value)
+/*
+ * "%.2f" of a value below 1e7 in magnitude. value * 100 needs at most 53 + 7 bits, so it is exact in a long
+ * double (64-bit mantissa) and the last digit is rounded half to even on the exact value, as printf() does.
+ */
+static int formatFixed2(double value, char *out)
+{
+    long double scaled = (long double)value * 100;
+    int len = 0;
+
+    if (scaled < 0) {
+        out[len++] = '-';
+        scaled = -scaled;
+    }
+
+    unsigned long long cents = (unsigned long long)scaled;
+    long double frac = scaled - cents;
+
+    if (frac > 0.5L || (frac == 0.5L && (cents & 1)))
+        cents++;
+
+    len += formatIntValue((long long)(cents / 100), out + len);
+    out[len++] = '.';
+    out[len++] = (char)('0' + cents / 10 % 10);
+    out[len++] = (char)('0' + cents % 10);
+    out[len] = '\0';
+    return len;
+}
+
+static int formatFloatValue(float value, char *out)
 {
-    char *buffer = NULL;
-    
     // Handle special cases without math.h functions
     // Check for NaN (Not a Number) - NaN is not equal to itself
     if (value != value) {
-        buffer = strdup("NaN");
-        return buffer;
+        strcpy(out, "NaN");
+        return 3;
     }
-    
+
     // Check for infinity by comparing with very large values
     // Note: This is a simplified check that works for most cases
     if (value > 1e38f || value < -1e38f) {
-        if (value > 0) {
-            buffer = strdup("Inf");
-        } else {
-            buffer = strdup("-Inf");
-        }
-        return buffer;
+        strcpy(out, value > 0 ? "Inf" : "-Inf");
+        return (int)strlen(out);
     }
-    
+
     // Check if the value is exactly zero
     if (value == 0.0f) {
-        buffer = strdup("0.00");
-        return buffer;
+        strcpy(out, "0.00");
+        return 4;
     }
-    
+
     // Get absolute value without fabsf
     float absValue = value;
     if (absValue < 0) absValue = -absValue;
-    
+
     // Determine if we should use scientific notation
     int useScientific = 0;
-    
+
     // Very large or very small numbers use scientific notation
     if (absValue >= 1e7f || (absValue < 0.01f && absValue > 0.0f)) {
         useScientific = 1;
     } else {
         // For numbers in the "normal" range, check if rounding to 2 decimal places
         // accurately represents the number
-        
+
         // Manual rounding to 2 decimal places without roundf
         float rounded;
         if (value >= 0) {
@@ -371,17 +620,17 @@ static char* formatFloatValue(float value)
             // For negative numbers: multiply by 100, subtract 0.5, truncate, divide by 100
             rounded = (float)((int)(value * 100.0f - 0.5f)) / 100.0f;
         }
-        
+
         // Calculate the absolute difference
         float diff = rounded - value;
         if (diff < 0) diff = -diff;
-        
+
         // Calculate the relative difference
         float relDiff = diff;
         float valAbs = value;
         if (valAbs < 0) valAbs = -valAbs;
         if (valAbs != 0) relDiff = diff / valAbs;
-        
+
         // If the relative difference is significant (> 0.5%),
         // or if the absolute difference is more than half of the last digit (0.005),
         // then the number is not accurately represented by 2 decimal places
@@ -389,60 +638,115 @@ static char* formatFloatValue(float value)
             useScientific = 1;
         }
     }
-    
-    // Format the number appropriately
-    if (useScientific) {
-        // Use scientific notation with 2 decimal places
-        int len = snprintf(NULL, 0, "%.2e", value);
-        if (len < 0) return NULL;
-        
-        buffer = (char *)malloc(len + 1);
-        if (!buffer) return NULL;
-        
-        snprintf(buffer, len + 1, "%.2e", value);
-    } else {
-        // Use fixed-point notation with 2 decimal places
-        int len = snprintf(NULL, 0, "%.2f", value);
-        if (len < 0) return NULL;
-        
-        buffer = (char *)malloc(len + 1);
-        if (!buffer) return NULL;
-        
-        snprintf(buffer, len + 1, "%.2f", value);
-    }
-    
-    return buffer;
+
+    // Format the number appropriately: scientific notation with 2 decimal places, else fixed-point
+    if (useScientific)
+        return snprintf(out, NUM_LEN, "%.2e", value);
+    return formatFixed2(value, out);
 }
 
-static char* formatStringValue(const char *data, int length)
+/* Length of a string attribute with its trailing NULLs and spaces trimmed */
+static int formatStringValue(const char *data, int length)
 {
-    if (!data || length <= 0) {
-        // Return an empty string
-        char *empty = (char *)malloc(1);
-        if (empty) empty[0] = '\0';
-        return empty;
-    }
-    
-    // Find actual string length (trim trailing nulls/spaces)
+    if (!data || length <= 0)
+        return 0;
+
     int actualLen = length;
     while (actualLen > 0 && (data[actualLen - 1] == '\0' || data[actualLen - 1] == ' ')) {
         actualLen--;
     }
-    
-    if (actualLen <= 0) {
-        // Return an empty string
-        char *empty = (char *)malloc(1);
-        if (empty) empty[0] = '\0';
-        return empty;
-    }
-    
-    // Allocate exactly what we need
-    char *buffer = (char *)malloc(actualLen + 1);
-    if (!buffer) return NULL;
-    
-    // Copy the data
-    memcpy(buffer, data, actualLen);
-    buffer[actualLen] = '\0';
-    
-    return buffer;
+
+    /* a string shorter than the attribute ends at its first NULL */
+    const char *nul = memchr(data, '\0', actualLen);
+    return nul ? (int)(nul - data) : actualLen;
+}
+
+/* formatFloatValue() for an "f8" attribute: the same two-decimal or scientific choice, in double precision */
+static int formatDoubleValue(double value, char *out)
+{
+    if (isnan(value)) {
+        strcpy(out, "NaN");
+        return 3;
+    }
+    if (isinf(value)) {
+        strcpy(out, value > 0 ? "Inf" : "-Inf");
+        return (int)strlen(out);
+    }
+    if (value == 0.0) {
+        strcpy(out, "0.00");
+        return 4;
+    }
+
+    double absValue = fabs(value);
+    int useScientific = absValue >= 1e7 || absValue < 0.01;
+
+    if (!useScientific) {
+        double rounded = (double)(long long)(value * 100.0 + (value >= 0 ? 0.5 : -0.5)) / 100.0;
+        double diff = fabs(rounded - value);
+        useScientific = diff / absValue > 0.005 || diff > 0.005;
+    }
+
+    if (useScientific)
+        return snprintf(out, NUM_LEN, "%.2e", value);
+    return formatFixed2(value, out);
+}
+
+/*
+ * A float of csv or tsv output: the fewest decimals (up to 9 for a float, 17 for a double) with which the
+ * value reads back the same, e.g. 3.47 rather than 3.4700000286.  A value past 1e15 in magnitude, or one that
+ * needs more digits, is printed with "%.9g" / "%.17g", which also read back the same.
+ */
+static int formatShortest(double value, bool isFloat, char *out)
+{
+    static const long double pow10[] = { 1e0L, 1e1L, 1e2L, 1e3L, 1e4L, 1e5L, 1e6L, 1e7L, 1e8L, 1e9L,
+                                         1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L };
+
+    if (isnan(value)) {
+        strcpy(out, "NaN");
+        return 3;
+    }
+    if (isinf(value)) {
+        strcpy(out, value > 0 ? "Inf" : "-Inf");
+        return (int)strlen(out);
+    }
+
+    if (fabs(value) < 1e15) {
+        int maxDecimals = isFloat ? 9 : 17;
+
+        for (int k = 0; k <= maxDecimals; k++) {
+            long double scaled = (long double)value * pow10[k];
+
+            if (scaled >= 9e18L || scaled <= -9e18L)
+                break;
+
+            long long n = (long long)(scaled + (scaled >= 0 ? 0.5L : -0.5L));
+            int len = 0;
+
+            if (n < 0 || (n == 0 && value < 0))
+                out[len++] = '-';
+
+            unsigned long long v = n < 0 ? 0ULL - (unsigned long long)n : (unsigned long long)n;
+            char digits[NUM_LEN];
+            int d = 0;
+
+            do {
+                digits[d++] = (char)('0' + v % 10);
+                v /= 10;
+            } while (v || d <= k);
+
+            while (d > k)
+                out[len++] = digits[--d];
+            if (k > 0) {
+                out[len++] = '.';
+                while (d > 0)
+                    out[len++] = digits[--d];
+            }
+            out[len] = '\0';
+
+            if (isFloat ? strtof(out, NULL) == (float)value : strtod(out, NULL) == value)
+                return len;
+        }
+    }
+
+    return snprintf(out, NUM_LEN, isFloat ? "%.9g" : "%.17g", value);
 }
\ No newline at end of file
@@ -3,19 +3,359 @@
 #include "../include/defs.h"
 #include "../include/error.h"
 #include "../include/globals.h"
+#include "../include/helpers.h"
+#include "../include/openrel.h"
+#include "../include/findrel.h"
+#include "../include/findrelattr.h"
+#include "../include/getnextrec.h"
+#include "../include/insertrec.h"
+#include "../include/createfromattrlist.h"
+#include "../include/destroy.h"
+#include "../include/unpinrel.h"
+#include "../include/extsort.h"
+#include "../include/parsort.h"
+#include "../include/view.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
 
 
-int Sort (int argc, char **argv)
+/* Sort key of one Sort() call; handed to sortRecCmp() as the ExtSort context */
+typedef struct sortkey
 {
-    /* print command line arguments */
-    short k; /* iteration counter */
-    printf("%s:\n", argv[0]);
-    for (k=1; k<argc; ++k)
+    char type;      // attribute type
+    int size;       // attribute length
+    int offset;     // attribute offset within the record
+    int recSize;    // record length; the record's position follows it
+    int desc;       // 1 for descending order
+} SortKey;
+
+
+/*------------------------------------------------------------
+
+FUNCTION sortRecCmp (a, b, ctx)
+
+PARAMETER DESCRIPTION:
+    a, b → records of the source relation, each followed by its int position pid * recsPerPg + slot.
+    ctx  → SortKey describing the sort attribute.
+
+FUNCTION DESCRIPTION:
+    Orders records on the sort attribute, reversed for descending order.
+    Floats are ordered exactly.
+    Equal keys are ordered by position, so the sort is stable in both directions.
+
+RETURNS:
+    <0, 0 or >0.
+
+------------------------------------------------------------*/
+
+static int sortRecCmp(const void *a, const void *b, void *ctx)
+{
+    SortKey *key = ctx;
+    const char *ka = (const char *)a + key->offset;
+    const char *kb = (const char *)b + key->offset;
+    int c;
+
+    switch(key->type)
     {
-        printf ("\targv[%d] = %s\n", k, argv[k]);
+        case 'i':
+        case 'f':
+        case 'd':
+            c = compareNumeric(ka, kb, key->type, key->size);
+            break;
+        default:
+            c = strncmp(ka, kb, key->size);
+            c = (c > 0) - (c < 0);
     }
-    
-    printf ("Sort \n");
-    return (OK); /* all's fine */
+
+    if(c)
+        return key->desc ? -c : c;
+
+    int sa, sb;
+    memcpy(&sa, (const char *)a + key->recSize, sizeof(int));
+    memcpy(&sb, (const char *)b + key->recSize, sizeof(int));
+    return (sa > sb) - (sa < sb);
+}
+
+
+/* ParSortSink appending each sorted entry to the destination relation */
+static int sortInsert(const void *ent, void *arg)
+{
+    return InsertRec(*(int *)arg, (void *)ent);
 }
+
+
+/* Destroys the partly filled destination of a failed sort, keeping the error that stopped it */
+static int sortFail(char *dstRelName)
+{
+    int err = db_err_code;
+    char *destroyArgv[] = {"_destroy", dstRelName, NULL};
+
+    Destroy(2, destroyArgv);
+    db_err_code = err;
+    return ErrorMsgs(db_err_code, print_flag);
+}
+
+
+/* Body of Sort() once the source can be read by Rid: readName is the source relation, or the temporary relation
+   a view source was materialized into; messages name the source as given */
+static int sortRel(int argc, char **argv, const char *readName)
+{
+    char *dstRelName = argv[1];
+    char *srcRelName = argv[2];
+    char *attrName = argv[3];
+    int desc = 0;
+    long memBytes = SORT_MEM_BYTES;
+
+    if(FindRel(dstRelName) || ViewFind(dstRelName))
+    {
+        printf("Relation '%s' already exists in the DB.\n", dstRelName);
+        db_err_code = RELEXIST;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    int r2 = OpenRel((char *)readName);
+
+    if(r2 == NOTOK)
+    {
+        if(db_err_code == RELNOEXIST)
+        {
+            printf("Relation '%s' does NOT exist in the DB.\n", srcRelName);
+            printCloseStrings(RELCAT_CACHE, offsetof(RelCatRec, relName), srcRelName, NULL);
+        }
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    AttrDesc *attrDesc = FindRelAttr(r2, attrName);
+
+    if(!attrDesc)
+    {
+        printf("Attribute '%s' NOT present in relation '%s' of the DB.\n", attrName, srcRelName);
+        printCloseStrings(ATTRCAT_CACHE, offsetof(AttrCatRec, attrName), attrName, (char *)readName);
+        db_err_code = ATTRNOEXIST;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if(argc > 4 && argv[4][0] != '\0')
+    {
+        if(strcmp(argv[4], "desc") == OK)
+        {
+            desc = 1;
+        }
+        else if(strcmp(argv[4], "asc") != OK)
+        {
+            printf("Unknown sort order '%s'; use asc or desc.\n", argv[4]);
+            db_err_code = INVALID_VALUE;
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+    }
+
+    if(argc > 5)
+    {
+        long kb = strtol(argv[5], NULL, 10);
+
+        if(kb <= 0)
+        {
+            printf("Sort memory budget must be a positive number of KB.\n");
+            db_err_code = INVALID_VALUE;
+            return ErrorMsgs(db_err_code, print_flag);
+        }
+        memBytes = kb * 1024;
+    }
+
+    if(CreateFromAttrList(dstRelName, catcache[r2].attrList) == NOTOK)
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    int r1 = OpenRel(dstRelName);
+
+    if(r1 == NOTOK)
+    {
+        return sortFail(dstRelName);
+    }
+
+    SortKey key;
+    key.type = (attrDesc->attr).type[0];
+    key.size = (attrDesc->attr).length;
+    key.offset = (attrDesc->attr).offset;
+    key.recSize = catcache[r2].relcat_rec.recLength;
+    key.desc = desc;
+
+    int entSize = key.recSize + sizeof(int);
+    int numThreads = ParSortThreads(r2);
+    int rc = OK, numRuns = 0;
+
+    if(numThreads > 1)
+    {
+        rc = ParSortRel(r2, numThreads, sortRecCmp, &key, memBytes, dstRelName, sortInsert, &r1);
+    }
+    else
+    {
+        char *ent = malloc(entSize);
+        ExtSort sorter;
+
+        if(!ent)
+        {
+            db_err_code = MEM_ALLOC_ERROR;
+            return sortFail(dstRelName);
+        }
+
+        if(ExtSortOpen(&sorter, entSize, sortRecCmp, &key, memBytes, dstRelName) == NOTOK)
+        {
+            free(ent);
+            return sortFail(dstRelName);
+        }
+
+        Rid rid = INVALID_RID;
+        int recsPerPg = catcache[r2].relcat_rec.recsPerPg;
+
+        while(rc == OK)
+        {
+            if(GetNextRec(r2, rid, &rid, ent) == NOTOK)
+            {
+                rc = NOTOK;
+                break;
+            }
+
+            if(!isValidRid(rid))
+            {
+                break;
+            }
+
+            int pos = rid.pid * recsPerPg + rid.slotnum;
+            memcpy(ent + key.recSize, &pos, sizeof(int));
+            rc = ExtSortAdd(&sorter, ent);
+        }
+
+        if(rc == OK)
+        {
+            rc = ExtSortFinish(&sorter);
+        }
+
+        while(rc == OK)
+        {
+            int r = ExtSortNext(&sorter, ent);
+
+            if(r != 1)
+            {
+                rc = r == 0 ? OK : NOTOK;
+                break;
+            }
+
+            rc = sortInsert(ent, &r1);
+        }
+
+        numRuns = sorter.numRuns;
+        ExtSortClose(&sorter);
+        free(ent);
+    }
+
+    if(rc == NOTOK)
+    {
+        return sortFail(dstRelName);
+    }
+
+    UnPinRel(r1);
+    UnPinRel(r2);
+
+    if(numThreads > 1)
+    {
+        printf("Created relation %s with the %d tuples of %s sorted on %s (%s, %d threads)\n",
+        dstRelName, catcache[r1].relcat_rec.numRecs, srcRelName, attrName, desc ? "descending" : "ascending", numThreads);
+    }
+    else
+    {
+        printf("Created relation %s with the %d tuples of %s sorted on %s (%s, %d temporary run%s)\n",
+        dstRelName, catcache[r1].relcat_rec.numRecs, srcRelName, attrName, desc ? "descending" : "ascending",
+        numRuns, numRuns == 1 ? "" : "s");
+    }
+
+    return OK;
+}
+
+/*------------------------------------------------------------
+
+FUNCTION Sort (argc, argv)
+
+PARAMETER DESCRIPTION:
+    argc → number of command arguments.
+    argv → argument vector.
+
+SPECIFICATIONS:
+    argv[0] = "sort"
+    argv[1] = destination relation name (new relation)
+    argv[2] = source relation or view name
+    argv[3] = attribute name in source relation
+    argv[4] = (optional) "asc" or "desc" ("" when only "size" is given)
+    argv[5] = (optional) memory budget in KB, given as "size N"
+    argv[argc] = NIL
+
+FUNCTION DESCRIPTION:
+    Creates dstRelName with the schema of srcRelName and fills it with the records of srcRelName ordered on attrName.
+    Relations of any size are sorted with the external merge sort (physical/extsort.c) within the memory budget
+    (SORT_MEM_BYTES unless "size N" is given): replacement selection writes sorted runs roughly twice the budget long,
+    and a loser tree merges them, in several passes if there are more runs than the budget has merge buffers for.
+    Relations of at least 2 * SORT_PAR_MIN_PGS pages are sorted by several threads (ParSortRel()): workers sort disjoint
+    page ranges concurrently, and the merge is split by sampled key splitters so each worker produces one range of the output.
+    Temporary files "<dst>.*" are created in the database directory and removed before returning.
+    Records with equal keys keep their order in the source relation.
+
+ALGORITHM:
+    1) Verify that a database is open.
+    2) A view source is written to a temporary relation first (ViewMaterialize()), destroyed at the end.
+       Check that the destination does not exist, and that the source relation and the attribute do.
+    3) Validate the order keyword and the memory budget.
+    4) Create the destination relation from the source attribute list with CreateFromAttrList(), then OpenRel() it.
+    5) If ParSortThreads() allows more than one worker, sort with ParSortRel(), inserting the entries with InsertRec().
+    6) Otherwise open an ExtSort over (record, position) entries ordered by sortRecCmp(),
+       add every record of the source relation read with GetNextRec(), ExtSortFinish(),
+       then InsertRec() every entry returned by ExtSortNext() into the destination.
+    7) Print a success message and return OK.
+       If anything fails once the destination exists, destroy it again (sortFail()) so the sort can be retried.
+
+ERRORS REPORTED:
+    DBNOTOPEN
+    RELEXIST
+    RELNOEXIST
+    ATTRNOEXIST
+    INVALID_VALUE
+    MEM_ALLOC_ERROR
+    FILESYSTEM_ERROR
+    REC_INS_ERR (via InsertRec)
+
+GLOBAL VARIABLES MODIFIED:
+    db_err_code
+    Catalog entries for dstRelName (through CreateFromAttrList)
+
+IMPLEMENTATION NOTES:
+    • Heap files fill pages in insertion order, so a later GetNextRec() scan of the destination returns the records sorted.
+
+------------------------------------------------------------*/
+
+int Sort(int argc, char **argv)
+{
+    if(!db_open)
+    {
+        db_err_code = DBNOTOPEN;
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    if(!ViewFind(argv[2]))
+    {
+        return sortRel(argc, argv, argv[2]);
+    }
+
+    char tmpName[RELNAME];
+
+    if(ViewMaterialize(argv[2], tmpName) == NOTOK)
+    {
+        return ErrorMsgs(db_err_code, print_flag);
+    }
+
+    int rc = sortRel(argc, argv, tmpName);
+
+    ViewUnmaterialize(tmpName);
+    return rc;
+}
\ No newline at end of file